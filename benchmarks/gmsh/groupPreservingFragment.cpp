@@ -0,0 +1,90 @@
+//=============================================================================
+// Findings
+//=============================================================================
+// Times groupPreservingFragment on an N by N lattice of 3-ring pins, fragmented by
+// one "Coarse_Cell_XXXXX" rectangle per pin. This is what overlaySpatialPartition
+// does to a lattice. N = 50 gives 7500 pin entities, 2500 tools and 2504
+// physical groups.
+//
+// The physical group bookkeeping alone, without gmsh, is timed by
+// physical_group_bookkeeping.cpp.
+//
+// The full run below, which includes the OCC fragment, has not been measured yet.
+
+#include <benchmark/benchmark.h>
+
+#include <um2/config.hpp>
+
+#if UM2_USE_GMSH
+#  include <um2/gmsh/model.hpp>
+
+#  include <iomanip>
+#  include <sstream>
+
+// An n by n lattice of pins, and a rectangle with a coarse cell group around each.
+static void
+makeLattice(Size const n, um2::gmsh::vectorpair & object_dimtags,
+            um2::gmsh::vectorpair & tool_dimtags)
+{
+  double const pitch = 1.26;
+  std::vector<um2::Material> const materials = {
+      um2::Material(um2::ShortString("Fuel"), um2::Color("red")),
+      um2::Material(um2::ShortString("Gap"), um2::Color("white")),
+      um2::Material(um2::ShortString("Clad"), um2::Color("slategray"))};
+  std::vector<std::vector<int>> const pin_ids(static_cast<size_t>(n),
+                                              std::vector<int>(static_cast<size_t>(n), 0));
+  um2::gmsh::model::occ::addCylindricalPinLattice2D({{0.4096, 0.418, 0.475}}, {materials},
+                                                    {{pitch, pitch}}, pin_ids);
+  um2::gmsh::model::getEntities(object_dimtags, 2);
+  std::vector<int> cc_tags;
+  for (Size iy = 0; iy < n; ++iy) {
+    for (Size ix = 0; ix < n; ++ix) {
+      cc_tags.push_back(um2::gmsh::model::occ::addRectangle(ix * pitch, iy * pitch, 0.0,
+                                                            pitch, pitch));
+    }
+  }
+  um2::gmsh::model::occ::synchronize();
+  um2::gmsh::model::addToPhysicalGroup(2, cc_tags, -1, "Material_Moderator");
+  std::stringstream ss;
+  for (size_t i = 0; i < cc_tags.size(); ++i) {
+    ss.str("");
+    ss << "Coarse_Cell_" << std::setw(5) << std::setfill('0') << i;
+    um2::gmsh::model::addPhysicalGroup(2, {cc_tags[i]}, -1, ss.str());
+    tool_dimtags.emplace_back(2, cc_tags[i]);
+  }
+}
+
+static void
+groupPreservingFragment(benchmark::State & state)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  auto const n = static_cast<Size>(state.range(0));
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    state.PauseTiming();
+    um2::gmsh::initialize();
+    um2::gmsh::option::setNumber("General.Verbosity", 2);
+    um2::gmsh::vectorpair object_dimtags;
+    um2::gmsh::vectorpair tool_dimtags;
+    makeLattice(n, object_dimtags, tool_dimtags);
+    state.ResumeTiming();
+    um2::gmsh::vectorpair out_dimtags;
+    std::vector<um2::gmsh::vectorpair> out_dimtags_map;
+    um2::gmsh::model::occ::groupPreservingFragment(object_dimtags, tool_dimtags,
+                                                   out_dimtags, out_dimtags_map);
+    state.PauseTiming();
+    um2::gmsh::finalize();
+    state.ResumeTiming();
+  }
+}
+
+// Args: pins per side
+BENCHMARK(groupPreservingFragment)
+    ->Arg(10)
+    ->Arg(25)
+    ->Arg(50)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(1);
+#endif // UM2_USE_GMSH
+
+BENCHMARK_MAIN();
@@ -0,0 +1,227 @@
+//=============================================================================
+// Findings
+//=============================================================================
+// faceContaining for random points and intersect for random rays through the
+// pin meshes, with the full-precision mesh (arg 0: float, int32_t) or the
+// compact mesh (arg 1: 16-bit coordinates and indices). "bytes" is the size of
+// the vertices and fv, which is all either mesh reads. The sweep benchmarks
+// trace one ray through each of many copies of a mesh, so that the meshes do not
+// stay in cache between rays.
+//
+// Single vCPU VM at 2.0 GHz (48 KiB L1d, 2 MiB L2), GCC 12.2, -O3 -march=native,
+// ranges over two runs, full / compact:
+//  bytes:            tri 26.9k / 13.5k, quad 92.3k / 46.1k,
+//                    tri6 67.1k / 33.5k, quad8 215k / 108k
+//  faceContaining:   tri 61-63 / 71-73 ms,    quad 62-65 / 83-103 ms,
+//                    tri6 153-161 / 178-189,  quad8 265-271 / 410-416 ms
+//  intersect:        tri 61-62 / 73-80 ms,    quad 62-81 / 91-95 ms,
+//                    tri6 157-159 / 176-183,  quad8 419-425 / 517-540 ms
+//  sweep quad:       16 copies 0.82-0.91 / 1.34-1.45 ms,
+//                    2048 copies (189M / 94M bytes) 120-131 / 184-193 ms
+//  sweep quad8:      16 copies 6.5 / 8.0-8.1 ms,
+//                    1024 copies (220M / 110M bytes) 421-423 / 510-525 ms
+// The compact mesh takes half the memory of a float, int32_t mesh (a quarter of
+// a double, int64_t mesh), but is 15-60% slower. The faces are visited in order,
+// so the hardware prefetcher hides the memory traffic even when the meshes do
+// not fit in cache, and the time goes to converting the coordinates back to
+// floating point. The compact mesh is for fitting more coarse cells in memory,
+// not for speed. Whether it is faster when many threads share the memory
+// bandwidth could NOT be measured on this VM.
+#include "../helpers.hpp"
+
+#include <um2/mesh/CompactFaceVertexMesh.hpp>
+#include <um2/mesh/io.hpp>
+
+#include <iostream>
+
+constexpr Size npoints = 4096;
+constexpr Size nrays = 1024;
+
+template <Size P, Size N>
+void
+faceContaining(benchmark::State & state, std::string const & filename)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  um2::MeshFile<float, int32_t> meshfile;
+  um2::readAbaqusFile(filename, meshfile);
+  um2::FaceVertexMesh<P, N, 2, float, int32_t> const mesh(meshfile);
+  um2::CompactPolygonMesh<P, N, float> const compact(mesh);
+  auto const points = makeVectorOfRandomPoints(npoints, mesh.boundingBox());
+  bool const use_compact = state.range(0) == 1;
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    for (auto const & p : points) {
+      Size const i = use_compact ? compact.faceContaining(p) : mesh.faceContaining(p);
+      if (i == -1) {
+        std::cerr << "Face not found" << std::endl;
+      }
+    }
+  }
+  state.counters["bytes"] =
+      use_compact
+          ? static_cast<double>(compact.numVertices() * sizeof(um2::Vec2<uint16_t>) +
+                                compact.numFaces() * sizeof(um2::Vec<N, uint16_t>))
+          : static_cast<double>(mesh.numVertices() * sizeof(um2::Point2<float>) +
+                                mesh.numFaces() * sizeof(um2::Vec<N, int32_t>));
+}
+
+template <Size P, Size N>
+void
+intersect(benchmark::State & state, std::string const & filename)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  um2::MeshFile<float, int32_t> meshfile;
+  um2::readAbaqusFile(filename, meshfile);
+  um2::FaceVertexMesh<P, N, 2, float, int32_t> const mesh(meshfile);
+  um2::CompactPolygonMesh<P, N, float> const compact(mesh);
+  // Rays from random points on the left side of the mesh, in random directions
+  // to the right
+  auto const box = mesh.boundingBox();
+  um2::Vector<um2::Ray2<float>> rays;
+  for (Size i = 0; i < nrays; ++i) {
+    float const y =
+        box.minima[1] + randomFloat<float>() * (box.maxima[1] - box.minima[1]);
+    float const angle = (randomFloat<float>() - 0.5F) * um2::pi<float>;
+    rays.push_back(um2::Ray2<float>({box.minima[0] - 0.01F, y},
+                                    {um2::cos(angle), um2::sin(angle)}));
+  }
+  um2::Vector<float> intersections(4 * N * mesh.numFaces());
+  bool const use_compact = state.range(0) == 1;
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    for (auto const & ray : rays) {
+      Size n = intersections.size();
+      if (use_compact) {
+        compact.intersect(ray, intersections.data(), &n);
+      } else {
+        mesh.intersect(ray, intersections.data(), &n);
+      }
+      benchmark::DoNotOptimize(n);
+    }
+  }
+}
+
+// Trace one ray through each of num_meshes copies of the mesh in turn, as a
+// sweep does through the coarse cells of a core, so that the meshes do not stay
+// in cache between rays.
+template <Size P, Size N>
+void
+sweep(benchmark::State & state, std::string const & filename)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  um2::MeshFile<float, int32_t> meshfile;
+  um2::readAbaqusFile(filename, meshfile);
+  um2::FaceVertexMesh<P, N, 2, float, int32_t> const mesh(meshfile);
+  bool const use_compact = state.range(0) == 1;
+  auto const num_meshes = static_cast<Size>(state.range(1));
+  um2::Vector<um2::FaceVertexMesh<P, N, 2, float, int32_t>> meshes;
+  um2::Vector<um2::CompactPolygonMesh<P, N, float>> compacts;
+  for (Size i = 0; i < num_meshes; ++i) {
+    if (use_compact) {
+      compacts.push_back(um2::CompactPolygonMesh<P, N, float>(mesh));
+    } else {
+      meshes.push_back(mesh);
+    }
+  }
+  auto const box = mesh.boundingBox();
+  um2::Vector<um2::Ray2<float>> rays;
+  for (Size i = 0; i < num_meshes; ++i) {
+    float const y =
+        box.minima[1] + randomFloat<float>() * (box.maxima[1] - box.minima[1]);
+    float const angle = (randomFloat<float>() - 0.5F) * um2::pi<float>;
+    rays.push_back(um2::Ray2<float>({box.minima[0] - 0.01F, y},
+                                    {um2::cos(angle), um2::sin(angle)}));
+  }
+  um2::Vector<float> intersections(4 * N * mesh.numFaces());
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    for (Size i = 0; i < num_meshes; ++i) {
+      Size n = intersections.size();
+      if (use_compact) {
+        compacts[i].intersect(rays[i], intersections.data(), &n);
+      } else {
+        meshes[i].intersect(rays[i], intersections.data(), &n);
+      }
+      benchmark::DoNotOptimize(n);
+    }
+  }
+}
+
+static void
+faceContainingTri1656(benchmark::State & state)
+{
+  faceContaining<1, 3>(state, "./mesh_files/tri_pin_1656.inp");
+}
+
+static void
+faceContainingQuad3808(benchmark::State & state)
+{
+  faceContaining<1, 4>(state, "./mesh_files/quad_pin_3808.inp");
+}
+
+static void
+faceContainingTri6_1656(benchmark::State & state)
+{
+  faceContaining<2, 6>(state, "./mesh_files/tri6_pin_1656.inp");
+}
+
+static void
+faceContainingQuad8_3808(benchmark::State & state)
+{
+  faceContaining<2, 8>(state, "./mesh_files/quad8_pin_3808.inp");
+}
+
+static void
+intersectTri1656(benchmark::State & state)
+{
+  intersect<1, 3>(state, "./mesh_files/tri_pin_1656.inp");
+}
+
+static void
+intersectQuad3808(benchmark::State & state)
+{
+  intersect<1, 4>(state, "./mesh_files/quad_pin_3808.inp");
+}
+
+static void
+intersectTri6_1656(benchmark::State & state)
+{
+  intersect<2, 6>(state, "./mesh_files/tri6_pin_1656.inp");
+}
+
+static void
+intersectQuad8_3808(benchmark::State & state)
+{
+  intersect<2, 8>(state, "./mesh_files/quad8_pin_3808.inp");
+}
+
+static void
+sweepQuad3808(benchmark::State & state)
+{
+  sweep<1, 4>(state, "./mesh_files/quad_pin_3808.inp");
+}
+
+static void
+sweepQuad8_3808(benchmark::State & state)
+{
+  sweep<2, 8>(state, "./mesh_files/quad8_pin_3808.inp");
+}
+
+// Arg: 0 for the full-precision mesh, 1 for the compact mesh
+BENCHMARK(faceContainingTri1656)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(faceContainingQuad3808)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(faceContainingTri6_1656)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(faceContainingQuad8_3808)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(intersectTri1656)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(intersectQuad3808)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(intersectTri6_1656)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(intersectQuad8_3808)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+// Args: full-precision or compact mesh, number of copies of the mesh
+BENCHMARK(sweepQuad3808)
+    ->ArgsProduct({{0, 1}, {16, 2048}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(sweepQuad8_3808)
+    ->ArgsProduct({{0, 1}, {16, 1024}})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
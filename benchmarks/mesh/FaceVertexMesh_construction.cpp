@@ -0,0 +1,232 @@
+//=============================================================================
+// Findings
+//=============================================================================
+// Build a FaceVertexMesh from a MeshFile of an n by n grid of unit squares, or
+// of the triangles made by splitting each square in two. "toFaceVertexMesh" is
+// the whole construction, "connectivity" is buildVertexFaceConnectivity alone
+// and "validate" is validateMesh alone.
+//
+// The copies of the vertices and fv, the vertex-face connectivity and the
+// validation run in parallel with OpenMP (see buildVertexFaceConnectivity).
+//
+// The VM used for these numbers has a single vCPU at 2.0 GHz (GCC 12.2, -O3
+// -march=native), so the parallel speedup could NOT be measured. What was
+// measured is that the serial path did not get slower (OMP_NUM_THREADS=1,
+// medians of three runs, before -> after):
+//                       n = 1024          n = 2048
+//  toTriMesh            92 -> 98 ms       404 -> 336 ms
+//  toQuadMesh           43 -> 48 ms       301 -> 278 ms
+//  triConnectivity      37 -> 43 ms       132 -> 114 ms
+//  quadConnectivity     17 -> 18 ms        69 -> 68 ms
+//  validateTriMesh     8.4 -> 6.3 ms       31 -> 24 ms
+//  validateQuadMesh     13 -> 13 ms        52 -> 48 ms
+// These are within the run to run noise of this VM (10-20%). Most of the rest
+// of toFaceVertexMesh is page faults on the new buffers, which cost about 2.5
+// us per 4 KiB page on this VM.
+//
+// The total work of the parallel connectivity can be measured by running more
+// threads than cores with OMP_WAIT_POLICY=passive. The first parallel version
+// had each thread read all of fv and skip the vertices of other threads, so its
+// reads of fv grew with the number of threads. It was replaced by per-thread
+// counts over chunks of fv and a scan (see buildVertexFaceConnectivity), which
+// read fv twice in all. Medians of seven runs on the single vCPU, so these
+// are total work rather than speedups (all threads / chunked counts):
+//                          T = 1          T = 2          T = 4
+//  triConnectivity/1024    37 / 36 ms     40 / 45 ms     63 / 50 ms
+//  triConnectivity/2048   135 / 144 ms   156 / 183 ms   210 / 218 ms
+//  quadConnectivity/1024   14 / 14 ms     24 / 16 ms     39 / 18 ms
+//  quadConnectivity/2048   48 / 56 ms     95 / 84 ms    178 / 92 ms
+// The chunked version's extra work is the rows of counts, nthreads *
+// num_vertices entries, most of which is page faults on this VM. This is
+// largest for triangles, whose vertices are in about 6 faces each, and is
+// bounded by the cap of (entries of fv) / num_vertices threads. The speedup on
+// a multicore machine, where the chunked version also divides the reads of fv
+// between the threads, is still to be measured. The first versions counted and
+// scattered with an atomic operation per entry (7x slower per entry than the
+// serial loop with no contention), and then partitioned the entries by thread
+// first (about 4 times the work of the serial version with 2 threads); both
+// were dropped.
+//
+// Small meshes (fewer than 2^15 face-vertex entries, or 2^12 faces to
+// validate) are built serially. Before, every loop started an OpenMP region
+// (OMP_NUM_THREADS=4, before -> after):
+//  toTriMesh/16     0.050 -> 0.009 ms
+//  toQuadMesh/16    0.059 -> 0.008 ms
+//  toTriMesh/64     0.277 -> 0.200 ms
+// With OMP_NUM_THREADS=1, these are 0.008-0.010 ms and 0.19-0.23 ms either way.
+//
+// "validateFlippedQuadMesh" flips every face before validateMesh, which flips
+// them back and warns about them, with the log going to /dev/null. One warning
+// per face (before) against one warning in all (after), OMP_NUM_THREADS=1:
+//  n = 64:     11.7 ms -> 0.059 ms
+//  n = 256:    186 ms  -> 0.83 ms
+//  n = 1024:   2951 ms -> 14.5 ms
+// In a build without NDEBUG, which also checks for duplicate vertices by
+// sorting Morton codes rather than a copy of the vertices, validateQuadMesh
+// went from 83 to 81 ms (n = 1024) and from 482 to 388 ms (n = 2048); most of
+// that time is in the unoptimized checks of the debug build.
+
+#include "../helpers.hpp"
+
+#include <um2/mesh/FaceVertexMesh.hpp>
+
+// The vertices are numbered row by row, and so are the faces.
+template <Size N>
+auto
+makeGridMeshFile(Size const n) -> um2::MeshFile<float, int32_t>
+{
+  um2::MeshFile<float, int32_t> file;
+  auto const num_vertices = static_cast<size_t>((n + 1) * (n + 1));
+  file.vertices.resize(num_vertices);
+  for (Size i = 0; i <= n; ++i) {
+    for (Size j = 0; j <= n; ++j) {
+      file.vertices[static_cast<size_t>(i * (n + 1) + j)] =
+          um2::Point3<float>(static_cast<float>(j), static_cast<float>(i), 0.0F);
+    }
+  }
+  auto const v = [n](Size const i, Size const j) { return i * (n + 1) + j; };
+  for (Size i = 0; i < n; ++i) {
+    for (Size j = 0; j < n; ++j) {
+      if constexpr (N == 4) {
+        file.element_conn.insert(file.element_conn.end(),
+                                 {v(i, j), v(i, j + 1), v(i + 1, j + 1), v(i + 1, j)});
+      } else {
+        file.element_conn.insert(file.element_conn.end(),
+                                 {v(i, j), v(i, j + 1), v(i + 1, j + 1), v(i, j),
+                                  v(i + 1, j + 1), v(i + 1, j)});
+      }
+    }
+  }
+  auto const num_faces = file.element_conn.size() / N;
+  um2::MeshType const type = N == 4 ? um2::MeshType::Quad : um2::MeshType::Tri;
+  file.element_types.resize(num_faces, type);
+  file.element_offsets.resize(num_faces + 1);
+  for (size_t i = 0; i <= num_faces; ++i) {
+    file.element_offsets[i] = static_cast<int32_t>(i * N);
+  }
+  return file;
+}
+
+template <Size N>
+void
+toFaceVertexMesh(benchmark::State & state)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  auto const file = makeGridMeshFile<N>(static_cast<Size>(state.range(0)));
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    um2::FaceVertexMesh<1, N, 2, float, int32_t> mesh;
+    um2::toFaceVertexMesh(file, mesh);
+    benchmark::DoNotOptimize(mesh.vf.data());
+  }
+}
+
+template <Size N>
+void
+connectivity(benchmark::State & state)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  auto const file = makeGridMeshFile<N>(static_cast<Size>(state.range(0)));
+  um2::FaceVertexMesh<1, N, 2, float, int32_t> mesh(file);
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    um2::buildVertexFaceConnectivity(mesh);
+    benchmark::DoNotOptimize(mesh.vf.data());
+  }
+}
+
+template <Size N>
+void
+validate(benchmark::State & state)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  auto const file = makeGridMeshFile<N>(static_cast<Size>(state.range(0)));
+  um2::FaceVertexMesh<1, N, 2, float, int32_t> mesh(file);
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    um2::validateMesh(mesh);
+    benchmark::DoNotOptimize(mesh.fv.data());
+  }
+}
+
+// Every face is flipped before validateMesh flips it back, and the warnings
+// are printed.
+static void
+validateFlippedQuadMesh(benchmark::State & state)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  auto const file = makeGridMeshFile<4>(static_cast<Size>(state.range(0)));
+  um2::QuadMesh<2, float, int32_t> mesh(file);
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    state.PauseTiming();
+    for (Size i = 0; i < mesh.numFaces(); ++i) {
+      mesh.flipFace(i);
+    }
+    state.ResumeTiming();
+    um2::validateMesh(mesh);
+    benchmark::DoNotOptimize(mesh.fv.data());
+  }
+}
+
+static void
+toTriMesh(benchmark::State & state)
+{
+  toFaceVertexMesh<3>(state);
+}
+
+static void
+toQuadMesh(benchmark::State & state)
+{
+  toFaceVertexMesh<4>(state);
+}
+
+static void
+triConnectivity(benchmark::State & state)
+{
+  connectivity<3>(state);
+}
+
+static void
+quadConnectivity(benchmark::State & state)
+{
+  connectivity<4>(state);
+}
+
+static void
+validateTriMesh(benchmark::State & state)
+{
+  validate<3>(state);
+}
+
+static void
+validateQuadMesh(benchmark::State & state)
+{
+  validate<4>(state);
+}
+
+// Arg: number of squares along each side of the grid
+BENCHMARK(toTriMesh)->RangeMultiplier(4)->Range(16, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK(toQuadMesh)->RangeMultiplier(4)->Range(16, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK(triConnectivity)
+    ->RangeMultiplier(4)
+    ->Range(256, 2048)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(quadConnectivity)
+    ->RangeMultiplier(4)
+    ->Range(256, 2048)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(validateTriMesh)
+    ->RangeMultiplier(4)
+    ->Range(256, 2048)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(validateQuadMesh)
+    ->RangeMultiplier(4)
+    ->Range(256, 2048)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(validateFlippedQuadMesh)
+    ->RangeMultiplier(4)
+    ->Range(64, 1024)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,137 @@
+//=============================================================================
+// Findings
+//=============================================================================
+// The cached face geometry (see face_geometry.hpp) of the quadratic pin meshes.
+// Arg 0 clears the cache every iteration, arg 1 keeps it. Before the cache,
+// boundingBox of a quadratic mesh took the bounding box of every face on every
+// call, um2MPACTCoarseCellFaceCentroid computed the centroid of its face on
+// every call, and BinnedFaceVertexMesh took the bounding box of every face three
+// times.
+//
+// Single vCPU VM at 2.0 GHz, GCC 12.2, -O3 -march=native, two runs each,
+// before -> after (arg 0 / arg 1):
+//                     before        after, uncached    after, cached
+//  boundingBox tri6   37 us         300-530 us         1 ns
+//  boundingBox quad8  120-145 us    410-420 us         1 ns
+//  centroids tri6     62-64 us      67-73 us           4.3-4.4 us
+//  centroids quad8    210-235 us    250-265 us         7.9-8.0 us
+//  binning tri6       630-640 us    400-580 us
+//  binning quad8      1710-1860 us  630-650 us
+// Filling the cache costs 3 to 8 times one boundingBox pass of the old code,
+// since it also computes the area and centroid of every face, so it pays off
+// from the second call that uses it. importCoarseCells takes the bounding box
+// of each mesh once and then shifts its vertices, so it fills the cache and
+// clears it again: about 0.3 ms more per unique quadratic coarse cell mesh.
+// The parallel speedup of filling the cache could NOT be measured on this VM.
+
+#include "../helpers.hpp"
+
+#include <um2/mesh/BinnedFaceVertexMesh.hpp>
+#include <um2/mesh/io.hpp>
+
+// Read the quadratic mesh of a pin cell.
+template <Size N>
+auto
+readPinMesh(std::string const & filename)
+    -> um2::QuadraticPolygonMesh<N, 2, float, int32_t>
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  um2::MeshFile<float, int32_t> meshfile;
+  um2::readAbaqusFile(filename, meshfile);
+  return um2::QuadraticPolygonMesh<N, 2, float, int32_t>(meshfile);
+}
+
+// boundingBox of the mesh, with the face geometry computed each time (arg 0) or
+// cached (arg 1).
+template <Size N>
+void
+boundingBox(benchmark::State & state, std::string const & filename)
+{
+  auto mesh = readPinMesh<N>(filename);
+  bool const cached = state.range(0) == 1;
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    if (!cached) {
+      mesh.clearFaceGeometry();
+    }
+    benchmark::DoNotOptimize(mesh.boundingBox());
+  }
+}
+
+// The centroid of every face, computed each time (arg 0) or cached (arg 1),
+// as um2MPACTCoarseCellFaceCentroid is called for each face of a coarse cell.
+template <Size N>
+void
+faceCentroids(benchmark::State & state, std::string const & filename)
+{
+  auto mesh = readPinMesh<N>(filename);
+  bool const cached = state.range(0) == 1;
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    for (Size i = 0; i < mesh.numFaces(); ++i) {
+      um2::Point2<float> const p =
+          cached ? mesh.faceGeometry().centroids[i] : mesh.getFace(i).centroid();
+      benchmark::DoNotOptimize(p);
+    }
+  }
+}
+
+// Binning the faces, which needs the bounding box of each face
+template <Size N>
+void
+binning(benchmark::State & state, std::string const & filename)
+{
+  auto mesh = readPinMesh<N>(filename);
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    mesh.clearFaceGeometry();
+    um2::BinnedFaceVertexMesh<2, N, 2, float, int32_t> const binned(mesh);
+    benchmark::DoNotOptimize(binned.face_ids.data());
+  }
+}
+
+static void
+boundingBoxTri6_1656(benchmark::State & state)
+{
+  boundingBox<6>(state, "./mesh_files/tri6_pin_1656.inp");
+}
+
+static void
+boundingBoxQuad8_3808(benchmark::State & state)
+{
+  boundingBox<8>(state, "./mesh_files/quad8_pin_3808.inp");
+}
+
+static void
+faceCentroidsTri6_1656(benchmark::State & state)
+{
+  faceCentroids<6>(state, "./mesh_files/tri6_pin_1656.inp");
+}
+
+static void
+faceCentroidsQuad8_3808(benchmark::State & state)
+{
+  faceCentroids<8>(state, "./mesh_files/quad8_pin_3808.inp");
+}
+
+static void
+binningTri6_1656(benchmark::State & state)
+{
+  binning<6>(state, "./mesh_files/tri6_pin_1656.inp");
+}
+
+static void
+binningQuad8_3808(benchmark::State & state)
+{
+  binning<8>(state, "./mesh_files/quad8_pin_3808.inp");
+}
+
+// Arg: 0 to compute the face geometry each time, 1 to use the cache
+BENCHMARK(boundingBoxTri6_1656)->DenseRange(0, 1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(boundingBoxQuad8_3808)->DenseRange(0, 1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(faceCentroidsTri6_1656)->DenseRange(0, 1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(faceCentroidsQuad8_3808)->DenseRange(0, 1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(binningTri6_1656)->Unit(benchmark::kMicrosecond);
+BENCHMARK(binningQuad8_3808)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,203 @@
+//=============================================================================
+// Findings
+//=============================================================================
+// The faces and vertices of the fixture meshes are put in one of four orders
+// before calling faceContaining for random points:
+//  0: as read from the file (gmsh's order)
+//  1: randomly shuffled
+//  2: Morton order
+//  3: Hilbert order
+// Vertices are sorted by position and faces by the mean of their vertices.
+//
+// Hardware counters are not exposed in the VM used for these numbers, so cache
+// misses were not counted. Instead, "lines/face" is a counter-free proxy: the
+// average number of 64 byte lines of vertex data needed by a face and not
+// already needed by the previous face, in the order faceContaining visits them.
+// On a machine with counters, running with
+// --benchmark_perf_counters=CACHE-MISSES gives the real figure.
+//
+// faceContaining scans the faces in order until it finds the point, so the
+// order also changes the number of faces tested per query ("faces/query"). The
+// time is therefore given per face tested.
+//
+// Shared single vCPU VM at 2.0 GHz, GCC 12.2, -O3 -march=native, 4096 random
+// points, ranges over two runs:
+//                 lines/face                  ns/face
+//             file  shuffled Morton Hilbert  file   shuffled Morton  Hilbert
+//  tri1656    1.59  2.89     0.55   0.42     14-15  16       11-14   12-13
+//  quad3808   1.21  3.96     0.82   0.68     7.3    18       13      12.5
+//  tri6_1656  2.88  5.89     1.19   0.98     38     42-43    28-34   29-33
+// Hilbert order needs 15-25% fewer new lines per face than Morton order, and
+// 2-3x fewer than the file order. But these meshes are small enough that the
+// vertices fit in the 48 KiB L1 cache, so the timings mostly do not follow:
+// Morton and Hilbert order are within the noise of each other, and 10-25%
+// faster than the file order for the triangle meshes. For quad3808 the file
+// order is 1.7x faster than either curve. Its faces are largely structured
+// rows, so consecutive point-in-quad tests take the same branches, which the
+// jumps of both curves between rows break up. Shuffling the faces is slower
+// in every case.
+// The payoff in cache misses should be measured on meshes which do not fit in
+// cache, on a machine with hardware counters.
+
+#include "../helpers.hpp"
+
+#include <um2/geometry/hilbert_sort_points.hpp>
+#include <um2/geometry/morton_sort_points.hpp>
+#include <um2/mesh/FaceVertexMesh.hpp>
+#include <um2/mesh/io.hpp>
+
+#include <iostream>
+#include <random>
+
+constexpr Size npoints = 4096;
+
+// Put the vertices and faces of the mesh in the given order. Only vertices and
+// fv are reordered, which is all that faceContaining uses.
+template <Size P, Size N>
+void
+reorder(um2::FaceVertexMesh<P, N, 2, float, int32_t> & mesh, int64_t const order)
+{
+  Size const num_vertices = mesh.numVertices();
+  Size const num_faces = mesh.numFaces();
+  auto const box = mesh.boundingBox();
+  auto const normalize = [&box](um2::Point2<float> p) {
+    p -= box.minima;
+    p /= (box.maxima - box.minima);
+    // Guard against rounding at the sides of the box
+    for (auto & x : p) {
+      x = um2::clamp(x, 0.0F, 1.0F);
+    }
+    return p;
+  };
+  auto const sortPermutation = [order](um2::Vector<um2::Point2<float>> const & points,
+                                       um2::Vector<Size> & perm) {
+    perm.resize(points.size());
+    if (order == 0) {
+      std::iota(perm.begin(), perm.end(), 0);
+    } else if (order == 1) {
+      std::iota(perm.begin(), perm.end(), 0);
+      std::mt19937 g(0);
+      std::shuffle(perm.begin(), perm.end(), g);
+    } else if (order == 2) {
+      um2::mortonSortPermutation<uint32_t>(points.cbegin(), points.cend(), perm.begin());
+    } else {
+      um2::hilbertSortPermutation<uint32_t>(points.cbegin(), points.cend(), perm.begin());
+    }
+  };
+
+  um2::Vector<um2::Point2<float>> points(num_vertices);
+  for (Size i = 0; i < num_vertices; ++i) {
+    points[i] = normalize(mesh.vertices[i]);
+  }
+  um2::Vector<Size> perm;
+  sortPermutation(points, perm);
+  um2::Vector<int32_t> new_id(num_vertices);
+  um2::Vector<um2::Point2<float>> vertices(num_vertices);
+  for (Size i = 0; i < num_vertices; ++i) {
+    vertices[i] = mesh.vertices[perm[i]];
+    new_id[perm[i]] = i;
+  }
+  mesh.vertices = vertices;
+  for (auto & conn : mesh.fv) {
+    for (Size j = 0; j < N; ++j) {
+      conn[j] = new_id[conn[j]];
+    }
+  }
+
+  points.resize(num_faces);
+  for (Size i = 0; i < num_faces; ++i) {
+    um2::Point2<float> c(0, 0);
+    for (Size j = 0; j < N; ++j) {
+      c += mesh.vertices[mesh.fv[i][j]];
+    }
+    points[i] = normalize(c / static_cast<float>(N));
+  }
+  sortPermutation(points, perm);
+  auto const fv = mesh.fv;
+  for (Size i = 0; i < num_faces; ++i) {
+    mesh.fv[i] = fv[perm[i]];
+  }
+}
+
+// The average number of 64 byte lines of vertex data needed by a face and not
+// by the previous face.
+template <Size P, Size N>
+auto
+newLinesPerFace(um2::FaceVertexMesh<P, N, 2, float, int32_t> const & mesh) -> double
+{
+  Size constexpr vertices_per_line = 64 / static_cast<Size>(sizeof(um2::Point2<float>));
+  Size total = 0;
+  for (Size i = 0; i < mesh.numFaces(); ++i) {
+    for (Size j = 0; j < N; ++j) {
+      Size const line = mesh.fv[i][j] / vertices_per_line;
+      bool is_new = true;
+      // Lines already needed by this face or the previous one
+      for (Size k = 0; k < j && is_new; ++k) {
+        is_new = mesh.fv[i][k] / vertices_per_line != line;
+      }
+      for (Size k = 0; k < N && is_new && i > 0; ++k) {
+        is_new = mesh.fv[i - 1][k] / vertices_per_line != line;
+      }
+      total += is_new ? 1 : 0;
+    }
+  }
+  return static_cast<double>(total) / static_cast<double>(mesh.numFaces());
+}
+
+template <Size P, Size N>
+void
+faceContaining(benchmark::State & state, std::string const & filename)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  um2::MeshFile<float, int32_t> meshfile;
+  um2::readAbaqusFile(filename, meshfile);
+  um2::FaceVertexMesh<P, N, 2, float, int32_t> mesh(meshfile);
+  reorder(mesh, state.range(0));
+  auto const points = makeVectorOfRandomPoints(npoints, mesh.boundingBox());
+  // faceContaining scans the faces in order, so the order also changes how many
+  // faces are tested before the one containing the point is found.
+  Size faces_tested = 0;
+  for (auto const & p : points) {
+    faces_tested += mesh.faceContaining(p) + 1;
+  }
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    for (auto const & p : points) {
+      Size const i = mesh.faceContaining(p);
+      if (i == -1) {
+        std::cerr << "Face not found" << std::endl;
+      }
+    }
+  }
+  state.counters["lines/face"] = newLinesPerFace(mesh);
+  state.counters["faces/query"] =
+      static_cast<double>(faces_tested) / static_cast<double>(npoints);
+  state.counters["ns/face"] = benchmark::Counter(
+      static_cast<double>(faces_tested) * 1e-9,
+      benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+static void
+tri1656(benchmark::State & state)
+{
+  faceContaining<1, 3>(state, "./mesh_files/tri_pin_1656.inp");
+}
+
+static void
+quad3808(benchmark::State & state)
+{
+  faceContaining<1, 4>(state, "./mesh_files/quad_pin_3808.inp");
+}
+
+static void
+tri6_1656(benchmark::State & state)
+{
+  faceContaining<2, 6>(state, "./mesh_files/tri6_pin_1656.inp");
+}
+
+// Arg: order of the faces and vertices
+BENCHMARK(tri1656)->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
+BENCHMARK(quad3808)->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
+BENCHMARK(tri6_1656)->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,169 @@
+//=============================================================================
+// Findings
+//=============================================================================
+// Track lengths in a 3 by 3 lattice of tri_pin_1656 with its bottom left corner
+// at (300, 300), summed over 1942 modular rays at 4 angles, spaced 0.01 apart.
+// Errors are relative to the double mesh traced in local coordinates (arg 0).
+//
+// Single vCPU VM at 2.0 GHz, GCC 12.2, -O3 -march=native, two runs each:
+//                                      time         max err   mean err  total err
+//  0 double mesh, local                332-343 ms   -         -         -
+//  1 float mesh, local, double ray     320-333 ms   2.4e-5    9.6e-7    6.8e-9
+//  2 float mesh, core coordinates      339-360 ms   2.7e-2    4.3e-4    6.1e-7
+// Moving the ray to the mesh before converting it to float makes the error per
+// face 450 times smaller than tracing the float mesh where it is in the core.
+// Before a face hit an odd number of times was traced again in double, a ray
+// through a vertex on the edge of the pin missed both edges of the vertex in
+// float, and path 1 lost 11% of the track length of that face.
+//
+// The three paths take the same time within the noise of this VM: the
+// intersection kernels are scalar, so float does not do twice the work per
+// instruction that it could in SIMD registers. The smaller memory traffic of a
+// float mesh does not show either, since one pin mesh fits in L2. Neither
+// vectorized kernels nor a core large enough to be memory bound were measured.
+
+#include "../helpers.hpp"
+
+#include <um2/mesh/io.hpp>
+#include <um2/mesh/tracing.hpp>
+
+// A lattice of num_pins by num_pins copies of a pin mesh, with its bottom left
+// corner at (x0, x0) in the core, as far from the origin as the last lattices of
+// a large core.
+constexpr Size num_pins = 3;
+constexpr double x0 = 300.0;
+constexpr double ray_spacing = 0.01;
+constexpr Size num_angles = 4;
+
+// Where the rays are traced
+enum class Path { Double, Mixed, GlobalFloat };
+
+struct Lattice {
+  um2::TriMesh<2, double, int32_t> mesh; // local, bottom left corner at (0, 0)
+  um2::TriMesh<2, float, int32_t> mesh_f;
+  // The copies of mesh_f in the coordinates of the core, for Path::GlobalFloat
+  um2::Vector<um2::TriMesh<2, float, int32_t>> global_meshes_f;
+  um2::Vector<um2::Point2<double>> origins;
+  um2::Vector<um2::AxisAlignedBox2<double>> boxes;
+  um2::Vector<um2::Ray2<double>> rays;
+};
+
+auto
+makeLattice(std::string const & filename) -> Lattice
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  um2::MeshFile<double, int32_t> meshfile;
+  um2::readAbaqusFile(filename, meshfile);
+  Lattice lattice;
+  lattice.mesh = um2::TriMesh<2, double, int32_t>(meshfile);
+  auto const box = lattice.mesh.boundingBox();
+  for (auto & v : lattice.mesh.vertices) {
+    v -= box.minima;
+  }
+  lattice.mesh.clearFaceGeometry();
+  lattice.mesh_f = um2::convertPrecision<float>(lattice.mesh);
+  double const pitch = box.width();
+  for (Size j = 0; j < num_pins; ++j) {
+    for (Size i = 0; i < num_pins; ++i) {
+      um2::Point2<double> const origin(x0 + static_cast<double>(i) * pitch,
+                                       x0 + static_cast<double>(j) * pitch);
+      lattice.origins.push_back(origin);
+      lattice.boxes.push_back(um2::AxisAlignedBox2<double>(
+          origin, origin + um2::Point2<double>(pitch, box.height())));
+      auto global_mesh = lattice.mesh_f;
+      for (Size k = 0; k < global_mesh.numVertices(); ++k) {
+        for (Size d = 0; d < 2; ++d) {
+          global_mesh.vertices[k][d] =
+              static_cast<float>(origin[d] + lattice.mesh.vertices[k][d]);
+        }
+      }
+      lattice.global_meshes_f.push_back(um2::move(global_mesh));
+    }
+  }
+  um2::AxisAlignedBox2<double> const lattice_box(
+      lattice.origins[0], lattice.boxes[num_pins * num_pins - 1].maxima);
+  for (Size ia = 0; ia < num_angles; ++ia) {
+    double const angle =
+        um2::pi<double> * static_cast<double>(2 * ia + 1) / (4 * num_angles);
+    auto const params = um2::getModularRayParams(angle, ray_spacing, lattice_box);
+    for (Size i = 0; i < params.num_rays[0] + params.num_rays[1]; ++i) {
+      lattice.rays.push_back(params.getRay(i));
+    }
+  }
+  return lattice;
+}
+
+// The total track length in each face of each pin, over all rays
+template <class A>
+void
+trace(Lattice const & lattice, Path const path, um2::Vector<A> & lengths)
+{
+  Size const num_faces = lattice.mesh.numFaces();
+  lengths.resize(num_pins * num_pins * num_faces);
+  std::fill(lengths.begin(), lengths.end(), static_cast<A>(0));
+  for (auto const & ray : lattice.rays) {
+    um2::Ray2<float> const ray_f(
+        um2::Point2<float>(static_cast<float>(ray.o[0]), static_cast<float>(ray.o[1])),
+        um2::Vec2<float>(static_cast<float>(ray.d[0]), static_cast<float>(ray.d[1])));
+    for (Size p = 0; p < num_pins * num_pins; ++p) {
+      if (um2::intersect(lattice.boxes[p], ray)[0] >= um2::infiniteDistance<double>()) {
+        continue;
+      }
+      A * const pin_lengths = lengths.data() + p * num_faces;
+      if constexpr (std::same_as<A, double>) {
+        if (path == Path::Double) {
+          um2::addTrackLengths(lattice.mesh, lattice.origins[p], ray, pin_lengths);
+        } else {
+          um2::addTrackLengths(lattice.mesh_f, lattice.origins[p], ray, pin_lengths);
+        }
+      } else {
+        um2::addTrackLengths(lattice.global_meshes_f[p], ray_f, pin_lengths);
+      }
+    }
+  }
+}
+
+// Arg: 0 for Path::Double, 1 for Path::Mixed, 2 for Path::GlobalFloat. The counters
+// are the largest and the mean error of the total track length of a face,
+// relative to Path::Double, and the error of the sum over all faces.
+static void
+traceLattice(benchmark::State & state)
+{
+  static Lattice const lattice = makeLattice("./mesh_files/tri_pin_1656.inp");
+  auto const path = static_cast<Path>(state.range(0));
+  um2::Vector<double> expected;
+  trace(lattice, Path::Double, expected);
+  um2::Vector<double> lengths;
+  um2::Vector<float> lengths_f;
+  // NOLINTNEXTLINE justification: Need to loop over the state variable
+  for (auto s : state) {
+    if (path == Path::GlobalFloat) {
+      trace(lattice, path, lengths_f);
+    } else {
+      trace(lattice, path, lengths);
+    }
+  }
+  if (path == Path::GlobalFloat) {
+    lengths.resize(lengths_f.size());
+    std::copy(lengths_f.begin(), lengths_f.end(), lengths.begin());
+  }
+  double max_error = 0;
+  double sum_error = 0;
+  double total = 0;
+  double total_expected = 0;
+  for (Size i = 0; i < expected.size(); ++i) {
+    double const error = um2::abs(lengths[i] - expected[i]) / expected[i];
+    max_error = um2::max(max_error, error);
+    sum_error += error;
+    total += lengths[i];
+    total_expected += expected[i];
+  }
+  state.counters["max_err"] = max_error;
+  state.counters["mean_err"] = sum_error / static_cast<double>(expected.size());
+  state.counters["total_err"] = um2::abs(total - total_expected) / total_expected;
+  state.counters["rays"] = static_cast<double>(lattice.rays.size());
+}
+
+BENCHMARK(traceLattice)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -20,7 +20,8 @@ namespace um2
 //  - colorize messages based on their verbosity level
 //  - exit the program after an error is logged (or not)
 //
-// The logger is not thread-safe.
+// Messages may be logged from several threads at once, e.g. from an OpenMP
+// parallel region. The options should only be set from one thread.
 // Verbosity levels may be seen below in the LogVerbosity enum.
 
 enum class LogVerbosity {
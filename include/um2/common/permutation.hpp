@@ -2,9 +2,14 @@
 
 #include <um2/config.hpp>
 
+#include <um2/stdlib/Vector.hpp>
 #include <um2/stdlib/algorithm.hpp>
 #include <um2/stdlib/numeric.hpp>
 
+#include <cassert>
+#include <concepts>
+#include <utility>
+
 namespace um2
 {
 
@@ -23,37 +28,106 @@ sortPermutation(T const * const begin, T const * const end,
             [&begin](Size const i, Size const j) { return begin[i] < begin[j]; });
 }
 
-// template <typename T>
-// constexpr void
-// applyPermutation(Vector<T> & v, Vector<Size> const & perm) noexcept
-//{
-//   // Verify that perm is a permutation
-//   // (contains all elements of [0, v.size()) exactly once)
-// #ifndef NDEBUG
-//   Vector<int8_t> seen(v.size(), 0);
-//   for (Size const i : perm) {
-//     assert(i < v.size());
-//     assert(seen[i] == 0);
-//     seen[i] = 1;
-//   }
-//   assert(std::count(seen.cbegin(), seen.cend(), 1) == v.size());
-// #endif
-//   // Apply the permutation in-place by iterating over cycles.
-//   Vector<int8_t> done(v.size());
-//   for (Size i = 0; i < v.size(); ++i) {
-//     if (done[i] == 1) {
-//       continue;
-//     }
-//     done[i] = true;
-//     Size prev_j = i;
-//     Size j = perm[i];
-//     while (i != j) {
-//       std::swap(v[prev_j], v[j]);
-//       done[j] = true;
-//       prev_j = j;
-//       j = perm[j];
-//     }
-//   }
-// }
+//==============================================================================
+// Radix sort
+//==============================================================================
+// Stable LSD radix sort of unsigned integer keys, one byte per pass.
+// The keys are sorted in place and the permutation which sorts them is written
+// to perm_begin, so that the i-th key after the sort was the perm[i]-th key
+// before it. Each key is read once per pass instead of once per comparison,
+// which pays off when the keys are expensive to compute (e.g. Morton codes).
+// Passes in which every key has the same byte are skipped.
+
+template <std::unsigned_integral U>
+void
+radixSortPermutation(U * const begin, U * const end, Size * const perm_begin) noexcept
+{
+  auto const n = static_cast<Size>(end - begin);
+  std::iota(perm_begin, perm_begin + n, 0);
+  if (n < 2) {
+    return;
+  }
+  Size constexpr radix = 256;
+  Size constexpr num_passes = sizeof(U);
+
+  // Count the digits of every pass in a single sweep over the keys.
+  Vector<Size> counts(num_passes * radix, 0);
+  for (Size i = 0; i < n; ++i) {
+    U const key = begin[i];
+    for (Size pass = 0; pass < num_passes; ++pass) {
+      ++counts[pass * radix + static_cast<Size>((key >> (8 * pass)) & 0xFF)];
+    }
+  }
+
+  Vector<U> keys_tmp(n);
+  Vector<Size> perm_tmp(n);
+  U * keys_in = begin;
+  U * keys_out = keys_tmp.data();
+  Size * perm_in = perm_begin;
+  Size * perm_out = perm_tmp.data();
+  for (Size pass = 0; pass < num_passes; ++pass) {
+    Size * const offsets = counts.data() + pass * radix;
+    Size const shift = 8 * pass;
+    if (offsets[static_cast<Size>((keys_in[0] >> shift) & 0xFF)] == n) {
+      continue;
+    }
+    Size total = 0;
+    for (Size d = 0; d < radix; ++d) {
+      Size const count = offsets[d];
+      offsets[d] = total;
+      total += count;
+    }
+    for (Size i = 0; i < n; ++i) {
+      auto const d = static_cast<Size>((keys_in[i] >> shift) & 0xFF);
+      Size const j = offsets[d]++;
+      keys_out[j] = keys_in[i];
+      perm_out[j] = perm_in[i];
+    }
+    std::swap(keys_in, keys_out);
+    std::swap(perm_in, perm_out);
+  }
+  if (keys_in != begin) {
+    std::copy(keys_in, keys_in + n, begin);
+    std::copy(perm_in, perm_in + n, perm_begin);
+  }
+}
+
+//==============================================================================
+// Applying a permutation
+//==============================================================================
+// Reorder v so that v[i] becomes the perm[i]-th element of v, as in
+// sortPermutation. The permutation is applied in place by following its cycles.
+
+template <typename T>
+void
+applyPermutation(Vector<T> & v, Vector<Size> const & perm) noexcept
+{
+  assert(perm.size() == v.size());
+  // Verify that perm is a permutation
+  // (contains all elements of [0, v.size()) exactly once)
+#ifndef NDEBUG
+  Vector<int8_t> seen(v.size(), 0);
+  for (Size const i : perm) {
+    assert(0 <= i && i < v.size());
+    assert(seen[i] == 0);
+    seen[i] = 1;
+  }
+#endif
+  Vector<int8_t> done(v.size(), 0);
+  for (Size i = 0; i < v.size(); ++i) {
+    if (done[i] == 1) {
+      continue;
+    }
+    done[i] = 1;
+    Size prev_j = i;
+    Size j = perm[i];
+    while (i != j) {
+      std::swap(v[prev_j], v[j]);
+      done[j] = 1;
+      prev_j = j;
+      j = perm[j];
+    }
+  }
+}
 
 } // namespace um2
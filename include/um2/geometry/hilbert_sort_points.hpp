@@ -0,0 +1,85 @@
+#pragma once
+
+#include <um2/common/permutation.hpp>
+#include <um2/geometry/Point.hpp>
+#include <um2/math/hilbert.hpp>
+#include <um2/stdlib/Vector.hpp>
+
+#include <algorithm> // std::copy, std::transform
+
+namespace um2
+{
+
+//==============================================================================
+// Hilbert encoding/decoding with normalization
+//==============================================================================
+
+template <std::unsigned_integral U, Size D, std::floating_point T>
+PURE HOSTDEV auto
+hilbertEncode(Point<D, T> const & p) -> U
+{
+  if constexpr (D == 2) {
+    return hilbertEncode<U>(p[0], p[1]);
+  } else if constexpr (D == 3) {
+    return hilbertEncode<U>(p[0], p[1], p[2]);
+  } else {
+    static_assert(D == 2 || D == 3);
+    return 0;
+  }
+}
+
+template <std::unsigned_integral U, Size D, std::floating_point T>
+HOSTDEV void
+hilbertDecode(U const hilbert, Point<D, T> & p)
+{
+  if constexpr (D == 2) {
+    hilbertDecode(hilbert, p[0], p[1]);
+  } else if constexpr (D == 3) {
+    hilbertDecode(hilbert, p[0], p[1], p[2]);
+  } else {
+    static_assert(D == 2 || D == 3);
+  }
+}
+
+template <std::unsigned_integral U, Size D, std::floating_point T>
+PURE HOSTDEV auto
+hilbertLess(Point<D, T> const & lhs, Point<D, T> const & rhs) -> bool
+{
+  return hilbertEncode<U>(lhs) < hilbertEncode<U>(rhs);
+}
+
+//==============================================================================
+// Hilbert sort
+//==============================================================================
+// As mortonSort, the points are encoded once and the keys are radix sorted.
+// The points must be in the unit square or cube. The sort is stable.
+
+// Write the permutation which sorts the points in Hilbert order to perm_begin,
+// so that the i-th point in Hilbert order is begin[perm[i]].
+template <std::unsigned_integral U, Size D, std::floating_point T>
+void
+hilbertSortPermutation(Point<D, T> const * const begin, Point<D, T> const * const end,
+                       Size * const perm_begin)
+{
+  auto const n = static_cast<Size>(end - begin);
+  Vector<U> keys(n);
+  std::transform(begin, end, keys.begin(),
+                 [](Point<D, T> const & p) { return hilbertEncode<U>(p); });
+  radixSortPermutation(keys.begin(), keys.end(), perm_begin);
+}
+
+template <std::unsigned_integral U, Size D, std::floating_point T>
+void
+hilbertSort(Point<D, T> * const begin, Point<D, T> * const end)
+{
+  auto const n = static_cast<Size>(end - begin);
+  Vector<Size> perm(n);
+  hilbertSortPermutation<U>(begin, end, perm.begin());
+  Vector<Point<D, T>> sorted(n);
+  for (Size i = 0; i < n; ++i) {
+    sorted[i] = begin[perm[i]];
+  }
+  std::copy(sorted.cbegin(), sorted.cend(), begin);
+}
+
+} // namespace um2
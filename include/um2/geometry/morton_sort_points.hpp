@@ -1,9 +1,11 @@
 #pragma once
 
+#include <um2/common/permutation.hpp>
 #include <um2/geometry/Point.hpp>
 #include <um2/math/morton.hpp>
+#include <um2/stdlib/Vector.hpp>
 
-#include <algorithm> // std::sort
+#include <algorithm> // std::copy, std::transform
 
 namespace um2
 {
@@ -55,11 +57,40 @@ struct MortonLessFunctor {
   }
 };
 
+//==============================================================================
+// Morton sort
+//==============================================================================
+// Each point is encoded once, then the (key, index) pairs are radix sorted.
+// Comparing points with mortonLess would encode both points on every
+// comparison. The sort is stable.
+
+// Write the permutation which sorts the points in Morton order to perm_begin,
+// so that the i-th point in Morton order is begin[perm[i]]. The points are not
+// moved, so the permutation may be used to reorder data associated with them.
+template <std::unsigned_integral U, Size D, std::floating_point T>
+void
+mortonSortPermutation(Point<D, T> const * const begin, Point<D, T> const * const end,
+                      Size * const perm_begin)
+{
+  auto const n = static_cast<Size>(end - begin);
+  Vector<U> keys(n);
+  std::transform(begin, end, keys.begin(),
+                 [](Point<D, T> const & p) { return mortonEncode<U>(p); });
+  radixSortPermutation(keys.begin(), keys.end(), perm_begin);
+}
+
 template <std::unsigned_integral U, Size D, std::floating_point T>
 void
 mortonSort(Point<D, T> * const begin, Point<D, T> * const end)
 {
-  std::sort(begin, end, mortonLess<U, D, T>);
+  auto const n = static_cast<Size>(end - begin);
+  Vector<Size> perm(n);
+  mortonSortPermutation<U>(begin, end, perm.begin());
+  Vector<Point<D, T>> sorted(n);
+  for (Size i = 0; i < n; ++i) {
+    sorted[i] = begin[perm[i]];
+  }
+  std::copy(sorted.cbegin(), sorted.cend(), begin);
 }
 
 } // namespace um2
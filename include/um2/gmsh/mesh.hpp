@@ -25,5 +25,40 @@ void
 generateMesh(MeshType mesh_type, int smooth_iters = 100);
 // generateMesh(MeshType mesh_type, int opt_iters = 5, int smooth_iters = 100);
 
+// Get the 2D elements of the current model as a MeshFile, without any file I/O.
+// Each 2D physical group becomes an elset of the same name, just as if the mesh
+// had been written to an Abaqus file and read back.
+void
+getMeshFile(MeshFile<Float, Int> & mesh_file);
+
+// Mesh the coarse cells of a model that was cut by
+// um2::gmsh::model::occ::overlaySpatialPartition and get the mesh as a MeshFile.
+// If cache_dir is not empty, each coarse cell mesh is stored in cache_dir, keyed
+// by a hash of the coarse cell's geometry, materials, mesh sizes, mesh_type and
+// smooth_iters. Coarse cells with a matching entry are loaded from the cache and
+// removed from the model, so only the coarse cells that changed are meshed.
+//
+// If num_workers > 1, the coarse cells are split among num_workers worker
+// processes, balanced by their estimated number of faces, and meshed in
+// parallel. The workers run the um2_mesh_worker executable, which is found at
+// UM2_MESH_WORKER_PATH or at the path in the UM2_MESH_WORKER environment
+// variable, on the model written to a temporary directory. In that case the
+// gmsh model itself is left unmeshed. If the worker executable is missing, or
+// the model has mesh size fields other than constant fields on surfaces, the
+// coarse cells are meshed in this process and a warning is logged. Either way,
+// coarse cells that are identical up to translation are only meshed once. The
+// coarse cells of a worker that fails are meshed in this process instead.
+// Returns false, with mesh_file empty, if a coarse cell could not be meshed.
+// Pass the result to SpatialPartition::importCoarseCells.
+auto
+generateCoarseCellMeshes(MeshType mesh_type, MeshFile<Float, Int> & mesh_file,
+                         std::string const & cache_dir = "", int smooth_iters = 100,
+                         int num_workers = 1) -> bool;
+
+// Mesh the coarse cells in the job file written by generateCoarseCellMeshes.
+// This is the body of the um2_mesh_worker executable. Returns the exit status.
+auto
+runCoarseCellMeshWorker(std::string const & job_path) -> int;
+
 } // namespace um2::gmsh::model::mesh
 #endif // UM2_USE_GMSH
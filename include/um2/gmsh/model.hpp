@@ -72,10 +72,28 @@ addCylindricalPinLattice(std::vector<std::vector<double>> const & radii,
                          std::vector<std::vector<int>> const & pin_ids,
                          Point3d const & offset = {0.0, 0.0, 0.0}) -> std::vector<int>;
 
+// For each coarse cell in the partition, get the ID of the first coarse cell whose
+// geometry in the model is identical up to translation. A coarse cell that is
+// unique is its own representative. Must be called before overlaySpatialPartition.
+auto
+getUniqueCoarseCells(mpact::SpatialPartition const & partition) -> std::vector<Size>;
+
+// Cut the model with the coarse cells of the partition, keeping only the
+// entities inside the coarse cells. If cc_representatives is given (see
+// getUniqueCoarseCells), only the representative coarse cells are cut and
+// meshed. Use SpatialPartition::importCoarseCells with the same representatives
+// to share their meshes with the remaining coarse cells.
+//
+// If tile_cells > 0, the model is fragmented one tile of tile_cells x tile_cells
+// coarse cells at a time (e.g. 17 for 17x17 assemblies), each with only the
+// entities that overlap the tile. This keeps each OCC boolean operation small,
+// so full core models take roughly linear time.
 void
 overlaySpatialPartition(mpact::SpatialPartition const & partition,
                         std::string const & fill_material_name = "Moderator",
-                        Color fill_material_color = Color("royalblue"));
+                        Color fill_material_color = Color("royalblue"),
+                        std::vector<Size> const & cc_representatives = {},
+                        Size tile_cells = 0);
 } // namespace occ
 } // namespace um2::gmsh::model
 #endif // UM2_USE_GMSH
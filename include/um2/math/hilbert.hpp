@@ -0,0 +1,207 @@
+#pragma once
+
+#include <um2/math/morton.hpp>
+
+namespace um2
+{
+
+//==============================================================================
+// HILBERT CURVE
+//==============================================================================
+// Points which are close along a Morton (Z-order) curve are close in space, but
+// the curve jumps across the domain between quadrants. The Hilbert curve visits
+// the same cells, but consecutive cells always share a side, so it preserves
+// locality better when reordering faces and vertices.
+//
+// We use Skilling's algorithm ("Programming the Hilbert curve", AIP Conf. Proc.
+// 707, 2004). The coordinates are transformed in place into the "transpose" of
+// the Hilbert index, whose bits are then interleaved like a Morton code, with
+// the first coordinate in the most significant bit of each group.
+//
+// The coordinates use the same number of bits as a Morton code of the same
+// type, so the max coordinate values are the same.
+
+template <std::unsigned_integral U>
+constexpr U max_2d_hilbert_coord = max_2d_morton_coord<U>;
+
+template <std::unsigned_integral U>
+constexpr U max_3d_hilbert_coord = max_3d_morton_coord<U>;
+
+//==============================================================================
+// Hilbert index transpose
+//==============================================================================
+
+// Bits per coordinate of a D-dimensional Hilbert index of type U.
+template <std::unsigned_integral U, Size D>
+constexpr Size hilbert_bits = static_cast<Size>(8 * sizeof(U)) / D;
+
+// Coordinates -> transpose of the Hilbert index
+template <std::unsigned_integral U, Size D>
+HOSTDEV constexpr void
+hilbertAxesToTranspose(U * const x)
+{
+  U constexpr m = static_cast<U>(1) << (hilbert_bits<U, D> - 1);
+  // Inverse undo
+  for (U q = m; q > 1; q >>= 1) {
+    U const p = q - 1;
+    for (Size i = 0; i < D; ++i) {
+      if ((x[i] & q) != 0) {
+        x[0] ^= p; // Invert
+      } else {
+        U const t = (x[0] ^ x[i]) & p; // Exchange
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  // Gray encode
+  for (Size i = 1; i < D; ++i) {
+    x[i] ^= x[i - 1];
+  }
+  U t = 0;
+  for (U q = m; q > 1; q >>= 1) {
+    if ((x[D - 1] & q) != 0) {
+      t ^= q - 1;
+    }
+  }
+  for (Size i = 0; i < D; ++i) {
+    x[i] ^= t;
+  }
+}
+
+// Transpose of the Hilbert index -> coordinates
+template <std::unsigned_integral U, Size D>
+HOSTDEV constexpr void
+hilbertTransposeToAxes(U * const x)
+{
+  U constexpr n = static_cast<U>(1) << hilbert_bits<U, D>;
+  // Gray decode
+  U t = x[D - 1] >> 1;
+  for (Size i = D - 1; i > 0; --i) {
+    x[i] ^= x[i - 1];
+  }
+  x[0] ^= t;
+  // Undo excess work
+  for (U q = 2; q != n; q <<= 1) {
+    U const p = q - 1;
+    for (Size i = D - 1; i >= 0; --i) {
+      if ((x[i] & q) != 0) {
+        x[0] ^= p; // Invert
+      } else {
+        t = (x[0] ^ x[i]) & p; // Exchange
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+}
+
+//==============================================================================
+// Hilbert encoding/decoding
+//==============================================================================
+
+template <std::unsigned_integral U>
+CONST HOSTDEV auto
+hilbertEncode(U const x, U const y) -> U
+{
+  assert(x <= max_2d_hilbert_coord<U> && y <= max_2d_hilbert_coord<U>);
+  U xy[2] = {x, y};
+  hilbertAxesToTranspose<U, 2>(xy);
+  return mortonEncode(xy[1], xy[0]);
+}
+
+template <std::unsigned_integral U>
+CONST HOSTDEV auto
+hilbertEncode(U const x, U const y, U const z) -> U
+{
+  assert(x <= max_3d_hilbert_coord<U> && y <= max_3d_hilbert_coord<U> &&
+         z <= max_3d_hilbert_coord<U>);
+  U xyz[3] = {x, y, z};
+  hilbertAxesToTranspose<U, 3>(xyz);
+  return mortonEncode(xyz[2], xyz[1], xyz[0]);
+}
+
+template <std::unsigned_integral U>
+HOSTDEV void
+hilbertDecode(U const hilbert, U & x, U & y)
+{
+  U xy[2];
+  mortonDecode(hilbert, xy[1], xy[0]);
+  hilbertTransposeToAxes<U, 2>(xy);
+  x = xy[0];
+  y = xy[1];
+}
+
+template <std::unsigned_integral U>
+HOSTDEV void
+hilbertDecode(U const hilbert, U & x, U & y, U & z)
+{
+  U xyz[3];
+  mortonDecode(hilbert, xyz[2], xyz[1], xyz[0]);
+  hilbertTransposeToAxes<U, 3>(xyz);
+  x = xyz[0];
+  y = xyz[1];
+  z = xyz[2];
+}
+
+//==============================================================================
+// Hilbert encoding/decoding with normalization
+//==============================================================================
+
+template <std::unsigned_integral U, std::floating_point T>
+CONST HOSTDEV auto
+hilbertEncode(T const x, T const y) -> U
+{
+  assert(0 <= x && x <= 1);
+  assert(0 <= y && y <= 1);
+  if constexpr (std::same_as<float, T> && std::same_as<uint64_t, U>) {
+    static_assert(always_false<T>, "uint64_t -> float conversion can be lossy");
+  }
+  // Convert x,y in [0,1] to integers in [0 max_2d_hilbert_coord]
+  U const x_m = static_cast<U>(x * max_2d_hilbert_coord<U>);
+  U const y_m = static_cast<U>(y * max_2d_hilbert_coord<U>);
+  return hilbertEncode(x_m, y_m);
+}
+
+template <std::unsigned_integral U, std::floating_point T>
+HOSTDEV void
+hilbertDecode(U const hilbert, T & x, T & y)
+{
+  U x_m;
+  U y_m;
+  hilbertDecode(hilbert, x_m, y_m);
+  x = static_cast<T>(x_m) / static_cast<T>(max_2d_hilbert_coord<U>);
+  y = static_cast<T>(y_m) / static_cast<T>(max_2d_hilbert_coord<U>);
+}
+
+template <std::unsigned_integral U, std::floating_point T>
+CONST HOSTDEV auto
+hilbertEncode(T const x, T const y, T const z) -> U
+{
+  assert(0 <= x && x <= 1);
+  assert(0 <= y && y <= 1);
+  assert(0 <= z && z <= 1);
+  if constexpr (std::same_as<float, T> && std::same_as<uint64_t, U>) {
+    static_assert(always_false<T>, "uint64_t -> float conversion can be lossy");
+  }
+  // Convert x,y,z in [0,1] to integers in [0 max_3d_hilbert_coord]
+  U const x_m = static_cast<U>(x * max_3d_hilbert_coord<U>);
+  U const y_m = static_cast<U>(y * max_3d_hilbert_coord<U>);
+  U const z_m = static_cast<U>(z * max_3d_hilbert_coord<U>);
+  return hilbertEncode(x_m, y_m, z_m);
+}
+
+template <std::unsigned_integral U, std::floating_point T>
+HOSTDEV void
+hilbertDecode(U const hilbert, T & x, T & y, T & z)
+{
+  U x_m;
+  U y_m;
+  U z_m;
+  hilbertDecode(hilbert, x_m, y_m, z_m);
+  x = static_cast<T>(x_m) / static_cast<T>(max_3d_hilbert_coord<U>);
+  y = static_cast<T>(y_m) / static_cast<T>(max_3d_hilbert_coord<U>);
+  z = static_cast<T>(z_m) / static_cast<T>(max_3d_hilbert_coord<U>);
+}
+
+} // namespace um2
@@ -50,15 +50,15 @@ struct BinnedFaceVertexMesh {
   explicit BinnedFaceVertexMesh(FaceVertexMesh<P, N, D, T, I> const & mesh_in) noexcept
       : mesh(mesh_in)
   {
-    // Get the bounding box of the mesh.
-    auto const box = boundingBox(mesh);
+    // Get the bounding box of the mesh and of each face.
+    auto const & geometry = mesh.faceGeometry();
+    auto const box = geometry.box;
 
     // Determine the maximum edge length in the mesh.
     Size const nfaces = numFaces(mesh);
     T max_side_length = 0;
     for (Size i = 0; i < nfaces; ++i) {
-      auto const face = mesh.getFace(i);
-      auto const face_bb = face.boundingBox();
+      auto const & face_bb = geometry.boxes[i];
       auto const delta = face_bb.maxima - face_bb.minima;
       for (Size j = 0; j < D; ++j) {
         max_side_length = um2::max(max_side_length, delta[j]);
@@ -93,7 +93,7 @@ struct BinnedFaceVertexMesh {
     partition.children.resize(total_bins + 1);
     partition.children[0] = 0; // Just to be safe.
     for (Size i = 0; i < nfaces; ++i) {
-      auto const upper_right_point = mesh.getFace(i).boundingBox().maxima;
+      auto const & upper_right_point = geometry.boxes[i].maxima;
       auto const index = partition.getCellIndexContaining(upper_right_point);
       Size const flat_index = partition.getFlatIndex(index);
       ++partition.children[flat_index + 1];
@@ -107,7 +107,7 @@ struct BinnedFaceVertexMesh {
     face_ids = um2::move(Vector<I>(nfaces, -1));
     // Assign the face ids to the bins.
     for (Size i = 0; i < nfaces; ++i) {
-      auto const upper_right_point = mesh.getFace(i).boundingBox().maxima;
+      auto const & upper_right_point = geometry.boxes[i].maxima;
       auto const index = partition.getCellIndexContaining(upper_right_point);
       Size const offset_index = partition.getFlatIndex(index);
       auto offset = static_cast<Size>(partition.children[offset_index]);
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <um2/mesh/FaceVertexMesh.hpp>
+#include <um2/mesh/validation.hpp>
+
+#include <limits>
+
+namespace um2
+{
+
+//=============================================================================
+// COMPACT FACE-VERTEX MESH
+//=============================================================================
+//
+// A read-only copy of a small planar FaceVertexMesh, such as the mesh of a
+// coarse cell, for ray tracing and point location.
+//
+// Vertex indices are 16-bit, so the mesh may have at most 65536 vertices.
+// Vertex coordinates are fixed-point numbers of unsigned integer type Q, over
+// the bounding box of the vertices. Coordinate d of vertex i is
+//    box.minima[d] + vertices[i][d] * spacing[d]
+// where spacing[d] is the extent of the box in direction d divided by the
+// largest value of Q. Each vertex is at most spacing / 2 away from its original
+// position in each direction.
+//
+// With Q = uint16_t, a vertex takes 4 bytes rather than 8 (float) or 16
+// (double), and a triangle 6 bytes rather than 12 (int32_t) or 24 (int64_t).
+// The vertices are quantized once, so faces which share a vertex still share it
+// exactly and no gaps open between faces. Faces thinner than the spacing may
+// however become degenerate or flip. validateCompactMesh compares the compact
+// mesh with the full-precision mesh, and is called by the constructor in debug
+// builds.
+//
+// getFace returns the same Polygon as FaceVertexMesh::getFace, in T, so
+// faceContaining and intersect give the same results as for the full-precision
+// mesh, up to the quantization of the vertices.
+//
+template <Size P, Size N, std::floating_point T, std::unsigned_integral Q = uint16_t>
+struct CompactPolygonMesh {
+
+  using FaceConn = Vec<N, uint16_t>;
+  using Face = Polygon<P, N, 2, T>;
+
+  AxisAlignedBox2<T> box; // bounding box of the vertices
+  Vec2<T> spacing;        // size of a unit of Q in each direction
+  Vector<Vec2<Q>> vertices;
+  Vector<FaceConn> fv;
+
+  //===========================================================================
+  // Constructors
+  //===========================================================================
+
+  constexpr CompactPolygonMesh() noexcept = default;
+
+  template <std::signed_integral I>
+  explicit CompactPolygonMesh(PlanarPolygonMesh<P, N, T, I> const & mesh);
+
+  //==============================================================================
+  // Accessors
+  //==============================================================================
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  numVertices() const noexcept -> Size;
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  numFaces() const noexcept -> Size;
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  getVertex(Size i) const noexcept -> Point2<T>;
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  getFace(Size i) const noexcept -> Face;
+
+  //===========================================================================
+  // Methods
+  //===========================================================================
+
+  PURE [[nodiscard]] constexpr auto
+  faceContaining(Point2<T> const & p) const noexcept -> Size;
+
+  void
+  intersect(Ray2<T> const & ray, T * intersections, Size * n) const noexcept;
+};
+
+//==============================================================================
+// Aliases
+//==============================================================================
+
+template <std::floating_point T, std::unsigned_integral Q = uint16_t>
+using CompactTriMesh = CompactPolygonMesh<1, 3, T, Q>;
+template <std::floating_point T, std::unsigned_integral Q = uint16_t>
+using CompactQuadMesh = CompactPolygonMesh<1, 4, T, Q>;
+template <std::floating_point T, std::unsigned_integral Q = uint16_t>
+using CompactQuadraticTriMesh = CompactPolygonMesh<2, 6, T, Q>;
+template <std::floating_point T, std::unsigned_integral Q = uint16_t>
+using CompactQuadraticQuadMesh = CompactPolygonMesh<2, 8, T, Q>;
+
+//==============================================================================
+// validateCompactMesh
+//==============================================================================
+// Compare a compact mesh with the full-precision mesh it was made from. Faces
+// whose area is no longer positive once the vertices are quantized (flipped or
+// degenerate faces) are logged as a warning.
+
+template <std::floating_point T>
+struct CompactMeshValidation {
+  // The largest distance between a vertex and its quantized position
+  T max_vertex_error = 0;
+  // The largest change in the area of a face, relative to its area
+  T max_relative_area_error = 0;
+  // Faces with a positive area in the full-precision mesh, but not in the
+  // compact mesh
+  MeshIssue flipped_faces;
+};
+
+template <Size P, Size N, std::floating_point T, std::unsigned_integral Q,
+          std::signed_integral I>
+auto
+validateCompactMesh(CompactPolygonMesh<P, N, T, Q> const & compact,
+                    PlanarPolygonMesh<P, N, T, I> const & mesh)
+    -> CompactMeshValidation<T>;
+
+} // namespace um2
+
+#include "CompactFaceVertexMesh.inl"
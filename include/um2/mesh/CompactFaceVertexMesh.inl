@@ -0,0 +1,207 @@
+namespace um2
+{
+
+//==============================================================================
+// Constructors
+//==============================================================================
+
+template <Size P, Size N, std::floating_point T, std::unsigned_integral Q>
+template <std::signed_integral I>
+CompactPolygonMesh<P, N, T, Q>::CompactPolygonMesh(
+    PlanarPolygonMesh<P, N, T, I> const & mesh)
+{
+  static_assert(sizeof(Q) <= 4, "Coordinates must fit in 32 bits");
+  Size const num_vertices = mesh.numVertices();
+  Size constexpr max_vertices =
+      static_cast<Size>(std::numeric_limits<uint16_t>::max()) + 1;
+  if (num_vertices > max_vertices) {
+    Log::error("A compact mesh may have at most " + std::to_string(max_vertices) +
+               " vertices, not " + std::to_string(num_vertices));
+    return;
+  }
+  if (num_vertices == 0) {
+    return;
+  }
+
+  // -- Vertices --
+  // Quantize in double, since float cannot hold the largest 32-bit values
+  box = boundingBox(mesh.vertices);
+  double constexpr q_max = static_cast<double>(std::numeric_limits<Q>::max());
+  Vec2<double> scale;
+  for (Size d = 0; d < 2; ++d) {
+    T const extent = box.maxima[d] - box.minima[d];
+    spacing[d] = extent / static_cast<T>(q_max);
+    scale[d] = extent > 0 ? q_max / static_cast<double>(extent) : 0;
+  }
+  vertices.resize(num_vertices);
+  for (Size i = 0; i < num_vertices; ++i) {
+    for (Size d = 0; d < 2; ++d) {
+      double const x =
+          static_cast<double>(mesh.vertices[i][d] - box.minima[d]) * scale[d];
+      vertices[i][d] = static_cast<Q>(um2::clamp(um2::floor(x + 0.5), 0.0, q_max));
+    }
+  }
+
+  // -- Faces --
+  Size const num_faces = mesh.numFaces();
+  fv.resize(num_faces);
+  for (Size i = 0; i < num_faces; ++i) {
+    for (Size j = 0; j < N; ++j) {
+      fv[i][j] = static_cast<uint16_t>(mesh.fv[i][j]);
+    }
+  }
+#ifndef NDEBUG
+  validateCompactMesh(*this, mesh);
+#endif
+}
+
+//==============================================================================
+// numVertices
+//==============================================================================
+
+template <Size P, Size N, std::floating_point T, std::unsigned_integral Q>
+PURE HOSTDEV constexpr auto
+CompactPolygonMesh<P, N, T, Q>::numVertices() const noexcept -> Size
+{
+  return vertices.size();
+}
+
+//==============================================================================
+// numFaces
+//==============================================================================
+
+template <Size P, Size N, std::floating_point T, std::unsigned_integral Q>
+PURE HOSTDEV constexpr auto
+CompactPolygonMesh<P, N, T, Q>::numFaces() const noexcept -> Size
+{
+  return fv.size();
+}
+
+//==============================================================================
+// getVertex
+//==============================================================================
+
+template <Size P, Size N, std::floating_point T, std::unsigned_integral Q>
+PURE HOSTDEV constexpr auto
+CompactPolygonMesh<P, N, T, Q>::getVertex(Size const i) const noexcept -> Point2<T>
+{
+  return {box.minima[0] + static_cast<T>(vertices[i][0]) * spacing[0],
+          box.minima[1] + static_cast<T>(vertices[i][1]) * spacing[1]};
+}
+
+//==============================================================================
+// getFace
+//==============================================================================
+
+template <Size P, Size N, std::floating_point T, std::unsigned_integral Q>
+PURE HOSTDEV constexpr auto
+CompactPolygonMesh<P, N, T, Q>::getFace(Size const i) const noexcept -> Face
+{
+  Face face;
+  for (Size j = 0; j < N; ++j) {
+    face[j] = getVertex(static_cast<Size>(fv[i][j]));
+  }
+  return face;
+}
+
+//==============================================================================
+// faceContaining
+//==============================================================================
+
+template <Size P, Size N, std::floating_point T, std::unsigned_integral Q>
+PURE constexpr auto
+CompactPolygonMesh<P, N, T, Q>::faceContaining(Point2<T> const & p) const noexcept
+    -> Size
+{
+  for (Size i = 0; i < numFaces(); ++i) {
+    if (getFace(i).contains(p)) {
+      return i;
+    }
+  }
+  assert(false);
+  return -1;
+}
+
+//==============================================================================
+// intersect
+//==============================================================================
+// Same as intersect(PlanarPolygonMesh), for the compact mesh.
+
+template <Size P, Size N, std::floating_point T, std::unsigned_integral Q>
+void
+CompactPolygonMesh<P, N, T, Q>::intersect(Ray2<T> const & ray, T * const intersections,
+                                          Size * const n) const noexcept
+{
+  T constexpr r_miss = infiniteDistance<T>();
+  Size nintersect = 0;
+#ifndef NDEBUG
+  Size const n0 = *n;
+#endif
+  for (Size i = 0; i < numFaces(); ++i) {
+    // N intersections for N linear edges, or N / 2 quadratic edges
+    auto const r = getFace(i).intersect(ray);
+    for (Size j = 0; j < N; ++j) {
+      if (r[j] < r_miss) {
+        assert(nintersect < n0);
+        intersections[nintersect++] = r[j];
+      }
+    }
+  }
+  *n = nintersect;
+  std::sort(intersections, intersections + nintersect);
+}
+
+//==============================================================================
+// validateCompactMesh
+//==============================================================================
+
+// The signed area of a planar polygon, by the shoelace formula over its corners
+// plus the area between each quadratic edge and its chord. Unlike area(), this
+// does not assume that quadrilaterals are convex, which a quantized face may
+// not be.
+template <Size P, Size N, std::floating_point T>
+PURE constexpr auto
+signedArea(Polygon<P, N, 2, T> const & face) noexcept -> T
+{
+  Size constexpr num_corners = P == 1 ? N : N / 2;
+  T result = 0;
+  for (Size k = 0; k < num_corners; ++k) {
+    result += face[k].cross(face[(k + 1) % num_corners]) / 2;
+  }
+  if constexpr (P == 2) {
+    for (Size k = 0; k < num_corners; ++k) {
+      result += enclosedArea(face.getEdge(k));
+    }
+  }
+  return result;
+}
+
+template <Size P, Size N, std::floating_point T, std::unsigned_integral Q,
+          std::signed_integral I>
+auto
+validateCompactMesh(CompactPolygonMesh<P, N, T, Q> const & compact,
+                    PlanarPolygonMesh<P, N, T, I> const & mesh)
+    -> CompactMeshValidation<T>
+{
+  assert(compact.numVertices() == mesh.numVertices());
+  assert(compact.numFaces() == mesh.numFaces());
+  CompactMeshValidation<T> result;
+  for (Size i = 0; i < mesh.numVertices(); ++i) {
+    T const error = compact.getVertex(i).distanceTo(mesh.vertices[i]);
+    result.max_vertex_error = um2::max(result.max_vertex_error, error);
+  }
+  for (Size i = 0; i < mesh.numFaces(); ++i) {
+    T const area = signedArea(mesh.getFace(i));
+    if (area > 0) {
+      T const error = um2::abs(signedArea(compact.getFace(i)) - area) / area;
+      result.max_relative_area_error = um2::max(result.max_relative_area_error, error);
+    }
+  }
+  result.flipped_faces = findMeshIssue(mesh.numFaces(), [&](Size const i) {
+    return signedArea(mesh.getFace(i)) > 0 && signedArea(compact.getFace(i)) <= 0;
+  });
+  result.flipped_faces.log("faces flipped or degenerate in the compact mesh");
+  return result;
+}
+
+} // namespace um2
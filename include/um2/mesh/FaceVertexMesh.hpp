@@ -3,6 +3,10 @@
 #include <um2/geometry/Polygon.hpp>
 #include <um2/geometry/morton_sort_points.hpp>
 #include <um2/mesh/MeshFile.hpp>
+#include <um2/mesh/face_geometry.hpp>
+#include <um2/mesh/reorder.hpp>
+#include <um2/mesh/validation.hpp>
+#include <um2/mesh/weld.hpp>
 #include <um2/stdlib/Vector.hpp>
 
 namespace um2
@@ -41,6 +45,9 @@ namespace um2
 //          of the vf vector. Used to calculate the number of faces to which each
 //          vertex belongs.
 //
+// face_geometry caches the area, centroid and bounding box of each face. See
+// face_geometry.hpp.
+//
 template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
 struct FaceVertexMesh {
 
@@ -51,6 +58,7 @@ struct FaceVertexMesh {
   Vector<FaceConn> fv;
   Vector<I> vf_offsets; // size = num_vertices + 1
   Vector<I> vf;         // size = vf_offsets[num_vertices]
+  mutable FaceGeometry<D, T> face_geometry;
 
   //===========================================================================
   // Constructors
@@ -73,11 +81,17 @@ struct FaceVertexMesh {
   PURE HOSTDEV [[nodiscard]] constexpr auto
   getFace(Size i) const noexcept -> Face;
 
+  // Call f with the Face of face i and return the result. This matches
+  // MixedFaceVertexMesh::visitFace, so that code can be generic over both.
+  template <class F>
+  HOSTDEV constexpr auto
+  visitFace(Size i, F && f) const noexcept;
+
   //===========================================================================
   // Methods
   //===========================================================================
 
-  PURE [[nodiscard]] constexpr auto
+  [[nodiscard]] constexpr auto
   boundingBox() const noexcept -> AxisAlignedBox<D, T>;
 
   PURE [[nodiscard]] constexpr auto
@@ -90,12 +104,34 @@ struct FaceVertexMesh {
   void
   toMeshFile(MeshFile<T, I> & file) const noexcept;
 
-  [[nodiscard]] constexpr auto
+  [[nodiscard]] auto
   getFaceAreas() const noexcept -> Vector<T>;
 
+  // The area, centroid and bounding box of each face, computed on the first call
+  // from any thread.
+  [[nodiscard]] auto
+  faceGeometry() const noexcept -> FaceGeometry<D, T> const &
+    requires(D == 2);
+
+  // Discard the cached face geometry. Call after changing vertices or fv.
+  void
+  clearFaceGeometry() noexcept;
+
   void
   intersect(Ray<D, T> const & ray, T * intersections, Size * n) const noexcept
     requires(D == 2);
+
+  // Renumber the vertices and faces in the given order. See MeshOrdering.
+  // Returns the face permutation: new face i is old face perm[i].
+  auto
+  reorder(MeshOrdering ordering) -> Vector<Size>;
+
+  // Merge the vertices closer than tolerance to each other, and renumber the
+  // vertices of the faces. Returns the number of vertices merged away. Faces are
+  // not removed, even if some of their vertices are merged together. See
+  // weld.hpp.
+  auto
+  weldVertices(T tolerance = epsilonDistance<T>()) -> Size;
 };
 
 //==============================================================================
@@ -156,7 +192,7 @@ getFace(FaceVertexMesh<P, N, D, T, I> const & mesh, Size i) noexcept
 //==============================================================================
 
 template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
-PURE constexpr auto
+constexpr auto
 boundingBox(FaceVertexMesh<P, N, D, T, I> const & mesh) noexcept -> AxisAlignedBox<D, T>;
 
 //==============================================================================
@@ -177,6 +213,30 @@ void
 intersect(PlanarPolygonMesh<P, N, T, I> const & mesh, Ray2<T> const & ray,
           T * intersections, Size * n) noexcept;
 
+//==============================================================================
+// buildVertexFaceConnectivity
+//==============================================================================
+
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+void
+buildVertexFaceConnectivity(FaceVertexMesh<P, N, D, T, I> & mesh) noexcept;
+
+//==============================================================================
+// reorder
+//==============================================================================
+
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+auto
+reorder(FaceVertexMesh<P, N, D, T, I> & mesh, MeshOrdering ordering) -> Vector<Size>;
+
+//==============================================================================
+// weldVertices
+//==============================================================================
+
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+auto
+weldVertices(FaceVertexMesh<P, N, D, T, I> & mesh, T tolerance) -> Size;
+
 } // namespace um2
 
 #include "FaceVertexMesh.inl"
@@ -105,15 +105,20 @@ boundingBox(LinearPolygonMesh<N, D, T, I> const & mesh) noexcept -> AxisAlignedB
 }
 
 template <Size N, Size D, std::floating_point T, std::signed_integral I>
-PURE constexpr auto
+constexpr auto
 boundingBox(QuadraticPolygonMesh<N, D, T, I> const & mesh) noexcept
     -> AxisAlignedBox<D, T>
 {
-  AxisAlignedBox<D, T> box = mesh.getFace(0).boundingBox();
-  for (Size i = 1; i < numFaces(mesh); ++i) {
-    box += mesh.getFace(i).boundingBox();
+  // The edges of a face may bulge past its vertices
+  if constexpr (D == 2) {
+    return mesh.faceGeometry().box;
+  } else {
+    AxisAlignedBox<D, T> box = mesh.getFace(0).boundingBox();
+    for (Size i = 1; i < numFaces(mesh); ++i) {
+      box += mesh.getFace(i).boundingBox();
+    }
+    return box;
   }
-  return box;
 }
 
 //==============================================================================
@@ -139,63 +144,39 @@ faceContaining(PlanarPolygonMesh<P, N, T, I> const & mesh, Point2<T> const & p)
 //==============================================================================
 
 template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
-void
-validateMesh(FaceVertexMesh<P, N, D, T, I> & mesh)
+auto
+validateMesh(FaceVertexMesh<P, N, D, T, I> & mesh) -> MeshValidation
 {
+  MeshValidation result;
 #ifndef NDEBUG
   // Check for repeated vertices.
   // This is not technically an error, but it is a sign that the mesh may
   // cause problems for some algorithms. Hence, we warn the user.
-  auto const bbox = boundingBox(mesh);
-  Vec<D, T> normalization;
-  for (Size i = 0; i < D; ++i) {
-    normalization[i] = static_cast<T>(1) / (bbox.maxima[i] - bbox.minima[i]);
-  }
-  Vector<Point<D, T>> vertices_copy = mesh.vertices;
-  // Transform the points to be in the unit cube
-  for (auto & v : vertices_copy) {
-    v -= bbox.minima;
-    v *= normalization;
-  }
-  if constexpr (std::same_as<T, float>) {
-    mortonSort<uint32_t>(vertices_copy.begin(), vertices_copy.end());
-  } else {
-    mortonSort<uint64_t>(vertices_copy.begin(), vertices_copy.end());
-  }
-  // Revert the scaling
-  for (auto & v : vertices_copy) {
-    // cppcheck-suppress useStlAlgorithm; justification: This is less verbose
-    v /= normalization;
-  }
-  Size const num_vertices = mesh.numVertices();
-  for (Size i = 0; i < num_vertices - 1; ++i) {
-    if (isApprox(vertices_copy[i], vertices_copy[i + 1])) {
-      Log::warn("Vertex " + std::to_string(i) + " and " + std::to_string(i + 1) +
-                " are effectively equivalent");
-    }
-  }
+  result.duplicate_vertices = findDuplicateVertices(mesh.vertices);
+  result.duplicate_vertices.log("vertices are effectively equivalent to another vertex");
 #endif
 
   // Check that the vertices are in counter-clockwise order.
   // If the area of the face is negative, then the vertices are in clockwise
-  Size const num_faces = mesh.numFaces();
-  for (Size i = 0; i < num_faces; ++i) {
-    if (!mesh.getFace(i).isCCW()) {
-      Log::warn("Face " + std::to_string(i) +
-                " has vertices in clockwise order. Reordering");
-      mesh.flipFace(i);
+  // order, and the face is flipped. The faces are flipped in parallel, so the
+  // cache of face geometry is cleared first.
+  mesh.clearFaceGeometry();
+  result.clockwise_faces = findMeshIssue(mesh.numFaces(), [&mesh](Size const i) {
+    if (mesh.getFace(i).isCCW()) {
+      return false;
     }
-  }
+    mesh.flipFace(i);
+    return true;
+  });
+  result.clockwise_faces.log("faces have vertices in clockwise order and were flipped");
 
   // Convexity check
-  // if (file.type == MeshType::Quad) {
   if constexpr (N == 4) {
-    for (Size i = 0; i < num_faces; ++i) {
-      if (!isConvex(mesh.getFace(i))) {
-        Log::warn("Face " + std::to_string(i) + " is not convex");
-      }
-    }
+    result.nonconvex_faces = findMeshIssue(
+        mesh.numFaces(), [&mesh](Size const i) { return !isConvex(mesh.getFace(i)); });
+    result.nonconvex_faces.log("faces are not convex");
   }
+  return result;
 }
 
 //==============================================================================
@@ -235,6 +216,10 @@ getMeshType() -> MeshType
   return MeshType::None;
 }
 
+// Below this many face-vertex entries, the serial loops of toFaceVertexMesh and
+// buildVertexFaceConnectivity are faster than starting an OpenMP region.
+inline constexpr Size min_parallel_entries = 1 << 15;
+
 template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
 void
 toFaceVertexMesh(MeshFile<T, I> const & file,
@@ -244,13 +229,15 @@ toFaceVertexMesh(MeshFile<T, I> const & file,
   assert(!file.element_conn.empty());
   auto const num_vertices = static_cast<Size>(file.vertices.size());
   auto const num_faces = static_cast<Size>(file.numCells());
-  auto const conn_size = static_cast<Size>(file.element_conn.size());
   MeshType const meshtype = file.getMeshType();
   if (!validateMeshFileType<P, N>(meshtype)) {
     Log::error("Attempted to construct a FaceVertexMesh from a mesh file with an "
                "incompatible mesh type");
   }
-  assert(conn_size == num_faces * verticesPerCell(meshtype));
+  assert(static_cast<Size>(file.element_conn.size()) ==
+         num_faces * verticesPerCell(meshtype));
+
+  mesh.clearFaceGeometry();
 
   // -- Vertices --
   // Ensure each of the vertices has approximately the same z
@@ -263,6 +250,9 @@ toFaceVertexMesh(MeshFile<T, I> const & file,
     }
 #endif
     mesh.vertices.resize(num_vertices);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for if (num_faces * N >= min_parallel_entries)
+#endif
     for (Size i = 0; i < num_vertices; ++i) {
       mesh.vertices[i][0] = file.vertices[static_cast<size_t>(i)][0];
       mesh.vertices[i][1] = file.vertices[static_cast<size_t>(i)][1];
@@ -273,6 +263,9 @@ toFaceVertexMesh(MeshFile<T, I> const & file,
 
   // -- Face/Vertex connectivity --
   mesh.fv.resize(num_faces);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for if (num_faces * N >= min_parallel_entries)
+#endif
   for (Size i = 0; i < num_faces; ++i) {
     for (Size j = 0; j < N; ++j) {
       auto const idx = i * N + j;
@@ -281,27 +274,202 @@ toFaceVertexMesh(MeshFile<T, I> const & file,
   }
 
   // -- Vertex/Face connectivity --
+  buildVertexFaceConnectivity(mesh);
+  validateMesh(mesh);
+}
+
+//==============================================================================
+// buildVertexFaceConnectivity
+//==============================================================================
+
+// Set vf_offsets and vf from fv. The faces of each vertex are in increasing
+// order.
+//
+// The serial version counts the faces of each vertex, scans the counts and
+// scatters the faces. With OpenMP, each thread counts the faces of each vertex
+// in its own contiguous chunk of fv, into its own row of counts. The rows are
+// then scanned in vertex-major order, so that the faces of a vertex in the chunk
+// of thread t come after those in the chunks of threads 0, ..., t - 1, and each
+// thread scatters the faces of its chunk. Every entry of fv is read twice in
+// all, whatever the number of threads. The rows take nthreads * num_vertices
+// entries, so at most (entries of fv) / num_vertices threads are used, which
+// keeps the counts no larger than vf. Counting and scattering with an atomic
+// operation per entry instead is several times slower per entry on x86 and
+// needs a sort of the faces of each vertex afterwards.
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+void
+buildVertexFaceConnectivity(FaceVertexMesh<P, N, D, T, I> & mesh) noexcept
+{
+  Size const num_vertices = mesh.numVertices();
+  Size const num_faces = mesh.numFaces();
+  Size const num_entries = num_faces * N;
+  mesh.vf_offsets.resize(num_vertices + 1);
+  mesh.vf.resize(num_entries);
+
+#if UM2_USE_OPENMP
+  Size const omp_threads = omp_get_max_threads();
+  Size const max_threads =
+      num_vertices == 0 ? 1 : um2::min(omp_threads, num_entries / num_vertices);
+  if (max_threads > 1 && num_entries >= min_parallel_entries) {
+    // counts[t * num_vertices + v] is the number of faces of vertex v in the
+    // chunk of thread t, and then the position in vf of the next one.
+    Vector<I> counts(max_threads * num_vertices);
+    // The number of faces of the vertices of each thread
+    Vector<Size> totals(max_threads + 1, 0);
+#  pragma omp parallel num_threads(max_threads)
+    {
+      Size const nthreads = omp_get_num_threads();
+      Size const t = omp_get_thread_num();
+      auto const first_face =
+          static_cast<Size>(static_cast<int64_t>(t) * num_faces / nthreads);
+      auto const last_face =
+          static_cast<Size>(static_cast<int64_t>(t + 1) * num_faces / nthreads);
+      auto const first_vertex =
+          static_cast<Size>(static_cast<int64_t>(t) * num_vertices / nthreads);
+      auto const last_vertex =
+          static_cast<Size>(static_cast<int64_t>(t + 1) * num_vertices / nthreads);
+      I * const row = counts.data() + t * num_vertices;
+      for (Size i = first_face; i < last_face; ++i) {
+        for (Size j = 0; j < N; ++j) {
+          ++row[static_cast<Size>(mesh.fv[i][j])];
+        }
+      }
+#  pragma omp barrier
+      Size total = 0;
+      for (Size v = first_vertex; v < last_vertex; ++v) {
+        I count = 0;
+        for (Size u = 0; u < nthreads; ++u) {
+          count += counts[u * num_vertices + v];
+        }
+        total += static_cast<Size>(count);
+      }
+      totals[t + 1] = total;
+#  pragma omp barrier
+      Size offset = 0;
+      for (Size u = 0; u <= t; ++u) {
+        offset += totals[u];
+      }
+      for (Size v = first_vertex; v < last_vertex; ++v) {
+        mesh.vf_offsets[v] = static_cast<I>(offset);
+        for (Size u = 0; u < nthreads; ++u) {
+          I const count = counts[u * num_vertices + v];
+          counts[u * num_vertices + v] = static_cast<I>(offset);
+          offset += static_cast<Size>(count);
+        }
+      }
+#  pragma omp barrier
+      for (Size i = first_face; i < last_face; ++i) {
+        for (Size j = 0; j < N; ++j) {
+          I & pos = row[static_cast<Size>(mesh.fv[i][j])];
+          mesh.vf[static_cast<Size>(pos)] = static_cast<I>(i);
+          ++pos;
+        }
+      }
+    }
+    mesh.vf_offsets[num_vertices] = static_cast<I>(num_entries);
+    return;
+  }
+#endif
+
   Vector<I> vert_counts(num_vertices, 0);
-  for (size_t i = 0; i < static_cast<size_t>(conn_size); ++i) {
-    ++vert_counts[static_cast<Size>(file.element_conn[i])];
+  for (auto const & face : mesh.fv) {
+    for (Size j = 0; j < N; ++j) {
+      ++vert_counts[static_cast<Size>(face[j])];
+    }
   }
-  mesh.vf_offsets.resize(num_vertices + 1);
   mesh.vf_offsets[0] = 0;
   std::inclusive_scan(vert_counts.cbegin(), vert_counts.cend(),
                       mesh.vf_offsets.begin() + 1);
-  vert_counts.clear();
-  mesh.vf.resize(static_cast<Size>(mesh.vf_offsets[num_vertices]));
-  // Copy vf_offsets to vert_offsets
-  Vector<I> vert_offsets = mesh.vf_offsets;
+  // vert_counts is reused as the position in vf of the next face of each vertex
+  std::copy(mesh.vf_offsets.cbegin(), mesh.vf_offsets.cend() - 1, vert_counts.begin());
   for (Size i = 0; i < num_faces; ++i) {
     auto const & face = mesh.fv[i];
     for (Size j = 0; j < N; ++j) {
       auto const vert = static_cast<Size>(face[j]);
-      mesh.vf[static_cast<Size>(vert_offsets[vert])] = static_cast<I>(i);
-      ++vert_offsets[vert];
+      mesh.vf[static_cast<Size>(vert_counts[vert])] = static_cast<I>(i);
+      ++vert_counts[vert];
     }
   }
-  validateMesh(mesh);
+}
+
+//==============================================================================
+// reorder
+//==============================================================================
+
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+auto
+reorder(FaceVertexMesh<P, N, D, T, I> & mesh, MeshOrdering const ordering)
+    -> Vector<Size>
+{
+  Size const num_vertices = mesh.numVertices();
+  Size const num_faces = mesh.numFaces();
+  if (mesh.vf_offsets.size() != num_vertices + 1) {
+    buildVertexFaceConnectivity(mesh);
+  }
+  Vector<Size> vertex_perm;
+  Vector<Size> face_perm;
+  auto const forEachFaceVertex = [&mesh](Size const i, auto && f) {
+    for (auto const v : mesh.fv[i]) {
+      f(v);
+    }
+  };
+  meshOrder(mesh.vertices, num_faces, mesh.vf_offsets, mesh.vf, forEachFaceVertex,
+            ordering, vertex_perm, face_perm);
+  if (ordering == MeshOrdering::None) {
+    return face_perm;
+  }
+
+  // -- Vertices --
+  Vector<Point<D, T>> vertices(num_vertices);
+  Vector<I> new_index(num_vertices);
+  for (Size i = 0; i < num_vertices; ++i) {
+    vertices[i] = mesh.vertices[vertex_perm[i]];
+    new_index[vertex_perm[i]] = static_cast<I>(i);
+  }
+  mesh.vertices = um2::move(vertices);
+
+  // -- Faces --
+  Vector<Vec<N, I>> fv(num_faces);
+  for (Size i = 0; i < num_faces; ++i) {
+    auto const & face = mesh.fv[face_perm[i]];
+    for (Size j = 0; j < N; ++j) {
+      fv[i][j] = new_index[static_cast<Size>(face[j])];
+    }
+  }
+  mesh.fv = um2::move(fv);
+  mesh.clearFaceGeometry();
+  buildVertexFaceConnectivity(mesh);
+  return face_perm;
+}
+
+//==============================================================================
+// weldVertices
+//==============================================================================
+
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+auto
+weldVertices(FaceVertexMesh<P, N, D, T, I> & mesh, T const tolerance) -> Size
+{
+  Size const num_vertices = mesh.numVertices();
+  Size const num_faces = mesh.numFaces();
+  Vector<Size> new_index(num_vertices);
+  Size const num_merged = um2::weldVertices(mesh.vertices.begin(), mesh.vertices.end(),
+                                            tolerance, new_index.begin());
+  if (num_merged == 0) {
+    return 0;
+  }
+  mesh.vertices.resize(num_vertices - num_merged);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Size i = 0; i < num_faces; ++i) {
+    for (auto & v : mesh.fv[i]) {
+      v = static_cast<I>(new_index[static_cast<Size>(v)]);
+    }
+  }
+  mesh.clearFaceGeometry();
+  buildVertexFaceConnectivity(mesh);
+  return num_merged;
 }
 
 //==============================================================================
@@ -333,7 +501,7 @@ toMeshFile(FaceVertexMesh<P, N, D, T, I> const & mesh, MeshFile<T, I> & file) no
   auto const n = static_cast<size_t>(N);
   auto const len = nfaces * n;
   MeshType const mesh_type = getMeshType<P, N>();
-  file.element_types.resize(nfaces, mesh_type);
+  file.element_types.assign(nfaces, mesh_type);
   file.element_offsets.resize(nfaces + 1U);
   file.element_conn.resize(len);
   for (size_t i = 0; i < nfaces; ++i) {
@@ -481,12 +649,32 @@ FaceVertexMesh<P, N, D, T, I>::getFace(Size i) const noexcept -> Face
   return um2::getFace(*this, i);
 }
 
+//==============================================================================
+// visitFace
+//==============================================================================
+
+// Whether visitFace is pure depends on f
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wsuggest-attribute=pure"
+#endif
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+template <class F>
+HOSTDEV constexpr auto
+FaceVertexMesh<P, N, D, T, I>::visitFace(Size const i, F && f) const noexcept
+{
+  return f(um2::getFace(*this, i));
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+
 //==============================================================================
 // boundingBox
 //==============================================================================
 
 template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
-PURE [[nodiscard]] constexpr auto
+[[nodiscard]] constexpr auto
 FaceVertexMesh<P, N, D, T, I>::boundingBox() const noexcept -> AxisAlignedBox<D, T>
 {
   return um2::boundingBox(*this);
@@ -513,6 +701,7 @@ template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
 void
 FaceVertexMesh<P, N, D, T, I>::flipFace(Size i) noexcept
 {
+  clearFaceGeometry();
   if constexpr (P == 1 && N == 3) {
     um2::swap(fv[i][1], fv[i][2]);
   } else if constexpr (P == 1 && N == 4) {
@@ -542,14 +731,53 @@ FaceVertexMesh<P, N, D, T, I>::toMeshFile(MeshFile<T, I> & file) const noexcept
 //==============================================================================
 
 template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
-constexpr auto
+auto
 FaceVertexMesh<P, N, D, T, I>::getFaceAreas() const noexcept -> Vector<T>
 {
-  Vector<T> areas(numFaces());
-  for (Size i = 0; i < numFaces(); ++i) {
-    areas[i] = getFace(i).area();
+  if constexpr (D == 2) {
+    return faceGeometry().areas;
+  } else {
+    Vector<T> areas(numFaces());
+    for (Size i = 0; i < numFaces(); ++i) {
+      areas[i] = getFace(i).area();
+    }
+    return areas;
+  }
+}
+
+//==============================================================================
+// faceGeometry
+//==============================================================================
+
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+auto
+FaceVertexMesh<P, N, D, T, I>::faceGeometry() const noexcept
+    -> FaceGeometry<D, T> const &
+  requires(D == 2)
+{
+  // The fill happens once, whichever thread queries first
+  if (!face_geometry.computed.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> const lock(face_geometry.mutex);
+    if (!face_geometry.computed.load(std::memory_order_relaxed)) {
+      computeFaceGeometry(*this, face_geometry);
+    }
+  }
+  return face_geometry;
+}
+
+//==============================================================================
+// clearFaceGeometry
+//==============================================================================
+
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+void
+FaceVertexMesh<P, N, D, T, I>::clearFaceGeometry() noexcept
+{
+  // Only reads the cache if it is empty, so that flipFace may be called on
+  // different faces in parallel once the cache is cleared
+  if (face_geometry.computed) {
+    face_geometry = FaceGeometry<D, T>();
   }
-  return areas;
 }
 
 //==============================================================================
@@ -565,4 +793,26 @@ FaceVertexMesh<P, N, D, T, I>::intersect(Ray<D, T> const & ray, T * intersection
   um2::intersect(*this, ray, intersections, n);
 }
 
+//==============================================================================
+// reorder
+//==============================================================================
+
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+auto
+FaceVertexMesh<P, N, D, T, I>::reorder(MeshOrdering const ordering) -> Vector<Size>
+{
+  return um2::reorder(*this, ordering);
+}
+
+//==============================================================================
+// weldVertices
+//==============================================================================
+
+template <Size P, Size N, Size D, std::floating_point T, std::signed_integral I>
+auto
+FaceVertexMesh<P, N, D, T, I>::weldVertices(T const tolerance) -> Size
+{
+  return um2::weldVertices(*this, tolerance);
+}
+
 } // namespace um2
@@ -2,10 +2,12 @@
 
 #include <um2/common/Log.hpp>
 #include <um2/geometry/Point.hpp>
+#include <um2/mesh/weld.hpp>
 #include <um2/stdlib/algorithm.hpp>
 #include <um2/stdlib/memory.hpp>
 
 #include <algorithm>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -24,6 +26,15 @@ namespace um2
 // - write a mesh to a file
 // - convert a mesh to another format
 //
+// I is the type of the vertex and element ids. O is the type of element_offsets
+// and elset_offsets, which index into element_conn and elset_ids. A mesh with
+// fewer than 2^31 vertices and elements may still have more than 2^31 entries in
+// element_conn, e.g. 300 million quadratic quadrilaterals. Such a mesh keeps
+// 32-bit ids with 64-bit offsets, MeshFile<T, int32_t, int64_t>, instead of
+// doubling the size of element_conn with 64-bit ids. O defaults to I, so the
+// layout of a smaller mesh is unchanged. The meshes constructed from a MeshFile
+// index with Size, so only MeshFile<T, I> converts to and from them.
+//
 
 enum class MeshFileFormat : int8_t {
   None = 0,
@@ -95,6 +106,15 @@ verticesPerCell(MeshType const type) -> Size
   }
 }
 
+// Whether n, a number of entries of element_conn or elset_ids, fits in an offset
+// of type O.
+template <std::signed_integral O>
+constexpr auto
+offsetFits(size_t const n) -> bool
+{
+  return n <= static_cast<size_t>(std::numeric_limits<O>::max());
+}
+
 constexpr auto
 xdmfCellTypeToMeshType(int8_t x) -> MeshType
 {
@@ -131,7 +151,7 @@ meshTypeToXDMFCellType(MeshType x) -> int8_t
   }
 }
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O = I>
 struct MeshFile {
 
   std::string filepath; // path to the mesh file, including file name
@@ -141,14 +161,14 @@ struct MeshFile {
 
   std::vector<Point3<T>> vertices;
   std::vector<MeshType> element_types;
-  std::vector<I> element_offsets; // size = num_cells + 1
+  std::vector<O> element_offsets; // size = num_cells + 1
   std::vector<I> element_conn;
 
   // Instead of storing a vector of vector, we store the elset IDs in a single contiguous
   // array. This is much less convenient for adding or deleting elsets, but it is much
   // more efficient for generating submeshes and other more time-critical operations.
   std::vector<std::string> elset_names;
-  std::vector<I> elset_offsets; // size = num_elsets + 1
+  std::vector<O> elset_offsets; // size = num_elsets + 1
   std::vector<I> elset_ids;     // size = elset_offsets[num_elsets]
 
   constexpr MeshFile() = default;
@@ -167,7 +187,7 @@ struct MeshFile {
   sortElsets();
 
   void
-  getSubmesh(std::string const & elset_name, MeshFile<T, I> & submesh) const;
+  getSubmesh(std::string const & elset_name, MeshFile<T, I, O> & submesh) const;
 
   void
   getMaterialNames(std::vector<std::string> & material_names) const;
@@ -176,15 +196,21 @@ struct MeshFile {
   getMaterialIDs(std::vector<MaterialID> & material_ids,
                  std::vector<std::string> const & material_names) const;
 
+  // Merge the vertices closer than tolerance to each other, and renumber the
+  // vertices of the elements. Returns the number of vertices merged away. See
+  // weld.hpp.
+  auto
+  weldVertices(T tolerance = epsilonDistance<T>()) -> Size;
+
 }; // struct MeshFile
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 constexpr auto
-compareGeometry(MeshFile<T, I> const & lhs, MeshFile<T, I> const & rhs) -> int;
+compareGeometry(MeshFile<T, I, O> const & lhs, MeshFile<T, I, O> const & rhs) -> int;
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 constexpr auto
-compareTopology(MeshFile<T, I> const & lhs, MeshFile<T, I> const & rhs) -> int;
+compareTopology(MeshFile<T, I, O> const & lhs, MeshFile<T, I, O> const & rhs) -> int;
 
 } // namespace um2
 
@@ -5,9 +5,9 @@ namespace um2
 // numCells
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 PURE constexpr auto
-MeshFile<T, I>::numCells() const -> size_t
+MeshFile<T, I, O>::numCells() const -> size_t
 {
   return element_offsets.size() - 1;
 }
@@ -16,9 +16,9 @@ MeshFile<T, I>::numCells() const -> size_t
 // getMeshType
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 PURE constexpr auto
-MeshFile<T, I>::getMeshType() const -> MeshType
+MeshFile<T, I, O>::getMeshType() const -> MeshType
 {
   // Loop throught the element types to determine which 1 or 2 mesh types are
   // present.
@@ -67,9 +67,9 @@ MeshFile<T, I>::getMeshType() const -> MeshType
 // compareGeometry
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 constexpr auto
-compareGeometry(MeshFile<T, I> const & lhs, MeshFile<T, I> const & rhs) -> int
+compareGeometry(MeshFile<T, I, O> const & lhs, MeshFile<T, I, O> const & rhs) -> int
 {
   if (lhs.vertices.size() != rhs.vertices.size()) {
     return 1;
@@ -88,9 +88,9 @@ compareGeometry(MeshFile<T, I> const & lhs, MeshFile<T, I> const & rhs) -> int
 // compareTopology
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 constexpr auto
-compareTopology(MeshFile<T, I> const & lhs, MeshFile<T, I> const & rhs) -> int
+compareTopology(MeshFile<T, I, O> const & lhs, MeshFile<T, I, O> const & rhs) -> int
 {
   if (lhs.element_types.size() != rhs.element_types.size()) {
     return 1;
@@ -122,11 +122,11 @@ compareTopology(MeshFile<T, I> const & lhs, MeshFile<T, I> const & rhs) -> int
 // sortElsets
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 constexpr void
-MeshFile<T, I>::sortElsets()
+MeshFile<T, I, O>::sortElsets()
 {
-  using NameOffsetsPair = std::pair<std::string, std::pair<I, I>>;
+  using NameOffsetsPair = std::pair<std::string, std::pair<O, O>>;
   // Create a vector containing the elset names and offsets.
   size_t const num_elsets = elset_names.size();
   std::vector<NameOffsetsPair> elset_name_offsets_pairs(num_elsets);
@@ -145,11 +145,11 @@ MeshFile<T, I>::sortElsets()
   std::vector<I> elset_ids_copy = elset_ids;
   // Overwrite the current elset offsets and
   // copy the sorted elset ids to the elset_ids_copy vector.
-  I offset = 0;
+  O offset = 0;
   for (size_t i = 0; i < num_elsets; ++i) {
     elset_names[i] = elset_name_offsets_pairs[i].first;
     auto const & offset_pair = elset_name_offsets_pairs[i].second;
-    I const len = offset_pair.second - offset_pair.first;
+    O const len = offset_pair.second - offset_pair.first;
     elset_offsets[i] = offset;
     elset_offsets[i + 1] = offset + len;
     copy(addressof(elset_ids_copy[static_cast<size_t>(offset_pair.first)]),
@@ -163,9 +163,10 @@ MeshFile<T, I>::sortElsets()
 // getSubmesh
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 void
-MeshFile<T, I>::getSubmesh(std::string const & elset_name, MeshFile<T, I> & submesh) const
+MeshFile<T, I, O>::getSubmesh(std::string const & elset_name,
+                              MeshFile<T, I, O> & submesh) const
 {
   LOG_DEBUG("Extracting submesh for elset: " + elset_name);
 
@@ -209,7 +210,7 @@ MeshFile<T, I>::getSubmesh(std::string const & elset_name, MeshFile<T, I> & subm
     auto const element_end = static_cast<size_t>(element_offsets[element_id + 1]);
     auto const element_len = element_end - element_start;
     submesh.element_offsets[i + 1] =
-        submesh.element_offsets[i] + static_cast<I>(element_len);
+        submesh.element_offsets[i] + static_cast<O>(element_len);
     for (size_t j = 0; j < element_len; ++j) {
       I const vertex_id = element_conn[element_start + j];
       submesh.element_conn.push_back(vertex_id);
@@ -273,7 +274,7 @@ MeshFile<T, I>::getSubmesh(std::string const & elset_name, MeshFile<T, I> & subm
       submesh.elset_offsets.push_back(0);
     }
     submesh.elset_offsets.push_back(submesh.elset_offsets.back() +
-                                    static_cast<I>(intersection.size()));
+                                    static_cast<O>(intersection.size()));
     for (size_t j = 0; j < intersection.size(); ++j) {
       I const old_element_id = intersection[j];
       auto const it =
@@ -287,9 +288,9 @@ MeshFile<T, I>::getSubmesh(std::string const & elset_name, MeshFile<T, I> & subm
 // getMaterialNames
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 void
-MeshFile<T, I>::getMaterialNames(std::vector<std::string> & material_names) const
+MeshFile<T, I, O>::getMaterialNames(std::vector<std::string> & material_names) const
 {
   std::string const material = "Material";
   for (auto const & elset_name : elset_names) {
@@ -306,9 +307,9 @@ MeshFile<T, I>::getMaterialNames(std::vector<std::string> & material_names) cons
 // getMaterialIDs
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 constexpr void
-MeshFile<T, I>::getMaterialIDs(std::vector<MaterialID> & material_ids,
+MeshFile<T, I, O>::getMaterialIDs(std::vector<MaterialID> & material_ids,
                                std::vector<std::string> const & material_names) const
 {
   material_ids.resize(numCells(), static_cast<MaterialID>(-1));
@@ -336,4 +337,32 @@ MeshFile<T, I>::getMaterialIDs(std::vector<MaterialID> & material_ids,
   }
 }
 
+//==============================================================================
+// weldVertices
+//==============================================================================
+
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
+auto
+MeshFile<T, I, O>::weldVertices(T const tolerance) -> Size
+{
+  auto const num_vertices = static_cast<Size>(vertices.size());
+  Vector<Size> new_index(num_vertices);
+  Size const num_merged = um2::weldVertices(
+      vertices.data(), vertices.data() + num_vertices, tolerance, new_index.data());
+  if (num_merged == 0) {
+    return 0;
+  }
+  vertices.resize(static_cast<size_t>(num_vertices - num_merged));
+  // element_conn may have more entries than Size can count
+  size_t const num_conn = element_conn.size();
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (size_t i = 0; i < num_conn; ++i) {
+    auto & v = element_conn[i];
+    v = static_cast<I>(new_index[static_cast<Size>(v)]);
+  }
+  return num_merged;
+}
+
 } // namespace um2
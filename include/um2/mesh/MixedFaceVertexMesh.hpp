@@ -0,0 +1,226 @@
+#pragma once
+
+#include <um2/mesh/FaceVertexMesh.hpp>
+
+namespace um2
+{
+
+//=============================================================================
+// MIXED FACE-VERTEX MESH
+//=============================================================================
+//
+// A 2D volumetric or 3D surface mesh composed of triangles and quadrilaterals of
+// polynomial order P. Each vertex is a D-dimensional point of floating point
+// type T.
+//  - P = 1: Triangles and quadrilaterals (TriQuadMesh)
+//  - P = 2: Quadratic triangles and quadratic quadrilaterals (QuadraticTriQuadMesh)
+//
+// Since the number of vertices per face varies, the face-vertex connectivity is
+// stored in a single contiguous array with offsets, like the vertex-face
+// connectivity. Otherwise, the data structure is the same as FaceVertexMesh.
+//  - A TriQuadMesh with a quadrilateral and a triangle:
+//      3---2
+//      |   | .
+//      |   |   .
+//      0---1---4
+//      vertices = { {0, 0}, {1, 0}, {1, 1}, {0, 1}, {2, 0} }
+//      fv_offsets = { 0, 4, 7 }
+//          fv_offsets[i] is the index in fv of the first vertex of face i. There is
+//          an additional element at the end, which is the length of fv.
+//      fv = { 0, 1, 2, 3, 1, 4, 2 }
+//          The vertex indices composing the quadrilateral {0, 1, 2, 3} and the
+//          triangle {1, 4, 2}
+//      vf_offsets = { 0, 1, 3, 5, 6, 7 }
+//      vf = { 0, 0, 1, 0, 1, 0, 1 }
+//
+// A face has 3P vertices if it is a triangle and 4P vertices if it is a
+// quadrilateral. Use visitFace to operate on the polygon of a face.
+//
+// face_geometry caches the area, centroid and bounding box of each face. See
+// face_geometry.hpp.
+//
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+struct MixedFaceVertexMesh {
+
+  using TriFace = Polygon<P, 3 * P, D, T>;
+  using QuadFace = Polygon<P, 4 * P, D, T>;
+
+  Vector<Point<D, T>> vertices;
+  Vector<I> fv_offsets; // size = num_faces + 1
+  Vector<I> fv;         // size = fv_offsets[num_faces]
+  Vector<I> vf_offsets; // size = num_vertices + 1
+  Vector<I> vf;         // size = vf_offsets[num_vertices]
+  mutable FaceGeometry<D, T> face_geometry;
+
+  //===========================================================================
+  // Constructors
+  //===========================================================================
+
+  constexpr MixedFaceVertexMesh() noexcept = default;
+
+  explicit MixedFaceVertexMesh(MeshFile<T, I> const & file);
+
+  //==============================================================================
+  // Accessors
+  //==============================================================================
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  numVertices() const noexcept -> Size;
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  numFaces() const noexcept -> Size;
+
+  PURE HOSTDEV [[nodiscard]] constexpr auto
+  numFaceVertices(Size i) const noexcept -> Size;
+
+  // Call f with the TriFace or QuadFace of face i and return the result.
+  // f must return the same type for both.
+  template <class F>
+  HOSTDEV constexpr auto
+  visitFace(Size i, F && f) const noexcept;
+
+  //===========================================================================
+  // Methods
+  //===========================================================================
+
+  [[nodiscard]] constexpr auto
+  boundingBox() const noexcept -> AxisAlignedBox<D, T>;
+
+  PURE [[nodiscard]] constexpr auto
+  faceContaining(Point<D, T> const & p) const noexcept -> Size
+    requires(D == 2);
+
+  void
+  flipFace(Size i) noexcept;
+
+  void
+  toMeshFile(MeshFile<T, I> & file) const noexcept;
+
+  [[nodiscard]] auto
+  getFaceAreas() const noexcept -> Vector<T>;
+
+  // The area, centroid and bounding box of each face, computed on the first call
+  // from any thread.
+  [[nodiscard]] auto
+  faceGeometry() const noexcept -> FaceGeometry<D, T> const &
+    requires(D == 2);
+
+  // Discard the cached face geometry. Call after changing vertices or fv.
+  void
+  clearFaceGeometry() noexcept;
+
+  void
+  intersect(Ray<D, T> const & ray, T * intersections, Size * n) const noexcept
+    requires(D == 2);
+
+  // Renumber the vertices and faces in the given order. See MeshOrdering.
+  // Returns the face permutation: new face i is old face perm[i].
+  auto
+  reorder(MeshOrdering ordering) -> Vector<Size>;
+
+  // Merge the vertices closer than tolerance to each other, and renumber the
+  // vertices of the faces. Returns the number of vertices merged away. Faces are
+  // not removed, even if some of their vertices are merged together. See
+  // weld.hpp.
+  auto
+  weldVertices(T tolerance = epsilonDistance<T>()) -> Size;
+};
+
+//==============================================================================
+// Aliases
+//==============================================================================
+
+template <Size D, std::floating_point T, std::signed_integral I>
+using TriQuadMesh = MixedFaceVertexMesh<1, D, T, I>;
+template <Size D, std::floating_point T, std::signed_integral I>
+using QuadraticTriQuadMesh = MixedFaceVertexMesh<2, D, T, I>;
+
+template <Size P, std::floating_point T, std::signed_integral I>
+using PlanarMixedPolygonMesh = MixedFaceVertexMesh<P, 2, T, I>;
+
+//==============================================================================
+// numVertices
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+PURE HOSTDEV constexpr auto
+numVertices(MixedFaceVertexMesh<P, D, T, I> const & mesh) noexcept -> Size;
+
+//==============================================================================
+// numFaces
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+PURE HOSTDEV constexpr auto
+numFaces(MixedFaceVertexMesh<P, D, T, I> const & mesh) noexcept -> Size;
+
+//==============================================================================
+// numFaceVertices
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+PURE HOSTDEV constexpr auto
+numFaceVertices(MixedFaceVertexMesh<P, D, T, I> const & mesh, Size i) noexcept -> Size;
+
+//==============================================================================
+// visitFace
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I, class F>
+HOSTDEV constexpr auto
+visitFace(MixedFaceVertexMesh<P, D, T, I> const & mesh, Size i, F && f) noexcept;
+
+//==============================================================================
+// boundingBox
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+constexpr auto
+boundingBox(MixedFaceVertexMesh<P, D, T, I> const & mesh) noexcept
+    -> AxisAlignedBox<D, T>;
+
+//==============================================================================
+// faceContaining
+//==============================================================================
+
+template <Size P, std::floating_point T, std::signed_integral I>
+PURE constexpr auto
+faceContaining(PlanarMixedPolygonMesh<P, T, I> const & mesh, Point2<T> const & p) noexcept
+    -> Size;
+
+//==============================================================================
+// intersect
+//==============================================================================
+
+template <Size P, std::floating_point T, std::signed_integral I>
+void
+intersect(PlanarMixedPolygonMesh<P, T, I> const & mesh, Ray2<T> const & ray,
+          T * intersections, Size * n) noexcept;
+
+//==============================================================================
+// buildVertexFaceConnectivity
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+void
+buildVertexFaceConnectivity(MixedFaceVertexMesh<P, D, T, I> & mesh) noexcept;
+
+//==============================================================================
+// reorder
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+auto
+reorder(MixedFaceVertexMesh<P, D, T, I> & mesh, MeshOrdering ordering) -> Vector<Size>;
+
+//==============================================================================
+// weldVertices
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+auto
+weldVertices(MixedFaceVertexMesh<P, D, T, I> & mesh, T tolerance) -> Size;
+
+} // namespace um2
+
+#include "MixedFaceVertexMesh.inl"
@@ -0,0 +1,637 @@
+// Free functions
+namespace um2
+{
+
+//==============================================================================
+//==============================================================================
+// Free functions
+//==============================================================================
+//==============================================================================
+
+//==============================================================================
+// numVertices
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+PURE HOSTDEV constexpr auto
+numVertices(MixedFaceVertexMesh<P, D, T, I> const & mesh) noexcept -> Size
+{
+  return mesh.vertices.size();
+}
+
+//==============================================================================
+// numFaces
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+PURE HOSTDEV constexpr auto
+numFaces(MixedFaceVertexMesh<P, D, T, I> const & mesh) noexcept -> Size
+{
+  return mesh.fv_offsets.size() - 1;
+}
+
+//==============================================================================
+// numFaceVertices
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+PURE HOSTDEV constexpr auto
+numFaceVertices(MixedFaceVertexMesh<P, D, T, I> const & mesh, Size const i) noexcept
+    -> Size
+{
+  return static_cast<Size>(mesh.fv_offsets[i + 1] - mesh.fv_offsets[i]);
+}
+
+//==============================================================================
+// visitFace
+//==============================================================================
+
+// Whether visitFace is pure depends on f
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wsuggest-attribute=pure"
+#endif
+template <Size P, Size D, std::floating_point T, std::signed_integral I, class F>
+HOSTDEV constexpr auto
+visitFace(MixedFaceVertexMesh<P, D, T, I> const & mesh, Size const i, F && f) noexcept
+{
+  auto const offset = static_cast<Size>(mesh.fv_offsets[i]);
+  if (numFaceVertices(mesh, i) == 3 * P) {
+    typename MixedFaceVertexMesh<P, D, T, I>::TriFace face;
+    for (Size j = 0; j < 3 * P; ++j) {
+      face[j] = mesh.vertices[static_cast<Size>(mesh.fv[offset + j])];
+    }
+    return f(face);
+  }
+  assert(numFaceVertices(mesh, i) == 4 * P);
+  typename MixedFaceVertexMesh<P, D, T, I>::QuadFace face;
+  for (Size j = 0; j < 4 * P; ++j) {
+    face[j] = mesh.vertices[static_cast<Size>(mesh.fv[offset + j])];
+  }
+  return f(face);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+
+//==============================================================================
+// boundingBox
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+constexpr auto
+boundingBox(MixedFaceVertexMesh<P, D, T, I> const & mesh) noexcept
+    -> AxisAlignedBox<D, T>
+{
+  if constexpr (P == 1) {
+    return boundingBox(mesh.vertices);
+  } else {
+    // The edges of a face may bulge past its vertices
+    if constexpr (D == 2) {
+      return mesh.faceGeometry().box;
+    } else {
+      auto const face_box = [](auto const & face) { return face.boundingBox(); };
+      AxisAlignedBox<D, T> box = visitFace(mesh, 0, face_box);
+      for (Size i = 1; i < numFaces(mesh); ++i) {
+        box += visitFace(mesh, i, face_box);
+      }
+      return box;
+    }
+  }
+}
+
+//==============================================================================
+// faceContaining
+//==============================================================================
+
+template <Size P, std::floating_point T, std::signed_integral I>
+PURE constexpr auto
+faceContaining(PlanarMixedPolygonMesh<P, T, I> const & mesh, Point2<T> const & p) noexcept
+    -> Size
+{
+  auto const face_contains = [&p](auto const & face) { return face.contains(p); };
+  for (Size i = 0; i < numFaces(mesh); ++i) {
+    if (visitFace(mesh, i, face_contains)) {
+      return i;
+    }
+  }
+  assert(false);
+  return -1;
+}
+
+//==============================================================================
+// validateMesh
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+auto
+validateMesh(MixedFaceVertexMesh<P, D, T, I> & mesh) -> MeshValidation
+{
+  MeshValidation result;
+#ifndef NDEBUG
+  result.duplicate_vertices = findDuplicateVertices(mesh.vertices);
+  result.duplicate_vertices.log("vertices are effectively equivalent to another vertex");
+#endif
+
+  // Check that the vertices are in counter-clockwise order. The faces are
+  // flipped in parallel, so the cache of face geometry is cleared first.
+  mesh.clearFaceGeometry();
+  result.clockwise_faces = findMeshIssue(mesh.numFaces(), [&mesh](Size const i) {
+    if (mesh.visitFace(i, [](auto const & face) { return face.isCCW(); })) {
+      return false;
+    }
+    mesh.flipFace(i);
+    return true;
+  });
+  result.clockwise_faces.log("faces have vertices in clockwise order and were flipped");
+
+  // Convexity check
+  if constexpr (P == 1 && D == 2) {
+    result.nonconvex_faces = findMeshIssue(mesh.numFaces(), [&mesh](Size const i) {
+      if (mesh.numFaceVertices(i) != 4) {
+        return false;
+      }
+      auto const offset = static_cast<Size>(mesh.fv_offsets[i]);
+      Quadrilateral<D, T> const quad(mesh.vertices[static_cast<Size>(mesh.fv[offset])],
+                                     mesh.vertices[static_cast<Size>(mesh.fv[offset + 1])],
+                                     mesh.vertices[static_cast<Size>(mesh.fv[offset + 2])],
+                                     mesh.vertices[static_cast<Size>(mesh.fv[offset + 3])]);
+      return !isConvex(quad);
+    });
+    result.nonconvex_faces.log("faces are not convex");
+  }
+  return result;
+}
+
+//==============================================================================
+// toFaceVertexMesh
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+void
+toFaceVertexMesh(MeshFile<T, I> const & file,
+                 MixedFaceVertexMesh<P, D, T, I> & mesh) noexcept
+{
+  assert(!file.vertices.empty());
+  assert(!file.element_conn.empty());
+  auto const num_vertices = static_cast<Size>(file.vertices.size());
+  auto const num_faces = static_cast<Size>(file.numCells());
+  auto const conn_size = static_cast<Size>(file.element_conn.size());
+  MeshType const meshtype = file.getMeshType();
+  // A mixed mesh may also hold a mesh with a single face type
+  bool compatible = false;
+  if constexpr (P == 1) {
+    compatible = meshtype == MeshType::TriQuad || meshtype == MeshType::Tri ||
+                 meshtype == MeshType::Quad;
+  } else {
+    compatible = meshtype == MeshType::QuadraticTriQuad ||
+                 meshtype == MeshType::QuadraticTri ||
+                 meshtype == MeshType::QuadraticQuad;
+  }
+  if (!compatible) {
+    Log::error("Attempted to construct a MixedFaceVertexMesh from a mesh file with an "
+               "incompatible mesh type");
+  }
+
+  // -- Vertices --
+  if constexpr (D == 2) {
+    mesh.vertices.resize(num_vertices);
+    for (Size i = 0; i < num_vertices; ++i) {
+      mesh.vertices[i][0] = file.vertices[static_cast<size_t>(i)][0];
+      mesh.vertices[i][1] = file.vertices[static_cast<size_t>(i)][1];
+    }
+  } else {
+    mesh.vertices = file.vertices;
+  }
+  mesh.clearFaceGeometry();
+
+  // -- Face/Vertex connectivity --
+  mesh.fv_offsets.resize(num_faces + 1);
+  for (Size i = 0; i <= num_faces; ++i) {
+    mesh.fv_offsets[i] = file.element_offsets[static_cast<size_t>(i)];
+  }
+  assert(mesh.fv_offsets[0] == 0);
+  assert(static_cast<Size>(mesh.fv_offsets[num_faces]) == conn_size);
+  mesh.fv.resize(conn_size);
+  std::copy(file.element_conn.cbegin(), file.element_conn.cend(), mesh.fv.begin());
+
+  // -- Vertex/Face connectivity --
+  buildVertexFaceConnectivity(mesh);
+  validateMesh(mesh);
+}
+
+//==============================================================================
+// buildVertexFaceConnectivity
+//==============================================================================
+
+// Set vf_offsets and vf from fv_offsets and fv.
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+void
+buildVertexFaceConnectivity(MixedFaceVertexMesh<P, D, T, I> & mesh) noexcept
+{
+  Size const num_vertices = mesh.numVertices();
+  Size const num_faces = mesh.numFaces();
+  Vector<I> vert_counts(num_vertices, 0);
+  for (auto const v : mesh.fv) {
+    ++vert_counts[static_cast<Size>(v)];
+  }
+  mesh.vf_offsets.resize(num_vertices + 1);
+  mesh.vf_offsets[0] = 0;
+  std::inclusive_scan(vert_counts.cbegin(), vert_counts.cend(),
+                      mesh.vf_offsets.begin() + 1);
+  vert_counts.clear();
+  mesh.vf.resize(static_cast<Size>(mesh.vf_offsets[num_vertices]));
+  Vector<I> vert_offsets = mesh.vf_offsets;
+  for (Size i = 0; i < num_faces; ++i) {
+    for (auto j = static_cast<Size>(mesh.fv_offsets[i]);
+         j < static_cast<Size>(mesh.fv_offsets[i + 1]); ++j) {
+      auto const vert = static_cast<Size>(mesh.fv[j]);
+      mesh.vf[static_cast<Size>(vert_offsets[vert])] = static_cast<I>(i);
+      ++vert_offsets[vert];
+    }
+  }
+}
+
+//==============================================================================
+// reorder
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+auto
+reorder(MixedFaceVertexMesh<P, D, T, I> & mesh, MeshOrdering const ordering)
+    -> Vector<Size>
+{
+  Size const num_vertices = mesh.numVertices();
+  Size const num_faces = mesh.numFaces();
+  if (mesh.vf_offsets.size() != num_vertices + 1) {
+    buildVertexFaceConnectivity(mesh);
+  }
+  Vector<Size> vertex_perm;
+  Vector<Size> face_perm;
+  auto const forEachFaceVertex = [&mesh](Size const i, auto && f) {
+    for (auto j = static_cast<Size>(mesh.fv_offsets[i]);
+         j < static_cast<Size>(mesh.fv_offsets[i + 1]); ++j) {
+      f(mesh.fv[j]);
+    }
+  };
+  meshOrder(mesh.vertices, num_faces, mesh.vf_offsets, mesh.vf, forEachFaceVertex,
+            ordering, vertex_perm, face_perm);
+  if (ordering == MeshOrdering::None) {
+    return face_perm;
+  }
+
+  // -- Vertices --
+  Vector<Point<D, T>> vertices(num_vertices);
+  Vector<I> new_index(num_vertices);
+  for (Size i = 0; i < num_vertices; ++i) {
+    vertices[i] = mesh.vertices[vertex_perm[i]];
+    new_index[vertex_perm[i]] = static_cast<I>(i);
+  }
+  mesh.vertices = um2::move(vertices);
+
+  // -- Faces --
+  Vector<I> fv_offsets(num_faces + 1);
+  Vector<I> fv(mesh.fv.size());
+  fv_offsets[0] = 0;
+  Size k = 0;
+  for (Size i = 0; i < num_faces; ++i) {
+    Size const face = face_perm[i];
+    for (auto j = static_cast<Size>(mesh.fv_offsets[face]);
+         j < static_cast<Size>(mesh.fv_offsets[face + 1]); ++j) {
+      fv[k++] = new_index[static_cast<Size>(mesh.fv[j])];
+    }
+    fv_offsets[i + 1] = static_cast<I>(k);
+  }
+  mesh.fv_offsets = um2::move(fv_offsets);
+  mesh.fv = um2::move(fv);
+  mesh.clearFaceGeometry();
+  buildVertexFaceConnectivity(mesh);
+  return face_perm;
+}
+
+//==============================================================================
+// weldVertices
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+auto
+weldVertices(MixedFaceVertexMesh<P, D, T, I> & mesh, T const tolerance) -> Size
+{
+  Size const num_vertices = mesh.numVertices();
+  Vector<Size> new_index(num_vertices);
+  Size const num_merged = um2::weldVertices(mesh.vertices.begin(), mesh.vertices.end(),
+                                            tolerance, new_index.begin());
+  if (num_merged == 0) {
+    return 0;
+  }
+  mesh.vertices.resize(num_vertices - num_merged);
+  Size const num_conn = mesh.fv.size();
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Size i = 0; i < num_conn; ++i) {
+    mesh.fv[i] = static_cast<I>(new_index[static_cast<Size>(mesh.fv[i])]);
+  }
+  mesh.clearFaceGeometry();
+  buildVertexFaceConnectivity(mesh);
+  return num_merged;
+}
+
+//==============================================================================
+// toMeshFile
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+void
+toMeshFile(MixedFaceVertexMesh<P, D, T, I> const & mesh, MeshFile<T, I> & file) noexcept
+{
+  // Default to XDMf
+  file.format = MeshFileFormat::XDMF;
+
+  // Vertices
+  if constexpr (D == 3) {
+    file.vertices = mesh.vertices;
+  } else {
+    file.vertices.resize(static_cast<size_t>(mesh.numVertices()));
+    for (Size i = 0; i < mesh.numVertices(); ++i) {
+      file.vertices[static_cast<size_t>(i)][0] = mesh.vertices[i][0];
+      file.vertices[static_cast<size_t>(i)][1] = mesh.vertices[i][1];
+      file.vertices[static_cast<size_t>(i)][2] = 0;
+    }
+  }
+
+  // Faces
+  MeshType constexpr tri_type = P == 1 ? MeshType::Tri : MeshType::QuadraticTri;
+  MeshType constexpr quad_type = P == 1 ? MeshType::Quad : MeshType::QuadraticQuad;
+  auto const nfaces = static_cast<size_t>(mesh.numFaces());
+  file.element_types.resize(nfaces);
+  for (size_t i = 0; i < nfaces; ++i) {
+    file.element_types[i] =
+        mesh.numFaceVertices(static_cast<Size>(i)) == 3 * P ? tri_type : quad_type;
+  }
+  file.element_offsets.assign(mesh.fv_offsets.cbegin(), mesh.fv_offsets.cend());
+  file.element_conn.assign(mesh.fv.cbegin(), mesh.fv.cend());
+}
+
+//==============================================================================
+// intersect
+//==============================================================================
+
+template <Size P, std::floating_point T, std::signed_integral I>
+void
+intersect(PlanarMixedPolygonMesh<P, T, I> const & mesh, Ray2<T> const & ray,
+          T * const intersections, Size * const n) noexcept
+{
+  T constexpr r_miss = infiniteDistance<T>();
+  Size nintersect = 0;
+#ifndef NDEBUG
+  Size const n0 = *n;
+#endif
+  auto const intersect_edges = [&](auto const & face) {
+    for (Size j = 0; j < face.numEdges(); ++j) {
+      auto const edge = face.getEdge(j);
+      if constexpr (P == 1) {
+        T const r = intersect(edge, ray);
+        if (r < r_miss) {
+          assert(nintersect < n0);
+          intersections[nintersect++] = r;
+        }
+      } else {
+        auto const r = intersect(edge, ray);
+        if (r[0] < r_miss) {
+          assert(nintersect < n0);
+          intersections[nintersect++] = r[0];
+        }
+        if (r[1] < r_miss) {
+          assert(nintersect < n0);
+          intersections[nintersect++] = r[1];
+        }
+      }
+    }
+  };
+  for (Size i = 0; i < numFaces(mesh); ++i) {
+    visitFace(mesh, i, intersect_edges);
+  }
+  *n = nintersect;
+  std::sort(intersections, intersections + nintersect);
+}
+
+//==============================================================================
+//==============================================================================
+// Member functions
+//==============================================================================
+//==============================================================================
+
+//==============================================================================
+// Constructors
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+MixedFaceVertexMesh<P, D, T, I>::MixedFaceVertexMesh(MeshFile<T, I> const & file)
+{
+  um2::toFaceVertexMesh(file, *this);
+}
+
+//==============================================================================
+// numVertices
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+PURE HOSTDEV [[nodiscard]] constexpr auto
+MixedFaceVertexMesh<P, D, T, I>::numVertices() const noexcept -> Size
+{
+  return um2::numVertices(*this);
+}
+
+//==============================================================================
+// numFaces
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+PURE HOSTDEV [[nodiscard]] constexpr auto
+MixedFaceVertexMesh<P, D, T, I>::numFaces() const noexcept -> Size
+{
+  return um2::numFaces(*this);
+}
+
+//==============================================================================
+// numFaceVertices
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+PURE HOSTDEV [[nodiscard]] constexpr auto
+MixedFaceVertexMesh<P, D, T, I>::numFaceVertices(Size const i) const noexcept -> Size
+{
+  return um2::numFaceVertices(*this, i);
+}
+
+//==============================================================================
+// visitFace
+//==============================================================================
+
+// Whether visitFace is pure depends on f
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wsuggest-attribute=pure"
+#endif
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+template <class F>
+HOSTDEV constexpr auto
+MixedFaceVertexMesh<P, D, T, I>::visitFace(Size const i, F && f) const noexcept
+{
+  return um2::visitFace(*this, i, std::forward<F>(f));
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+
+//==============================================================================
+// boundingBox
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+[[nodiscard]] constexpr auto
+MixedFaceVertexMesh<P, D, T, I>::boundingBox() const noexcept -> AxisAlignedBox<D, T>
+{
+  return um2::boundingBox(*this);
+}
+
+//==============================================================================
+// faceContaining
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+PURE [[nodiscard]] constexpr auto
+MixedFaceVertexMesh<P, D, T, I>::faceContaining(Point<D, T> const & p) const noexcept
+    -> Size
+  requires(D == 2)
+{
+  return um2::faceContaining(*this, p);
+}
+
+//==============================================================================
+// flipFace
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+void
+MixedFaceVertexMesh<P, D, T, I>::flipFace(Size const i) noexcept
+{
+  clearFaceGeometry();
+  auto const offset = static_cast<Size>(fv_offsets[i]);
+  I * const face = fv.data() + offset;
+  Size const nverts = numFaceVertices(i);
+  if (nverts == 3) {
+    um2::swap(face[1], face[2]);
+  } else if (nverts == 4) {
+    um2::swap(face[1], face[3]);
+  } else if (nverts == 6) {
+    um2::swap(face[1], face[2]);
+    um2::swap(face[3], face[5]);
+  } else if (nverts == 8) {
+    um2::swap(face[1], face[3]);
+    um2::swap(face[4], face[7]);
+  }
+}
+
+//==============================================================================
+// toMeshFile
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+void
+MixedFaceVertexMesh<P, D, T, I>::toMeshFile(MeshFile<T, I> & file) const noexcept
+{
+  um2::toMeshFile(*this, file);
+}
+
+//==============================================================================
+// getFaceAreas
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+auto
+MixedFaceVertexMesh<P, D, T, I>::getFaceAreas() const noexcept -> Vector<T>
+{
+  if constexpr (D == 2) {
+    return faceGeometry().areas;
+  } else {
+    Vector<T> areas(numFaces());
+    for (Size i = 0; i < numFaces(); ++i) {
+      areas[i] = visitFace(i, [](auto const & face) { return face.area(); });
+    }
+    return areas;
+  }
+}
+
+//==============================================================================
+// faceGeometry
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+auto
+MixedFaceVertexMesh<P, D, T, I>::faceGeometry() const noexcept
+    -> FaceGeometry<D, T> const &
+  requires(D == 2)
+{
+  // The fill happens once, whichever thread queries first
+  if (!face_geometry.computed.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> const lock(face_geometry.mutex);
+    if (!face_geometry.computed.load(std::memory_order_relaxed)) {
+      computeFaceGeometry(*this, face_geometry);
+    }
+  }
+  return face_geometry;
+}
+
+//==============================================================================
+// clearFaceGeometry
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+void
+MixedFaceVertexMesh<P, D, T, I>::clearFaceGeometry() noexcept
+{
+  // Only reads the cache if it is empty, so that flipFace may be called on
+  // different faces in parallel once the cache is cleared
+  if (face_geometry.computed) {
+    face_geometry = FaceGeometry<D, T>();
+  }
+}
+
+//==============================================================================
+// intersect
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+void
+MixedFaceVertexMesh<P, D, T, I>::intersect(Ray<D, T> const & ray, T * intersections,
+                                           Size * const n) const noexcept
+  requires(D == 2)
+{
+  um2::intersect(*this, ray, intersections, n);
+}
+
+//==============================================================================
+// reorder
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+auto
+MixedFaceVertexMesh<P, D, T, I>::reorder(MeshOrdering const ordering) -> Vector<Size>
+{
+  return um2::reorder(*this, ordering);
+}
+
+//==============================================================================
+// weldVertices
+//==============================================================================
+
+template <Size P, Size D, std::floating_point T, std::signed_integral I>
+auto
+MixedFaceVertexMesh<P, D, T, I>::weldVertices(T const tolerance) -> Size
+{
+  return um2::weldVertices(*this, tolerance);
+}
+
+} // namespace um2
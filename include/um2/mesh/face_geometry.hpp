@@ -0,0 +1,113 @@
+#pragma once
+
+#include <um2/geometry/AxisAlignedBox.hpp>
+#include <um2/stdlib/Vector.hpp>
+
+#include <atomic> // std::atomic
+#include <mutex>  // std::mutex, std::lock_guard
+#include <utility> // std::move
+
+namespace um2
+{
+
+//==============================================================================
+// FACE GEOMETRY
+//==============================================================================
+// The area, centroid and bounding box of each face of a planar mesh, and the
+// bounding box of the whole mesh.
+//
+// FaceVertexMesh and MixedFaceVertexMesh compute them on the first call to
+// faceGeometry() and keep them until a member function changes the vertices or
+// faces (flipFace, reorder, weldVertices, ...). Code that changes vertices or fv
+// directly must call clearFaceGeometry() afterwards.
+//
+// The cache takes about 56 bytes per face in 2D double precision, so it is only
+// filled for meshes which are queried. faceGeometry() fills it under the mutex
+// of the cache, so a const mesh may be queried from several threads, e.g.
+// through the C API, and only the first query pays for the fill. To fill the
+// caches up front instead, call faceGeometry() once, or
+// SpatialPartition::computeFaceGeometry for all the meshes of a model.
+// clearFaceGeometry() must not race with queries.
+
+template <Size D, std::floating_point T>
+struct FaceGeometry {
+  Vector<T> areas;
+  Vector<Point<D, T>> centroids;
+  Vector<AxisAlignedBox<D, T>> boxes;
+  AxisAlignedBox<D, T> box; // The union of boxes
+  std::atomic<bool> computed = false;
+  mutable std::mutex mutex; // Held while the cache is filled or copied
+
+  FaceGeometry() = default;
+  ~FaceGeometry() = default;
+
+  // The mutex is not copied or moved.
+  FaceGeometry(FaceGeometry const & other) { *this = other; }
+
+  FaceGeometry(FaceGeometry && other) noexcept { *this = std::move(other); }
+
+  auto
+  operator=(FaceGeometry const & other) -> FaceGeometry &
+  {
+    if (this != &other) {
+      // A query of other may be filling its cache
+      std::lock_guard<std::mutex> const lock(other.mutex);
+      areas = other.areas;
+      centroids = other.centroids;
+      boxes = other.boxes;
+      box = other.box;
+      computed = other.computed.load();
+    }
+    return *this;
+  }
+
+  auto
+  operator=(FaceGeometry && other) noexcept -> FaceGeometry &
+  {
+    if (this == &other) {
+      return *this;
+    }
+    areas = std::move(other.areas);
+    centroids = std::move(other.centroids);
+    boxes = std::move(other.boxes);
+    box = other.box;
+    computed = other.computed.load();
+    return *this;
+  }
+};
+
+//==============================================================================
+// computeFaceGeometry
+//==============================================================================
+// Compute the geometry of the faces of mesh, a FaceVertexMesh or a
+// MixedFaceVertexMesh, in parallel with OpenMP. The caller holds
+// geometry.mutex, or is the only user of geometry.
+
+template <Size D, std::floating_point T, class Mesh>
+void
+computeFaceGeometry(Mesh const & mesh, FaceGeometry<D, T> & geometry)
+{
+  Size const num_faces = mesh.numFaces();
+  geometry.areas.resize(num_faces);
+  geometry.centroids.resize(num_faces);
+  geometry.boxes.resize(num_faces);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Size i = 0; i < num_faces; ++i) {
+    mesh.visitFace(i, [&geometry, i](auto const & face) {
+      geometry.areas[i] = face.area();
+      geometry.centroids[i] = face.centroid();
+      geometry.boxes[i] = face.boundingBox();
+    });
+  }
+  if (num_faces > 0) {
+    geometry.box = geometry.boxes[0];
+    for (Size i = 1; i < num_faces; ++i) {
+      geometry.box += geometry.boxes[i];
+    }
+  }
+  geometry.computed.store(true, std::memory_order_release);
+}
+
+} // namespace um2
@@ -10,26 +10,27 @@ namespace um2
 // IO for mesh files
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 void
-importMesh(std::string const & path, MeshFile<T, I> & mesh)
+importMesh(std::string const & path, MeshFile<T, I, O> & mesh)
 {
   if (path.ends_with(".inp")) {
-    readAbaqusFile<T, I>(path, mesh);
+    readAbaqusFile(path, mesh);
   } else if (path.ends_with(".xdmf")) {
-    readXDMFFile<T, I>(path, mesh);
+    readXDMFFile(path, mesh);
   } else {
     Log::error("Unsupported file format.");
   }
 }
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 void
-exportMesh(std::string const & path, MeshFile<T, I> & mesh)
+exportMesh(std::string const & path, MeshFile<T, I, O> & mesh,
+           H5WriteOptions const & options = {})
 {
   if (path.ends_with(".xdmf")) {
     mesh.filepath = path;
-    writeXDMFFile<T, I>(mesh);
+    writeXDMFFile(mesh, options);
   } else {
     Log::error("Unsupported file format.");
   }
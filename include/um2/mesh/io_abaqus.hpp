@@ -24,9 +24,9 @@ namespace um2
 // parseNodes
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 static void
-parseNodes(MeshFile<T, I> & mesh, std::string & line, std::ifstream & file)
+parseNodes(MeshFile<T, I, O> & mesh, std::string & line, std::ifstream & file)
 {
   // Would love to use chars_format here, but it bugs out on "0.5" occasionally
   LOG_DEBUG("Parsing nodes");
@@ -49,9 +49,9 @@ parseNodes(MeshFile<T, I> & mesh, std::string & line, std::ifstream & file)
 // parseElements
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 static void
-parseElements(MeshFile<T, I> & mesh, std::string & line, std::ifstream & file)
+parseElements(MeshFile<T, I, O> & mesh, std::string & line, std::ifstream & file)
 {
   LOG_DEBUG("Parsing elements");
   //  "*ELEMENT, type=CPS".size() = 18
@@ -106,19 +106,23 @@ parseElements(MeshFile<T, I> & mesh, std::string & line, std::ifstream & file)
     mesh.element_conn.push_back(id - 1); // ABAQUS is 1-indexed
     ++num_elements;
   }
+  if (!offsetFits<O>(mesh.element_conn.size())) {
+    LOG_ERROR("The element offsets overflow. Use a wider offset type");
+    return;
+  }
   mesh.element_types.insert(mesh.element_types.end(), num_elements, this_type);
   size_t offsets_size = mesh.element_offsets.size();
   if (offsets_size == 0) {
     mesh.element_offsets.push_back(0);
     offsets_size = 1;
   }
-  I const offset_back = mesh.element_offsets.back();
+  O const offset_back = mesh.element_offsets.back();
   mesh.element_offsets.resize(offsets_size + num_elements);
   for (size_t i = 0; i < num_elements; ++i) {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wconversion"
     // NOLINTNEXTLINE(bugprone-misplaced-widening-cast)
-    auto const ip1 = static_cast<I>(i + 1U);
+    auto const ip1 = static_cast<O>(i + 1U);
     mesh.element_offsets[offsets_size + i] = offset_back + ip1 * offset;
 #pragma GCC diagnostic pop
   }
@@ -128,9 +132,9 @@ parseElements(MeshFile<T, I> & mesh, std::string & line, std::ifstream & file)
 // parseElsets
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 static void
-parseElsets(MeshFile<T, I> & mesh, std::string & line, std::ifstream & file)
+parseElsets(MeshFile<T, I, O> & mesh, std::string & line, std::ifstream & file)
 {
   LOG_DEBUG("Parsing elsets");
   std::string_view line_view = line;
@@ -140,8 +144,8 @@ parseElsets(MeshFile<T, I> & mesh, std::string & line, std::ifstream & file)
   if (mesh.elset_offsets.size() == 0) {
     mesh.elset_offsets.push_back(0);
   }
-  I const offset_back = mesh.elset_offsets.back();
-  I num_elements = 0;
+  O const offset_back = mesh.elset_offsets.back();
+  O num_elements = 0;
   while (std::getline(file, line) && line[0] != '*') {
     line_view = line;
     // Add each element ID to the elset
@@ -166,6 +170,10 @@ parseElsets(MeshFile<T, I> & mesh, std::string & line, std::ifstream & file)
       next = line_view.find(',', last + 1);
     }
   }
+  if (!offsetFits<O>(mesh.elset_ids.size())) {
+    LOG_ERROR("The elset offsets overflow. Use a wider offset type");
+    return;
+  }
   mesh.elset_offsets.push_back(offset_back + num_elements);
   // Ensure the elset is sorted
   assert(std::is_sorted(mesh.elset_ids.cbegin() + offset_back, mesh.elset_ids.cend()));
@@ -175,9 +183,9 @@ parseElsets(MeshFile<T, I> & mesh, std::string & line, std::ifstream & file)
 // readAbaqusFile
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 void
-readAbaqusFile(std::string const & filename, MeshFile<T, I> & mesh)
+readAbaqusFile(std::string const & filename, MeshFile<T, I, O> & mesh)
 {
   LOG_INFO("Reading Abaqus mesh file: " + filename);
 
@@ -206,13 +214,13 @@ readAbaqusFile(std::string const & filename, MeshFile<T, I> & mesh)
       }
       mesh.name = line.substr(1, nchars);
     } else if (line.starts_with("*NODE")) {
-      parseNodes<T>(mesh, line, file);
+      parseNodes(mesh, line, file);
       loop_again = true;
     } else if (line.starts_with("*ELEMENT")) {
-      parseElements<T, I>(mesh, line, file);
+      parseElements(mesh, line, file);
       loop_again = true;
     } else if (line.starts_with("*ELSET")) {
-      parseElsets<T, I>(mesh, line, file);
+      parseElsets(mesh, line, file);
       loop_again = true;
     }
   }
@@ -4,7 +4,7 @@
 #include <um2/mesh/MeshFile.hpp>
 #include <um2/stdlib/sto.hpp>
 
-#include <algorithm> // std::transform
+#include <algorithm> // std::clamp, std::transform
 #include <cstring>   // strcmp
 #include <sstream>   // std::stringstream
 #include <string>
@@ -55,15 +55,79 @@ getH5DataType() -> H5::PredType
   }
 }
 
+//==============================================================================
+// H5WriteOptions
+//==============================================================================
+// Layout and filter options for the HDF5 datasets written alongside an XDMF
+// file. By default, datasets are contiguous and uncompressed. Any filter
+// requires a chunked layout, so a chunk size is chosen automatically when
+// compression is requested without one.
+//
+// Deflate (gzip) is built into HDF5. Shuffle reorders the bytes of each value
+// so that the slowly varying high bytes of coordinates and vertex ids are
+// adjacent, which typically improves the deflate ratio on mesh data.
+// Compressed files are read transparently by readXDMFFile, ParaView, etc.
+
+enum class H5Compression : int8_t {
+  None = 0,
+  Deflate = 1,
+  ShuffleDeflate = 2,
+};
+
+struct H5WriteOptions {
+  H5Compression compression = H5Compression::None;
+  // Deflate level in [1, 9]. Levels above ~4 rarely buy much on mesh data.
+  int deflate_level = 4;
+  // Number of rows (vertices, cells, ids) per chunk. 0 chooses the chunk size
+  // automatically when chunking is required.
+  hsize_t chunk_rows = 0;
+};
+
+// Target chunk size in bytes when H5WriteOptions::chunk_rows is 0.
+inline constexpr size_t h5_default_chunk_bytes = 1 << 20;
+
+static inline auto
+makeH5DSetCreatPropList(int const rank, hsize_t const * dims, size_t const type_size,
+                        H5WriteOptions const & options) -> H5::DSetCreatPropList
+{
+  H5::DSetCreatPropList plist;
+  bool const compress = options.compression != H5Compression::None;
+  // Contiguous unless the user asked for chunks or a filter.
+  // Chunked datasets with zero extent are not allowed by a fixed size dataspace.
+  if ((!compress && options.chunk_rows == 0) || dims[0] == 0) {
+    return plist;
+  }
+  // Chunk along the first dimension only, keeping each row whole.
+  hsize_t chunk_dims[2] = {options.chunk_rows, rank == 2 ? dims[1] : 1};
+  if (chunk_dims[0] == 0) {
+    size_t const row_bytes = type_size * static_cast<size_t>(chunk_dims[1]);
+    chunk_dims[0] = static_cast<hsize_t>(h5_default_chunk_bytes / row_bytes);
+  }
+  chunk_dims[0] = std::clamp(chunk_dims[0], static_cast<hsize_t>(1), dims[0]);
+  plist.setChunk(rank, chunk_dims);
+  if (compress) {
+    if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0) {
+      Log::warn("HDF5 deflate filter is not available. Writing uncompressed data");
+      return plist;
+    }
+    if (options.compression == H5Compression::ShuffleDeflate) {
+      plist.setShuffle();
+    }
+    plist.setDeflate(std::clamp(options.deflate_level, 1, 9));
+  }
+  return plist;
+}
+
 //==============================================================================
 // writeXDMFGeometry
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
   requires(sizeof(T) == 4 || sizeof(T) == 8)
 static void writeXDMFGeometry(pugi::xml_node & xgrid, H5::Group & h5group,
                               std::string const & h5filename, std::string const & h5path,
-                              MeshFile<T, I> const & mesh)
+                              MeshFile<T, I, O> const & mesh,
+                              H5WriteOptions const & options)
 {
   LOG_DEBUG("Writing XDMF geometry");
   size_t const num_verts = mesh.vertices.size();
@@ -91,31 +155,26 @@ static void writeXDMFGeometry(pugi::xml_node & xgrid, H5::Group & h5group,
   xdata.append_child(pugi::node_pcdata).set_value(h5geompath.c_str());
 
   // Create HDF5 data space
-  hsize_t dims[2] = {static_cast<hsize_t>(num_verts), dim};
+  hsize_t const dims[2] = {static_cast<hsize_t>(num_verts), dim};
   H5::DataSpace const h5space(2, dims);
   // Create HDF5 data type
   H5::DataType const h5type = getH5DataType<T>();
   // Create HDF5 data set
-  H5::DataSet const h5dataset = h5group.createDataSet("Geometry", h5type, h5space);
-  // Create an xy or xyz array
-  // cppcheck-suppress constStatement; justification: cppcheck is scared *const
-  T * const xyz = new T[num_verts * dim];
-  if (dim == 2) {
-    for (size_t i = 0; i < num_verts; ++i) {
-      xyz[2 * i] = mesh.vertices[i][0];
-      xyz[2 * i + 1] = mesh.vertices[i][1];
-    }
-  } else { // dim == 3
-    for (size_t i = 0; i < num_verts; ++i) {
-      xyz[3 * i] = mesh.vertices[i][0];
-      xyz[3 * i + 1] = mesh.vertices[i][1];
-      xyz[3 * i + 2] = mesh.vertices[i][2];
-    }
+  H5::DSetCreatPropList const h5plist =
+      makeH5DSetCreatPropList(2, dims, sizeof(T), options);
+  H5::DataSet const h5dataset =
+      h5group.createDataSet("Geometry", h5type, h5space, h5plist);
+  // Write directly from the vertices. The points are stored as contiguous xyz
+  // triplets, so for a 2D mesh we select the xy columns of an n by 3 memory
+  // space and let HDF5 gather them.
+  static_assert(sizeof(Point3<T>) == 3 * sizeof(T));
+  hsize_t const mem_dims[2] = {static_cast<hsize_t>(num_verts), 3};
+  H5::DataSpace const h5memspace(2, mem_dims);
+  if (dim == 2 && num_verts > 0) {
+    hsize_t const start[2] = {0, 0};
+    h5memspace.selectHyperslab(H5S_SELECT_SET, dims, start);
   }
-  // Write HDF5 data set
-  h5dataset.write(xyz, h5type, h5space);
-  // If xyz is not null, delete it
-  delete[] xyz;
+  h5dataset.write(mesh.vertices.data(), h5type, h5memspace, h5space);
 
 } // writeXDMFgeometry
 
@@ -123,18 +182,18 @@ static void writeXDMFGeometry(pugi::xml_node & xgrid, H5::Group & h5group,
 // writeXDMFTopology
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
   requires(sizeof(T) == 4 || sizeof(T) == 8)
 static void writeXDMFTopology(pugi::xml_node & xgrid, H5::Group & h5group,
                               std::string const & h5filename, std::string const & h5path,
-                              MeshFile<T, I> const & mesh)
+                              MeshFile<T, I, O> const & mesh,
+                              H5WriteOptions const & options)
 {
   LOG_DEBUG("Writing XDMF topology");
   // Create XDMF Topology node
   auto xtopo = xgrid.append_child("Topology");
   size_t const ncells = mesh.numCells();
 
-  std::vector<I> topology;
   std::string topology_type;
   std::string dimensions;
   size_t nverts = 0;
@@ -160,23 +219,6 @@ static void writeXDMFTopology(pugi::xml_node & xgrid, H5::Group & h5group,
     topology_type = "Mixed";
     ishomogeneous = false;
     dimensions = std::to_string(ncells + mesh.element_conn.size());
-    topology.resize(ncells + mesh.element_conn.size());
-    // Create the topology array (type id + node ids)
-    size_t topo_ctr = 0;
-    for (size_t i = 0; i < ncells; ++i) {
-      int8_t const topo_type = meshTypeToXDMFCellType(mesh.element_types[i]);
-      if (topo_type == -1) {
-        Log::error("Unsupported mesh type");
-      }
-      topology[topo_ctr] = static_cast<I>(static_cast<unsigned int>(topo_type));
-      auto const offset = static_cast<size_t>(mesh.element_offsets[i]);
-      auto const npts =
-          static_cast<size_t>(mesh.element_offsets[i + 1] - mesh.element_offsets[i]);
-      for (size_t j = 0; j < npts; ++j) {
-        topology[topo_ctr + j + 1] = mesh.element_conn[offset + j];
-      }
-      topo_ctr += npts + 1;
-    }
   } else {
     Log::error("Unsupported mesh type");
   }
@@ -195,20 +237,56 @@ static void writeXDMFTopology(pugi::xml_node & xgrid, H5::Group & h5group,
   H5::DataType const h5type = getH5DataType<I>();
   if (ishomogeneous) {
     // Create HDF5 data space
-    hsize_t dims[2] = {static_cast<hsize_t>(ncells), nverts};
+    hsize_t const dims[2] = {static_cast<hsize_t>(ncells), nverts};
     H5::DataSpace const h5space(2, dims);
     // Create HDF5 data set
-    H5::DataSet const h5dataset = h5group.createDataSet("Topology", h5type, h5space);
+    H5::DSetCreatPropList const h5plist =
+        makeH5DSetCreatPropList(2, dims, sizeof(I), options);
+    H5::DataSet const h5dataset =
+        h5group.createDataSet("Topology", h5type, h5space, h5plist);
     // Write HDF5 data set
     h5dataset.write(mesh.element_conn.data(), h5type, h5space);
   } else {
     // Create HDF5 data space
-    auto const dims = static_cast<hsize_t>(topology.size());
+    auto const dims = static_cast<hsize_t>(ncells + mesh.element_conn.size());
     H5::DataSpace const h5space(1, &dims);
     // Create HDF5 data set
-    H5::DataSet const h5dataset = h5group.createDataSet("Topology", h5type, h5space);
-    // Write HDF5 data set
-    h5dataset.write(topology.data(), h5type, h5space);
+    H5::DSetCreatPropList const h5plist =
+        makeH5DSetCreatPropList(1, &dims, sizeof(I), options);
+    H5::DataSet const h5dataset =
+        h5group.createDataSet("Topology", h5type, h5space, h5plist);
+    // Write the topology array (type id + node ids) one block at a time, rather
+    // than making a copy of element_conn.
+    size_t const block_size = h5_default_chunk_bytes / sizeof(I);
+    std::vector<I> block;
+    block.reserve(block_size);
+    hsize_t start = 0;
+    auto const write_block = [&]() {
+      auto const count = static_cast<hsize_t>(block.size());
+      H5::DataSpace const h5memspace(1, &count);
+      h5space.selectHyperslab(H5S_SELECT_SET, &count, &start);
+      h5dataset.write(block.data(), h5type, h5memspace, h5space);
+      start += count;
+      block.clear();
+    };
+    for (size_t i = 0; i < ncells; ++i) {
+      int8_t const topo_type = meshTypeToXDMFCellType(mesh.element_types[i]);
+      if (topo_type == -1) {
+        Log::error("Unsupported mesh type");
+      }
+      auto const offset = static_cast<size_t>(mesh.element_offsets[i]);
+      auto const npts =
+          static_cast<size_t>(mesh.element_offsets[i + 1] - mesh.element_offsets[i]);
+      if (block.size() + npts + 1 > block_size) {
+        write_block();
+      }
+      block.push_back(static_cast<I>(static_cast<unsigned int>(topo_type)));
+      I const * const conn = mesh.element_conn.data() + offset;
+      block.insert(block.end(), conn, conn + npts);
+    }
+    if (!block.empty()) {
+      write_block();
+    }
   }
 } // writeXDMFTopology
 
@@ -216,12 +294,13 @@ static void writeXDMFTopology(pugi::xml_node & xgrid, H5::Group & h5group,
 // writeXDMFMaterials
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
   requires(sizeof(T) == 4 || sizeof(T) == 8)
 static void writeXDMFMaterials(pugi::xml_node & xgrid, H5::Group & h5group,
                                std::string const & h5filename, std::string const & h5path,
-                               MeshFile<T, I> const & mesh,
-                               std::vector<std::string> const & material_names)
+                               MeshFile<T, I, O> const & mesh,
+                               std::vector<std::string> const & material_names,
+                               H5WriteOptions const & options)
 {
   LOG_DEBUG("Writing XDMF materials");
   // Create material array
@@ -257,7 +336,10 @@ static void writeXDMFMaterials(pugi::xml_node & xgrid, H5::Group & h5group,
   static_assert(std::signed_integral<MaterialID>);
   H5::DataType const h5type = getH5DataType<MaterialID>();
   // Create HDF5 data set
-  H5::DataSet const h5dataset = h5group.createDataSet("Materials", h5type, h5space);
+  H5::DSetCreatPropList const h5plist =
+      makeH5DSetCreatPropList(1, &dims, sizeof(MaterialID), options);
+  H5::DataSet const h5dataset =
+      h5group.createDataSet("Materials", h5type, h5space, h5plist);
   // Write HDF5 data set
   h5dataset.write(materials.data(), h5type, h5space);
 
@@ -279,11 +361,12 @@ static void writeXDMFMaterials(pugi::xml_node & xgrid, H5::Group & h5group,
 // writeXDMFElsets
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
   requires(sizeof(T) == 4 || sizeof(T) == 8)
 static void writeXDMFElsets(pugi::xml_node & xgrid, H5::Group & h5group,
                             std::string const & h5filename, std::string const & h5path,
-                            MeshFile<T, I> const & mesh)
+                            MeshFile<T, I, O> const & mesh,
+                            H5WriteOptions const & options)
 {
   LOG_DEBUG("Writing XDMF elsets");
   for (size_t i = 0; i < mesh.elset_names.size(); ++i) {
@@ -291,12 +374,14 @@ static void writeXDMFElsets(pugi::xml_node & xgrid, H5::Group & h5group,
     auto const start = static_cast<size_t>(mesh.elset_offsets[i]);
     auto const end = static_cast<size_t>(mesh.elset_offsets[i + 1]);
     // Create HDF5 data space
-    auto dims = static_cast<hsize_t>(end - start);
+    auto const dims = static_cast<hsize_t>(end - start);
     H5::DataSpace const h5space(1, &dims);
     // Create HDF5 data type
     H5::DataType const h5type = getH5DataType<I>();
     // Create HDF5 data set
-    H5::DataSet const h5dataset = h5group.createDataSet(name, h5type, h5space);
+    H5::DSetCreatPropList const h5plist =
+        makeH5DSetCreatPropList(1, &dims, sizeof(I), options);
+    H5::DataSet const h5dataset = h5group.createDataSet(name, h5type, h5space, h5plist);
     // Write HDF5 data set.
     h5dataset.write(&mesh.elset_ids[start], h5type, h5space);
 
@@ -323,12 +408,13 @@ static void writeXDMFElsets(pugi::xml_node & xgrid, H5::Group & h5group,
 // writeXDMFUniformGrid
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 static void
 writeXDMFUniformGrid(pugi::xml_node & xdomain, H5::H5File & h5file,
                      std::string const & h5filename, std::string const & h5path,
-                     MeshFile<T, I> const & mesh,
-                     std::vector<std::string> const & material_names)
+                     MeshFile<T, I, O> const & mesh,
+                     std::vector<std::string> const & material_names,
+                     H5WriteOptions const & options = {})
 {
   LOG_DEBUG("Writing XDMF uniform grid");
 
@@ -352,19 +438,20 @@ writeXDMFUniformGrid(pugi::xml_node & xdomain, H5::H5File & h5file,
   std::string const h5grouppath = h5path + "/" + name;
   H5::Group h5group = h5file.createGroup(h5grouppath);
 
-  writeXDMFGeometry(xgrid, h5group, h5filename, h5grouppath, mesh);
-  writeXDMFTopology(xgrid, h5group, h5filename, h5grouppath, mesh);
-  writeXDMFMaterials(xgrid, h5group, h5filename, h5grouppath, mesh, material_names);
-  writeXDMFElsets(xgrid, h5group, h5filename, h5grouppath, mesh);
+  writeXDMFGeometry(xgrid, h5group, h5filename, h5grouppath, mesh, options);
+  writeXDMFTopology(xgrid, h5group, h5filename, h5grouppath, mesh, options);
+  writeXDMFMaterials(xgrid, h5group, h5filename, h5grouppath, mesh, material_names,
+                     options);
+  writeXDMFElsets(xgrid, h5group, h5filename, h5grouppath, mesh, options);
 } // writeXDMFUniformGrid
 
 //==============================================================================
 // writeXDMFFile
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 void
-writeXDMFFile(MeshFile<T, I> & mesh)
+writeXDMFFile(MeshFile<T, I, O> & mesh, H5WriteOptions const & options = {})
 {
 
   // If format is Abaqus, convert to XDMF
@@ -437,7 +524,8 @@ writeXDMFFile(MeshFile<T, I> & mesh)
 
   // Add the mesh as a uniform grid
   std::string const h5path;
-  writeXDMFUniformGrid(xdomain, h5file, h5filename, h5path, mesh, material_names);
+  writeXDMFUniformGrid(xdomain, h5file, h5filename, h5path, mesh, material_names,
+                       options);
 
   // Write the XML file
   xdoc.save_file(mesh.filepath.c_str(), "  ");
@@ -447,47 +535,14 @@ writeXDMFFile(MeshFile<T, I> & mesh)
 
 } // writeXDMFfile
 
-//==============================================================================
-// addNodesToMesh
-//==============================================================================
-
-template <std::floating_point T, std::signed_integral I, std::floating_point V>
-static void
-addNodesToMesh(MeshFile<T, I> & mesh, size_t const num_verts, size_t const num_dimensions,
-               H5::DataSet const & dataset, H5::FloatType const & datatype,
-               bool const xyz)
-{
-  V * data = new V[num_verts * num_dimensions];
-  dataset.read(data, datatype);
-  size_t const num_verts_old = mesh.vertices.size();
-  mesh.vertices.reserve(num_verts_old + num_verts);
-  // Add the nodes to the mesh
-  if (xyz) {
-    for (size_t i = 0; i < num_verts; ++i) {
-      T const x = static_cast<T>(data[i * 3]);
-      T const y = static_cast<T>(data[i * 3 + 1]);
-      T const z = static_cast<T>(data[i * 3 + 2]);
-      mesh.vertices.emplace_back(x, y, z);
-    }
-  } else { // XY
-    for (size_t i = 0; i < num_verts; ++i) {
-      T const x = static_cast<T>(data[i * 2]);
-      T const y = static_cast<T>(data[i * 2 + 1]);
-      T const z = 0;
-      mesh.vertices.emplace_back(x, y, z);
-    }
-  }
-  delete[] data;
-} // addNodesToMesh
-
 //==============================================================================
 // readXDMFGeometry
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
   requires(sizeof(T) == 4 || sizeof(T) == 8)
 static void readXDMFGeometry(pugi::xml_node const & xgrid, H5::H5File const & h5file,
-                             std::string const & h5filename, MeshFile<T, I> & mesh)
+                             std::string const & h5filename, MeshFile<T, I, O> & mesh)
 {
   LOG_DEBUG("Reading XDMF geometry");
   pugi::xml_node const xgeometry = xgrid.child("Geometry");
@@ -546,11 +601,9 @@ static void readXDMFGeometry(pugi::xml_node const & xgrid, H5::H5File const & h5
   H5T_class_t const type_class = dataset.getTypeClass();
   assert(type_class == H5T_FLOAT);
 #endif
-  H5::FloatType const datatype = dataset.getFloatType();
-  size_t const datatype_size = datatype.getSize();
-#ifndef NDEBUG
-  assert(datatype_size == std::stoul(precision));
   H5::DataSpace const dataspace = dataset.getSpace();
+#ifndef NDEBUG
+  assert(dataset.getFloatType().getSize() == std::stoul(precision));
   int const rank = dataspace.getSimpleExtentNdims();
   assert(rank == 2);
   hsize_t dims[2];
@@ -559,58 +612,113 @@ static void readXDMFGeometry(pugi::xml_node const & xgrid, H5::H5File const & h5
   assert(dims[0] == num_verts);
   assert(dims[1] == num_dimensions);
 #endif
-  if (datatype_size == 4) {
-    addNodesToMesh<T, I, float>(mesh, num_verts, num_dimensions, dataset, datatype,
-                                geometry_type == "XYZ");
-  } else if (datatype_size == 8) {
-    addNodesToMesh<T, I, double>(mesh, num_verts, num_dimensions, dataset, datatype,
-                                 geometry_type == "XYZ");
+  // Read directly into the vertices, as writeXDMFGeometry writes from them, with
+  // HDF5 converting the coordinates to T. For an XY mesh, select the xy columns
+  // of an n by 3 memory space.
+  static_assert(sizeof(Point3<T>) == 3 * sizeof(T));
+  size_t const num_verts_old = mesh.vertices.size();
+  mesh.vertices.resize(num_verts_old + num_verts);
+  if (num_verts == 0) {
+    return;
+  }
+  hsize_t const file_dims[2] = {static_cast<hsize_t>(num_verts), num_dimensions};
+  hsize_t const mem_dims[2] = {static_cast<hsize_t>(num_verts), 3};
+  H5::DataSpace const h5memspace(2, mem_dims);
+  hsize_t const start[2] = {0, 0};
+  h5memspace.selectHyperslab(H5S_SELECT_SET, file_dims, start);
+  dataset.read(mesh.vertices.data() + num_verts_old, getH5DataType<T>(), h5memspace,
+               dataspace);
+  if (num_dimensions == 2) {
+    for (size_t i = num_verts_old; i < mesh.vertices.size(); ++i) {
+      mesh.vertices[i][2] = 0;
+    }
   }
 }
 
 //==============================================================================
 // addElementsToMesh
 //==============================================================================
+// HDF5 converts the vertex ids to I as they are read, so they are read directly
+// into element_conn, or one block at a time for a mixed topology, rather than
+// through a copy of the whole topology.
 
-template <std::floating_point T, std::signed_integral I, std::signed_integral V>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 static void
 addElementsToMesh(size_t const num_elements, std::string const & topology_type,
-                  std::string const & dimensions, MeshFile<T, I> & mesh,
-                  H5::DataSet const & dataset, H5::IntType const & datatype)
+                  std::string const & dimensions, MeshFile<T, I, O> & mesh,
+                  H5::DataSet const & dataset)
 {
+  H5::DataType const h5type = getH5DataType<I>();
   size_t const prev_num_elements = mesh.element_types.size();
+  size_t const prev_conn_size = mesh.element_conn.size();
   if (prev_num_elements == 0) {
     mesh.element_offsets.push_back(0);
   }
-  I const prev_offset = mesh.element_offsets.back();
-  mesh.element_offsets.insert(mesh.element_offsets.end(), num_elements, -1);
+  O const prev_offset = mesh.element_offsets.back();
   if (topology_type == "Mixed") {
-    mesh.element_types.insert(mesh.element_types.end(), num_elements, MeshType::None);
     // Expect dims to be one number
     auto const conn_length = sto<size_t>(dimensions);
-    V * data = new V[conn_length];
-    dataset.read(data, datatype);
-    // Add the elements to the mesh
-    size_t const prev_conn_size = mesh.element_conn.size();
+    if (conn_length < num_elements) {
+      Log::error("Mismatch in number of elements");
+      return;
+    }
     size_t const num_conn_added = conn_length - num_elements;
+    if (!offsetFits<O>(prev_conn_size + num_conn_added)) {
+      Log::error("The element offsets overflow. Use a wider offset type");
+      return;
+    }
+    mesh.element_types.insert(mesh.element_types.end(), num_elements, MeshType::None);
+    mesh.element_offsets.insert(mesh.element_offsets.end(), num_elements, -1);
     mesh.element_conn.insert(mesh.element_conn.end(), num_conn_added, -1);
-    size_t offset = 0;
-    size_t position = 0;
-    for (size_t i = 0; i < num_elements; ++i) {
-      auto const element_type = static_cast<int8_t>(data[position]);
-      MeshType const mesh_type = xdmfCellTypeToMeshType(element_type);
-      mesh.element_types[prev_num_elements + i] = mesh_type;
-      auto const npoints = static_cast<size_t>(verticesPerCell(mesh_type));
-      for (size_t j = 0; j < npoints; ++j) {
-        mesh.element_conn[prev_conn_size + offset + j] =
-            static_cast<I>(static_cast<unsigned int>(data[position + j + 1]));
+    H5::DataSpace const h5space = dataset.getSpace();
+    size_t const block_size = h5_default_chunk_bytes / sizeof(I);
+    std::vector<I> block(block_size);
+    size_t filled = 0; // Entries of block read from the file
+    hsize_t start = 0; // Entries of the file read
+    size_t offset = 0; // Entries of element_conn added
+    size_t i = 0;
+    while (i < num_elements) {
+      auto const count = static_cast<hsize_t>(
+          std::min(block_size - filled, conn_length - static_cast<size_t>(start)));
+      if (count == 0) {
+        Log::error("Mismatch in number of elements");
+        return;
       }
-      offset += npoints;
-      position += npoints + 1;
-      mesh.element_offsets[1 + prev_num_elements + i] =
-          prev_offset + static_cast<I>(offset);
+      H5::DataSpace const h5memspace(1, &count);
+      h5space.selectHyperslab(H5S_SELECT_SET, &count, &start);
+      dataset.read(block.data() + filled, h5type, h5memspace, h5space);
+      filled += count;
+      start += count;
+      // Add the elements that are entirely in the block
+      size_t position = 0;
+      while (i < num_elements && position < filled) {
+        auto const element_type = static_cast<int8_t>(block[position]);
+        MeshType const mesh_type = xdmfCellTypeToMeshType(element_type);
+        if (mesh_type == MeshType::None) {
+          Log::error("Unsupported element type");
+          return;
+        }
+        auto const npoints = static_cast<size_t>(verticesPerCell(mesh_type));
+        if (position + npoints + 1 > filled) {
+          break;
+        }
+        if (offset + npoints > num_conn_added) {
+          Log::error("Mismatch in number of elements");
+          return;
+        }
+        mesh.element_types[prev_num_elements + i] = mesh_type;
+        std::copy(block.data() + position + 1, block.data() + position + npoints + 1,
+                  mesh.element_conn.data() + prev_conn_size + offset);
+        offset += npoints;
+        position += npoints + 1;
+        mesh.element_offsets[1 + prev_num_elements + i] =
+            prev_offset + static_cast<O>(offset);
+        ++i;
+      }
+      // Move the start of the next element to the front of the block
+      std::copy(block.data() + position, block.data() + filled, block.data());
+      filled -= position;
     }
-    delete[] data;
   } else {
     size_t const split = dimensions.find_last_of(' ');
     auto const ncells = sto<size_t>(dimensions.substr(0, split));
@@ -619,19 +727,17 @@ addElementsToMesh(size_t const num_elements, std::string const & topology_type,
       Log::error("Mismatch in number of elements");
       return;
     }
-    V * data = new V[ncells * nverts];
-    dataset.read(data, datatype);
-    // Add the elements to the mesh
-    size_t const prev_conn_size = mesh.element_conn.size();
-    mesh.element_conn.reserve(prev_conn_size + ncells * nverts);
+    if (!offsetFits<O>(prev_conn_size + ncells * nverts)) {
+      Log::error("The element offsets overflow. Use a wider offset type");
+      return;
+    }
+    mesh.element_conn.resize(prev_conn_size + ncells * nverts);
+    dataset.read(mesh.element_conn.data() + prev_conn_size, h5type);
+    mesh.element_offsets.resize(1 + prev_num_elements + ncells);
     for (size_t i = 0; i < ncells; ++i) {
       mesh.element_offsets[1 + prev_num_elements + i] =
-          static_cast<I>((i + 1U) * nverts) + prev_offset;
-      for (size_t j = 0; j < nverts; ++j) {
-        mesh.element_conn.emplace_back(static_cast<I>(data[i * nverts + j]));
-      }
+          static_cast<O>((i + 1U) * nverts) + prev_offset;
     }
-    delete[] data;
     MeshType mesh_type = MeshType::None;
     if (topology_type == "Triangle") {
       mesh_type = MeshType::Tri;
@@ -652,10 +758,10 @@ addElementsToMesh(size_t const num_elements, std::string const & topology_type,
 // readXDMFTopology
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
   requires(sizeof(T) == 4 || sizeof(T) == 8)
 static void readXDMFTopology(pugi::xml_node const & xgrid, H5::H5File const & h5file,
-                             std::string const & h5filename, MeshFile<T, I> & mesh)
+                             std::string const & h5filename, MeshFile<T, I, O> & mesh)
 {
   LOG_DEBUG("Reading XDMF topology");
   pugi::xml_node const xtopology = xgrid.child("Topology");
@@ -699,10 +805,8 @@ static void readXDMFTopology(pugi::xml_node const & xgrid, H5::H5File const & h5
   H5T_class_t const type_class = dataset.getTypeClass();
   assert(type_class == H5T_INTEGER);
 #endif
-  H5::IntType const datatype = dataset.getIntType();
-  size_t const datatype_size = datatype.getSize();
 #ifndef NDEBUG
-  assert(datatype_size == std::stoul(precision));
+  assert(dataset.getIntType().getSize() == std::stoul(precision));
   H5::DataSpace const dataspace = dataset.getSpace();
   int const rank = dataspace.getSimpleExtentNdims();
   if (topology_type == "Mixed") {
@@ -719,51 +823,34 @@ static void readXDMFTopology(pugi::xml_node const & xgrid, H5::H5File const & h5
 #endif
   // Get the dimensions
   std::string const dimensions = xdataitem.attribute("Dimensions").value();
-  if (datatype_size == 1) {
-    addElementsToMesh<T, I, int8_t>(num_elements, topology_type, dimensions, mesh,
-                                    dataset, datatype);
-  } else if (datatype_size == 2) {
-    addElementsToMesh<T, I, int16_t>(num_elements, topology_type, dimensions, mesh,
-                                     dataset, datatype);
-  } else if (datatype_size == 4) {
-    addElementsToMesh<T, I, int32_t>(num_elements, topology_type, dimensions, mesh,
-                                     dataset, datatype);
-  } else if (datatype_size == 8) {
-    addElementsToMesh<T, I, int64_t>(num_elements, topology_type, dimensions, mesh,
-                                     dataset, datatype);
-  } else {
-    Log::error("Unsupported data type size");
-  }
+  addElementsToMesh(num_elements, topology_type, dimensions, mesh, dataset);
 }
 
 //==============================================================================
 // addElsetToMesh
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I, std::signed_integral V>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 static void
-addElsetToMesh(MeshFile<T, I> & mesh, size_t const num_elements,
-               H5::DataSet const & dataset, H5::IntType const & datatype)
+addElsetToMesh(MeshFile<T, I, O> & mesh, size_t const num_elements,
+               H5::DataSet const & dataset)
 {
-  V * data = new V[num_elements];
-  dataset.read(data, datatype);
-  I const last_offset = mesh.elset_offsets.back();
-  mesh.elset_offsets.push_back(last_offset + static_cast<I>(num_elements));
-  mesh.elset_ids.reserve(mesh.elset_ids.size() + num_elements);
-  for (size_t i = 0; i < num_elements; ++i) {
-    mesh.elset_ids.emplace_back(static_cast<I>(data[i]));
-  }
-  delete[] data;
+  O const last_offset = mesh.elset_offsets.back();
+  mesh.elset_offsets.push_back(last_offset + static_cast<O>(num_elements));
+  // HDF5 converts the ids to I as they are read
+  size_t const prev_num_ids = mesh.elset_ids.size();
+  mesh.elset_ids.resize(prev_num_ids + num_elements);
+  dataset.read(mesh.elset_ids.data() + prev_num_ids, getH5DataType<I>());
 }
 
 //==============================================================================
 // readXDMFElsets
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
   requires(sizeof(T) == 4 || sizeof(T) == 8)
 static void readXDMFElsets(pugi::xml_node const & xgrid, H5::H5File const & h5file,
-                           std::string const & h5filename, MeshFile<T, I> & mesh)
+                           std::string const & h5filename, MeshFile<T, I, O> & mesh)
 {
   LOG_DEBUG("Reading XDMF elsets");
   // Loop over all nodes to find the elsets
@@ -817,9 +904,7 @@ static void readXDMFElsets(pugi::xml_node const & xgrid, H5::H5File const & h5fi
     H5T_class_t const type_class = dataset.getTypeClass();
     assert(type_class == H5T_INTEGER);
 #endif
-    H5::IntType const datatype = dataset.getIntType();
-    size_t const datatype_size = datatype.getSize();
-    assert(datatype_size == std::stoul(precision));
+    assert(dataset.getIntType().getSize() == std::stoul(precision));
     H5::DataSpace const dataspace = dataset.getSpace();
 #ifndef NDEBUG
     int const rank = dataspace.getSimpleExtentNdims();
@@ -836,19 +921,15 @@ static void readXDMFElsets(pugi::xml_node const & xgrid, H5::H5File const & h5fi
     std::string const dimensions = xdataitem.attribute("Dimensions").value();
     size_t const num_elements = dims[0];
     assert(num_elements == std::stoul(dimensions));
+    if (!offsetFits<O>(mesh.elset_ids.size() + num_elements)) {
+      Log::error("The elset offsets overflow. Use a wider offset type");
+      return;
+    }
     mesh.elset_names.push_back(name);
     if (mesh.elset_offsets.empty()) {
       mesh.elset_offsets.push_back(0);
     }
-    if (datatype_size == 1) {
-      addElsetToMesh<T, I, int8_t>(mesh, num_elements, dataset, datatype);
-    } else if (datatype_size == 2) {
-      addElsetToMesh<T, I, int16_t>(mesh, num_elements, dataset, datatype);
-    } else if (datatype_size == 4) {
-      addElsetToMesh<T, I, int32_t>(mesh, num_elements, dataset, datatype);
-    } else if (datatype_size == 8) {
-      addElsetToMesh<T, I, int64_t>(mesh, num_elements, dataset, datatype);
-    }
+    addElsetToMesh(mesh, num_elements, dataset);
   }
 }
 
@@ -856,12 +937,12 @@ static void readXDMFElsets(pugi::xml_node const & xgrid, H5::H5File const & h5fi
 // readXDMFUniformGrid
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
   requires(sizeof(T) == 4 || sizeof(T) == 8)
 void readXDMFUniformGrid(pugi::xml_node const & xgrid, H5::H5File const & h5file,
                          std::string const & h5filename,
                          //    std::vector<std::string> const & material_names,
-                         MeshFile<T, I> & mesh)
+                         MeshFile<T, I, O> & mesh)
 {
   readXDMFGeometry(xgrid, h5file, h5filename, mesh);
   readXDMFTopology(xgrid, h5file, h5filename, mesh);
@@ -872,9 +953,9 @@ void readXDMFUniformGrid(pugi::xml_node const & xgrid, H5::H5File const & h5file
 // readXDMFFile
 //==============================================================================
 
-template <std::floating_point T, std::signed_integral I>
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
 void
-readXDMFFile(std::string const & filename, MeshFile<T, I> & mesh)
+readXDMFFile(std::string const & filename, MeshFile<T, I, O> & mesh)
 {
   Log::info("Reading XDMF mesh file: " + filename);
 
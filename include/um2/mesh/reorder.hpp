@@ -0,0 +1,205 @@
+#pragma once
+
+#include <um2/common/permutation.hpp>
+#include <um2/geometry/AxisAlignedBox.hpp>
+#include <um2/geometry/hilbert_sort_points.hpp>
+#include <um2/geometry/morton_sort_points.hpp>
+#include <um2/stdlib/Vector.hpp>
+
+#include <algorithm> // std::stable_sort, std::reverse
+#include <numeric>   // std::iota
+#include <type_traits>
+
+namespace um2
+{
+
+//==============================================================================
+// MESH ORDERING
+//==============================================================================
+// Mesh generators number vertices and faces in an order which has little to do
+// with where they are, so getFace(i) gathers vertices from all over memory. A
+// mesh may be reordered so that vertices and faces which are close in space are
+// close in memory:
+//  - Morton, Hilbert: Vertices are sorted along a space-filling curve through
+//    their positions, and faces along the curve through their centroids.
+//  - RCM: Vertices are put in reverse Cuthill-McKee order of the graph whose
+//    edges join the vertices of each face, which reduces the spread of the
+//    vertex indices of a face. Faces are sorted by their smallest vertex index.
+//
+// The reorder methods of the meshes return the face permutation perm, such that
+// new face i is old face perm[i], so that per-face data may follow with
+// applyPermutation.
+
+enum class MeshOrdering : int8_t {
+  None = 0,
+  Morton = 1,
+  Hilbert = 2,
+  RCM = 3,
+};
+
+//==============================================================================
+// curveOrder
+//==============================================================================
+// Return the permutation which sorts the points along the curve of ordering,
+// after scaling their bounding box to the unit square or cube.
+
+template <Size D, std::floating_point T>
+auto
+curveOrder(Vector<Point<D, T>> const & points, MeshOrdering const ordering)
+    -> Vector<Size>
+{
+  assert(ordering == MeshOrdering::Morton || ordering == MeshOrdering::Hilbert);
+  Size const n = points.size();
+  Vector<Size> perm(n);
+  if (n == 0) {
+    return perm;
+  }
+  auto const box = boundingBox(points);
+  Vector<Point<D, T>> normalized(n);
+  for (Size i = 0; i < n; ++i) {
+    for (Size d = 0; d < D; ++d) {
+      T const extent = box.maxima[d] - box.minima[d];
+      T const x = extent > 0 ? (points[i][d] - box.minima[d]) / extent : 0;
+      normalized[i][d] = um2::clamp(x, static_cast<T>(0), static_cast<T>(1));
+    }
+  }
+  using U = std::conditional_t<std::same_as<T, float>, uint32_t, uint64_t>;
+  if (ordering == MeshOrdering::Morton) {
+    mortonSortPermutation<U>(normalized.cbegin(), normalized.cend(), perm.begin());
+  } else {
+    hilbertSortPermutation<U>(normalized.cbegin(), normalized.cend(), perm.begin());
+  }
+  return perm;
+}
+
+//==============================================================================
+// rcmOrder
+//==============================================================================
+// Return the reverse Cuthill-McKee order of the graph whose vertex i has the
+// neighbors adj[offsets[i]], ..., adj[offsets[i + 1] - 1]. Each connected
+// component is started from a vertex of minimum degree.
+
+template <std::signed_integral I>
+auto
+rcmOrder(Vector<I> const & offsets, Vector<I> const & adj) -> Vector<Size>
+{
+  Size const n = offsets.size() - 1;
+  auto const degree = [&offsets](Size const i) {
+    return static_cast<Size>(offsets[i + 1] - offsets[i]);
+  };
+  auto const lessDegree = [&degree](Size const i, Size const j) {
+    return degree(i) < degree(j);
+  };
+  Vector<Size> by_degree(n);
+  std::iota(by_degree.begin(), by_degree.end(), 0);
+  std::stable_sort(by_degree.begin(), by_degree.end(), lessDegree);
+
+  // order is also the queue of the breadth-first search
+  Vector<Size> order(n);
+  Vector<int8_t> visited(n, 0);
+  Size head = 0;
+  Size tail = 0;
+  for (Size const start : by_degree) {
+    if (visited[start] == 1) {
+      continue;
+    }
+    visited[start] = 1;
+    order[tail++] = start;
+    while (head < tail) {
+      Size const v = order[head++];
+      Size const first = tail;
+      for (auto k = static_cast<Size>(offsets[v]); k < static_cast<Size>(offsets[v + 1]);
+           ++k) {
+        auto const u = static_cast<Size>(adj[k]);
+        if (visited[u] == 0) {
+          visited[u] = 1;
+          order[tail++] = u;
+        }
+      }
+      // Visit the new neighbors in order of increasing degree
+      std::stable_sort(order.begin() + first, order.begin() + tail, lessDegree);
+    }
+  }
+  std::reverse(order.begin(), order.end());
+  return order;
+}
+
+//==============================================================================
+// meshOrder
+//==============================================================================
+// Compute the vertex and face permutations which put a mesh in the given order.
+// forEachFaceVertex(i, f) must call f(v) for each vertex index v of face i, and
+// vf_offsets and vf must be the vertex-face connectivity of the mesh.
+
+template <Size D, std::floating_point T, std::signed_integral I, class F>
+void
+meshOrder(Vector<Point<D, T>> const & vertices, Size const num_faces,
+          Vector<I> const & vf_offsets, Vector<I> const & vf, F const & forEachFaceVertex,
+          MeshOrdering const ordering, Vector<Size> & vertex_perm,
+          Vector<Size> & face_perm)
+{
+  Size const num_vertices = vertices.size();
+  if (ordering == MeshOrdering::None) {
+    vertex_perm.resize(num_vertices);
+    std::iota(vertex_perm.begin(), vertex_perm.end(), 0);
+    face_perm.resize(num_faces);
+    std::iota(face_perm.begin(), face_perm.end(), 0);
+    return;
+  }
+
+  if (ordering == MeshOrdering::Morton || ordering == MeshOrdering::Hilbert) {
+    vertex_perm = curveOrder(vertices, ordering);
+    Vector<Point<D, T>> centroids(num_faces);
+    for (Size i = 0; i < num_faces; ++i) {
+      auto c = Point<D, T>::zero();
+      Size n = 0;
+      forEachFaceVertex(i, [&](auto const v) {
+        c += vertices[static_cast<Size>(v)];
+        ++n;
+      });
+      centroids[i] = c / static_cast<T>(n);
+    }
+    face_perm = curveOrder(centroids, ordering);
+    return;
+  }
+
+  assert(ordering == MeshOrdering::RCM);
+  assert(vf_offsets.size() == num_vertices + 1);
+  // The vertex graph, from the faces of each vertex
+  Vector<I> offsets(num_vertices + 1);
+  Vector<I> adj;
+  Vector<Size> last_seen(num_vertices, -1);
+  offsets[0] = 0;
+  for (Size v = 0; v < num_vertices; ++v) {
+    last_seen[v] = v;
+    for (auto k = static_cast<Size>(vf_offsets[v]); k < static_cast<Size>(vf_offsets[v + 1]);
+         ++k) {
+      forEachFaceVertex(static_cast<Size>(vf[k]), [&](auto const u) {
+        if (last_seen[static_cast<Size>(u)] != v) {
+          last_seen[static_cast<Size>(u)] = v;
+          adj.push_back(u);
+        }
+      });
+    }
+    offsets[v + 1] = static_cast<I>(adj.size());
+  }
+  vertex_perm = rcmOrder(offsets, adj);
+
+  // Sort the faces by their smallest new vertex index
+  Vector<uint32_t> new_index(num_vertices);
+  for (Size i = 0; i < num_vertices; ++i) {
+    new_index[vertex_perm[i]] = static_cast<uint32_t>(i);
+  }
+  Vector<uint32_t> keys(num_faces);
+  for (Size i = 0; i < num_faces; ++i) {
+    uint32_t key = static_cast<uint32_t>(num_vertices);
+    forEachFaceVertex(i, [&](auto const v) {
+      key = um2::min(key, new_index[static_cast<Size>(v)]);
+    });
+    keys[i] = key;
+  }
+  face_perm.resize(num_faces);
+  radixSortPermutation(keys.begin(), keys.end(), face_perm.begin());
+}
+
+} // namespace um2
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <um2/mesh/FaceVertexMesh.hpp>
+#include <um2/mesh/MixedFaceVertexMesh.hpp>
+#include <um2/stdlib/algorithm.hpp> // insertionSort
+
+#include <concepts>
+#include <type_traits>
+
+namespace um2
+{
+
+//==============================================================================
+// MIXED-PRECISION TRACING
+//==============================================================================
+// The mesh of a coarse cell is local: importCoarseCells moves the bottom left
+// corner of its bounding box to the origin, so its coordinates are no larger
+// than the cell. float holds them to about 1e-7 of the size of the cell, which
+// is enough to intersect rays with the faces. The position of the cell in the
+// core and the sums of segment lengths over many rays are not small, and need
+// double.
+//
+// addTrackLengths(mesh, ray, lengths) traces ray through mesh in the precision
+// of the mesh, and adds the length of the ray inside face i to lengths[i]. The
+// lengths may be of a wider type than the mesh. A float face that a ray hits an
+// odd number of times, which happens when the ray passes through a vertex, is
+// traced again in double.
+//
+// addTrackLengths(mesh, origin, ray, lengths) takes the ray in double, in the
+// coordinates of the core, and the position of the origin of the mesh in the
+// core. It moves the origin of the ray to the point of the ray closest to the
+// center of the mesh, in double, before converting the ray to the precision of
+// the mesh, so that the distances the mesh computes are no larger than the mesh.
+// Tracing a float mesh this way is nearly as accurate as tracing a double mesh,
+// while tracing a float mesh in the coordinates of the core is not. See
+// benchmarks/mesh/mixed_precision_tracing.cpp.
+//
+// The direction of the ray must be a unit vector.
+
+//==============================================================================
+// convertPrecision
+//==============================================================================
+// A copy of mesh, or face, with vertices of floating point type U.
+
+template <std::floating_point U, Size P, Size N, Size D, std::floating_point T,
+          std::signed_integral I>
+auto
+convertPrecision(FaceVertexMesh<P, N, D, T, I> const & mesh)
+    -> FaceVertexMesh<P, N, D, U, I>
+{
+  if constexpr (std::same_as<T, U>) {
+    return mesh;
+  } else {
+    FaceVertexMesh<P, N, D, U, I> result;
+    result.vertices.resize(mesh.numVertices());
+    for (Size i = 0; i < mesh.numVertices(); ++i) {
+      for (Size d = 0; d < D; ++d) {
+        result.vertices[i][d] = static_cast<U>(mesh.vertices[i][d]);
+      }
+    }
+    result.fv = mesh.fv;
+    result.vf_offsets = mesh.vf_offsets;
+    result.vf = mesh.vf;
+    return result;
+  }
+}
+
+template <std::floating_point U, Size P, Size D, std::floating_point T,
+          std::signed_integral I>
+auto
+convertPrecision(MixedFaceVertexMesh<P, D, T, I> const & mesh)
+    -> MixedFaceVertexMesh<P, D, U, I>
+{
+  if constexpr (std::same_as<T, U>) {
+    return mesh;
+  } else {
+    MixedFaceVertexMesh<P, D, U, I> result;
+    result.vertices.resize(mesh.numVertices());
+    for (Size i = 0; i < mesh.numVertices(); ++i) {
+      for (Size d = 0; d < D; ++d) {
+        result.vertices[i][d] = static_cast<U>(mesh.vertices[i][d]);
+      }
+    }
+    result.fv_offsets = mesh.fv_offsets;
+    result.fv = mesh.fv;
+    result.vf_offsets = mesh.vf_offsets;
+    result.vf = mesh.vf;
+    return result;
+  }
+}
+
+template <std::floating_point U, Size P, Size N, std::floating_point T>
+PURE HOSTDEV constexpr auto
+convertPrecision(Polygon<P, N, 2, T> const & face) noexcept -> Polygon<P, N, 2, U>
+{
+  Polygon<P, N, 2, U> result;
+  for (Size i = 0; i < N; ++i) {
+    result[i] = Point2<U>(static_cast<U>(face[i][0]), static_cast<U>(face[i][1]));
+  }
+  return result;
+}
+
+//==============================================================================
+// addTrackLength
+//==============================================================================
+// Adds the length of ray inside face to length.
+
+template <Size P, Size N, std::floating_point T, std::floating_point A>
+HOSTDEV constexpr void
+addTrackLength(Polygon<P, N, 2, T> const & face, Ray2<T> const & ray, A & length) noexcept
+{
+  static_assert(sizeof(T) <= sizeof(A), "length must be at least as wide as the face");
+  T constexpr r_miss = infiniteDistance<T>();
+  auto r = face.intersect(ray);
+  um2::insertionSort(r.begin(), r.end());
+  Size n = 0;
+  while (n < r.size() && r[n] < r_miss) {
+    ++n;
+  }
+  if constexpr (!std::same_as<T, double>) {
+    // The intersection of a ray through a vertex with each edge of the vertex
+    // is rounded differently, and in float both may miss. Trace the face again
+    // in double.
+    if (n % 2 == 1) {
+      Ray2<double> const ray_d(
+          Point2<double>(static_cast<double>(ray.o[0]), static_cast<double>(ray.o[1])),
+          Vec2<double>(static_cast<double>(ray.d[0]), static_cast<double>(ray.d[1])));
+      double l = 0;
+      addTrackLength(convertPrecision<double>(face), ray_d, l);
+      if constexpr (std::same_as<A, double>) {
+        length += l;
+      } else {
+        length += static_cast<A>(l);
+      }
+      return;
+    }
+  }
+  if (n == 2) {
+    A const l = r[1] - r[0];
+    length += l;
+    return;
+  }
+  // A ray through a vertex may hit both edges of the vertex, at nearly but not
+  // exactly the same distance, and a ray may cross a quadratic edge twice. Add
+  // the pieces of the ray between consecutive intersections whose midpoint is in
+  // the face.
+  for (Size j = 0; j + 1 < n; ++j) {
+    if (face.contains(ray((r[j] + r[j + 1]) / 2))) {
+      A const l = r[j + 1] - r[j];
+      length += l;
+    }
+  }
+}
+
+//==============================================================================
+// addTrackLengths
+//==============================================================================
+
+template <class Mesh, std::floating_point T, std::floating_point A>
+void
+addTrackLengths(Mesh const & mesh, Ray2<T> const & ray, A * const lengths) noexcept
+{
+  for (Size i = 0; i < mesh.numFaces(); ++i) {
+    mesh.visitFace(i, [&ray, lengths, i](auto const & face) {
+      addTrackLength(face, ray, lengths[i]);
+    });
+  }
+}
+
+template <class Mesh, std::floating_point A>
+void
+addTrackLengths(Mesh const & mesh, Point2<double> const & origin,
+                Ray2<double> const & ray, A * const lengths) noexcept
+{
+  using T = std::remove_cvref_t<decltype(mesh.vertices[0][0])>;
+  AxisAlignedBox2<T> const box = mesh.boundingBox();
+  Point2<T> const center_t = box.centroid();
+  Point2<double> center;
+  for (Size d = 0; d < 2; ++d) {
+    double const c = center_t[d];
+    center[d] = origin[d] + c;
+  }
+  // The point of the ray closest to the center of the mesh, relative to origin
+  double const t0 = (center - ray.o).dot(ray.d);
+  Point2<double> o;
+  for (Size d = 0; d < 2; ++d) {
+    o[d] = ray.o[d] + t0 * ray.d[d] - origin[d];
+  }
+  if constexpr (std::same_as<T, double>) {
+    addTrackLengths(mesh, Ray2<double>(o, ray.d), lengths);
+  } else {
+    Ray2<T> const local_ray(Point2<T>(static_cast<T>(o[0]), static_cast<T>(o[1])),
+                            Vec2<T>(static_cast<T>(ray.d[0]), static_cast<T>(ray.d[1])));
+    addTrackLengths(mesh, local_ray, lengths);
+  }
+}
+
+} // namespace um2
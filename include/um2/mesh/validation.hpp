@@ -0,0 +1,180 @@
+#pragma once
+
+#include <um2/common/Log.hpp>
+#include <um2/common/permutation.hpp>
+#include <um2/geometry/AxisAlignedBox.hpp>
+#include <um2/geometry/morton_sort_points.hpp>
+#include <um2/parallel/common/permutation.hpp>
+#include <um2/stdlib/Vector.hpp>
+
+#include <algorithm> // std::sort
+#include <string>
+#include <type_traits>
+
+namespace um2
+{
+
+//==============================================================================
+// MESH VALIDATION
+//==============================================================================
+// validateMesh checks every face of a mesh in parallel and returns, for each
+// kind of problem, the number of faces (or vertices) found and the first few of
+// them. It logs one warning per kind of problem found, rather than one per
+// face, so that a bad mesh with millions of flipped faces does not flood the
+// log.
+
+struct MeshIssue {
+
+  // The number of ids kept
+  static constexpr Size max_ids = 8;
+
+  // The number of faces or vertices with the issue
+  Size count = 0;
+
+  // min(count, max_ids) of them, in increasing order. For faces, these are the
+  // first ones.
+  Vector<Size> ids;
+
+  // Log "<count> <description>: <ids>", if count > 0.
+  void
+  log(std::string const & description) const
+  {
+    if (count == 0) {
+      return;
+    }
+    std::string msg = std::to_string(count) + " " + description + ": ";
+    for (Size i = 0; i < ids.size(); ++i) {
+      msg += (i == 0 ? "" : ", ") + std::to_string(ids[i]);
+    }
+    if (count > ids.size()) {
+      msg += ", ...";
+    }
+    Log::warn(msg);
+  }
+};
+
+struct MeshValidation {
+  // Faces with vertices in clockwise order. They are flipped.
+  MeshIssue clockwise_faces;
+  // Linear quadrilaterals which are not convex
+  MeshIssue nonconvex_faces;
+  // Vertices which are effectively equal to another vertex. Only checked in
+  // debug builds.
+  MeshIssue duplicate_vertices;
+};
+
+// Below this many faces (or vertices), the checks run serially, which is faster
+// than starting an OpenMP region.
+inline constexpr Size min_parallel_checks = 1 << 12;
+
+//==============================================================================
+// findMeshIssue
+//==============================================================================
+// Return the i in [0, n) for which isBad(i) is true. isBad is called once for
+// each i, in parallel with OpenMP, and may modify face (or vertex) i only.
+// Each thread checks a contiguous chunk of [0, n) in order and keeps the first
+// max_ids ids of its chunk, so the first ids overall are found without a flag
+// per face.
+
+template <class F>
+auto
+findMeshIssue(Size const n, F const & isBad) -> MeshIssue
+{
+#if UM2_USE_OPENMP
+  Size const max_threads = omp_get_max_threads();
+#else
+  Size const max_threads = 1;
+#endif
+  Vector<Size> counts(max_threads, 0);
+  Vector<Size> first_ids(max_threads * MeshIssue::max_ids);
+#if UM2_USE_OPENMP
+#  pragma omp parallel if (n >= min_parallel_checks)
+#endif
+  {
+#if UM2_USE_OPENMP
+    Size const nthreads = omp_get_num_threads();
+    Size const t = omp_get_thread_num();
+#else
+    Size const nthreads = 1;
+    Size const t = 0;
+#endif
+    auto const first = static_cast<Size>(static_cast<int64_t>(t) * n / nthreads);
+    auto const last = static_cast<Size>(static_cast<int64_t>(t + 1) * n / nthreads);
+    Size * const ids = first_ids.data() + t * MeshIssue::max_ids;
+    Size count = 0;
+    for (Size i = first; i < last; ++i) {
+      if (isBad(i)) {
+        if (count < MeshIssue::max_ids) {
+          ids[count] = i;
+        }
+        ++count;
+      }
+    }
+    counts[t] = count;
+  }
+  MeshIssue issue;
+  for (Size t = 0; t < max_threads; ++t) {
+    issue.count += counts[t];
+    for (Size k = 0; k < um2::min(counts[t], MeshIssue::max_ids); ++k) {
+      if (issue.ids.size() < MeshIssue::max_ids) {
+        issue.ids.push_back(first_ids[t * MeshIssue::max_ids + k]);
+      }
+    }
+  }
+  return issue;
+}
+
+//==============================================================================
+// findDuplicateVertices
+//==============================================================================
+// Vertices which are effectively equal are likely, though not certain, to be
+// next to each other in Morton order. Rather than sorting a copy of the
+// vertices, only their Morton codes are sorted. A vertex is reported if it is
+// effectively equal to the previous vertex in Morton order, and the ids kept
+// are those of the first such vertices in Morton order.
+
+template <Size D, std::floating_point T>
+auto
+findDuplicateVertices(Vector<Point<D, T>> const & vertices) -> MeshIssue
+{
+  Size const n = vertices.size();
+  if (n < 2) {
+    return {};
+  }
+  auto const box = boundingBox(vertices);
+  Vec<D, T> scale;
+  for (Size d = 0; d < D; ++d) {
+    T const extent = box.maxima[d] - box.minima[d];
+    scale[d] = extent > 0 ? static_cast<T>(1) / extent : static_cast<T>(0);
+  }
+  using U = std::conditional_t<std::same_as<T, float>, uint32_t, uint64_t>;
+  Vector<U> keys(n);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for if (n >= min_parallel_checks)
+#endif
+  for (Size i = 0; i < n; ++i) {
+    Point<D, T> p = vertices[i];
+    for (Size d = 0; d < D; ++d) {
+      p[d] = um2::clamp((p[d] - box.minima[d]) * scale[d], static_cast<T>(0),
+                        static_cast<T>(1));
+    }
+    keys[i] = mortonEncode<U>(p);
+  }
+  Vector<Size> perm(n);
+#if UM2_USE_TBB
+  parallel::radixSortPermutation(keys.begin(), keys.end(), perm.begin());
+#else
+  radixSortPermutation(keys.begin(), keys.end(), perm.begin());
+#endif
+  MeshIssue issue = findMeshIssue(n - 1, [&vertices, &perm](Size const k) {
+    return isApprox(vertices[perm[k]], vertices[perm[k + 1]]);
+  });
+  // Report the vertices themselves, rather than their positions in Morton order
+  for (auto & id : issue.ids) {
+    id = perm[id + 1];
+  }
+  std::sort(issue.ids.begin(), issue.ids.end());
+  return issue;
+}
+
+} // namespace um2
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <um2/geometry/Point.hpp>
+#include <um2/stdlib/Vector.hpp>
+
+#include <cmath>   // std::floor
+#include <utility> // std::swap
+
+namespace um2
+{
+
+//==============================================================================
+// VERTEX WELDING
+//==============================================================================
+// Meshes exported by gmsh, or stitched together from several meshes, often have
+// several vertices at the same position. Welding merges them into one.
+//
+// Two vertices are coincident if they are closer than the tolerance, and
+// vertices are merged with every vertex they are coincident with, directly or
+// through a chain of coincident vertices. Each group of merged vertices keeps
+// the position of its vertex with the smallest index, and the vertices which
+// are kept keep their order.
+//
+// Coincident vertices are found with a uniform grid of cells 4 times the size
+// of the tolerance, stored in a hash table. A vertex is compared with the
+// vertices of its own cell and, along the axes where it is within the tolerance
+// of a side of its cell, of the cells on those sides. Cells are centered on the
+// multiples of their size, so that the usual round coordinates are in the
+// middle of their cell. A vertex then looks up (3/2)^D cells on average, and
+// only its own at round coordinates, rather than 3^D cells, each of which is
+// likely a cache miss in a large mesh. Building the grid is a serial O(n) pass.
+// Finding the coincident vertices, grouping them and renumbering are done in
+// parallel with OpenMP.
+
+//==============================================================================
+// weldVertices
+//==============================================================================
+// Weld the vertices in [begin, end), moving the vertices which are kept to the
+// front of the range. Set new_index[i] to the index of old vertex i after
+// welding, and return the number of vertices merged into another vertex.
+
+template <Size D, std::floating_point T>
+auto
+weldVertices(Point<D, T> * const begin, Point<D, T> * const end, T const tolerance,
+             Size * const new_index) -> Size
+{
+  assert(tolerance > 0);
+  auto const n = static_cast<Size>(end - begin);
+  if (n == 0) {
+    return 0;
+  }
+  // Cell coordinates are computed in double, so that float coordinates much
+  // larger than the tolerance still map to the right cell.
+  double const inv_cell_size = 1 / (4 * static_cast<double>(tolerance));
+  T const tolerance_squared = tolerance * tolerance;
+  using Cell = Vec<D, int64_t>;
+  auto const cellCoord = [inv_cell_size](T const x) {
+    return static_cast<double>(x) * inv_cell_size + 0.5;
+  };
+  auto const cellOf = [&cellCoord](Point<D, T> const & p) {
+    Cell cell;
+    for (Size d = 0; d < D; ++d) {
+      cell[d] = static_cast<int64_t>(std::floor(cellCoord(p[d])));
+    }
+    return cell;
+  };
+
+  // -- Grid --
+  // An open addressing hash table of the non-empty cells. Slots store the hash
+  // of their cell rather than the cell, so that a probe touches one cache line.
+  // Cells with the same hash share a slot, which only costs a few more distance
+  // tests. The vertices of the cell(s) in slot s are slots[s].first,
+  // next[slots[s].first], ... until -1.
+  struct Slot {
+    uint64_t key;
+    Size first;
+  };
+  Size capacity = 1;
+  while (capacity < 2 * n) {
+    capacity *= 2;
+  }
+  auto const mask = static_cast<uint64_t>(capacity - 1);
+  Vector<Slot> slots(capacity, Slot{0, -1});
+  Vector<Size> next(n, -1);
+  auto const hash = [](Cell const & cell) {
+    // Multiply by large primes, and mix with the finalizer of splitmix64
+    uint64_t constexpr primes[3] = {73856093, 19349663, 83492791};
+    uint64_t h = 0;
+    for (Size d = 0; d < D; ++d) {
+      h ^= static_cast<uint64_t>(cell[d]) * primes[d];
+    }
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+  };
+  // Return the slot of the cell, or of the empty slot where it would go
+  auto const findSlot = [&](Cell const & cell) {
+    uint64_t const key = hash(cell);
+    auto s = static_cast<Size>(key & mask);
+    while (slots[s].first != -1 && slots[s].key != key) {
+      s = static_cast<Size>((static_cast<uint64_t>(s) + 1) & mask);
+    }
+    return s;
+  };
+  // Insert in reverse, so that each cell lists its vertices in increasing order
+  for (Size i = n - 1; i >= 0; --i) {
+    auto const cell = cellOf(begin[i]);
+    Size const s = findSlot(cell);
+    slots[s].key = hash(cell);
+    next[i] = slots[s].first;
+    slots[s].first = i;
+  }
+
+  // -- Coincident vertices --
+  // Call f(j) for each vertex j != i coincident with vertex i.
+  auto const forEachCoincident = [&](Size const i, auto const & f) {
+    auto const cell = cellOf(begin[i]);
+    // The m axes along which the vertex is within the tolerance of a side of
+    // its cell, and the direction of that side
+    Vec<D, Size> axes;
+    Cell sides;
+    Size m = 0;
+    for (Size d = 0; d < D; ++d) {
+      double const x = cellCoord(begin[i][d]) - static_cast<double>(cell[d]);
+      if (x < 0.25 || x > 0.75) {
+        axes[m] = d;
+        sides[m] = x < 0.25 ? -1 : 1;
+        ++m;
+      }
+    }
+    for (Size k = 0; k < (1 << m); ++k) {
+      Cell neighbor = cell;
+      for (Size a = 0; a < m; ++a) {
+        if ((k >> a & 1) == 1) {
+          neighbor[axes[a]] += sides[a];
+        }
+      }
+      Size const s = findSlot(neighbor);
+      for (Size j = slots[s].first; j != -1; j = next[j]) {
+        if (j != i && begin[i].squaredDistanceTo(begin[j]) < tolerance_squared) {
+          f(j);
+        }
+      }
+    }
+  };
+  // The coincident vertices of each vertex, in compressed rows. Each thread
+  // searches a contiguous chunk of the vertices into its own buffer, and the
+  // buffers are concatenated in thread order, so the grid is searched once.
+#if UM2_USE_OPENMP
+  Size const max_threads = omp_get_max_threads();
+#else
+  Size const max_threads = 1;
+#endif
+  Vector<Size> offsets(n + 1);
+  Vector<Vector<Size>> buffers(max_threads);
+  Vector<Size> chunk_firsts(max_threads + 1, n);
+  offsets[0] = 0;
+#if UM2_USE_OPENMP
+#  pragma omp parallel
+#endif
+  {
+#if UM2_USE_OPENMP
+    Size const nthreads = omp_get_num_threads();
+    Size const t = omp_get_thread_num();
+#else
+    Size const nthreads = 1;
+    Size const t = 0;
+#endif
+    auto const first = static_cast<Size>(static_cast<int64_t>(t) * n / nthreads);
+    auto const last = static_cast<Size>(static_cast<int64_t>(t + 1) * n / nthreads);
+    chunk_firsts[t] = first;
+    Vector<Size> & buffer = buffers[t];
+    for (Size i = first; i < last; ++i) {
+      Size const size = buffer.size();
+      forEachCoincident(i, [&buffer](Size const j) { buffer.push_back(j); });
+      offsets[i + 1] = buffer.size() - size;
+    }
+  }
+  for (Size i = 0; i < n; ++i) {
+    offsets[i + 1] += offsets[i];
+  }
+  Vector<Size> coincident(offsets[n]);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Size t = 0; t < max_threads; ++t) {
+    Size const first = offsets[chunk_firsts[t]];
+    for (Size k = 0; k < buffers[t].size(); ++k) {
+      coincident[first + k] = buffers[t][k];
+    }
+  }
+
+  // -- Groups --
+  // Label each vertex with the smallest index of its group, by replacing each
+  // label with the smallest label of the coincident vertices until no label
+  // changes. Groups are usually a few vertices across, so this takes a few
+  // rounds.
+  Vector<Size> labels(n);
+  Vector<Size> new_labels(n);
+  for (Size i = 0; i < n; ++i) {
+    labels[i] = i;
+  }
+  bool changed = offsets[n] > 0;
+  while (changed) {
+    changed = false;
+#if UM2_USE_OPENMP
+#  pragma omp parallel for reduction(|| : changed)
+#endif
+    for (Size i = 0; i < n; ++i) {
+      Size label = labels[i];
+      for (Size k = offsets[i]; k < offsets[i + 1]; ++k) {
+        label = um2::min(label, labels[coincident[k]]);
+      }
+      new_labels[i] = label;
+      changed = changed || label != labels[i];
+    }
+    std::swap(labels, new_labels);
+  }
+
+  // -- Renumbering --
+  // The vertices which are kept are those which are their own label.
+  Size num_kept = 0;
+  for (Size i = 0; i < n; ++i) {
+    if (labels[i] == i) {
+      new_index[i] = num_kept;
+      begin[num_kept] = begin[i];
+      ++num_kept;
+    }
+  }
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Size i = 0; i < n; ++i) {
+    if (labels[i] != i) {
+      new_index[i] = new_index[labels[i]];
+    }
+  }
+  return n - num_kept;
+}
+
+} // namespace um2
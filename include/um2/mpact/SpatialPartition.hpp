@@ -1,12 +1,14 @@
 #pragma once
 
 #include <um2/mesh/FaceVertexMesh.hpp>
+#include <um2/mesh/MixedFaceVertexMesh.hpp>
 #include <um2/mesh/RectilinearPartition.hpp>
 #include <um2/mesh/RegularPartition.hpp>
 #include <um2/mesh/io.hpp>
 #include <um2/physics/Material.hpp>
 
 #include <iomanip>
+#include <memory>
 #include <string>
 
 namespace um2::mpact
@@ -90,10 +92,24 @@ struct SpatialPartition {
 
   Vector<Material> materials;
 
+  // The order in which importCoarseCells renumbers the vertices and faces of
+  // each fine mesh, so that neighboring faces are close in memory. The material
+  // IDs of the coarse cell follow the faces. See MeshOrdering.
+  MeshOrdering mesh_ordering = MeshOrdering::None;
+
+  // If set, the buffers of the fine meshes are in this arena instead of on the
+  // heap, so that the many small buffers of the meshes live in a few contiguous
+  // slabs, in the order the meshes were made. Set it with useMeshArena before
+  // making or importing meshes. The slabs are kept until the last mesh buffer
+  // in them is freed, so a mesh may outlive the model.
+  std::shared_ptr<Arena> mesh_arena;
+
   Vector<TriMesh<2, Float, Int>> tri;
   Vector<QuadMesh<2, Float, Int>> quad;
+  Vector<TriQuadMesh<2, Float, Int>> tri_quad;
   Vector<QuadraticTriMesh<2, Float, Int>> quadratic_tri;
   Vector<QuadraticQuadMesh<2, Float, Int>> quadratic_quad;
+  Vector<QuadraticTriQuadMesh<2, Float, Int>> quadratic_tri_quad;
 
   // -----------------------------------------------------------------------------
   // Constructors
@@ -129,11 +145,162 @@ struct SpatialPartition {
     return assemblies.size();
   }
 
+  // -----------------------------------------------------------------------------
+  // Mesh dispatch
+  // -----------------------------------------------------------------------------
+  // The fine meshes are stored in one array per mesh type. The functions below
+  // are the only place the mesh type is switched on. Callers pass a generic
+  // callable, which is instantiated once per mesh type, so that work over many
+  // meshes of the same type is a single loop over a concrete mesh type.
+  //
+  // f must return the same type for every mesh type. If mesh_type is not a fine
+  // mesh type, or mesh_id is not a loaded mesh of that type, an error is logged
+  // and a value-initialized result is returned.
+
+// Whether these functions are pure depends on f
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wsuggest-attribute=pure"
+#endif
+
+private:
+  // Self is SpatialPartition or SpatialPartition const.
+  template <class Self, class F>
+  static auto
+  visitMeshesImpl(Self & self, MeshType const mesh_type, F && f) -> decltype(f(self.tri))
+  {
+    switch (mesh_type) {
+    case MeshType::Tri:
+      return f(self.tri);
+    case MeshType::Quad:
+      return f(self.quad);
+    case MeshType::TriQuad:
+      return f(self.tri_quad);
+    case MeshType::QuadraticTri:
+      return f(self.quadratic_tri);
+    case MeshType::QuadraticQuad:
+      return f(self.quadratic_quad);
+    case MeshType::QuadraticTriQuad:
+      return f(self.quadratic_tri_quad);
+    default:
+      break;
+    }
+    Log::error("Invalid mesh type: " + std::to_string(static_cast<int>(mesh_type)));
+    using R = decltype(f(self.tri));
+    if constexpr (!std::is_void_v<R>) {
+      return R{};
+    }
+  }
+
+  template <class Self, class F>
+  static auto
+  visitMeshImpl(Self & self, MeshType const mesh_type, Size const mesh_id, F && f)
+      -> decltype(f(self.tri[0]))
+  {
+    using R = decltype(f(self.tri[0]));
+    return visitMeshesImpl(self, mesh_type, [mesh_id, &f](auto & meshes) -> R {
+      // Coarse cells read without their meshes have mesh_id == -1
+      if (0 <= mesh_id && mesh_id < meshes.size()) {
+        return f(meshes[mesh_id]);
+      }
+      Log::error("Mesh " + std::to_string(mesh_id) + " is not loaded");
+      if constexpr (!std::is_void_v<R>) {
+        return R{};
+      }
+    });
+  }
+
+  // The order is the order of the meshes in a snapshot. Do not change it.
+  template <class Self, class F>
+  static constexpr void
+  forEachMeshesImpl(Self & self, F && f)
+  {
+    f(self.tri);
+    f(self.quad);
+    f(self.quadratic_tri);
+    f(self.quadratic_quad);
+    f(self.tri_quad);
+    f(self.quadratic_tri_quad);
+  }
+
+public:
+  // Call f with the array of meshes of type mesh_type.
+  template <class F>
+  auto
+  visitMeshes(MeshType mesh_type, F && f)
+  {
+    return visitMeshesImpl(*this, mesh_type, f);
+  }
+
+  template <class F>
+  auto
+  visitMeshes(MeshType mesh_type, F && f) const
+  {
+    return visitMeshesImpl(*this, mesh_type, f);
+  }
+
+  // Call f with mesh mesh_id of type mesh_type.
+  template <class F>
+  auto
+  visitMesh(MeshType mesh_type, Size mesh_id, F && f)
+  {
+    return visitMeshImpl(*this, mesh_type, mesh_id, f);
+  }
+
+  template <class F>
+  auto
+  visitMesh(MeshType mesh_type, Size mesh_id, F && f) const
+  {
+    return visitMeshImpl(*this, mesh_type, mesh_id, f);
+  }
+
+  // Whether the fine mesh of coarse cell cc_id is loaded. Coarse cells read
+  // without their meshes, e.g. outside the assemblies given to importSubdomain,
+  // have none until loadCoarseCellMeshes.
+  [[nodiscard]] auto
+  hasCoarseCellMesh(Size cc_id) const -> bool
+  {
+    CoarseCell const & cc = coarse_cells[cc_id];
+    if (cc.mesh_type == MeshType::None || cc.mesh_id < 0) {
+      return false;
+    }
+    return cc.mesh_id < visitMeshes(cc.mesh_type,
+                                    [](auto const & meshes) { return meshes.size(); });
+  }
+
+  // Call f with the fine mesh of coarse cell cc_id.
+  template <class F>
+  auto
+  visitCoarseCellMesh(Size cc_id, F && f) const
+  {
+    CoarseCell const & cc = coarse_cells[cc_id];
+    return visitMesh(cc.mesh_type, cc.mesh_id, f);
+  }
+
+  // Call f with the array of meshes of each type, in a fixed order.
+  template <class F>
+  constexpr void
+  forEachMeshes(F && f)
+  {
+    forEachMeshesImpl(*this, f);
+  }
+
+  template <class F>
+  constexpr void
+  forEachMeshes(F && f) const
+  {
+    forEachMeshesImpl(*this, f);
+  }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic pop
+#endif
+
   // -----------------------------------------------------------------------------
   // Methods
   // -----------------------------------------------------------------------------
 
-  HOSTDEV constexpr void
+  void
   clear() noexcept
   {
     core.clear();
@@ -142,51 +309,87 @@ struct SpatialPartition {
     rtms.clear();
     coarse_cells.clear();
 
-    tri.clear();
-    quad.clear();
-    quadratic_tri.clear();
-    quadratic_quad.clear();
+    // Free the mesh arrays too, so that the slabs of the arena can be returned
+    forEachMeshes([](auto & meshes) { meshes = std::remove_cvref_t<decltype(meshes)>(); });
+    if (mesh_arena) {
+      // Copies of the model may share the arena, so start a new one instead of
+      // releasing it.
+      mesh_arena = std::make_shared<Arena>(mesh_arena->slabSize());
+    }
+  }
+
+  // Fill the face geometry cache of every fine mesh (see FaceGeometry), rather
+  // than on the first query of each mesh. The caches take about 56 bytes per
+  // face, so neither importing nor reading a model fills them.
+  void
+  computeFaceGeometry() const
+  {
+    forEachMeshes([](auto const & meshes) {
+      for (auto const & mesh : meshes) {
+        static_cast<void>(mesh.faceGeometry());
+      }
+    });
+  }
+
+  // Allocate the fine meshes made or imported from now on from a new arena,
+  // with slabs of slab_size bytes. See mesh_arena. Has no effect if the model
+  // already has an arena, since its meshes may be in it.
+  void
+  useMeshArena(size_t slab_size = Arena::default_slab_size)
+  {
+    if (mesh_arena) {
+      Log::warn("The model already has a mesh arena");
+      return;
+    }
+    mesh_arena = std::make_shared<Arena>(slab_size);
+  }
+
+  // Copy the buffers of mesh into the mesh arena, if the model has one. Meshes
+  // are built on the heap and then moved, so that the temporary buffers of their
+  // construction do not take up space between them in the arena.
+  template <class Mesh>
+  void
+  moveToMeshArena(Mesh & mesh) const
+  {
+    if (mesh_arena) {
+      ArenaScope const scope(mesh_arena.get());
+      Mesh copy = mesh;
+      mesh = um2::move(copy);
+    }
   }
 
   inline void
   checkMeshExists(MeshType mesh_type, Size mesh_id) const
   {
-    switch (mesh_type) {
-    case MeshType::Tri:
-      if (0 > mesh_id || mesh_id >= this->tri.size()) {
-        Log::error("Tri mesh " + std::to_string(mesh_id) + " does not exist");
-      }
-      break;
-    case MeshType::Quad:
-      if (0 > mesh_id || mesh_id >= this->quad.size()) {
-        Log::error("Quad mesh " + std::to_string(mesh_id) + " does not exist");
-      }
-      break;
-    case MeshType::QuadraticTri:
-      if (0 > mesh_id || mesh_id >= this->quadratic_tri.size()) {
-        Log::error("Quadratic tri mesh " + std::to_string(mesh_id) + " does not exist");
-      }
-      break;
-    case MeshType::QuadraticQuad:
-      if (0 > mesh_id || mesh_id >= this->quadratic_quad.size()) {
-        Log::error("Quadratic quad mesh " + std::to_string(mesh_id) + " does not exist");
-      }
-      break;
-    default:
-      Log::error("Invalid mesh type");
+    Size const num_meshes = visitMeshes(mesh_type, [](auto const & meshes) -> Size {
+      return meshes.size();
+    });
+    if (0 > mesh_id || mesh_id >= num_meshes) {
+      Log::error("Mesh " + std::to_string(mesh_id) + " of type " +
+                 std::to_string(static_cast<int>(mesh_type)) + " does not exist");
     }
   }
 
-  //    int make_cylindrical_pin_mesh(std::vector<double> const & radii,
-  //                                  double const pitch,
-  //                                  std::vector<int> const & num_rings,
-  //                                  int const num_azimuthal,
-  //                                  int const mesh_order = 1);
-  //
-  //    int make_rectangular_pin_mesh(Vec2<Float> const dxdy,
-  //                                  int const nx,
-  //                                  int const ny);
-  //
+  // Make a structured mesh of a square pin cell of width pitch, with circular
+  // regions of the given radii. Region i is divided into num_rings[i]
+  // equal-area rings and every ring into num_azimuthal faces, which must be a
+  // power of 2 and at least 8. The ring areas are preserved exactly.
+  // mesh_order = 1 makes a QuadMesh, mesh_order = 2 a QuadraticQuadMesh.
+  // Faces are ordered ring by ring, from the center outward, followed by the
+  // faces outside the last radius. The innermost ring has num_azimuthal / 2
+  // faces and every other ring has num_azimuthal faces, so there are
+  // num_azimuthal / 2 + num_azimuthal * sum(num_rings) faces.
+  // Returns the index of the mesh in quad or quadratic_quad, or -1 on error.
+  auto
+  makeCylindricalPinMesh(std::vector<Float> const & radii, Float pitch,
+                         std::vector<Size> const & num_rings, Size num_azimuthal,
+                         Size mesh_order = 1) -> Size;
+
+  // Make a uniform nx by ny quadrilateral mesh of a dxdy rectangle.
+  // Returns the index of the mesh in quad.
+  auto
+  makeRectangularPinMesh(Vec2<Float> dxdy, Size nx, Size ny) -> Size;
+
   auto
   makeCoarseCell(Vec2<Float> dxdy, MeshType mesh_type = MeshType::None, Size mesh_id = -1,
                  Vector<MaterialID> const & material_ids = {}) -> Size;
@@ -204,8 +407,18 @@ struct SpatialPartition {
   auto
   makeCore(std::vector<std::vector<Size>> const & asy_ids) -> Size;
 
+  // If cc_representatives is given, only the representative coarse cells are read
+  // from the mesh. Every other coarse cell shares the mesh of its representative,
+  // e.g. with representatives from um2::gmsh::model::occ::getUniqueCoarseCells.
+  void
+  importCoarseCells(std::string const & filename,
+                    std::vector<Size> const & cc_representatives = {});
+
+  // Import the coarse cell meshes from a mesh that is already in memory, e.g.
+  // from um2::gmsh::model::mesh::getMeshFile.
   void
-  importCoarseCells(std::string const & filename);
+  importCoarseCells(MeshFile<Float, Int> const & mesh_file,
+                    std::vector<Size> const & cc_representatives = {});
 
 }; // struct SpatialPartition
 
@@ -7,12 +7,58 @@ namespace um2
 {
 
 void
-writeXDMFFile(std::string const & path, mpact::SpatialPartition const & model);
+writeXDMFFile(std::string const & path, mpact::SpatialPartition const & model,
+              H5WriteOptions const & h5options = {});
 
+// Write a versioned binary snapshot of the entire model: the hierarchy, the
+// coarse cells, the materials, and the meshes. Snapshots are meant for fast
+// restarts on the same machine and build configuration, not for archival.
 void
-exportMesh(std::string const & path, mpact::SpatialPartition const & model);
+writeSnapshotFile(std::string const & path, mpact::SpatialPartition const & model);
 
+// Exports .xdmf files with writeXDMFFile and .um2 files with writeSnapshotFile.
 void
-importMesh(std::string const & path, mpact::SpatialPartition & model);
+exportMesh(std::string const & path, mpact::SpatialPartition const & model,
+           H5WriteOptions const & h5options = {});
+
+// Import a model from an XDMF file.
+// If load_meshes is false, only the hierarchy, the materials, and the size and
+// mesh type of each coarse cell are read. The fine meshes are left unloaded
+// (mesh_id == -1 and no material IDs) until loadCoarseCellMeshes is called.
+void
+readXDMFFile(std::string const & path, mpact::SpatialPartition & model,
+             bool load_meshes = true);
+
+// Read a snapshot written by writeSnapshotFile. The whole file is read at once
+// and no per-element parsing is done.
+void
+readSnapshotFile(std::string const & path, mpact::SpatialPartition & model);
+
+// Imports .xdmf files with readXDMFFile and .um2 files with readSnapshotFile.
+// Snapshots always include the meshes, so load_meshes is ignored for them.
+void
+importMesh(std::string const & path, mpact::SpatialPartition & model,
+           bool load_meshes = true);
+
+// Read the fine meshes and material IDs of the coarse cells cc_ids from the
+// XDMF file that the model was imported from. Cells whose meshes are already
+// loaded are skipped.
+void
+loadCoarseCellMeshes(std::string const & path, mpact::SpatialPartition & model,
+                     std::vector<Size> const & cc_ids);
+
+// Import a model for a spatially decomposed run. The entire hierarchy is read,
+// but only the fine meshes of the coarse cells in the assemblies at the given
+// (x, y) positions in the core are loaded. The remaining coarse cells are left
+// unloaded, as with importMesh(path, model, false). Only XDMF files are
+// supported, since snapshots cannot be read in part.
+void
+importSubdomain(std::string const & path, mpact::SpatialPartition & model,
+                std::vector<Vec2<Size>> const & asy_positions);
+
+// Same as above, for the assemblies at positions lo <= (x, y) < hi.
+void
+importSubdomain(std::string const & path, mpact::SpatialPartition & model,
+                Vec2<Size> const & lo, Vec2<Size> const & hi);
 
 } // namespace um2
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <um2/common/permutation.hpp>
+
+#include <algorithm>
+#include <thread>
+
+#if UM2_USE_TBB
+#  include <execution>
+#endif
+
+namespace um2::parallel
+{
+
+#if UM2_USE_TBB
+
+//==============================================================================
+// Radix sort
+//==============================================================================
+// Parallel version of um2::radixSortPermutation. The keys are split into one
+// contiguous chunk per thread. In each pass, every chunk counts its digits,
+// the offsets are laid out digit by digit and chunk by chunk, and every chunk
+// scatters its keys. Since the chunks are in order, the sort stays stable.
+
+template <std::unsigned_integral U>
+void
+radixSortPermutation(U * const begin, U * const end, Size * const perm_begin) noexcept
+{
+  auto const n = static_cast<Size>(end - begin);
+  Size const num_threads = static_cast<Size>(std::thread::hardware_concurrency());
+  // Below this many keys per thread, the passes are too short to share.
+  Size constexpr min_chunk_size = 1 << 14;
+  if (num_threads < 2 || n < 2 * min_chunk_size) {
+    um2::radixSortPermutation(begin, end, perm_begin);
+    return;
+  }
+  Size constexpr radix = 256;
+  Size constexpr num_passes = sizeof(U);
+  Size const num_chunks = um2::min(num_threads, n / min_chunk_size);
+  Size const chunk_size = (n + num_chunks - 1) / num_chunks;
+  Vector<Size> chunks(num_chunks);
+  std::iota(chunks.begin(), chunks.end(), 0);
+  std::iota(perm_begin, perm_begin + n, 0);
+
+  Vector<Size> offsets(num_chunks * radix);
+  Vector<U> keys_tmp(n);
+  Vector<Size> perm_tmp(n);
+  U * keys_in = begin;
+  U * keys_out = keys_tmp.data();
+  Size * perm_in = perm_begin;
+  Size * perm_out = perm_tmp.data();
+  for (Size pass = 0; pass < num_passes; ++pass) {
+    Size const shift = 8 * pass;
+    std::for_each(std::execution::par, chunks.cbegin(), chunks.cend(), [&](Size const c) {
+      Size * const count = offsets.data() + c * radix;
+      std::fill(count, count + radix, 0);
+      Size const last = um2::min((c + 1) * chunk_size, n);
+      for (Size i = c * chunk_size; i < last; ++i) {
+        ++count[static_cast<Size>((keys_in[i] >> shift) & 0xFF)];
+      }
+    });
+    bool skip = false;
+    Size total = 0;
+    for (Size d = 0; d < radix; ++d) {
+      Size digit_total = 0;
+      for (Size c = 0; c < num_chunks; ++c) {
+        Size const count = offsets[c * radix + d];
+        offsets[c * radix + d] = total;
+        total += count;
+        digit_total += count;
+      }
+      skip = skip || digit_total == n;
+    }
+    if (skip) {
+      continue;
+    }
+    std::for_each(std::execution::par, chunks.cbegin(), chunks.cend(), [&](Size const c) {
+      Size * const offset = offsets.data() + c * radix;
+      Size const last = um2::min((c + 1) * chunk_size, n);
+      for (Size i = c * chunk_size; i < last; ++i) {
+        auto const d = static_cast<Size>((keys_in[i] >> shift) & 0xFF);
+        Size const j = offset[d]++;
+        keys_out[j] = keys_in[i];
+        perm_out[j] = perm_in[i];
+      }
+    });
+    std::swap(keys_in, keys_out);
+    std::swap(perm_in, perm_out);
+  }
+  if (keys_in != begin) {
+    std::copy(std::execution::par_unseq, keys_in, keys_in + n, begin);
+    std::copy(std::execution::par_unseq, perm_in, perm_in + n, perm_begin);
+  }
+}
+
+#endif // UM2_USE_TBB
+
+} // namespace um2::parallel
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <um2/geometry/morton_sort_points.hpp>
+#include <um2/parallel/common/permutation.hpp>
 
 #if UM2_USE_TBB
 #  include <execution>
@@ -14,11 +15,31 @@ namespace um2::parallel
 {
 
 #if UM2_USE_TBB
+// Parallel versions of um2::mortonSortPermutation and um2::mortonSort.
+
+template <std::unsigned_integral U, Size D, std::floating_point T>
+void
+mortonSortPermutation(Point<D, T> const * const begin, Point<D, T> const * const end,
+                      Size * const perm_begin)
+{
+  auto const n = static_cast<Size>(end - begin);
+  Vector<U> keys(n);
+  std::transform(std::execution::par_unseq, begin, end, keys.begin(),
+                 [](Point<D, T> const & p) { return mortonEncode<U>(p); });
+  um2::parallel::radixSortPermutation(keys.begin(), keys.end(), perm_begin);
+}
+
 template <std::unsigned_integral U, Size D, std::floating_point T>
 void
 mortonSort(Point<D, T> * const begin, Point<D, T> * const end)
 {
-  std::sort(std::execution::par_unseq, begin, end, mortonLess<U, D, T>);
+  auto const n = static_cast<Size>(end - begin);
+  Vector<Size> perm(n);
+  um2::parallel::mortonSortPermutation<U>(begin, end, perm.begin());
+  Vector<Point<D, T>> sorted(n);
+  std::transform(std::execution::par_unseq, perm.cbegin(), perm.cend(), sorted.begin(),
+                 [begin](Size const i) { return begin[i]; });
+  std::copy(std::execution::par_unseq, sorted.cbegin(), sorted.cend(), begin);
 }
 #endif
 
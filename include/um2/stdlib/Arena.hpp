@@ -0,0 +1,376 @@
+#pragma once
+
+#include <um2/config.hpp>
+
+#include <array>   // std::array
+#include <atomic>  // std::atomic
+#include <cstddef> // std::byte, std::max_align_t
+#include <cstdint> // uintptr_t
+#include <mutex>   // std::mutex, std::lock_guard
+#include <new>     // ::operator new, ::operator delete, std::align_val_t
+
+namespace um2
+{
+
+//==============================================================================
+// ARENA
+//==============================================================================
+// A bump allocator for the buffers of many small Vectors, for use in host code
+// only.
+//
+// Memory is handed out from large slabs. Allocating is a pointer increment and
+// freeing an individual buffer only decrements a count, so constructing and
+// destroying many small vectors is cheap, and vectors allocated one after
+// another are adjacent in memory. The price is that a buffer which is freed, or
+// left behind when a vector grows, is not reused. The slabs are returned to the
+// system once the arena is destroyed and all of its buffers are freed, so a
+// vector may outlive the arena that its buffer came from.
+//
+// A Vector allocates from the arena of the innermost ArenaScope on its thread,
+// or from the heap if there is none. Slabs are aligned to arena_granule bytes
+// and recorded in a table of granules, so that freeing a buffer finds its arena
+// from the buffer's address alone. Vector itself holds no arena state. While
+// no ArenaScope is active, an allocation costs Vector one extra atomic load,
+// and while no arena has slabs, so does a free.
+//
+// Allocation is thread-safe, so an arena may be shared by the ArenaScopes of
+// several threads.
+
+// The alignment of slabs, and the unit of their size.
+inline constexpr size_t arena_granule = size_t{1} << 20; // 1 MiB
+
+// The arena is neither copyable nor movable, since vectors point into it.
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions) justified
+class Arena
+{
+
+  // Each slab starts with a header, which links it to the previous slab.
+  struct SlabHeader {
+    SlabHeader * prev;
+    size_t size; // Including the header
+  };
+
+  // The slabs, which outlive the Arena while any of their buffers are in use.
+  struct State {
+    std::mutex mutex;
+    SlabHeader * slab = nullptr; // The current slab
+    std::byte * pos = nullptr;   // The next free byte in the current slab
+    std::byte * end = nullptr;   // One past the last byte of the current slab
+    size_t slab_size = 0;
+    size_t bytes_allocated = 0;
+    size_t bytes_reserved = 0;
+    Size num_slabs = 0;
+    // The number of buffers in use, plus one for the Arena itself. The slabs
+    // are freed when this drops to zero.
+    std::atomic<size_t> refs = 1;
+  };
+
+  //============================================================================
+  // Granule table
+  //============================================================================
+  // An open addressing hash table from the index of each granule in a slab to
+  // the State of the slab's arena. Lookups are lock-free, since every Vector
+  // that is freed while an arena exists looks up its buffer. Entries are added
+  // and removed under granule_mutex. Removed entries are only reclaimed when the
+  // table is empty, so that a lookup never misses a granule that is in use.
+
+  static constexpr int granule_table_bits = 14;
+  static constexpr size_t granule_table_size = size_t{1} << granule_table_bits;
+  static constexpr uintptr_t empty_key = 0;
+  static constexpr uintptr_t removed_key = ~uintptr_t{0};
+
+  // std::atomic is value-initialized, so entries start out empty.
+  struct GranuleEntry {
+    std::atomic<uintptr_t> key; // Granule index + 1
+    std::atomic<State *> state;
+  };
+
+  // NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables) justified
+  inline static std::array<GranuleEntry, granule_table_size> granule_table{};
+  inline static std::atomic<size_t> num_granules = 0;
+  inline static size_t num_removed_granules = 0; // Guarded by granule_mutex
+  inline static std::mutex granule_mutex;
+  inline static std::atomic<Size> num_scopes = 0;
+  // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+  static auto
+  granuleKey(void const * p) noexcept -> uintptr_t
+  {
+    return (reinterpret_cast<uintptr_t>(p) / arena_granule) + 1;
+  }
+
+  static auto
+  granuleHash(uintptr_t const key) noexcept -> size_t
+  {
+    // Fibonacci hashing
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >>
+                               (64 - granule_table_bits));
+  }
+
+  // The State of the arena whose slab contains p, or nullptr.
+  static auto
+  findState(void const * p) noexcept -> State *
+  {
+    uintptr_t const key = granuleKey(p);
+    size_t i = granuleHash(key);
+    for (size_t probe = 0; probe < granule_table_size; ++probe) {
+      uintptr_t const k = granule_table[i].key.load(std::memory_order_acquire);
+      if (k == key) {
+        return granule_table[i].state.load(std::memory_order_relaxed);
+      }
+      if (k == empty_key) {
+        return nullptr;
+      }
+      i = (i + 1) & (granule_table_size - 1);
+    }
+    return nullptr;
+  }
+
+  // Record the granules of a slab. Returns false if the table is too full.
+  static auto
+  addGranules(std::byte const * slab, size_t const size, State * state) noexcept -> bool
+  {
+    size_t const n = size / arena_granule;
+    std::lock_guard<std::mutex> const lock(granule_mutex);
+    // Keep the table at most half full, so that probe sequences stay short
+    if (2 * (num_granules.load(std::memory_order_relaxed) + num_removed_granules + n) >
+        granule_table_size) {
+      return false;
+    }
+    for (size_t g = 0; g < n; ++g) {
+      uintptr_t const key = granuleKey(slab + g * arena_granule);
+      size_t i = granuleHash(key);
+      for (;;) {
+        uintptr_t const k = granule_table[i].key.load(std::memory_order_relaxed);
+        if (k == empty_key || k == removed_key) {
+          granule_table[i].state.store(state, std::memory_order_relaxed);
+          granule_table[i].key.store(key, std::memory_order_release);
+          break;
+        }
+        i = (i + 1) & (granule_table_size - 1);
+      }
+    }
+    num_granules.fetch_add(n, std::memory_order_relaxed);
+    return true;
+  }
+
+  static void
+  removeGranules(std::byte const * slab, size_t const size) noexcept
+  {
+    size_t const n = size / arena_granule;
+    std::lock_guard<std::mutex> const lock(granule_mutex);
+    for (size_t g = 0; g < n; ++g) {
+      uintptr_t const key = granuleKey(slab + g * arena_granule);
+      size_t i = granuleHash(key);
+      while (granule_table[i].key.load(std::memory_order_relaxed) != key) {
+        i = (i + 1) & (granule_table_size - 1);
+      }
+      granule_table[i].key.store(removed_key, std::memory_order_release);
+    }
+    num_removed_granules += n;
+    if (num_granules.fetch_sub(n, std::memory_order_relaxed) == n) {
+      // No granule is in use, so no lookup can miss one
+      for (auto & entry : granule_table) {
+        entry.key.store(empty_key, std::memory_order_relaxed);
+      }
+      num_removed_granules = 0;
+    }
+  }
+
+  // Drop a reference to state, freeing its slabs if it was the last one.
+  static void
+  unref(State * state) noexcept
+  {
+    if (state->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    while (state->slab != nullptr) {
+      SlabHeader * const prev = state->slab->prev;
+      removeGranules(reinterpret_cast<std::byte const *>(state->slab), state->slab->size);
+      ::operator delete(state->slab, std::align_val_t{arena_granule});
+      state->slab = prev;
+    }
+    delete state;
+  }
+
+  // Add a slab with room for at least min_size bytes. Returns false if the slab
+  // could not be recorded.
+  auto
+  addSlab(size_t const min_size) noexcept -> bool
+  {
+    size_t size = sizeof(SlabHeader) +
+                  (min_size > _state->slab_size ? min_size : _state->slab_size);
+    size = (size + arena_granule - 1) / arena_granule * arena_granule;
+    auto * const slab = static_cast<SlabHeader *>(
+        ::operator new(size, std::align_val_t{arena_granule}));
+    if (!addGranules(reinterpret_cast<std::byte const *>(slab), size, _state)) {
+      ::operator delete(slab, std::align_val_t{arena_granule});
+      return false;
+    }
+    slab->prev = _state->slab;
+    slab->size = size;
+    _state->slab = slab;
+    _state->pos = reinterpret_cast<std::byte *>(slab) + sizeof(SlabHeader);
+    _state->end = reinterpret_cast<std::byte *>(slab) + size;
+    _state->bytes_reserved += size;
+    ++_state->num_slabs;
+    return true;
+  }
+
+  // The arena of the innermost ArenaScope on this thread.
+  static auto
+  currentRef() noexcept -> Arena *&
+  {
+    thread_local Arena * arena = nullptr;
+    return arena;
+  }
+
+  State * _state;
+
+  friend class ArenaScope;
+
+public:
+  static constexpr size_t default_slab_size = arena_granule;
+
+  // Slabs hold at least slab_size bytes, rounded up to a multiple of
+  // arena_granule.
+  explicit Arena(size_t slab_size = default_slab_size)
+      : _state(new State)
+  {
+    _state->slab_size = slab_size;
+  }
+
+  Arena(Arena const &) = delete;
+
+  auto
+  operator=(Arena const &) -> Arena & = delete;
+
+  ~Arena() noexcept { unref(_state); }
+
+  // Return size bytes aligned to alignment, which must be a power of 2. If the
+  // granule table is full, the buffer is allocated on the heap instead.
+  [[nodiscard]] auto
+  allocate(size_t size, size_t alignment) noexcept -> void *
+  {
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    assert(alignment <= alignof(std::max_align_t));
+    std::lock_guard<std::mutex> const lock(_state->mutex);
+    auto const align = [alignment](std::byte * p) {
+      auto const u = reinterpret_cast<uintptr_t>(p);
+      return p + ((alignment - (u & (alignment - 1))) & (alignment - 1));
+    };
+    std::byte * p = align(_state->pos);
+    // A buffer must start inside its slab, even if it is empty
+    if (_state->slab == nullptr || p + size >= _state->end) {
+      if (!addSlab(size + alignment)) {
+        return ::operator new(size);
+      }
+      p = align(_state->pos);
+    }
+    _state->pos = p + size;
+    _state->bytes_allocated += size;
+    _state->refs.fetch_add(1, std::memory_order_relaxed);
+    return p;
+  }
+
+  // If p was allocated from an arena, free it and return true. Otherwise,
+  // return false, and p must be freed by the caller.
+  static auto
+  deallocate(void * p) noexcept -> bool
+  {
+    if (num_granules.load(std::memory_order_relaxed) == 0) {
+      return false;
+    }
+    State * const state = findState(p);
+    if (state == nullptr) {
+      return false;
+    }
+    unref(state);
+    return true;
+  }
+
+  // Whether p is in one of the slabs of this arena.
+  [[nodiscard]] auto
+  contains(void const * p) const noexcept -> bool
+  {
+    return findState(p) == _state;
+  }
+
+  [[nodiscard]] auto
+  slabSize() const noexcept -> size_t
+  {
+    return _state->slab_size;
+  }
+
+  // The number of bytes handed out.
+  [[nodiscard]] auto
+  bytesAllocated() const noexcept -> size_t
+  {
+    return _state->bytes_allocated;
+  }
+
+  // The number of bytes in slabs, including the slab headers.
+  [[nodiscard]] auto
+  bytesReserved() const noexcept -> size_t
+  {
+    return _state->bytes_reserved;
+  }
+
+  [[nodiscard]] auto
+  numSlabs() const noexcept -> Size
+  {
+    return _state->num_slabs;
+  }
+
+  // The arena of the innermost ArenaScope on this thread, or nullptr.
+  [[nodiscard]] static auto
+  current() noexcept -> Arena *
+  {
+    // Skip the thread_local lookup while no thread has a scope
+    if (num_scopes.load(std::memory_order_relaxed) == 0) {
+      return nullptr;
+    }
+    return currentRef();
+  }
+};
+
+//==============================================================================
+// ARENA SCOPE
+//==============================================================================
+// Make arena the current arena of this thread for the lifetime of the scope.
+// If arena is nullptr, the current arena is left unchanged, so that
+//    ArenaScope const scope(maybe_null_arena);
+// is a no-op when there is no arena to use.
+
+// NOLINTNEXTLINE(cppcoreguidelines-special-member-functions) justified
+class ArenaScope
+{
+  Arena * _prev;
+  bool _active;
+
+public:
+  explicit ArenaScope(Arena * arena) noexcept
+      : _prev(Arena::currentRef()),
+        _active(arena != nullptr)
+  {
+    if (_active) {
+      Arena::currentRef() = arena;
+      Arena::num_scopes.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  ArenaScope(ArenaScope const &) = delete;
+
+  auto
+  operator=(ArenaScope const &) -> ArenaScope & = delete;
+
+  ~ArenaScope() noexcept
+  {
+    if (_active) {
+      Arena::num_scopes.fetch_sub(1, std::memory_order_relaxed);
+      Arena::currentRef() = _prev;
+    }
+  }
+};
+
+} // namespace um2
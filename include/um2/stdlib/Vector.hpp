@@ -1,5 +1,6 @@
 #pragma once
 
+#include <um2/stdlib/Arena.hpp>     // Arena
 #include <um2/stdlib/algorithm.hpp> // copy
 #include <um2/stdlib/math.hpp>      // max
 #include <um2/stdlib/memory.hpp>    // addressof
@@ -15,6 +16,9 @@ namespace um2
 //==============================================================================
 // An std::vector-like class without and Allocator template parameter.
 //
+// Buffers are allocated on the heap, unless an ArenaScope is active on the
+// calling thread, in which case they are allocated from its arena. See Arena.
+//
 // https://en.cppreference.com/w/cpp/container/vector
 
 template <typename T>
@@ -150,6 +154,12 @@ public:
   // Hidden
   //==============================================================================
 
+  HOSTDEV HIDDEN static constexpr auto
+  allocateBuffer(Size n) noexcept -> Ptr;
+
+  HOSTDEV HIDDEN constexpr void
+  deallocate() noexcept;
+
   HOSTDEV HIDDEN constexpr void
   allocate(Size n) noexcept;
 
@@ -5,13 +5,48 @@ namespace um2
 // Hidden
 //==============================================================================
 
+// Allocate an uninitialized buffer of n elements from the current Arena, or
+// the heap if there is none.
+template <class T>
+HOSTDEV constexpr auto
+Vector<T>::allocateBuffer(Size n) noexcept -> Ptr
+{
+  assert(n < max_size());
+  auto const bytes = static_cast<size_t>(n) * sizeof(T);
+#ifndef __CUDA_ARCH__
+  Arena * const arena = Arena::current();
+  if (arena != nullptr) {
+    return static_cast<T *>(arena->allocate(bytes, alignof(T)));
+  }
+#endif
+  return static_cast<T *>(::operator new(bytes));
+}
+
+// Free the buffer. The elements must already be destroyed.
+template <class T>
+HOSTDEV constexpr void
+Vector<T>::deallocate() noexcept
+{
+  if (_begin != nullptr) {
+#ifndef __CUDA_ARCH__
+    if (!Arena::deallocate(_begin)) {
+      ::operator delete(_begin);
+    }
+#else
+    ::operator delete(_begin);
+#endif
+  }
+  _begin = nullptr;
+  _end = nullptr;
+  _end_cap = nullptr;
+}
+
 template <class T>
 HOSTDEV constexpr void
 Vector<T>::allocate(Size n) noexcept
 {
-  assert(n < max_size());
   assert(_begin == nullptr);
-  _begin = static_cast<T *>(::operator new(static_cast<size_t>(n) * sizeof(T)));
+  _begin = allocateBuffer(n);
   _end = _begin;
   _end_cap = _begin + n;
 }
@@ -63,15 +98,15 @@ Vector<T>::grow(Size n) noexcept
   Size const current_size = size();
   Size const new_size = current_size + n;
   Size const new_capacity = recommend(new_size);
-  Ptr new_begin =
-      static_cast<T *>(::operator new(static_cast<size_t>(new_capacity) * sizeof(T)));
+  Ptr new_begin = allocateBuffer(new_capacity);
   Ptr new_end = new_begin;
   // Move the elements over
   for (Ptr old_pos = _begin; old_pos != _end; ++old_pos, ++new_end) {
     um2::construct_at(new_end, um2::move(*old_pos));
   }
-  // Destroy the old elements
+  // Destroy the old elements and free the old buffer
   destruct_at_end(_begin);
+  deallocate();
   // Update the pointers
   _begin = new_begin;
   _end = new_end;
@@ -148,7 +183,7 @@ HOSTDEV constexpr Vector<T>::~Vector() noexcept
 {
   if (_begin != nullptr) {
     this->destruct_at_end(_begin);
-    ::operator delete(_begin);
+    this->deallocate();
   }
 }
 
@@ -296,8 +331,7 @@ Vector<T>::operator=(Vector<T> const & v) noexcept -> Vector<T> &
 {
   if (this != addressof(v)) {
     destruct_at_end(_begin);
-    ::operator delete(_begin);
-    _begin = nullptr;
+    deallocate();
     allocate(v.size());
     construct_at_end(v.size());
     copy(v.begin(), v.end(), _begin);
@@ -311,7 +345,7 @@ Vector<T>::operator=(Vector<T> && v) noexcept -> Vector<T> &
 {
   if (this != addressof(v)) {
     destruct_at_end(_begin);
-    ::operator delete(_begin);
+    deallocate();
     _begin = v._begin;
     _end = v._end;
     _end_cap = v._end_cap;
@@ -327,8 +361,7 @@ HOSTDEV constexpr auto
 Vector<T>::operator=(std::initializer_list<T> const & list) noexcept -> Vector &
 {
   destruct_at_end(_begin);
-  ::operator delete(_begin);
-  _begin = nullptr;
+  deallocate();
   allocate(static_cast<Size>(list.size()));
   construct_at_end(static_cast<Size>(list.size()));
   copy(list.begin(), list.end(), _begin);
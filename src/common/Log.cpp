@@ -2,6 +2,7 @@
 
 #include <iomanip>  // std::setw, std::setfill
 #include <iostream> // std::cout, std::endl, std::cerr
+#include <mutex>    // std::recursive_mutex, std::lock_guard
 #include <sstream>  // std::stringstream
 
 namespace um2
@@ -37,6 +38,13 @@ size_t Log::num_warnings = 0;
 std::vector<LogVerbosity> Log::verbosity_levels;
 std::vector<LogTimePoint> Log::times;
 std::vector<std::string> Log::messages;
+
+namespace
+{
+// Guards the messages and counts, so that messages may be logged from several
+// threads. Recursive since handleMessage calls flush.
+std::recursive_mutex log_mutex;
+} // namespace
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 
 //==============================================================================
@@ -46,6 +54,7 @@ std::vector<std::string> Log::messages;
 void
 Log::reset()
 {
+  std::lock_guard<std::recursive_mutex> const lock(log_mutex);
   // Reset options to default
   max_verbosity_level = log_default_max_verbosity_level;
   buffered = log_default_buffered;
@@ -249,6 +258,7 @@ printLogMessage(LogVerbosity const verbosity, LogTimePoint const time,
 void
 Log::flush()
 {
+  std::lock_guard<std::recursive_mutex> const lock(log_mutex);
   for (size_t i = 0; i < messages.size(); ++i) {
     printLogMessage(verbosity_levels[i], times[i], messages[i]);
   }
@@ -262,6 +272,7 @@ Log::flush()
 void
 Log::handleMessage(LogVerbosity const verbosity, std::string const & msg)
 {
+  std::lock_guard<std::recursive_mutex> const lock(log_mutex);
   if (verbosity <= max_verbosity_level) {
     if (buffered) {
       verbosity_levels.push_back(verbosity);
@@ -279,8 +290,11 @@ Log::handleMessage(LogVerbosity const verbosity, std::string const & msg)
 void
 Log::error(std::string const & msg)
 {
-  num_errors += 1;
-  handleMessage(LogVerbosity::Error, msg);
+  {
+    std::lock_guard<std::recursive_mutex> const lock(log_mutex);
+    num_errors += 1;
+    handleMessage(LogVerbosity::Error, msg);
+  }
   if (exit_on_error) {
     exit(1);
   }
@@ -289,6 +303,7 @@ Log::error(std::string const & msg)
 void
 Log::warn(std::string const & msg)
 {
+  std::lock_guard<std::recursive_mutex> const lock(log_mutex);
   num_warnings += 1;
   handleMessage(LogVerbosity::Warn, msg);
 }
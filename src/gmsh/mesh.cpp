@@ -1,7 +1,28 @@
 #include <um2/gmsh/mesh.hpp>
 
+#include <um2/gmsh/io.hpp>
+#include <um2/mesh/io.hpp>
+
+#include <algorithm>  // std::max_element, std::lower_bound, std::sort
+#include <array>      // std::array
+#include <cmath>      // std::llround
+#include <cstdio>     // std::fflush
+#include <cstdlib>    // std::getenv
+#include <filesystem> // std::filesystem::create_directories
+#include <fstream>    // std::ifstream, std::ofstream
+#include <iomanip>    // std::setw, std::setfill
+#include <iostream>   // std::cout
+#include <limits>     // std::numeric_limits
+#include <map>        // std::map
+#include <numeric>    // std::iota
+#include <sstream>    // std::stringstream
+
 #if UM2_USE_GMSH
 
+#  include <spawn.h>    // posix_spawn
+#  include <sys/wait.h> // waitpid
+#  include <unistd.h>   // access, getpid, environ
+
 namespace um2::gmsh::model::mesh
 {
 
@@ -79,11 +100,164 @@ generateMesh(MeshType const mesh_type, int const smooth_iters)
     //      gmsh::model::mesh::optimize("HighOrderElastic");
     //    }
     break;
+  case MeshType::TriQuad:
+    Log::info("Generating triangle/quadrilateral mesh");
+    // Recombine as many triangles as possible, but keep the rest instead of
+    // subdividing every face into quads.
+    gmsh::option::setNumber("Mesh.RecombineAll", 1);
+    gmsh::option::setNumber("Mesh.Algorithm", 8); // Frontal-Delaunay for quads.
+    gmsh::option::setNumber("Mesh.SubdivisionAlgorithm", 0);   // None
+    gmsh::option::setNumber("Mesh.RecombinationAlgorithm", 1); // Blossom
+    gmsh::model::mesh::generate(2);
+    break;
+  case MeshType::QuadraticTriQuad:
+    Log::info("Generating quadratic triangle/quadrilateral mesh");
+    gmsh::option::setNumber("Mesh.RecombineAll", 1);
+    gmsh::option::setNumber("Mesh.Algorithm", 8); // Frontal-Delaunay for quads.
+    gmsh::option::setNumber("Mesh.SubdivisionAlgorithm", 0);   // None
+    gmsh::option::setNumber("Mesh.RecombinationAlgorithm", 1); // Blossom
+    gmsh::model::mesh::generate(2);
+    gmsh::option::setNumber("Mesh.HighOrderOptimize", 2); // elastic + opt
+    gmsh::model::mesh::setOrder(2);
+    break;
   default:
     Log::error("Invalid mesh type");
   }
 }
 
+//=============================================================================
+// getMeshFile
+//=============================================================================
+
+namespace
+{
+auto
+gmshElementTypeToMeshType(int const type) -> MeshType
+{
+  switch (type) {
+  case 2:
+    return MeshType::Tri;
+  case 3:
+    return MeshType::Quad;
+  case 9:
+    return MeshType::QuadraticTri;
+  case 16:
+    return MeshType::QuadraticQuad;
+  default:
+    return MeshType::None;
+  }
+}
+
+// Convert a gmsh coordinate to Float. The cast is only made when the types
+// differ, since a cast of double to double is -Wuseless-cast.
+template <class T>
+constexpr auto
+toFloat(T const x) -> Float
+{
+  if constexpr (std::same_as<T, Float>) {
+    return x;
+  } else {
+    return static_cast<Float>(x);
+  }
+}
+} // namespace
+
+void
+getMeshFile(MeshFile<Float, Int> & mesh_file)
+{
+  Log::info("Getting mesh from the gmsh model");
+  mesh_file = MeshFile<Float, Int>();
+  gmsh::model::getCurrent(mesh_file.name);
+
+  //==============================================================================
+  // Vertices
+  //==============================================================================
+  // Node tags need not be contiguous, so map them to vertex indices.
+  std::vector<size_t> node_tags;
+  std::vector<double> coords;
+  std::vector<double> parametric_coords;
+  gmsh::model::mesh::getNodes(node_tags, coords, parametric_coords, -1, -1,
+                              /*includeBoundary=*/false,
+                              /*returnParametricCoord=*/false);
+  if (node_tags.empty()) {
+    Log::error("The gmsh model has no mesh");
+    return;
+  }
+  size_t const num_nodes = node_tags.size();
+  std::vector<Int> vertex_ids(*std::max_element(node_tags.cbegin(), node_tags.cend()) + 1,
+                              -1);
+  mesh_file.vertices.resize(num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i) {
+    vertex_ids[node_tags[i]] = static_cast<Int>(i);
+    mesh_file.vertices[i] = {toFloat(coords[3 * i]), toFloat(coords[3 * i + 1]),
+                             toFloat(coords[3 * i + 2])};
+  }
+
+  //==============================================================================
+  // Elements
+  //==============================================================================
+  // Elements are stored entity by entity, so that the elements of each entity
+  // are a contiguous range.
+  gmsh::vectorpair dimtags;
+  gmsh::model::getEntities(dimtags, 2);
+  std::sort(dimtags.begin(), dimtags.end());
+  std::vector<int> entity_tags(dimtags.size());
+  std::vector<Int> entity_offsets(dimtags.size() + 1, 0);
+  std::vector<int> elem_types;
+  std::vector<std::vector<size_t>> elem_tags;
+  std::vector<std::vector<size_t>> elem_node_tags;
+  mesh_file.element_offsets.push_back(0);
+  for (size_t ie = 0; ie < dimtags.size(); ++ie) {
+    entity_tags[ie] = dimtags[ie].second;
+    gmsh::model::mesh::getElements(elem_types, elem_tags, elem_node_tags, 2,
+                                   dimtags[ie].second);
+    for (size_t it = 0; it < elem_types.size(); ++it) {
+      MeshType const mesh_type = gmshElementTypeToMeshType(elem_types[it]);
+      if (mesh_type == MeshType::None) {
+        Log::error("Unsupported gmsh element type: " + std::to_string(elem_types[it]));
+        return;
+      }
+      auto const verts_per_elem = static_cast<size_t>(verticesPerCell(mesh_type));
+      size_t const num_elems = elem_tags[it].size();
+      mesh_file.element_types.insert(mesh_file.element_types.end(), num_elems, mesh_type);
+      for (size_t i = 0; i < num_elems * verts_per_elem; ++i) {
+        mesh_file.element_conn.push_back(vertex_ids[elem_node_tags[it][i]]);
+      }
+      for (size_t i = 0; i < num_elems; ++i) {
+        mesh_file.element_offsets.push_back(mesh_file.element_offsets.back() +
+                                            static_cast<Int>(verts_per_elem));
+      }
+    }
+    entity_offsets[ie + 1] = static_cast<Int>(mesh_file.element_types.size());
+  }
+
+  //==============================================================================
+  // Elsets
+  //==============================================================================
+  gmsh::model::getPhysicalGroups(dimtags, 2);
+  std::vector<int> group_entity_tags;
+  mesh_file.elset_offsets.push_back(0);
+  for (auto const & dimtag : dimtags) {
+    std::string name;
+    gmsh::model::getPhysicalName(2, dimtag.second, name);
+    gmsh::model::getEntitiesForPhysicalGroup(2, dimtag.second, group_entity_tags);
+    auto const start = mesh_file.elset_ids.size();
+    for (int const tag : group_entity_tags) {
+      auto const it = std::lower_bound(entity_tags.cbegin(), entity_tags.cend(), tag);
+      assert(it != entity_tags.cend() && *it == tag);
+      auto const ie = static_cast<size_t>(it - entity_tags.cbegin());
+      for (Int i = entity_offsets[ie]; i < entity_offsets[ie + 1]; ++i) {
+        mesh_file.elset_ids.push_back(i);
+      }
+    }
+    std::sort(mesh_file.elset_ids.begin() + static_cast<ptrdiff_t>(start),
+              mesh_file.elset_ids.end());
+    mesh_file.elset_names.push_back(name);
+    mesh_file.elset_offsets.push_back(static_cast<Int>(mesh_file.elset_ids.size()));
+  }
+  mesh_file.sortElsets();
+}
+
 //=============================================================================
 // setMeshFieldFromGroups
 //=============================================================================
@@ -157,5 +331,830 @@ setMeshFieldFromGroups(int const dim, std::vector<std::string> const & groups,
   return field_ids;
 }
 
+//=============================================================================
+// generateCoarseCellMeshes
+//=============================================================================
+
+namespace
+{
+
+// 64-bit FNV-1a hash
+auto
+hashString(std::string const & s) -> uint64_t
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (char const c : s) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// The 2D entities of a coarse cell produced by overlaySpatialPartition.
+struct CoarseCellEntities {
+  std::string name;
+  std::vector<int> surfaces;
+  std::array<double, 3> lower_left;
+  std::string key;
+  double cost = 0; // Estimated number of faces, for load balancing
+};
+
+// The numeric gmsh options that determine the mesh sizes. They are part of the
+// cache key and are passed to the worker processes.
+constexpr std::array<char const *, 7> mesh_size_options = {
+    "Mesh.MeshSizeMin",         "Mesh.MeshSizeMax",
+    "Mesh.MeshSizeFactor",      "Mesh.MeshSizeFromCurvature",
+    "Mesh.MeshSizeFromPoints",  "Mesh.MeshSizeExtendFromBoundary",
+    "Mesh.ElementOrder"};
+
+// The meshing options that apply to every coarse cell.
+auto
+getMeshOptionsKey(MeshType const mesh_type, int const smooth_iters) -> std::string
+{
+  std::stringstream ss;
+  std::string version;
+  gmsh::option::getString("General.Version", version);
+  ss << "um2 coarse cell mesh v1\ngmsh " << version << '\n';
+  ss << "type " << static_cast<int>(mesh_type) << "\nsmooth " << smooth_iters << '\n';
+  ss << std::setprecision(17);
+  for (char const * const option : mesh_size_options) {
+    double value = 0;
+    gmsh::option::getNumber(option, value);
+    ss << option << ' ' << value << '\n';
+  }
+  // Constant fields are accounted for per surface. Any other field is only
+  // recorded by type, since its effect on a coarse cell is not known.
+  std::vector<int> field_tags;
+  gmsh::model::mesh::field::list(field_tags);
+  for (int const fid : field_tags) {
+    std::string type;
+    gmsh::model::mesh::field::getType(fid, type);
+    if (type != "Constant" && type != "Min") {
+      ss << "field " << type << '\n';
+    }
+  }
+  return ss.str();
+}
+
+// The mesh size of each surface from the constant fields of setMeshFieldFromGroups
+auto
+getConstantFieldSizes() -> std::map<int, double>
+{
+  std::map<int, double> sizes;
+  std::vector<int> field_tags;
+  gmsh::model::mesh::field::list(field_tags);
+  for (int const fid : field_tags) {
+    std::string type;
+    gmsh::model::mesh::field::getType(fid, type);
+    if (type != "Constant") {
+      continue;
+    }
+    double size = 0;
+    gmsh::model::mesh::field::getNumber(fid, "VIn", size);
+    std::vector<double> surfaces;
+    gmsh::model::mesh::field::getNumbers(fid, "SurfacesList", surfaces);
+    for (double const s : surfaces) {
+      auto const [it, inserted] = sizes.try_emplace(static_cast<int>(s), size);
+      if (!inserted) {
+        it->second = std::min(it->second, size);
+      }
+    }
+  }
+  return sizes;
+}
+
+// The size that the constant fields of setMeshFieldFromGroups give a curve
+// (dim = 1) or point (dim = 0), or 0 if none applies. The fields include the
+// boundaries of their surfaces, so an entity on the edge of a coarse cell is
+// also sized by the surfaces of the neighbouring cells, through the Min field.
+auto
+getBoundaryFieldSize(int const dim, int const tag,
+                     std::map<int, double> const & surface_sizes) -> double
+{
+  std::vector<int> upward;
+  std::vector<int> downward;
+  gmsh::model::getAdjacencies(dim, tag, upward, downward);
+  double min_size = 0;
+  bool found_size = false;
+  for (int const up_tag : upward) {
+    double size = 0;
+    if (dim == 1) {
+      auto const it = surface_sizes.find(up_tag);
+      if (it != surface_sizes.end()) {
+        size = it->second;
+      }
+    } else {
+      size = getBoundaryFieldSize(1, up_tag, surface_sizes);
+    }
+    if (size > 0 && (!found_size || size < min_size)) {
+      min_size = size;
+      found_size = true;
+    }
+  }
+  return min_size;
+}
+
+// Describe the geometry, materials and mesh sizes of a coarse cell relative to
+// its lower left corner. Lengths are rounded to 1e-6 of the coarse cell size, so
+// that coarse cells which are identical up to translation have the same key.
+// The sizes of the curves and points are those of the fields, which depend on
+// the neighbouring cells, so an interior cell and an edge cell with the same
+// geometry have different keys. Also estimate the cost of meshing the coarse
+// cell.
+void
+makeCoarseCellKey(CoarseCellEntities & cell, std::string const & options_key,
+                  std::map<int, std::vector<std::string>> const & surface_materials,
+                  std::map<int, double> const & surface_sizes)
+{
+  std::array<double, 3> lo = {std::numeric_limits<double>::max(),
+                              std::numeric_limits<double>::max(),
+                              std::numeric_limits<double>::max()};
+  std::array<double, 3> hi = {std::numeric_limits<double>::lowest(),
+                              std::numeric_limits<double>::lowest(),
+                              std::numeric_limits<double>::lowest()};
+  for (int const tag : cell.surfaces) {
+    std::array<double, 6> bb{};
+    gmsh::model::getBoundingBox(2, tag, bb[0], bb[1], bb[2], bb[3], bb[4], bb[5]);
+    for (size_t d = 0; d < 3; ++d) {
+      lo[d] = std::min(lo[d], bb[d]);
+      hi[d] = std::max(hi[d], bb[d + 3]);
+    }
+  }
+  cell.lower_left = lo;
+  double const h = std::max(hi[0] - lo[0], hi[1] - lo[1]);
+  double const eps = h / 1000000;
+  auto const quantize = [eps](double const x) { return std::llround(x / eps); };
+  // Round a length relative to the lower left corner in dimension d
+  auto const rel = [&](double const x, size_t const d) { return quantize(x - lo[d]); };
+
+  std::vector<std::string> lines;
+  std::stringstream ss;
+  auto const addBox = [&](int const dim, int const tag) {
+    std::array<double, 6> bb{};
+    gmsh::model::getBoundingBox(dim, tag, bb[0], bb[1], bb[2], bb[3], bb[4], bb[5]);
+    ss << ' ' << rel(bb[0], 0) << ' ' << rel(bb[1], 1) << ' ' << rel(bb[3], 0) << ' '
+       << rel(bb[4], 1);
+  };
+
+  // Surfaces
+  gmsh::vectorpair surface_dimtags;
+  std::vector<std::pair<double, double>> area_sizes; // (area, field size)
+  for (int const tag : cell.surfaces) {
+    surface_dimtags.emplace_back(2, tag);
+    ss.str("");
+    ss << "surface";
+    auto const mat_it = surface_materials.find(tag);
+    if (mat_it != surface_materials.end()) {
+      for (auto const & mat : mat_it->second) {
+        ss << ' ' << mat;
+      }
+    }
+    addBox(2, tag);
+    double area = 0;
+    gmsh::model::occ::getMass(2, tag, area);
+    ss << " area " << std::llround(area / (eps * h));
+    auto const size_it = surface_sizes.find(tag);
+    double field_size = 0;
+    if (size_it != surface_sizes.end()) {
+      field_size = size_it->second;
+      ss << " size " << quantize(field_size);
+    }
+    area_sizes.emplace_back(area, field_size);
+    lines.push_back(ss.str());
+  }
+
+  // Curves
+  gmsh::vectorpair curve_dimtags;
+  gmsh::model::getBoundary(surface_dimtags, curve_dimtags, /*combined=*/false,
+                           /*oriented=*/false);
+  std::sort(curve_dimtags.begin(), curve_dimtags.end());
+  curve_dimtags.erase(std::unique(curve_dimtags.begin(), curve_dimtags.end()),
+                      curve_dimtags.end());
+  for (auto const & dimtag : curve_dimtags) {
+    ss.str("");
+    std::string type;
+    gmsh::model::getType(dimtag.first, dimtag.second, type);
+    ss << "curve " << type;
+    addBox(dimtag.first, dimtag.second);
+    double length = 0;
+    gmsh::model::occ::getMass(dimtag.first, dimtag.second, length);
+    ss << " length " << quantize(length);
+    double const field_size =
+        getBoundaryFieldSize(dimtag.first, dimtag.second, surface_sizes);
+    if (field_size > 0) {
+      ss << " size " << quantize(field_size);
+    }
+    lines.push_back(ss.str());
+  }
+
+  // Points and their mesh sizes
+  gmsh::vectorpair point_dimtags;
+  gmsh::model::getBoundary(curve_dimtags, point_dimtags, /*combined=*/false,
+                           /*oriented=*/false);
+  std::sort(point_dimtags.begin(), point_dimtags.end());
+  point_dimtags.erase(std::unique(point_dimtags.begin(), point_dimtags.end()),
+                      point_dimtags.end());
+  std::vector<double> point_sizes;
+  gmsh::model::mesh::getSizes(point_dimtags, point_sizes);
+  for (size_t i = 0; i < point_dimtags.size(); ++i) {
+    ss.str("");
+    ss << "point";
+    addBox(0, point_dimtags[i].second);
+    ss << " size " << quantize(point_sizes[i]);
+    double const field_size =
+        getBoundaryFieldSize(0, point_dimtags[i].second, surface_sizes);
+    if (field_size > 0) {
+      ss << " field " << quantize(field_size);
+    }
+    lines.push_back(ss.str());
+  }
+
+  // Faces ~ area / size^2. Use the smallest point size where there is no field.
+  double point_size = h / 10;
+  bool found_size = false;
+  for (double const size : point_sizes) {
+    if (size > 0) {
+      point_size = found_size ? std::min(point_size, size) : size;
+      found_size = true;
+    }
+  }
+  cell.cost = 0;
+  for (auto const & [area, field_size] : area_sizes) {
+    double const size = field_size > 0 ? field_size : point_size;
+    cell.cost += area / (size * size);
+  }
+
+  std::sort(lines.begin(), lines.end());
+  ss.str("");
+  ss << options_key << "extent " << quantize(hi[0] - lo[0]) << ' '
+     << quantize(hi[1] - lo[1]) << '\n';
+  for (auto const & line : lines) {
+    ss << line << '\n';
+  }
+  cell.key = ss.str();
+}
+
+auto
+getCachePath(std::string const & cache_dir, std::string const & key) -> std::string
+{
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << hashString(key);
+  return cache_dir + "/" + ss.str();
+}
+
+// Load the mesh of a coarse cell from the cache. The full key is stored next to
+// the mesh, so a hash collision is a miss, not a wrong mesh.
+auto
+readCachedMesh(std::string const & path, std::string const & key,
+               MeshFile<Float, Int> & mesh) -> bool
+{
+  std::ifstream key_file(path + ".key", std::ios::binary);
+  if (!key_file.is_open()) {
+    return false;
+  }
+  std::stringstream ss;
+  ss << key_file.rdbuf();
+  if (ss.str() != key || !std::filesystem::exists(path + ".xdmf")) {
+    return false;
+  }
+  mesh = MeshFile<Float, Int>();
+  importMesh(path + ".xdmf", mesh);
+  return !mesh.element_types.empty();
+}
+
+void
+writeCachedMesh(std::string const & path, std::string const & key,
+                MeshFile<Float, Int> & mesh)
+{
+  mesh.format = MeshFileFormat::XDMF;
+  exportMesh(path + ".xdmf", mesh);
+  // Write the key last, so that an interrupted write is a miss.
+  std::ofstream key_file(path + ".key", std::ios::binary);
+  key_file << key;
+}
+
+// Append the mesh of a coarse cell, shifted by its lower left corner, to the
+// mesh of the whole model.
+void
+appendCoarseCellMesh(MeshFile<Float, Int> const & cc_mesh, std::string const & cc_name,
+                     std::array<double, 3> const & shift, MeshFile<Float, Int> & mesh_file,
+                     std::map<std::string, std::vector<Int>> & elsets)
+{
+  auto const vertex_offset = static_cast<Int>(mesh_file.vertices.size());
+  auto const element_offset = static_cast<Int>(mesh_file.element_types.size());
+  auto const conn_offset = static_cast<Int>(mesh_file.element_conn.size());
+  for (auto const & v : cc_mesh.vertices) {
+    mesh_file.vertices.push_back({v[0] + static_cast<Float>(shift[0]),
+                                  v[1] + static_cast<Float>(shift[1]),
+                                  v[2] + static_cast<Float>(shift[2])});
+  }
+  mesh_file.element_types.insert(mesh_file.element_types.end(),
+                                 cc_mesh.element_types.begin(),
+                                 cc_mesh.element_types.end());
+  for (size_t i = 1; i < cc_mesh.element_offsets.size(); ++i) {
+    mesh_file.element_offsets.push_back(conn_offset + cc_mesh.element_offsets[i]);
+  }
+  for (Int const v : cc_mesh.element_conn) {
+    mesh_file.element_conn.push_back(vertex_offset + v);
+  }
+  auto & cc_elset = elsets[cc_name];
+  for (size_t i = 0; i < cc_mesh.element_types.size(); ++i) {
+    cc_elset.push_back(element_offset + static_cast<Int>(i));
+  }
+  for (size_t i = 0; i < cc_mesh.elset_names.size(); ++i) {
+    auto & elset = elsets[cc_mesh.elset_names[i]];
+    auto const start = static_cast<size_t>(cc_mesh.elset_offsets[i]);
+    auto const end = static_cast<size_t>(cc_mesh.elset_offsets[i + 1]);
+    for (size_t j = start; j < end; ++j) {
+      elset.push_back(element_offset + cc_mesh.elset_ids[j]);
+    }
+  }
+}
+
+// Mesh only the coarse cells in cell_ids, removing all other surfaces from the
+// model. cc_meshes[i] is set to the mesh of cells[i], shifted to the coarse
+// cell's lower left corner.
+void
+meshCoarseCells(std::vector<CoarseCellEntities> const & cells,
+                std::vector<size_t> const & cell_ids, MeshType const mesh_type,
+                int const smooth_iters, std::vector<MeshFile<Float, Int>> & cc_meshes)
+{
+  std::vector<int> keep;
+  for (size_t const i : cell_ids) {
+    keep.insert(keep.end(), cells[i].surfaces.begin(), cells[i].surfaces.end());
+  }
+  std::sort(keep.begin(), keep.end());
+  gmsh::vectorpair all_dimtags;
+  gmsh::model::getEntities(all_dimtags, 2);
+  gmsh::vectorpair remove_dimtags;
+  for (auto const & dimtag : all_dimtags) {
+    if (!std::binary_search(keep.begin(), keep.end(), dimtag.second)) {
+      remove_dimtags.push_back(dimtag);
+    }
+  }
+  if (!remove_dimtags.empty()) {
+    gmsh::model::occ::remove(remove_dimtags, /*recursive=*/true);
+    gmsh::model::removeEntities(remove_dimtags, /*recursive=*/true);
+    gmsh::model::occ::synchronize();
+  }
+  generateMesh(mesh_type, smooth_iters);
+  MeshFile<Float, Int> model_mesh;
+  getMeshFile(model_mesh);
+  for (size_t const i : cell_ids) {
+    auto & cc_mesh = cc_meshes[i];
+    model_mesh.getSubmesh(cells[i].name, cc_mesh);
+    auto const & ll = cells[i].lower_left;
+    for (auto & v : cc_mesh.vertices) {
+      v[0] -= static_cast<Float>(ll[0]);
+      v[1] -= static_cast<Float>(ll[1]);
+      v[2] -= static_cast<Float>(ll[2]);
+    }
+  }
+}
+
+// A directory that is removed, with its contents, when this goes out of scope.
+// An empty path is not removed.
+struct TemporaryDirectory {
+  std::string path;
+
+  TemporaryDirectory() = default;
+
+  TemporaryDirectory(TemporaryDirectory const &) = delete;
+
+  auto
+  operator=(TemporaryDirectory const &) -> TemporaryDirectory & = delete;
+
+  ~TemporaryDirectory()
+  {
+    if (!path.empty()) {
+      std::error_code ec;
+      std::filesystem::remove_all(path, ec);
+    }
+  }
+};
+
+//=============================================================================
+// Worker processes
+//=============================================================================
+// gmsh meshes one model at a time per process, so coarse cells are meshed in
+// parallel by separate processes. The workers are started with posix_spawn of
+// the um2_mesh_worker executable, not with fork: a fork of a process that has
+// OpenMP or TBB thread pools, which persist after their first use, may deadlock
+// on a lock held by a thread that does not exist in the child.
+//
+// The model is written to dir/model.brep, with its physical groups in
+// dir/model.info (see um2::gmsh::write). Each worker gets a job file, which
+// holds everything else that sizes the mesh, and writes the mesh of each of its
+// coarse cells to dir/<coarse cell name>.xdmf:
+//
+//  um2 mesh worker v1
+//  type <mesh type> <smooth iters>
+//  option <name> <value>          For each of mesh_size_options
+//  point <tag> <size>             For each point with a mesh size
+//  field <size> <surface tags>    For each constant field
+//  cell <name> <x> <y> <z>        For each coarse cell, with its lower left corner
+
+constexpr char const * worker_job_header = "um2 mesh worker v1";
+
+// The path of the worker executable. The UM2_MESH_WORKER environment variable
+// overrides the path of the build, e.g. for an installed copy.
+auto
+getMeshWorkerPath() -> std::string
+{
+  char const * const path = std::getenv("UM2_MESH_WORKER");
+  return path != nullptr ? std::string(path) : std::string(UM2_MESH_WORKER_PATH);
+}
+
+// Whether the mesh sizes of the model can be passed to a worker. Only constant
+// fields on surfaces, combined by a Min field, are passed.
+auto
+canPassMeshSizes() -> bool
+{
+  std::vector<int> field_tags;
+  gmsh::model::mesh::field::list(field_tags);
+  for (int const fid : field_tags) {
+    std::string type;
+    gmsh::model::mesh::field::getType(fid, type);
+    if (type != "Constant" && type != "Min") {
+      return false;
+    }
+    if (type == "Constant") {
+      std::vector<double> points;
+      std::vector<double> curves;
+      gmsh::model::mesh::field::getNumbers(fid, "PointsList", points);
+      gmsh::model::mesh::field::getNumbers(fid, "CurvesList", curves);
+      if (!points.empty() || !curves.empty()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The job file lines shared by every worker: the mesh type and mesh sizes.
+auto
+getWorkerJobHeader(MeshType const mesh_type, int const smooth_iters) -> std::string
+{
+  std::stringstream ss;
+  ss << std::setprecision(17);
+  ss << worker_job_header << '\n';
+  ss << "type " << static_cast<int>(mesh_type) << ' ' << smooth_iters << '\n';
+  for (char const * const option : mesh_size_options) {
+    double value = 0;
+    gmsh::option::getNumber(option, value);
+    ss << "option " << option << ' ' << value << '\n';
+  }
+  gmsh::vectorpair point_dimtags;
+  gmsh::model::getEntities(point_dimtags, 0);
+  std::vector<double> point_sizes;
+  gmsh::model::mesh::getSizes(point_dimtags, point_sizes);
+  for (size_t i = 0; i < point_dimtags.size(); ++i) {
+    if (point_sizes[i] > 0) {
+      ss << "point " << point_dimtags[i].second << ' ' << point_sizes[i] << '\n';
+    }
+  }
+  std::vector<int> field_tags;
+  gmsh::model::mesh::field::list(field_tags);
+  for (int const fid : field_tags) {
+    std::string type;
+    gmsh::model::mesh::field::getType(fid, type);
+    if (type != "Constant") {
+      continue;
+    }
+    double size = 0;
+    gmsh::model::mesh::field::getNumber(fid, "VIn", size);
+    std::vector<double> surfaces;
+    gmsh::model::mesh::field::getNumbers(fid, "SurfacesList", surfaces);
+    ss << "field " << size;
+    for (double const tag : surfaces) {
+      ss << ' ' << static_cast<int>(tag);
+    }
+    ss << '\n';
+  }
+  return ss.str();
+}
+
+// Split the coarse cells among num_workers worker processes, balancing their
+// estimated cost, and mesh them in parallel. The meshes are written to dir.
+// Returns false if the workers could not be started, e.g. because the worker
+// executable is missing. A worker that fails leaves some meshes missing.
+auto
+meshCoarseCellsInWorkers(std::vector<CoarseCellEntities> const & cells,
+                         std::vector<size_t> const & cell_ids, MeshType const mesh_type,
+                         int const smooth_iters, std::string const & dir,
+                         int const num_workers) -> bool
+{
+  std::string const worker_path = getMeshWorkerPath();
+  if (access(worker_path.c_str(), X_OK) != 0) {
+    Log::warn("Cannot run the mesh worker " + worker_path);
+    return false;
+  }
+  // Longest processing time first
+  std::vector<size_t> sorted_ids = cell_ids;
+  std::stable_sort(sorted_ids.begin(), sorted_ids.end(),
+                   [&cells](size_t const a, size_t const b) {
+                     return cells[a].cost > cells[b].cost;
+                   });
+  auto const nworkers = std::min(static_cast<size_t>(num_workers), cell_ids.size());
+  std::vector<std::vector<size_t>> worker_ids(nworkers);
+  std::vector<double> worker_cost(nworkers, 0);
+  for (size_t const i : sorted_ids) {
+    auto const w = static_cast<size_t>(
+        std::min_element(worker_cost.begin(), worker_cost.end()) - worker_cost.begin());
+    worker_ids[w].push_back(i);
+    worker_cost[w] += cells[i].cost;
+  }
+  Log::info("Meshing " + std::to_string(cell_ids.size()) + " coarse cells in " +
+            std::to_string(nworkers) + " worker processes");
+
+  um2::gmsh::write(dir + "/model.brep", /*extra_info=*/true);
+  std::string const header = getWorkerJobHeader(mesh_type, smooth_iters);
+  std::vector<pid_t> pids;
+  for (size_t w = 0; w < nworkers; ++w) {
+    std::string job_path = dir + "/worker_" + std::to_string(w) + ".job";
+    {
+      std::ofstream job(job_path);
+      job << std::setprecision(17) << header;
+      for (size_t const i : worker_ids[w]) {
+        auto const & ll = cells[i].lower_left;
+        job << "cell " << cells[i].name << ' ' << ll[0] << ' ' << ll[1] << ' ' << ll[2]
+            << '\n';
+      }
+    }
+    std::string program = worker_path;
+    std::array<char *, 3> argv = {program.data(), job_path.data(), nullptr};
+    pid_t pid = 0;
+    if (posix_spawn(&pid, program.c_str(), nullptr, nullptr, argv.data(), environ) != 0) {
+      Log::warn("Failed to start a meshing worker process");
+      continue;
+    }
+    pids.push_back(pid);
+  }
+  bool success = pids.size() == nworkers;
+  for (pid_t const pid : pids) {
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      success = false;
+    }
+  }
+  if (!success) {
+    Log::warn("A meshing worker process failed");
+  }
+  return !pids.empty();
+}
+
+} // namespace
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+auto
+generateCoarseCellMeshes(MeshType const mesh_type, MeshFile<Float, Int> & mesh_file,
+                         std::string const & cache_dir, int const smooth_iters,
+                         int const num_workers) -> bool
+{
+  if (cache_dir.empty() && num_workers <= 1) {
+    generateMesh(mesh_type, smooth_iters);
+    getMeshFile(mesh_file);
+    return !mesh_file.element_types.empty();
+  }
+
+  // Get the coarse cells and the materials of each surface
+  std::vector<CoarseCellEntities> cells;
+  std::map<int, std::vector<std::string>> surface_materials;
+  gmsh::vectorpair group_dimtags;
+  gmsh::model::getPhysicalGroups(group_dimtags, 2);
+  for (auto const & dimtag : group_dimtags) {
+    std::string name;
+    gmsh::model::getPhysicalName(2, dimtag.second, name);
+    std::vector<int> tags;
+    gmsh::model::getEntitiesForPhysicalGroup(2, dimtag.second, tags);
+    if (name.starts_with("Coarse_Cell")) {
+      cells.push_back({name, tags, {}, {}});
+    } else if (name.starts_with("Material_")) {
+      for (int const tag : tags) {
+        surface_materials[tag].push_back(name);
+      }
+    }
+  }
+  if (cells.empty()) {
+    Log::error("The gmsh model has no coarse cells");
+    return false;
+  }
+  for (auto & mats : surface_materials) {
+    std::sort(mats.second.begin(), mats.second.end());
+  }
+  std::string const options_key = getMeshOptionsKey(mesh_type, smooth_iters);
+  std::map<int, double> const surface_sizes = getConstantFieldSizes();
+
+  if (!cache_dir.empty()) {
+    Log::info("Generating coarse cell meshes with cache: " + cache_dir);
+    std::filesystem::create_directories(cache_dir);
+  }
+
+  // Look up each coarse cell in the cache. Coarse cells with the same key are
+  // only meshed once.
+  size_t const num_cells = cells.size();
+  std::vector<MeshFile<Float, Int>> cc_meshes(num_cells);
+  std::vector<size_t> source(num_cells); // The cell whose mesh is used
+  std::map<std::string, size_t> first_with_key;
+  std::vector<size_t> to_mesh;
+  size_t num_hits = 0;
+  for (size_t i = 0; i < num_cells; ++i) {
+    makeCoarseCellKey(cells[i], options_key, surface_materials, surface_sizes);
+    auto const [it, inserted] = first_with_key.try_emplace(cells[i].key, i);
+    source[i] = it->second;
+    if (!inserted) {
+      continue;
+    }
+    if (!cache_dir.empty() && readCachedMesh(getCachePath(cache_dir, cells[i].key),
+                                             cells[i].key, cc_meshes[i])) {
+      ++num_hits;
+    } else {
+      to_mesh.push_back(i);
+    }
+  }
+  if (!cache_dir.empty()) {
+    Log::info("Found " + std::to_string(num_hits) + " of " +
+              std::to_string(first_with_key.size()) +
+              " unique coarse cell meshes in the cache");
+  }
+  std::vector<size_t> const meshed = to_mesh;
+
+  // Mesh the coarse cells that were not in the cache
+  bool const use_workers = num_workers > 1 && to_mesh.size() > 1;
+  if (use_workers && !canPassMeshSizes()) {
+    Log::warn("The mesh size fields cannot be passed to worker processes, so the "
+              "coarse cells are meshed in this process");
+  } else if (use_workers) {
+    // The workers pass their meshes back through a temporary directory, which
+    // is removed on return.
+    TemporaryDirectory work_dir;
+    work_dir.path = (std::filesystem::temp_directory_path() /
+                     ("um2_meshes_" + std::to_string(getpid())))
+                        .string();
+    std::filesystem::create_directories(work_dir.path);
+    if (meshCoarseCellsInWorkers(cells, to_mesh, mesh_type, smooth_iters,
+                                 work_dir.path, num_workers)) {
+      // Mesh the cells of any worker that failed in this process instead
+      std::vector<size_t> failed;
+      for (size_t const i : to_mesh) {
+        std::string const path = work_dir.path + "/" + cells[i].name + ".xdmf";
+        if (std::filesystem::exists(path)) {
+          importMesh(path, cc_meshes[i]);
+        }
+        if (cc_meshes[i].element_types.empty()) {
+          failed.push_back(i);
+        }
+      }
+      to_mesh = std::move(failed);
+      if (!to_mesh.empty()) {
+        Log::warn("Meshing the " + std::to_string(to_mesh.size()) +
+                  " coarse cells of failed workers in this process");
+      }
+    }
+  }
+  if (!to_mesh.empty()) {
+    meshCoarseCells(cells, to_mesh, mesh_type, smooth_iters, cc_meshes);
+  }
+
+  // Store the new meshes in the cache
+  if (!cache_dir.empty()) {
+    for (size_t const i : meshed) {
+      if (!cc_meshes[i].element_types.empty()) {
+        writeCachedMesh(getCachePath(cache_dir, cells[i].key), cells[i].key,
+                        cc_meshes[i]);
+      }
+    }
+  }
+
+  // A coarse cell without a mesh would silently be missing from the model
+  for (size_t i = 0; i < num_cells; ++i) {
+    if (cc_meshes[source[i]].element_types.empty()) {
+      Log::error("Failed to mesh " + cells[i].name);
+      mesh_file = MeshFile<Float, Int>();
+      return false;
+    }
+  }
+
+  // Assemble the mesh of the whole model
+  mesh_file = MeshFile<Float, Int>();
+  gmsh::model::getCurrent(mesh_file.name);
+  mesh_file.element_offsets.push_back(0);
+  std::map<std::string, std::vector<Int>> elsets;
+  for (size_t i = 0; i < num_cells; ++i) {
+    appendCoarseCellMesh(cc_meshes[source[i]], cells[i].name, cells[i].lower_left,
+                         mesh_file, elsets);
+  }
+  mesh_file.elset_offsets.push_back(0);
+  for (auto const & elset : elsets) {
+    mesh_file.elset_names.push_back(elset.first);
+    mesh_file.elset_ids.insert(mesh_file.elset_ids.end(), elset.second.begin(),
+                               elset.second.end());
+    mesh_file.elset_offsets.push_back(static_cast<Int>(mesh_file.elset_ids.size()));
+  }
+  mesh_file.sortElsets();
+  return true;
+}
+
+//=============================================================================
+// runCoarseCellMeshWorker
+//=============================================================================
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+auto
+runCoarseCellMeshWorker(std::string const & job_path) -> int
+{
+  std::ifstream job(job_path);
+  std::string line;
+  if (!std::getline(job, line) || line != worker_job_header) {
+    Log::error("Not a mesh worker job file: " + job_path);
+    return 1;
+  }
+  std::string const dir = std::filesystem::path(job_path).parent_path().string();
+  um2::gmsh::open(dir + "/model.brep", /*extra_info=*/true);
+  // The other workers use the other cores
+  gmsh::option::setNumber("General.NumThreads", 1);
+
+  std::map<std::string, std::vector<int>> cell_surfaces;
+  gmsh::vectorpair group_dimtags;
+  gmsh::model::getPhysicalGroups(group_dimtags, 2);
+  for (auto const & dimtag : group_dimtags) {
+    std::string name;
+    gmsh::model::getPhysicalName(2, dimtag.second, name);
+    if (name.starts_with("Coarse_Cell")) {
+      gmsh::model::getEntitiesForPhysicalGroup(2, dimtag.second, cell_surfaces[name]);
+    }
+  }
+
+  int mesh_type = 0;
+  int smooth_iters = 0;
+  std::vector<double> field_ids;
+  std::vector<CoarseCellEntities> cells;
+  while (std::getline(job, line)) {
+    std::stringstream ss(line);
+    std::string kind;
+    ss >> kind;
+    if (kind == "type") {
+      ss >> mesh_type >> smooth_iters;
+    } else if (kind == "option") {
+      std::string name;
+      double value = 0;
+      ss >> name >> value;
+      gmsh::option::setNumber(name, value);
+    } else if (kind == "point") {
+      int tag = 0;
+      double size = 0;
+      ss >> tag >> size;
+      gmsh::model::mesh::setSize({{0, tag}}, size);
+    } else if (kind == "field") {
+      double size = 0;
+      ss >> size;
+      std::vector<double> surfaces;
+      int tag = 0;
+      while (ss >> tag) {
+        surfaces.push_back(tag);
+      }
+      int const fid = gmsh::model::mesh::field::add("Constant");
+      gmsh::model::mesh::field::setNumber(fid, "VIn", size);
+      gmsh::model::mesh::field::setNumbers(fid, "SurfacesList", surfaces);
+      field_ids.push_back(fid);
+    } else if (kind == "cell") {
+      CoarseCellEntities cell;
+      ss >> cell.name >> cell.lower_left[0] >> cell.lower_left[1] >> cell.lower_left[2];
+      auto const it = cell_surfaces.find(cell.name);
+      if (it == cell_surfaces.end()) {
+        Log::error("The gmsh model has no coarse cell " + cell.name);
+        return 1;
+      }
+      cell.surfaces = it->second;
+      cells.push_back(std::move(cell));
+    } else {
+      Log::error("Invalid line in mesh worker job file: " + line);
+      return 1;
+    }
+  }
+  if (!field_ids.empty()) {
+    int const fid = gmsh::model::mesh::field::add("Min");
+    gmsh::model::mesh::field::setNumbers(fid, "FieldsList", field_ids);
+    gmsh::model::mesh::field::setAsBackgroundMesh(fid);
+  }
+
+  std::vector<size_t> cell_ids(cells.size());
+  std::iota(cell_ids.begin(), cell_ids.end(), 0);
+  std::vector<MeshFile<Float, Int>> cc_meshes(cells.size());
+  meshCoarseCells(cells, cell_ids, static_cast<MeshType>(mesh_type), smooth_iters,
+                  cc_meshes);
+  int status = 0;
+  for (size_t i = 0; i < cells.size(); ++i) {
+    if (cc_meshes[i].element_types.empty()) {
+      Log::error("Failed to mesh " + cells[i].name);
+      status = 1;
+      continue;
+    }
+    cc_meshes[i].format = MeshFileFormat::XDMF;
+    exportMesh(dir + "/" + cells[i].name + ".xdmf", cc_meshes[i]);
+  }
+  return status;
+}
+
 } // namespace um2::gmsh::model::mesh
 #endif // UM2_USE_GMSH
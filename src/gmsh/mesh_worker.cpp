@@ -0,0 +1,21 @@
+// Meshes coarse cells for um2::gmsh::model::mesh::generateCoarseCellMeshes in a
+// separate process.
+//
+// Usage: um2_mesh_worker <job file>
+
+#include <um2.hpp>
+
+#include <string> // std::string
+
+auto
+main(int argc, char ** argv) -> int
+{
+  if (argc != 2) {
+    um2::Log::error("Usage: um2_mesh_worker <job file>");
+    return 1;
+  }
+  um2::initialize("warn", /*init_gmsh=*/true, /*gmsh_verbosity=*/0);
+  int const status = um2::gmsh::model::mesh::runCoarseCellMeshWorker(argv[1]);
+  um2::finalize();
+  return status;
+}
@@ -2,7 +2,14 @@
 
 #if UM2_USE_GMSH
 
+#  include <algorithm>
+#  include <array>
+#  include <cmath>
 #  include <iomanip>
+#  include <limits>
+#  include <map>
+#  include <numeric>
+#  include <unordered_map>
 
 namespace um2::gmsh::model
 {
@@ -21,9 +28,9 @@ void
 colorMaterialPhysicalGroupEntities(std::vector<Material> const & materials)
 {
   size_t const num_materials = materials.size();
-  std::vector<std::string> material_names(num_materials);
+  std::unordered_map<std::string, size_t> material_index;
   for (size_t i = 0; i < num_materials; ++i) {
-    material_names[i] = "Material_" + std::string(materials[i].name.data());
+    material_index.emplace("Material_" + std::string(materials[i].name.data()), i);
   }
   std::vector<int> ptags(num_materials, -1);
   gmsh::vectorpair dimtags;
@@ -38,12 +45,9 @@ colorMaterialPhysicalGroupEntities(std::vector<Material> const & materials)
     int const tag = dimtag.second;
     std::string name;
     gmsh::model::getPhysicalName(dim, tag, name);
-    if (name.starts_with("Material_")) {
-      auto const it = std::find(material_names.begin(), material_names.end(), name);
-      if (it != material_names.end() && *it == name) {
-        ptrdiff_t const i = it - material_names.begin();
-        ptags[static_cast<size_t>(i)] = tag;
-      }
+    auto const it = material_index.find(name);
+    if (it != material_index.end()) {
+      ptags[it->second] = tag;
     }
   }
   // Color in reverse order so that the highest priority materials
@@ -64,45 +68,66 @@ colorMaterialPhysicalGroupEntities(std::vector<Material> const & materials)
     }
   }
 }
-} // namespace
 
-//=============================================================================
-// addToPhysicalGroup
-//=============================================================================
+// The tags of the dim-dimensional physical groups, by name
+auto
+getPhysicalGroupTags(int const dim) -> std::unordered_map<std::string, int>
+{
+  gmsh::vectorpair dimtags;
+  gmsh::model::getPhysicalGroups(dimtags, dim);
+  std::unordered_map<std::string, int> group_tags;
+  group_tags.reserve(dimtags.size());
+  for (auto const & dimtag : dimtags) {
+    std::string name;
+    gmsh::model::getPhysicalName(dim, dimtag.second, name);
+    group_tags.emplace(std::move(name), dimtag.second);
+  }
+  return group_tags;
+}
 
+// addToPhysicalGroup, using and updating group_tags from getPhysicalGroupTags(dim),
+// so that adding to many groups does not look up every group each time.
 void
 addToPhysicalGroup(int const dim, std::vector<int> const & tags, int const tag,
-                   std::string const & name)
+                   std::string const & name,
+                   std::unordered_map<std::string, int> & group_tags)
 {
   Log::debug("Adding entities to physical group \"" + name + "\"");
   assert(std::is_sorted(tags.begin(), tags.end()));
-  gmsh::vectorpair dimtags;
-  gmsh::model::getPhysicalGroups(dimtags, dim);
-  for (auto const & existing_group_dimtag : dimtags) {
-    int const existing_group_tag = existing_group_dimtag.second;
-    std::string existing_group_name;
-    gmsh::model::getPhysicalName(dim, existing_group_tag, existing_group_name);
-    if (existing_group_name == name) {
-      std::vector<int> existing_tags;
-      gmsh::model::getEntitiesForPhysicalGroup(dim, existing_group_tag, existing_tags);
-      std::vector<int> new_tags(tags.size() + existing_tags.size());
-      std::merge(tags.begin(), tags.end(), existing_tags.begin(), existing_tags.end(),
-                 new_tags.begin());
-      gmsh::model::removePhysicalGroups({
-          {dim, existing_group_tag}
-      });
+  auto const it = group_tags.find(name);
+  if (it == group_tags.end()) {
+    // The physical group does not exist yet.
+    group_tags.emplace(name, gmsh::model::addPhysicalGroup(dim, tags, tag, name));
+    return;
+  }
+  int const existing_group_tag = it->second;
+  std::vector<int> existing_tags;
+  gmsh::model::getEntitiesForPhysicalGroup(dim, existing_group_tag, existing_tags);
+  std::vector<int> new_tags(tags.size() + existing_tags.size());
+  std::merge(tags.begin(), tags.end(), existing_tags.begin(), existing_tags.end(),
+             new_tags.begin());
+  gmsh::model::removePhysicalGroups({
+      {dim, existing_group_tag}
+  });
 #  ifndef NDEBUG
-      int const new_tag =
-          gmsh::model::addPhysicalGroup(dim, new_tags, existing_group_tag, name);
-      assert(new_tag == existing_group_tag);
+  int const new_tag = gmsh::model::addPhysicalGroup(dim, new_tags, existing_group_tag, name);
+  assert(new_tag == existing_group_tag);
 #  else
-      gmsh::model::addPhysicalGroup(dim, new_tags, existing_group_tag, name);
+  gmsh::model::addPhysicalGroup(dim, new_tags, existing_group_tag, name);
 #  endif
-      return;
-    }
-  }
-  // If we get here, the physical group does not exist yet.
-  gmsh::model::addPhysicalGroup(dim, tags, tag, name);
+}
+} // namespace
+
+//=============================================================================
+// addToPhysicalGroup
+//=============================================================================
+
+void
+addToPhysicalGroup(int const dim, std::vector<int> const & tags, int const tag,
+                   std::string const & name)
+{
+  std::unordered_map<std::string, int> group_tags = getPhysicalGroupTags(dim);
+  addToPhysicalGroup(dim, tags, tag, name, group_tags);
 }
 
 //=============================================================================
@@ -206,30 +231,42 @@ groupPreservingInputChecking(gmsh::vectorpair const & object_dimtags,
 // getPhysicalGroupInfo
 //=============================================================================
 
+// Get the physical groups of dimension model_dim, sorted by name. The output
+// vectors must be empty on entry.
 void
 getPhysicalGroupInfo(std::vector<std::string> & physical_group_names,
                      std::vector<int> & physical_group_tag,
                      std::vector<std::vector<int>> & physical_group_ent_tags,
                      gmsh::vectorpair & physical_group_dimtags, int const model_dim)
 {
+  assert(physical_group_names.empty() && physical_group_tag.empty() &&
+         physical_group_ent_tags.empty());
   gmsh::model::getPhysicalGroups(physical_group_dimtags);
+  std::vector<std::string> names;
+  std::vector<int> ptags;
   for (auto const & dimtag : physical_group_dimtags) {
     int const dim = dimtag.first;
     if (dim != model_dim) {
       continue;
     }
-    int const ptag = dimtag.second;
     std::string name;
-    gmsh::model::getPhysicalName(dim, ptag, name);
-    std::vector<int> tags;
-    gmsh::model::getEntitiesForPhysicalGroup(dim, ptag, tags);
-    // Insert the physical group, keeping the vectors sorted
-    auto const it = std::lower_bound(physical_group_names.cbegin(),
-                                     physical_group_names.cend(), name);
-    ptrdiff_t const idx = it - physical_group_names.cbegin();
-    physical_group_names.insert(it, name);
-    physical_group_tag.insert(physical_group_tag.begin() + idx, ptag);
-    physical_group_ent_tags.insert(physical_group_ent_tags.begin() + idx, tags);
+    gmsh::model::getPhysicalName(dim, dimtag.second, name);
+    names.push_back(std::move(name));
+    ptags.push_back(dimtag.second);
+  }
+  // Sort the physical groups by name
+  std::vector<size_t> order(names.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&names](size_t const a, size_t const b) { return names[a] < names[b]; });
+  physical_group_names.resize(order.size());
+  physical_group_tag.resize(order.size());
+  physical_group_ent_tags.resize(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    physical_group_names[i] = std::move(names[order[i]]);
+    physical_group_tag[i] = ptags[order[i]];
+    gmsh::model::getEntitiesForPhysicalGroup(model_dim, ptags[order[i]],
+                                             physical_group_ent_tags[i]);
   }
 }
 
@@ -251,67 +288,36 @@ getNewPhysicalGroups(gmsh::vectorpair const & object_dimtags,
   //       Add the fragment children of the entity to the new physical group.
   //     Else,
   //       Add the entity to the new physical group.
-  std::vector<int> object_tags(object_dimtags.size());
-  std::vector<int> tool_tags(tool_dimtags.size());
+  //
+  // Map each object and tool entity to its index in out_dimtags_map, so the
+  // cost is linear in the total size of the groups, not groups x entities.
+  // If an entity is in both the object and the tool, the object takes precedence.
   size_t const nobject = object_dimtags.size();
   size_t const ntool = tool_dimtags.size();
-  for (size_t i = 0; i < object_dimtags.size(); ++i) {
-    object_tags[i] = object_dimtags[i].second;
+  std::unordered_map<int, size_t> map_index;
+  map_index.reserve(nobject + ntool);
+  for (size_t i = 0; i < nobject; ++i) {
+    map_index.emplace(object_dimtags[i].second, i);
   }
-  for (size_t i = 0; i < tool_dimtags.size(); ++i) {
-    tool_tags[i] = tool_dimtags[i].second;
+  for (size_t i = 0; i < ntool; ++i) {
+    map_index.emplace(tool_dimtags[i].second, i + nobject);
   }
   for (size_t i = 0; i < num_groups; ++i) {
-    std::vector<int> const & tags = pre_physical_group_ent_tags[i];
-    std::vector<int> new_tags;
-    new_tags.reserve(tags.size());
-    // The object, tool, and physical group entities are sorted.
-    // Therefore, we can simply iterate through the entities in the
-    // physical group and the object and tool entities, and compare
-    // the tags.
-    size_t object_idx = 0;
-    size_t tool_idx = 0;
-    size_t idx = 0;
-    for (int const etag : tags) {
-      bool found = false;
-      while (object_idx < nobject && object_tags[object_idx] < etag) {
-        ++object_idx;
-      }
-      if (object_idx < nobject && object_tags[object_idx] == etag) {
-        idx = object_idx;
-        found = true;
-      }
-      if (!found) {
-        while (tool_idx < ntool && tool_tags[tool_idx] < etag) {
-          ++tool_idx;
-        }
-        if (tool_idx < ntool && tool_tags[tool_idx] == etag) {
-          idx = tool_idx + nobject;
-          found = true;
-        }
-      }
-      if (found) {
-        // The entity is in the object or tool, so add the fragment children
-        // to the new physical group.
-        for (auto const & child : out_dimtags_map[idx]) {
-          auto const child_it =
-              std::lower_bound(new_tags.begin(), new_tags.end(), child.second);
-          if (child_it == new_tags.end() || *child_it != child.second) {
-            new_tags.insert(child_it, child.second);
-          }
-        }
+    std::vector<int> & new_tags = post_physical_group_ent_tags[i];
+    new_tags.clear();
+    for (int const etag : pre_physical_group_ent_tags[i]) {
+      auto const it = map_index.find(etag);
+      if (it == map_index.end()) {
+        new_tags.push_back(etag);
       } else {
-        // The entity is not in the object or tool, so add the entity to the
-        // new physical group.
-        auto const child_it = std::lower_bound(new_tags.begin(), new_tags.end(), etag);
-        if (child_it == new_tags.end() || *child_it != etag) {
-          new_tags.insert(child_it, etag);
+        for (auto const & child : out_dimtags_map[it->second]) {
+          new_tags.push_back(child.second);
         }
       }
-    } // end for (int const etag : tags)
-    // Insert the physical group, keeping the vector sorted by name
-    post_physical_group_ent_tags[i] = new_tags;
-  } // end for (size_t i = 0; i < physical_group_names.size(); ++i)
+    }
+    std::sort(new_tags.begin(), new_tags.end());
+    new_tags.erase(std::unique(new_tags.begin(), new_tags.end()), new_tags.end());
+  }
 }
 
 //=============================================================================
@@ -684,6 +690,7 @@ addCylindricalPinLattice2D(std::vector<std::vector<double>> const & radii,
 
   std::vector<int> out_tags;
   // For each unique pin, loop through the pin_ids_rev array and add the pins.
+  std::unordered_map<std::string, int> group_tags = getPhysicalGroupTags(2);
   for (size_t pin_id = 0; pin_id < nunique_pins; ++pin_id) {
     size_t const nrad = radii[pin_id].size();
     if (nrad == 0) {
@@ -727,11 +734,11 @@ addCylindricalPinLattice2D(std::vector<std::vector<double>> const & radii,
         continue;
       }
       addToPhysicalGroup(
-          2,                                                          // dim
-          material_ids[i],                                            // tags
-          -1,                                                         // tag
-          "Material_" + std::string(materials[pin_id][i].name.data()) // name
-      );
+          2,                                                           // dim
+          material_ids[i],                                             // tags
+          -1,                                                          // tag
+          "Material_" + std::string(materials[pin_id][i].name.data()), // name
+          group_tags);
       // Color entities according to materials
       gmsh::vectorpair mat_dimtags(nents);
       for (size_t j = 0; j < nents; ++j) {
@@ -889,6 +896,7 @@ addCylindricalPinLattice(std::vector<std::vector<double>> const & radii,
 
   std::vector<int> out_tags;
   // For each unique pin, loop through the pin_ids_rev array and add the pins.
+  std::unordered_map<std::string, int> group_tags = getPhysicalGroupTags(3);
   for (size_t pin_id = 0; pin_id < nunique_pins; ++pin_id) {
     size_t const nrad = radii[pin_id].size();
     if (nrad == 0) {
@@ -950,11 +958,11 @@ addCylindricalPinLattice(std::vector<std::vector<double>> const & radii,
       }
       assert(ctr == nents);
       addToPhysicalGroup(
-          3,                                                          // dim
-          material_ids[i],                                            // tags
-          -1,                                                         // tag
-          "Material_" + std::string(materials[pin_id][i].name.data()) // name
-      );
+          3,                                                           // dim
+          material_ids[i],                                             // tags
+          -1,                                                          // tag
+          "Material_" + std::string(materials[pin_id][i].name.data()), // name
+          group_tags);
       // Color entities according to materials
       gmsh::vectorpair mat_dimtags(nents);
       for (size_t j = 0; j < nents; ++j) {
@@ -970,41 +978,29 @@ addCylindricalPinLattice(std::vector<std::vector<double>> const & radii,
 } // end function
 
 //==============================================================================
-// overlaySpatialPartition
+// getCoarseCellBoxes
 //==============================================================================
+//
+// Get the box that cuts the model for the first instance of each coarse cell in
+// the spatial partition. In 3D, the box starts at the cut plane (the midpoint of
+// the lattice) and extends half the lattice thickness upward. Returns false if
+// the partition is incomplete.
 
-void
+namespace
+{
+auto
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-overlaySpatialPartition(mpact::SpatialPartition const & partition,
-                        std::string const & fill_material_name,
-                        Color const fill_material_color)
+getCoarseCellBoxes(mpact::SpatialPartition const & partition,
+                   Vector<Point3<Float>> & cc_lower_lefts, Vector<Vec3<Float>> & cc_extents)
+    -> bool
 {
-  Log::info("Overlaying MPACT spatial partition");
-  // Algorithm:
-  //  1. Get the lower left corner of each unique 2D coarse cell rectangle that
-  //      will cut the model.
-  //  2. Create the rectangles. Since group preserving fragment only keeps the
-  //      highest dimension groups, if the model is 3D, we create a box whose
-  //      bottom face is the coarse cell rectangle.
-  //  3. Assign the fill material and coarse cell labels to these entities.
-  //  4. Group preserving fragment with the model and grid.
-  //  4a. If the model is 3D, group preserving intersection between the model
-  //      and the 2D rectangles.
-  //  5. Remove all entities that are not coarse cells.
-
-  // Get all model entities prior to adding the grid
-  gmsh::vectorpair model_dimtags;
-  gmsh::model::getEntities(model_dimtags, 3);
-  // Determine model dimension
-  int model_dim = 3;
-  if (model_dimtags.empty()) {
-    gmsh::model::getEntities(model_dimtags, 2);
-    model_dim = 2;
-  }
-  // Get the unique coarse cell lower left corners
   Size const num_cc = partition.numCoarseCells();
-  Vector<Point3<Float>> cc_lower_lefts(num_cc); // Of the cut-plane
-  Vector<Vec3<Float>> cc_extents(num_cc);
+  cc_lower_lefts.resize(num_cc);
+  cc_extents.resize(num_cc);
+  for (Size i = 0; i < num_cc; ++i) {
+    cc_lower_lefts[i] = {0, 0, 0};
+    cc_extents[i] = {0, 0, 0};
+  }
   Vector<int8_t> cc_found(num_cc, 0);
   Vector<int8_t> rtm_found(partition.numRTMs(), 0);
   Vector<int8_t> lat_found(partition.numLattices(), 0);
@@ -1013,7 +1009,7 @@ overlaySpatialPartition(mpact::SpatialPartition const & partition,
   auto const & core = partition.core;
   if (core.children.empty()) {
     Log::error("Core has no children");
-    return;
+    return false;
   }
   // For each assembly
   Size const nyasy = core.numYCells();
@@ -1030,7 +1026,7 @@ overlaySpatialPartition(mpact::SpatialPartition const & partition,
       auto const & assembly = partition.assemblies[asy_id];
       if (assembly.children.empty()) {
         Log::error("Assembly has no children");
-        return;
+        return false;
       }
       // For each lattice
       Size const nzlat = assembly.numXCells();
@@ -1048,7 +1044,7 @@ overlaySpatialPartition(mpact::SpatialPartition const & partition,
         auto const & lattice = partition.lattices[lat_id];
         if (lattice.children.empty()) {
           Log::error("Lattice has no children");
-          return;
+          return false;
         }
         // For each RTM
         Size const nyrtm = lattice.numYCells();
@@ -1065,7 +1061,7 @@ overlaySpatialPartition(mpact::SpatialPartition const & partition,
             auto const & rtm = partition.rtms[rtm_id];
             if (rtm.children.empty()) {
               Log::error("RTM has no children");
-              return;
+              return false;
             }
             // For each coarse cell
             Size const nycells = rtm.numYCells();
@@ -1088,6 +1084,540 @@ overlaySpatialPartition(mpact::SpatialPartition const & partition,
       }         // lat
     }           // assembly
   }             // assembly
+  return true;
+}
+
+//==============================================================================
+// getOverlappingEntities
+//==============================================================================
+//
+// For each box in box_ids, get the indices of the entities in dimtags whose
+// bounding box overlaps the interior of the box. Entities that only touch the
+// boundary of a box do not overlap it. If model_dim is 2, the z-coordinate is
+// ignored.
+//
+// The boxes are bucketed on a uniform grid with the spacing of the largest box,
+// so the cost is roughly linear in the number of entities and boxes, rather than
+// their product.
+
+void
+getOverlappingEntities(std::vector<std::array<double, 6>> const & entity_bbs,
+                       int const model_dim, Vector<Point3<Float>> const & lower_lefts,
+                       Vector<Vec3<Float>> const & extents,
+                       std::vector<Size> const & box_ids,
+                       std::vector<std::vector<size_t>> & overlaps)
+{
+  size_t const nboxes = box_ids.size();
+  overlaps.assign(nboxes, {});
+  if (nboxes == 0) {
+    return;
+  }
+  Float xmin = std::numeric_limits<Float>::max();
+  Float ymin = std::numeric_limits<Float>::max();
+  Float xmax = std::numeric_limits<Float>::lowest();
+  Float ymax = std::numeric_limits<Float>::lowest();
+  Float h = 0;
+  for (Size const id : box_ids) {
+    Point3<Float> const & ll = lower_lefts[id];
+    Vec3<Float> const & ext = extents[id];
+    xmin = std::min(xmin, ll[0]);
+    ymin = std::min(ymin, ll[1]);
+    xmax = std::max(xmax, ll[0] + ext[0]);
+    ymax = std::max(ymax, ll[1] + ext[1]);
+    h = std::max({h, ext[0], ext[1]});
+  }
+  if (h <= 0) {
+    Log::error("Coarse cell boxes have no extent");
+    return;
+  }
+  Float const eps = h / 1000000;
+  auto const nbx = static_cast<int64_t>(std::floor((xmax - xmin) / h)) + 1;
+  auto const nby = static_cast<int64_t>(std::floor((ymax - ymin) / h)) + 1;
+  // The range of buckets covered by [lo, hi], clamped to the grid.
+  auto const bucketRange = [h](double const lo, double const hi, Float const origin,
+                               int64_t const n) {
+    auto const first = static_cast<int64_t>(std::floor((lo - origin) / h));
+    auto const last = static_cast<int64_t>(std::floor((hi - origin) / h));
+    return std::make_pair(std::clamp(first, int64_t{0}, n - 1),
+                          std::clamp(last, int64_t{0}, n - 1));
+  };
+  std::vector<std::vector<size_t>> buckets(static_cast<size_t>(nbx * nby));
+  for (size_t k = 0; k < nboxes; ++k) {
+    Point3<Float> const & ll = lower_lefts[box_ids[k]];
+    Vec3<Float> const & ext = extents[box_ids[k]];
+    auto const xr = bucketRange(ll[0] + eps, ll[0] + ext[0] - eps, xmin, nbx);
+    auto const yr = bucketRange(ll[1] + eps, ll[1] + ext[1] - eps, ymin, nby);
+    for (int64_t iy = yr.first; iy <= yr.second; ++iy) {
+      for (int64_t ix = xr.first; ix <= xr.second; ++ix) {
+        buckets[static_cast<size_t>(iy * nbx + ix)].push_back(k);
+      }
+    }
+  }
+  size_t const nentities = entity_bbs.size();
+  for (size_t e = 0; e < nentities; ++e) {
+    auto const & bb = entity_bbs[e];
+    if (bb[3] < xmin || bb[0] > xmax || bb[4] < ymin || bb[1] > ymax) {
+      continue;
+    }
+    auto const xr = bucketRange(bb[0], bb[3], xmin, nbx);
+    auto const yr = bucketRange(bb[1], bb[4], ymin, nby);
+    for (int64_t iy = yr.first; iy <= yr.second; ++iy) {
+      for (int64_t ix = xr.first; ix <= xr.second; ++ix) {
+        for (size_t const k : buckets[static_cast<size_t>(iy * nbx + ix)]) {
+          // A box that spans several buckets may be visited more than once.
+          if (!overlaps[k].empty() && overlaps[k].back() == e) {
+            continue;
+          }
+          Point3<Float> const & ll = lower_lefts[box_ids[k]];
+          Vec3<Float> const & ext = extents[box_ids[k]];
+          bool overlap = bb[0] < ll[0] + ext[0] - eps && bb[3] > ll[0] + eps &&
+                         bb[1] < ll[1] + ext[1] - eps && bb[4] > ll[1] + eps;
+          if (model_dim == 3) {
+            overlap = overlap && bb[2] < ll[2] + ext[2] - eps && bb[5] > ll[2] + eps;
+          }
+          if (overlap) {
+            overlaps[k].push_back(e);
+          }
+        }
+      }
+    }
+  }
+}
+
+// Get the highest dimension entities in the model and their dimension.
+auto
+getModelEntities(gmsh::vectorpair & model_dimtags) -> int
+{
+  model_dimtags.clear();
+  gmsh::model::getEntities(model_dimtags, 3);
+  if (!model_dimtags.empty()) {
+    return 3;
+  }
+  gmsh::model::getEntities(model_dimtags, 2);
+  return 2;
+}
+
+auto
+getBoundingBoxes(gmsh::vectorpair const & dimtags) -> std::vector<std::array<double, 6>>
+{
+  std::vector<std::array<double, 6>> bbs(dimtags.size());
+  for (size_t i = 0; i < dimtags.size(); ++i) {
+    auto & bb = bbs[i];
+    gmsh::model::getBoundingBox(dimtags[i].first, dimtags[i].second, bb[0], bb[1], bb[2],
+                                bb[3], bb[4], bb[5]);
+  }
+  return bbs;
+}
+
+//==============================================================================
+// fragmentByTile
+//==============================================================================
+//
+// The same as groupPreservingFragment of the model entities with the coarse
+// cell rectangles (cc_tags), which get the fill material and their coarse cell
+// group, but done one tile of coarse cells at a time. Each OCC fragment only sees
+// the rectangles of one tile and the entities that overlap them, so the cost
+// grows linearly with the number of tiles. The physical groups are tracked per
+// entity and only recreated once all tiles are done.
+//
+// cc_objects[k] are the tags of the model entities that overlap the coarse cell
+// cc_ids[k], and cc_tile[k] is its tile.
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+void
+fragmentByTile(int const model_dim, std::vector<Size> const & cc_ids,
+               std::vector<int> const & cc_tags,
+               std::vector<std::vector<int>> const & cc_objects,
+               std::vector<size_t> const & cc_tile, std::string const & fill_mat_full_name,
+               std::vector<Material> const & materials)
+{
+  // Get the existing physical groups and add the fill material and coarse cell
+  // groups, if needed.
+  std::vector<std::string> group_names;
+  std::vector<int> group_tags;
+  std::vector<std::vector<int>> group_ent_tags;
+  gmsh::vectorpair group_dimtags;
+  getPhysicalGroupInfo(group_names, group_tags, group_ent_tags, group_dimtags, model_dim);
+  std::unordered_map<std::string, size_t> group_index;
+  for (size_t i = 0; i < group_names.size(); ++i) {
+    group_index.emplace(group_names[i], i);
+  }
+  auto const getGroup = [&](std::string const & name) {
+    auto const [it, inserted] = group_index.try_emplace(name, group_names.size());
+    if (inserted) {
+      group_names.push_back(name);
+      group_tags.push_back(-1);
+    }
+    return it->second;
+  };
+  // The physical groups of each entity
+  std::unordered_map<int, std::vector<size_t>> entity_groups;
+  for (size_t i = 0; i < group_ent_tags.size(); ++i) {
+    for (int const tag : group_ent_tags[i]) {
+      entity_groups[tag].push_back(i);
+    }
+  }
+  size_t const fill_group = getGroup(fill_mat_full_name);
+  std::stringstream ss;
+  for (size_t k = 0; k < cc_ids.size(); ++k) {
+    ss.str("");
+    ss << "Coarse_Cell_" << std::setw(5) << std::setfill('0') << cc_ids[k];
+    entity_groups[cc_tags[k]] = {fill_group, getGroup(ss.str())};
+  }
+  gmsh::model::removePhysicalGroups();
+
+  // The objects and tools of each tile
+  size_t const num_tiles = *std::max_element(cc_tile.begin(), cc_tile.end()) + 1;
+  std::vector<std::vector<int>> tile_objects(num_tiles);
+  std::vector<std::vector<int>> tile_tools(num_tiles);
+  for (size_t k = 0; k < cc_ids.size(); ++k) {
+    auto & objects = tile_objects[cc_tile[k]];
+    objects.insert(objects.end(), cc_objects[k].begin(), cc_objects[k].end());
+    tile_tools[cc_tile[k]].push_back(cc_tags[k]);
+  }
+  // The tiles, after the current one, that each entity still has to be
+  // fragmented with.
+  std::unordered_map<int, std::vector<size_t>> later_tiles;
+  for (size_t t = 0; t < num_tiles; ++t) {
+    auto & objects = tile_objects[t];
+    std::sort(objects.begin(), objects.end());
+    objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+    for (int const tag : objects) {
+      later_tiles[tag].push_back(t);
+    }
+  }
+
+  Log::info("Fragmenting the model in " + std::to_string(num_tiles) + " tiles");
+  for (size_t t = 0; t < num_tiles; ++t) {
+    auto & objects = tile_objects[t];
+    auto & tools = tile_tools[t];
+    std::sort(objects.begin(), objects.end());
+    objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+    std::sort(tools.begin(), tools.end());
+    gmsh::vectorpair object_dimtags;
+    gmsh::vectorpair tool_dimtags;
+    for (int const tag : objects) {
+      object_dimtags.emplace_back(model_dim, tag);
+    }
+    for (int const tag : tools) {
+      tool_dimtags.emplace_back(model_dim, tag);
+    }
+    gmsh::vectorpair out_dimtags;
+    std::vector<gmsh::vectorpair> out_dimtags_map;
+    if (object_dimtags.empty()) {
+      // Nothing to cut. The rectangles are their own children.
+      for (auto const & dimtag : tool_dimtags) {
+        out_dimtags_map.push_back({dimtag});
+      }
+    } else {
+      gmsh::model::occ::fragment(object_dimtags, tool_dimtags, out_dimtags,
+                                 out_dimtags_map);
+    }
+
+    // Move the physical groups of each input entity to its children
+    size_t const nobject = object_dimtags.size();
+    size_t const ninput = nobject + tool_dimtags.size();
+    std::vector<std::vector<size_t>> parent_groups(ninput);
+    for (size_t i = 0; i < ninput; ++i) {
+      int const tag = i < nobject ? object_dimtags[i].second : tool_dimtags[i - nobject].second;
+      auto const it = entity_groups.find(tag);
+      if (it != entity_groups.end()) {
+        parent_groups[i] = std::move(it->second);
+        entity_groups.erase(it);
+      }
+    }
+    std::vector<int> in_tool; // Children that are inside a rectangle of this tile
+    for (size_t i = 0; i < ninput; ++i) {
+      for (auto const & child : out_dimtags_map[i]) {
+        auto & groups = entity_groups[child.second];
+        groups.insert(groups.end(), parent_groups[i].begin(), parent_groups[i].end());
+        if (i >= nobject) {
+          in_tool.push_back(child.second);
+        }
+      }
+    }
+    std::sort(in_tool.begin(), in_tool.end());
+
+    // Children outside of this tile's rectangles replace their parent in the
+    // later tiles of the parent.
+    for (size_t i = 0; i < nobject; ++i) {
+      int const tag = object_dimtags[i].second;
+      auto const it = later_tiles.find(tag);
+      if (it == later_tiles.end()) {
+        continue;
+      }
+      std::vector<size_t> const tiles = std::move(it->second);
+      later_tiles.erase(it);
+      // The parent no longer exists, and a child may reuse its tag
+      for (size_t const later : tiles) {
+        if (later > t) {
+          auto & later_objects = tile_objects[later];
+          later_objects.erase(std::remove(later_objects.begin(), later_objects.end(), tag),
+                              later_objects.end());
+        }
+      }
+      for (auto const & child : out_dimtags_map[i]) {
+        if (std::binary_search(in_tool.begin(), in_tool.end(), child.second)) {
+          continue;
+        }
+        for (size_t const later : tiles) {
+          if (later > t) {
+            tile_objects[later].push_back(child.second);
+            later_tiles[child.second].push_back(later);
+          }
+        }
+      }
+    }
+  }
+  gmsh::model::occ::synchronize();
+
+  // Recreate the physical groups, sorted by name for processMaterialHierarchy
+  size_t const num_groups = group_names.size();
+  std::vector<std::vector<int>> post_ent_tags(num_groups);
+  for (auto const & [tag, groups] : entity_groups) {
+    for (size_t const g : groups) {
+      post_ent_tags[g].push_back(tag);
+    }
+  }
+  std::vector<size_t> order(num_groups);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&group_names](size_t const a, size_t const b) {
+    return group_names[a] < group_names[b];
+  });
+  std::vector<std::string> sorted_names(num_groups);
+  std::vector<std::vector<int>> sorted_ent_tags(num_groups);
+  for (size_t i = 0; i < num_groups; ++i) {
+    sorted_names[i] = group_names[order[i]];
+    sorted_ent_tags[i] = std::move(post_ent_tags[order[i]]);
+    auto & tags = sorted_ent_tags[i];
+    std::sort(tags.begin(), tags.end());
+    tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+  }
+  processMaterialHierarchy(materials, sorted_names, sorted_ent_tags);
+  for (size_t i = 0; i < num_groups; ++i) {
+    if (!sorted_ent_tags[i].empty()) {
+      gmsh::model::addPhysicalGroup(model_dim, sorted_ent_tags[i], group_tags[order[i]],
+                                    sorted_names[i]);
+    }
+  }
+  colorMaterialPhysicalGroupEntities(materials);
+}
+} // namespace
+
+//==============================================================================
+// getUniqueCoarseCells
+//==============================================================================
+//
+// Two coarse cells are considered identical if they have the same extents and
+// the model entities that overlap them match up to translation. Entities are
+// compared by their material physical groups, their bounding box and center of
+// mass relative to the lower left corner of the coarse cell, and their area
+// (volume in 3D), to a relative tolerance of 1e-6 of the coarse cell size. The
+// center of mass tells apart mirrored or rotated copies of an asymmetric entity,
+// which have the same bounding box and area. An entity that extends
+// beyond a coarse cell, such as a large moderator region, only matches if the
+// coarse cells sit at the same position relative to it, so cells on assembly
+// edges, near gaps, etc. are kept unique.
+
+auto
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+getUniqueCoarseCells(mpact::SpatialPartition const & partition) -> std::vector<Size>
+{
+  Log::info("Finding unique coarse cells");
+  Size const num_cc = partition.numCoarseCells();
+  std::vector<Size> cc_representatives(static_cast<size_t>(num_cc));
+  std::iota(cc_representatives.begin(), cc_representatives.end(), 0);
+  Vector<Point3<Float>> cc_lower_lefts;
+  Vector<Vec3<Float>> cc_extents;
+  if (!getCoarseCellBoxes(partition, cc_lower_lefts, cc_extents)) {
+    return cc_representatives;
+  }
+
+  gmsh::vectorpair model_dimtags;
+  int const model_dim = getModelEntities(model_dimtags);
+  std::sort(model_dimtags.begin(), model_dimtags.end());
+  std::vector<std::array<double, 6>> const entity_bbs = getBoundingBoxes(model_dimtags);
+  std::vector<double> entity_masses(model_dimtags.size());
+  std::vector<std::array<double, 3>> entity_centers(model_dimtags.size());
+  for (size_t i = 0; i < model_dimtags.size(); ++i) {
+    gmsh::model::occ::getMass(model_dimtags[i].first, model_dimtags[i].second,
+                              entity_masses[i]);
+    auto & c = entity_centers[i];
+    gmsh::model::occ::getCenterOfMass(model_dimtags[i].first, model_dimtags[i].second,
+                                      c[0], c[1], c[2]);
+  }
+
+  // The material physical groups of each entity, in increasing tag order.
+  std::vector<std::vector<int>> entity_materials(model_dimtags.size());
+  gmsh::vectorpair group_dimtags;
+  gmsh::model::getPhysicalGroups(group_dimtags, model_dim);
+  for (auto const & group : group_dimtags) {
+    std::string name;
+    gmsh::model::getPhysicalName(group.first, group.second, name);
+    if (!name.starts_with("Material_")) {
+      continue;
+    }
+    std::vector<int> tags;
+    gmsh::model::getEntitiesForPhysicalGroup(group.first, group.second, tags);
+    for (int const tag : tags) {
+      auto const it = std::lower_bound(model_dimtags.begin(), model_dimtags.end(),
+                                       std::make_pair(model_dim, tag));
+      if (it != model_dimtags.end() && it->second == tag) {
+        auto const e = static_cast<size_t>(it - model_dimtags.begin());
+        entity_materials[e].push_back(group.second);
+      }
+    }
+  }
+
+  // Only coarse cells that appear in the partition have a box.
+  std::vector<Size> cc_ids;
+  for (Size i = 0; i < num_cc; ++i) {
+    if (cc_extents[i][0] > 0 && cc_extents[i][1] > 0) {
+      cc_ids.push_back(i);
+    }
+  }
+  std::vector<std::vector<size_t>> overlaps;
+  getOverlappingEntities(entity_bbs, model_dim, cc_lower_lefts, cc_extents, cc_ids,
+                         overlaps);
+
+  // Map the signature of each coarse cell to the first coarse cell with that
+  // signature.
+  std::map<std::vector<int64_t>, Size> signatures;
+  std::vector<std::vector<int64_t>> entity_keys;
+  for (size_t k = 0; k < cc_ids.size(); ++k) {
+    Size const id = cc_ids[k];
+    Point3<Float> const & ll = cc_lower_lefts[id];
+    Vec3<Float> const & ext = cc_extents[id];
+    double const h = std::max(ext[0], ext[1]);
+    double const eps = 1e-6 * h;
+    double const mass_eps = model_dim == 2 ? eps * h : eps * h * h;
+    auto const quantize = [](double const x, double const tol) {
+      return static_cast<int64_t>(std::llround(x / tol));
+    };
+    entity_keys.clear();
+    for (size_t const e : overlaps[k]) {
+      std::vector<int64_t> key;
+      key.push_back(static_cast<int64_t>(entity_materials[e].size()));
+      for (int const mat : entity_materials[e]) {
+        key.push_back(mat);
+      }
+      auto const & bb = entity_bbs[e];
+      for (Size d = 0; d < model_dim; ++d) {
+        auto const ud = static_cast<size_t>(d);
+        key.push_back(quantize(bb[ud] - ll[d], eps));
+        key.push_back(quantize(bb[ud + 3] - ll[d], eps));
+        key.push_back(quantize(entity_centers[e][ud] - ll[d], eps));
+      }
+      key.push_back(quantize(entity_masses[e], mass_eps));
+      entity_keys.push_back(std::move(key));
+    }
+    std::sort(entity_keys.begin(), entity_keys.end());
+    std::vector<int64_t> signature = {quantize(ext[0], eps), quantize(ext[1], eps),
+                                      quantize(ext[2], eps),
+                                      static_cast<int64_t>(entity_keys.size())};
+    for (auto const & key : entity_keys) {
+      signature.insert(signature.end(), key.begin(), key.end());
+    }
+    auto const it = signatures.try_emplace(std::move(signature), id).first;
+    cc_representatives[static_cast<size_t>(id)] = it->second;
+  }
+  Log::info("Found " + std::to_string(signatures.size()) + " unique coarse cells out of " +
+            std::to_string(cc_ids.size()));
+  return cc_representatives;
+}
+
+//==============================================================================
+// overlaySpatialPartition
+//==============================================================================
+
+void
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+overlaySpatialPartition(mpact::SpatialPartition const & partition,
+                        std::string const & fill_material_name,
+                        Color const fill_material_color,
+                        std::vector<Size> const & cc_representatives,
+                        Size const tile_cells)
+{
+  Log::info("Overlaying MPACT spatial partition");
+  // Algorithm:
+  //  1. Get the lower left corner of each unique 2D coarse cell rectangle that
+  //      will cut the model.
+  //  2. Remove the model entities that do not overlap any of the rectangles.
+  //  3. Create the rectangles. Since group preserving fragment only keeps the
+  //      highest dimension groups, if the model is 3D, we create a box whose
+  //      bottom face is the coarse cell rectangle.
+  //  4. Assign the fill material and coarse cell labels to these entities.
+  //  5. Group preserving fragment with the model and grid. If tile_cells > 0,
+  //      this is done one tile of coarse cells at a time.
+  //  5a. If the model is 3D, group preserving intersection between the model
+  //      and the 2D rectangles.
+  //  6. Remove all entities that are not coarse cells.
+
+  // Get all model entities prior to adding the grid
+  gmsh::vectorpair model_dimtags;
+  int const model_dim = getModelEntities(model_dimtags);
+  // Get the unique coarse cell lower left corners
+  Size const num_cc = partition.numCoarseCells();
+  Vector<Point3<Float>> cc_lower_lefts; // Of the cut-plane
+  Vector<Vec3<Float>> cc_extents;
+  if (!getCoarseCellBoxes(partition, cc_lower_lefts, cc_extents)) {
+    return;
+  }
+  // The coarse cells to cut the model with. If representatives are given, only
+  // the representative of each set of identical coarse cells is kept.
+  if (!cc_representatives.empty() &&
+      cc_representatives.size() != static_cast<size_t>(num_cc)) {
+    Log::error("Number of coarse cell representatives does not match the number of "
+               "coarse cells");
+    return;
+  }
+  std::vector<Size> cc_ids;
+  for (Size i = 0; i < num_cc; ++i) {
+    if (cc_representatives.empty() || cc_representatives[static_cast<size_t>(i)] == i) {
+      cc_ids.push_back(i);
+    }
+  }
+  if (cc_ids.size() != static_cast<size_t>(num_cc)) {
+    Log::info("Meshing " + std::to_string(cc_ids.size()) + " of " +
+              std::to_string(num_cc) + " coarse cells");
+  }
+
+  // Entities that do not overlap any coarse cell would be removed after the
+  // fragment anyway, so remove them now to avoid fragmenting them.
+  std::vector<std::vector<int>> cc_objects(cc_ids.size()); // Overlapping entity tags
+  {
+    std::vector<std::vector<size_t>> overlaps;
+    getOverlappingEntities(getBoundingBoxes(model_dimtags), model_dim, cc_lower_lefts,
+                           cc_extents, cc_ids, overlaps);
+    for (size_t k = 0; k < cc_ids.size(); ++k) {
+      for (size_t const e : overlaps[k]) {
+        cc_objects[k].push_back(model_dimtags[e].second);
+      }
+    }
+    std::vector<int8_t> keep(model_dimtags.size(), 0);
+    for (auto const & entities : overlaps) {
+      for (size_t const e : entities) {
+        keep[e] = 1;
+      }
+    }
+    gmsh::vectorpair kept_dimtags;
+    gmsh::vectorpair pruned_dimtags;
+    for (size_t i = 0; i < model_dimtags.size(); ++i) {
+      if (keep[i] == 1) {
+        kept_dimtags.push_back(model_dimtags[i]);
+      } else {
+        pruned_dimtags.push_back(model_dimtags[i]);
+      }
+    }
+    if (!pruned_dimtags.empty()) {
+      Log::info("Removing " + std::to_string(pruned_dimtags.size()) +
+                " entities outside of the coarse cells");
+      gmsh::model::occ::remove(pruned_dimtags, /*recursive=*/true);
+      gmsh::model::removeEntities(pruned_dimtags, /*recursive=*/true);
+      gmsh::model::occ::synchronize();
+    }
+    model_dimtags = std::move(kept_dimtags);
+  }
 
   // Get materials and see if the fill material already exists
   // If it does, move it to the end of the material hierarchy, otherwise
@@ -1110,24 +1640,24 @@ overlaySpatialPartition(mpact::SpatialPartition const & partition,
   if (!fill_exists) {
     materials.emplace_back(ShortString(fill_material_name.c_str()), fill_material_color);
   }
-  std::vector<int> cc_tags(static_cast<size_t>(num_cc));
+  std::vector<int> cc_tags(cc_ids.size());
   namespace factory = gmsh::model::occ;
   if (model_dim == 2) {
     // Create rectangles
-    for (Size i = 0; i < num_cc; ++i) {
-      Point3<Float> const & ll = cc_lower_lefts[i];
-      Vec3<Float> const & ext = cc_extents[i];
-      cc_tags[static_cast<size_t>(i)] =
+    for (size_t i = 0; i < cc_ids.size(); ++i) {
+      Point3<Float> const & ll = cc_lower_lefts[cc_ids[i]];
+      Vec3<Float> const & ext = cc_extents[cc_ids[i]];
+      cc_tags[i] =
           factory::addRectangle(static_cast<double>(ll[0]), static_cast<double>(ll[1]),
                                 static_cast<double>(ll[2]), static_cast<double>(ext[0]),
                                 static_cast<double>(ext[1]));
     }
   } else {
     // Create boxes
-    for (Size i = 0; i < num_cc; ++i) {
-      Point3<Float> const & ll = cc_lower_lefts[i];
-      Vec3<Float> const & ext = cc_extents[i];
-      cc_tags[static_cast<size_t>(i)] =
+    for (size_t i = 0; i < cc_ids.size(); ++i) {
+      Point3<Float> const & ll = cc_lower_lefts[cc_ids[i]];
+      Vec3<Float> const & ext = cc_extents[cc_ids[i]];
+      cc_tags[i] =
           factory::addBox(static_cast<double>(ll[0]), static_cast<double>(ll[1]),
                           static_cast<double>(ll[2]), static_cast<double>(ext[0]),
                           static_cast<double>(ext[1]), static_cast<double>(ext[2]));
@@ -1135,28 +1665,52 @@ overlaySpatialPartition(mpact::SpatialPartition const & partition,
   }
   factory::synchronize();
 
-  // Assign physical groups
-  // Fill material is assigned to all slice rectangles
   std::string const fill_mat_full_name = "Material_" + fill_material_name;
-  addToPhysicalGroup(model_dim, cc_tags, -1, fill_mat_full_name);
-  // Add a physical group for each coarse cell
-  std::stringstream ss;
-  for (Size i = 0; i < num_cc; ++i) {
-    ss.str("");
-    ss << "Coarse_Cell_" << std::setw(5) << std::setfill('0') << i;
-    gmsh::model::addPhysicalGroup(model_dim, {cc_tags[static_cast<size_t>(i)]}, -1,
-                                  ss.str());
-  }
-  // Fragment
-  gmsh::vectorpair grid_dimtags(cc_tags.size());
-  for (size_t i = 0; i < cc_tags.size(); ++i) {
-    grid_dimtags[i] = {model_dim, cc_tags[i]};
+  if (tile_cells > 0) {
+    // Tiles of tile_cells x tile_cells coarse cells, by the position of the
+    // lower left corner of each coarse cell.
+    Float xmin = std::numeric_limits<Float>::max();
+    Float ymin = std::numeric_limits<Float>::max();
+    Float h = 0;
+    for (Size const id : cc_ids) {
+      xmin = std::min(xmin, cc_lower_lefts[id][0]);
+      ymin = std::min(ymin, cc_lower_lefts[id][1]);
+      h = std::max({h, cc_extents[id][0], cc_extents[id][1]});
+    }
+    Float const tile_len = static_cast<Float>(tile_cells) * h;
+    std::map<std::pair<int64_t, int64_t>, size_t> tile_index;
+    std::vector<size_t> cc_tile(cc_ids.size());
+    for (size_t k = 0; k < cc_ids.size(); ++k) {
+      Point3<Float> const & ll = cc_lower_lefts[cc_ids[k]];
+      // Nudge inward, so that round-off does not move a cell to the previous tile
+      auto const ix = static_cast<int64_t>(std::floor((ll[0] - xmin + h / 2) / tile_len));
+      auto const iy = static_cast<int64_t>(std::floor((ll[1] - ymin + h / 2) / tile_len));
+      cc_tile[k] = tile_index.try_emplace({iy, ix}, tile_index.size()).first->second;
+    }
+    fragmentByTile(model_dim, cc_ids, cc_tags, cc_objects, cc_tile, fill_mat_full_name,
+                   materials);
+  } else {
+    // Assign physical groups
+    // Fill material is assigned to all slice rectangles
+    addToPhysicalGroup(model_dim, cc_tags, -1, fill_mat_full_name);
+    // Add a physical group for each coarse cell
+    std::stringstream ss;
+    for (size_t i = 0; i < cc_ids.size(); ++i) {
+      ss.str("");
+      ss << "Coarse_Cell_" << std::setw(5) << std::setfill('0') << cc_ids[i];
+      gmsh::model::addPhysicalGroup(model_dim, {cc_tags[i]}, -1, ss.str());
+    }
+    // Fragment
+    gmsh::vectorpair grid_dimtags(cc_tags.size());
+    for (size_t i = 0; i < cc_tags.size(); ++i) {
+      grid_dimtags[i] = {model_dim, cc_tags[i]};
+    }
+    std::sort(grid_dimtags.begin(), grid_dimtags.end());
+    gmsh::vectorpair out_dimtags;
+    std::vector<gmsh::vectorpair> out_dimtags_map;
+    groupPreservingFragment(model_dimtags, grid_dimtags, out_dimtags, out_dimtags_map,
+                            materials);
   }
-  std::sort(grid_dimtags.begin(), grid_dimtags.end());
-  gmsh::vectorpair out_dimtags;
-  std::vector<gmsh::vectorpair> out_dimtags_map;
-  groupPreservingFragment(model_dimtags, grid_dimtags, out_dimtags, out_dimtags_map,
-                          materials);
 
   // Remove all entities that do not have a "Coarse_Cell" physical group
   // associated with them.
@@ -1231,12 +1785,12 @@ overlaySpatialPartition(mpact::SpatialPartition const & partition,
     }
     gmsh::vectorpair model_dimtags_2d;
     gmsh::model::getEntities(model_dimtags_2d, 2);
-    std::vector<int> cc_tags_2d(static_cast<size_t>(num_cc));
+    std::vector<int> cc_tags_2d(cc_ids.size());
     // Create rectangles
-    for (Size i = 0; i < num_cc; ++i) {
-      Point3<Float> const & ll = cc_lower_lefts[i];
-      Vec3<Float> const & ext = cc_extents[i];
-      cc_tags_2d[static_cast<size_t>(i)] =
+    for (size_t i = 0; i < cc_ids.size(); ++i) {
+      Point3<Float> const & ll = cc_lower_lefts[cc_ids[i]];
+      Vec3<Float> const & ext = cc_extents[cc_ids[i]];
+      cc_tags_2d[i] =
           factory::addRectangle(static_cast<double>(ll[0]), static_cast<double>(ll[1]),
                                 static_cast<double>(ll[2]), static_cast<double>(ext[0]),
                                 static_cast<double>(ext[1]));
@@ -1,635 +1,350 @@
 #include <um2/mpact/SpatialPartition.hpp>
 
+#include <array>   // std::array
+#include <cmath>   // std::sqrt, std::sin, std::cos
+#include <limits>  // std::numeric_limits
+#include <map>     // std::map
+#include <utility> // std::pair
+
 namespace um2::mpact
 {
 
-// template <std::floating_point T, std::signed_integral I>
-// int SpatialPartition::make_cylindrical_pin_mesh(
-//     std::vector<double> const & radii,
-//     double const pitch,
-//     std::vector<int> const & num_rings,
-//     int const num_azimuthal,
-//     int const mesh_order)
-//{
-//   if ((num_azimuthal & (num_azimuthal - 1)) != 0)
-//   {
-//     Log::error("The number of azimuthal divisions must be a power of 2");
-//   }
-//   if (num_azimuthal < 8)
-//   {
-//     Log::error("The number of azimuthal divisions must be at least 8 until someone
-//     fixes the AABB mesh for 4 divisions");
-//   }
-//   if (radii.size() != num_rings.size())
-//   {
-//     Log::error("The number of radii must match the size of the subradial rings
-//     vector");
-//   }
-//   if (std::any_of(radii.begin(), radii.end(), [pitch](double r) { return r > pitch / 2;
-//   }))
-//   {
-//     Log::error("The radii must be less than half the pitch");
-//   }
-//
-//   // radial region = region containing different materials (rings + outside of the last
-//   radius)
-//   //   radial_region_areas = area of each radial region, including outside of the last
-//   radius
-//   // ring = an equal area division of a radial region containing the same material
-//   //   ring_radii = the radius of each ring, NOT including the outside of the last
-//   radius
-//   //   ring_areas = the area of each ring, including the outside of the last radius
-//   Size mesh_id = -1;
-//   if (mesh_order == 1) {
-//     mesh_id = this->quad.size();
-//     Log::info("Making linear quadrilateral cylindrical pin mesh " +
-//     std::to_string(mesh_id));
-//   } else if (mesh_order == 2) {
-//     mesh_id = this->quadratic_quad.size();
-//     Log::info("Making quadratic quadrilateral cylindrical pin mesh " +
-//     std::to_string(mesh_id));
-//   } else {
-//     Log::error("Invalid mesh order");
-//   }
-//
-//   // Get the area of each radial region (rings + outside of the last ring)
-//   // --------------------------------------
-//   size_t const num_radial_regions = radii.size() + 1;
-//   std::vector<double> radial_region_areas(num_radial_regions); // Each of the radii +
-//   the pin pitch using std::numbers::pi;
-//   // A0 = pi * r0^2
-//   // Ai = pi * (ri^2 - ri-1^2)
-//   radial_region_areas[0] = pi * radii[0] * radii[0];
-//   for (size_t i = 1; i < num_radial_regions - 1; ++i)
-//   {
-//     radial_region_areas[i] = pi * (radii[i] * radii[i] - radii[i - 1] * radii[i - 1]);
-//   }
-//   radial_region_areas[num_radial_regions - 1] = pitch * pitch -
-//   radial_region_areas[num_radial_regions - 2];
-//
-//   // Get the radii and areas of each ring after splitting the radial regions
-//   // This includes outside of the last ring
-//   // --------------------------------------
-//   size_t const total_rings = std::reduce(num_rings.begin(), num_rings.end(), 0);
-//   std::vector<double> ring_radii(total_rings);
-//   std::vector<double> ring_areas(total_rings + 1);
-//   // Inside the innermost region
-//   ring_areas[0] = radial_region_areas[0] / num_rings[0];
-//   ring_radii[0] = std::sqrt(ring_areas[0] / pi);
-//   for (size_t i = 1; i < num_rings[0]; ++i)
-//   {
-//     ring_areas[i] = ring_areas[0];
-//     ring_radii[i] = std::sqrt(ring_areas[i] / pi + ring_radii[i - 1] * ring_radii[i -
-//     1]);
-//   }
-//   size_t ctr = num_rings[0];
-//   for (size_t ireg = 1; ireg < num_radial_regions - 1; ++ireg)
-//   {
-//     size_t const num_rings_in_region = num_rings[ireg];
-//     double const area_per_ring = radial_region_areas[ireg] / num_rings_in_region;
-//     for (size_t iring = 0; iring < num_rings_in_region; ++iring, ++ctr)
-//     {
-//       ring_areas[ctr] = area_per_ring;
-//       ring_radii[ctr] = std::sqrt(area_per_ring / pi + ring_radii[ctr - 1] *
-//       ring_radii[ctr - 1]);
-//     }
-//   }
-//   // Outside of the last ring
-//   ring_areas[ctr] = pitch * pitch - pi * ring_radii.back() * ring_radii.back();
-//   // Log the radii and areas in debug mode
-//   for (size_t i = 0; i < total_rings; ++i)
-//   {
-//     Log::debug("Ring " + std::to_string(i) + " radius: " +
-//     std::to_string(ring_radii[i])); Log::debug("Ring " + std::to_string(i) + " area: "
-//     + std::to_string(ring_areas[i]));
-//   }
-//   Log::debug("The area outside of the last ring is " +
-//   std::to_string(ring_areas[ctr]));
-//   // Ensure the sum of the ring areas is equal to pitch^2
-//   double const sum_ring_areas = std::reduce(ring_areas.begin(), ring_areas.end(), 0.0);
-//   UM2_ASSERT(std::abs(sum_ring_areas - pitch * pitch) < 1e-6)
-//
-//   if (mesh_order == 1)
-//   {
-//     // Get the equivalent radius of each ring if it were a quadrilateral
-//     double const theta = 2 * pi / num_azimuthal;
-//     double const sin_theta = std::sin(theta);
-//     std::vector<double> eq_radii(total_rings);
-//     // The innermost radius is a special case, and is essentially a triangle.
-//     // A_t = l² * sin(θ) / 2
-//     // A_ring = num_azi * A_t = l² * sin(θ) * num_azi / 2
-//     // l = sqrt(2 * A_ring / (sin(θ) * num_azi))
-//     eq_radii[0] = sqrt(2 * ring_areas[0] / (sin_theta * num_azimuthal));
-//     // A_q = (l² - l²₀) * sin(θ) / 2
-//     // A_ring = num_azi * A_q = (l² - l²₀) * sin(θ) * num_azi / 2
-//     // l = sqrt(2 * A_ring / (sin(θ) * num_azi) + l²₀)
-//     for (size_t i = 1; i < total_rings; ++i)
-//     {
-//       eq_radii[i] = sqrt(2 * ring_areas[i] / (sin_theta * num_azimuthal) + eq_radii[i -
-//       1] * eq_radii[i - 1]);
-//     }
-//     // Log the equivalent radii in debug mode
-//     for (size_t i = 0; i < total_rings; ++i)
-//     {
-//       Log::debug("Ring " + std::to_string(i) + " equivalent radius: " +
-//       std::to_string(eq_radii[i]));
-//     }
-//     // If any of the equivalent radii are larger than half the pitch, error
-//     if (std::any_of(eq_radii.begin(), eq_radii.end(), [pitch](double r) { return r >
-//     pitch / 2; }))
-//     {
-//       Log::error("The equivalent radius of a ring is larger than half the pitch.");
-//       return -1;
-//     }
-//     // Sanity check: ensure the sum of the quadrilateral areas in a ring is equal to
-//     the ring area UM2_ASSERT(std::abs(eq_radii[0] * eq_radii[0] * sin_theta / 2 -
-//     ring_areas[0] / num_azimuthal) < 1e-4) for (size_t i = 0; i < total_rings; ++i)
-//     {
-//       double const area = (eq_radii[i] * eq_radii[i] - eq_radii[i - 1] * eq_radii[i -
-//       1]) * sin_theta / 2; UM2_ASSERT(std::abs(area - ring_areas[i] / num_azimuthal) <
-//       1e-4)
-//     }
-//
-//     // Get the points that make up the mesh
-//     // -------------------------------------
-//     // The number of points is:
-//     //   Center point
-//     //   num_azimuthal / 2, for the points in the innermost ring to make the quads
-//     "triangular"
-//     //   (num_rings + 1) * num_azimuthal
-//     size_t const num_points = 1 + (total_rings + 1) * num_azimuthal + num_azimuthal /
-//     2; std::vector<Point2d> vertices(num_points);
-//     // Center point
-//     vertices[0] = {0, 0};
-//     // Triangular points
-//     double const rt = eq_radii[0] / 2;
-//     for (size_t ia = 0; ia < num_azimuthal / 2; ++ia)
-//     {
-//       double const sin_ia_theta = std::sin(theta * (2 * ia + 1));
-//       double const cos_ia_theta = std::cos(theta * (2 * ia + 1));
-//       vertices[1 + ia] = {rt * cos_ia_theta, rt * sin_ia_theta};
-//     }
-//     // Quadrilateral points
-//     // Points on rings, not including the boundary of the pin (pitch / 2 box)
-//     for (size_t ir = 0; ir < total_rings; ++ir)
-//     {
-//       size_t const num_prev_points = 1 + num_azimuthal / 2 + ir * num_azimuthal;
-//       for (size_t ia = 0; ia < num_azimuthal; ++ia)
-//       {
-//         double sin_ia_theta = std::sin(theta * ia);
-//         double cos_ia_theta = std::cos(theta * ia);
-//         if (std::abs(sin_ia_theta) < 1e-6)
-//         {
-//           sin_ia_theta = 0;
-//         }
-//         if (std::abs(cos_ia_theta) < 1e-6)
-//         {
-//           cos_ia_theta = 0;
-//         }
-//         vertices[num_prev_points + ia] = {eq_radii[ir] * cos_ia_theta, eq_radii[ir] *
-//         sin_ia_theta};
-//       }
-//     }
-//     // Points on the boundary of the pin (pitch / 2)
-//     size_t const num_prev_points = 1 + num_azimuthal / 2 + total_rings * num_azimuthal;
-//     for (size_t ia = 0; ia < num_azimuthal; ++ia)
-//     {
-//       double sin_ia_theta = std::sin(theta * ia);
-//       double cos_ia_theta = std::cos(theta * ia);
-//       if (std::abs(sin_ia_theta) < 1e-6)
-//       {
-//         sin_ia_theta = 0;
-//       }
-//       if (std::abs(cos_ia_theta) < 1e-6)
-//       {
-//         cos_ia_theta = 0;
-//       }
-//       double const rx = std::abs(pitch / (2 * cos_ia_theta));
-//       double const ry = std::abs(pitch / (2 * sin_ia_theta));
-//       double const rb = std::min(rx, ry);
-//       vertices[num_prev_points + ia] = {rb * cos_ia_theta, rb * sin_ia_theta};
-//     }
-//     for (size_t i = 0; i < num_points; ++i)
-//     {
-//       Log::debug("Point " + std::to_string(i) + ": " + std::to_string(vertices[i][0]) +
-//       ", " + std::to_string(vertices[i][1]));
-//     }
-//
-//     // Get the faces that make up the mesh
-//     // -----------------------------------
-//     size_t const num_faces = num_azimuthal * (total_rings + 1);
-//     std::vector<Vec<4, size_t>> faces(num_faces);
-//     // Establish a few aliases
-//     size_t const na = num_azimuthal;
-//     size_t const nr = total_rings;
-//     size_t const ntric = 1 + na / 2; // Number of triangular points + center point
-//     // Triangular quads
-//     for (size_t ia = 0; ia < na / 2; ++ia)
-//     {
-//       size_t const p0 = 0;                  // Center point
-//       size_t const p1 = ntric + ia * 2;      // Bottom right point on ring
-//       size_t const p2 = ntric + ia * 2 + 1;  // Top right point on ring
-//       size_t const p3 = 1 + ia;             // The triangular point
-//       size_t       p4 = ntric + ia * 2 + 2;  // Top left point on ring
-//       // If we're at the end of the ring, wrap around
-//       if (p4 == ntric + na)
-//       {
-//         p4 = ntric;
-//       }
-//       faces[2 * ia    ] = {p0, p1, p2, p3};
-//       faces[2 * ia + 1] = {p0, p3, p2, p4};
-//     }
-//     // Non-boundary and boundary quads
-//     for (size_t ir = 1; ir < nr + 1; ++ir)
-//     {
-//       for (size_t ia = 0; ia < na; ++ia)
-//       {
-//         size_t const p0 = ntric + (ir - 1) * na + ia;     // Bottom left point
-//         size_t const p1 = ntric + (ir    ) * na + ia;     // Bottom right point
-//         size_t       p2 = ntric + (ir    ) * na + ia + 1; // Top right point
-//         size_t       p3 = ntric + (ir - 1) * na + ia + 1; // Top left point
-//         // If we're at the end of the ring, wrap around
-//         if (ia + 1 == na)
-//         {
-//           p2 -= na;
-//           p3 -= na;
-//         }
-//         faces[ir * na + ia] = {p0, p1, p2, p3};
-//       }
-//     }
-//     Vector<Point2<Float>> vertices_t(static_cast<Size>(num_points));
-//     double const half_pitch = pitch / 2;
-//     for (size_t i = 0; i < num_points; ++i)
-//     {
-//       vertices_t[i] = {static_cast<Float>(vertices[i][0] + half_pitch),
-//                        static_cast<Float>(vertices[i][1] + half_pitch)};
-//       // Fix close to zero values
-//       if (std::abs(vertices_t[i][0]) < 1e-6)
-//       {
-//         vertices_t[i][0] = 0;
-//       }
-//       if (std::abs(vertices_t[i][1]) < 1e-6)
-//       {
-//         vertices_t[i][1] = 0;
-//       }
-//     }
-//     Vector<Int> faces_t(static_cast<Size>(num_faces * 4));
-//     for (size_t i = 0; i < num_faces; ++i)
-//     {
-//       faces_t[4 * i    ] = static_cast<Int>(faces[i][0]);
-//       faces_t[4 * i + 1] = static_cast<Int>(faces[i][1]);
-//       faces_t[4 * i + 2] = static_cast<Int>(faces[i][2]);
-//       faces_t[4 * i + 3] = static_cast<Int>(faces[i][3]);
-//     }
-//     this->quad.push_back(QuadMesh<Float, Int>(vertices_t, {}, faces_t));
-//     return mesh_id;
-//   } else if (mesh_order == 2) {
-//     // Get the equivalent radius of each ring if it were a quadratic quadrilateral
-//     double const theta = 2 * pi / num_azimuthal;
-//     double const gamma = theta / 2;
-//     double const sin_gamma = std::sin(gamma);
-//     double const cos_gamma = std::cos(gamma);
-//     double const sincos_gamma = sin_gamma * cos_gamma;
-//     std::vector<double> eq_radii(total_rings);
-//     // The innermost radius is a special case, and is essentially a triangle.
-//     // Each quadratic shape is made up of the linear shape plus quadratic edges
-//     // A_t = l² * sin(θ) / 2 = l² * sin(θ/2) * cos(θ/2)
-//     // A_q = (l² - l²₀) * sin(θ) / 2 = (l² - l²₀) * sin(θ/2) * cos(θ/2)
-//     // A_edge = (4 / 3) the area of the triangle formed by the vertices of the edge.
-//     //        = (4 / 3) * 2l sin(θ/2) * (L - l cos(θ/2)) / 2 = (4 / 3) * l sin(θ/2) *
-//     (L - l cos(θ/2))
-//     //
-//     // For N + 1 rings
-//     // A_0 = pi R_0² = Na ( A_t + A_e0)
-//     // A_i = pi (R_i² - R_{i-1}²) = Na ( A_q + A_ei - A_ei-1)
-//     // A_N = P² - pi R_N² = P² - sum_i=0^N A_i
-//     // Constraining L_N to be the value which minimizes the 2-norm of the integral of
-//     the quadratic segment
-//     // minus the circle arc is the correct thing to do, but holy cow the integral is a
-//     mess.
-//     // Therefore we settle for constraining l_i = r_i
-//     double tri_area = ring_radii[0] * ring_radii[0] * sincos_gamma;
-//     double ring_area = ring_areas[0] / num_azimuthal;
-//     double l = ring_radii[0];
-//     eq_radii[0] = 0.75 * (ring_area - tri_area) / (l * sin_gamma) + l * cos_gamma;
-//     for (size_t i = 1; i < total_rings; ++i)
-//     {
-//       double const l_im1 = ring_radii[i - 1];
-//       double const L_im1 = eq_radii[i - 1];
-//       double const A_edge_im1 = (4.0 / 3.0) * l_im1 * sin_gamma * (L_im1 - l_im1 *
-//       cos_gamma); double const l = ring_radii[i]; double const A_quad = (l * l - l_im1
-//       * l_im1) * sincos_gamma; double const A_ring = ring_areas[i] / num_azimuthal;
-//       eq_radii[i] = 0.75 * (A_ring - A_quad + A_edge_im1) / (l * sin_gamma) + l *
-//       cos_gamma;
-//     }
-//     // Log the equivalent radii in debug mode
-//     for (size_t i = 0; i < total_rings; ++i)
-//     {
-//       Log::debug("Ring " + std::to_string(i) + " equivalent radius: " +
-//       std::to_string(eq_radii[i]));
-//     }
-//     // If any of the equivalent radii are larger than half the pitch, error
-//     if (std::any_of(eq_radii.begin(), eq_radii.end(), [pitch](double r) { return r >
-//     pitch / 2; }))
-//     {
-//       Log::error("The equivalent radius of a ring is larger than half the pitch.");
-//       return -1;
-//     }
-//
-//     // Get the points that make up the mesh
-//     // -------------------------------------
-//     // The number of points is:
-//     //   Center point
-//     //   2 * num_azimuthal for the triangular points inside the first ring
-//     //   2 * num_azimuthal for the triangular points on the first ring
-//     //   3 * num_azimuthal * total_rings
-//     //
-//     // Some aliases to make the code more readable
-//     size_t const na = num_azimuthal;
-//     size_t const nr = total_rings;
-//     size_t const num_points = 1 + 4 * na + 3 * na * nr;
-//     std::vector<Point2d> vertices(num_points);
-//     // Center point
-//     vertices[0] = {0, 0};
-//     // Triangular points
-//     double const rt = ring_radii[0] / 2;
-//     for (size_t ia = 0; ia < na; ++ia)
-//     {
-//       double const sin_ia_theta = std::sin(ia * theta);
-//       double const cos_ia_theta = std::cos(ia * theta);
-//       // if ia is 0 or even, just do the 1 center point, otherwise we need 3 points at
-//       (1/4, 2/4, 3/4) of the radius if (ia % 2 == 0)
-//       {
-//         vertices[1 + 2 * ia] = {rt * cos_ia_theta, rt * sin_ia_theta};
-//       }
-//       else
-//       {
-//         vertices[2 * ia] = {rt * cos_ia_theta / 2, rt * sin_ia_theta / 2};
-//         vertices[2 * ia + 1] = {rt * cos_ia_theta, rt * sin_ia_theta};
-//         vertices[2 * ia + 2] = {3 * rt * cos_ia_theta / 2, 3 * rt * sin_ia_theta / 2};
-//       }
-//     }
-//     // Points on the first ring
-//     size_t num_prev_points = 1 + 2 * na;
-//     for (size_t ia = 0; ia < 2 * na; ++ia)
-//     {
-//       double sin_ia_gamma = std::sin(ia * gamma);
-//       double cos_ia_gamma = std::cos(ia * gamma);
-//       if (std::abs(sin_ia_gamma) < 1e-6)
-//       {
-//         sin_ia_gamma = 0;
-//       }
-//       if (std::abs(cos_ia_gamma) < 1e-6)
-//       {
-//         cos_ia_gamma = 0;
-//       }
-//       // if ia is 0 or even, we want the point at ring_radii[ir], otherwise we want the
-//       point at eq_radii[ir] if (ia % 2 == 0)
-//       {
-//         vertices[num_prev_points + ia] = {ring_radii[0] * cos_ia_gamma, ring_radii[0] *
-//         sin_ia_gamma};
-//       }
-//       else
-//       {
-//         vertices[num_prev_points + ia] = {eq_radii[0] * cos_ia_gamma, eq_radii[0] *
-//         sin_ia_gamma};
-//       }
-//     }
-//     // Points on and between the rings
-//     for (size_t ir = 1; ir < total_rings; ++ir)
-//     {
-//       num_prev_points = 1 + 4 * na + 3 * na * (ir - 1);
-//       // Between the rings
-//       for (size_t ia = 0; ia < num_azimuthal; ++ia)
-//       {
-//         double sin_ia_theta = std::sin(ia * theta);
-//         double cos_ia_theta = std::cos(ia * theta);
-//         if (std::abs(sin_ia_theta) < 1e-6)
-//         {
-//           sin_ia_theta = 0;
-//         }
-//         if (std::abs(cos_ia_theta) < 1e-6)
-//         {
-//           cos_ia_theta = 0;
-//         }
-//         double const r = (ring_radii[ir] + ring_radii[ir - 1]) / 2;
-//         vertices[num_prev_points + ia] = {r * cos_ia_theta, r * sin_ia_theta};
-//       }
-//       num_prev_points += num_azimuthal;
-//       for (size_t ia = 0; ia < 2 * num_azimuthal; ++ia)
-//       {
-//         double sin_ia_gamma = std::sin(ia * gamma);
-//         double cos_ia_gamma = std::cos(ia * gamma);
-//         if (std::abs(sin_ia_gamma) < 1e-6)
-//         {
-//           sin_ia_gamma = 0;
-//         }
-//         if (std::abs(cos_ia_gamma) < 1e-6)
-//         {
-//           cos_ia_gamma = 0;
-//         }
-//         // if ia is 0 or even, we want the point at ring_radii[ir], otherwise we want
-//         the point at eq_radii[ir] if (ia % 2 == 0)
-//         {
-//           vertices[num_prev_points + ia] = {ring_radii[ir] * cos_ia_gamma,
-//           ring_radii[ir] * sin_ia_gamma};
-//         }
-//         else
-//         {
-//           vertices[num_prev_points + ia] = {eq_radii[ir] * cos_ia_gamma, eq_radii[ir] *
-//           sin_ia_gamma};
-//         }
-//       }
-//     }
-//     // Quadratic points before the boundary
-//     num_prev_points = 1 + 4 * na + 3 * na * (total_rings - 1);
-//     for (size_t ia = 0; ia < num_azimuthal; ++ia)
-//     {
-//       double sin_ia_theta = std::sin(ia * theta);
-//       double cos_ia_theta = std::cos(ia * theta);
-//       if (std::abs(sin_ia_theta) < 1e-6)
-//       {
-//         sin_ia_theta = 0;
-//       }
-//       if (std::abs(cos_ia_theta) < 1e-6)
-//       {
-//         cos_ia_theta = 0;
-//       }
-//       // pitch and last ring radius
-//       double const rx = std::abs(pitch / (2 * cos_ia_theta));
-//       double const ry = std::abs(pitch / (2 * sin_ia_theta));
-//       double const rb = std::min(rx, ry);
-//       double const r = (rb + ring_radii[total_rings - 1]) / 2;
-//       vertices[num_prev_points + ia] = {r * cos_ia_theta, r * sin_ia_theta};
-//     }
-//     // Points on the boundary of the pin (pitch / 2)
-//     num_prev_points += num_azimuthal;
-//     for (size_t ia = 0; ia < 2 * num_azimuthal; ++ia)
-//     {
-//       double sin_ia_gamma = std::sin(gamma * ia);
-//       double cos_ia_gamma = std::cos(gamma * ia);
-//       if (std::abs(sin_ia_gamma) < 1e-6)
-//       {
-//         sin_ia_gamma = 0;
-//       }
-//       if (std::abs(cos_ia_gamma) < 1e-6)
-//       {
-//         cos_ia_gamma = 0;
-//       }
-//       double const rx = std::abs(pitch / (2 * cos_ia_gamma));
-//       double const ry = std::abs(pitch / (2 * sin_ia_gamma));
-//       double const rb = std::min(rx, ry);
-//       vertices[num_prev_points + ia] = {rb * cos_ia_gamma, rb * sin_ia_gamma};
-//     }
-//     for (size_t i = 0; i < num_points; ++i)
-//     {
-//       Log::debug("Point " + std::to_string(i) + ": " + std::to_string(vertices[i][0]) +
-//       ", " + std::to_string(vertices[i][1]));
-//     }
-//
-//     // Get the faces that make up the mesh
-//     // -----------------------------------
-//     size_t const num_faces = na * (nr + 1);
-//     std::vector<Vec<8, size_t>> faces(num_faces);
-//     // Triangular quads
-//     for (size_t ia = 0; ia < na / 2; ++ia)
-//     {
-//       size_t const p0 = 0;                      // Center point
-//       size_t const p1 = 1 + 2 * na + 4 * ia;    // Bottom right point on ring
-//       size_t const p2 = p1 + 2;                 // Top right point on ring
-//       size_t const p3 = 3 + 4 * ia;             // The triangular point
-//       size_t       p4 = p2 + 2;                 // Top left point on ring
-//       size_t const p5 = 1 + 4 * ia;             // Bottom quadratic point
-//       size_t const p6 = p1 + 1;                 // Right quadratic point
-//       size_t const p7 = p3 + 1;                 // Top tri quadratic point
-//       size_t const p8 = p3 - 1;                 // Bottom tri quadratic point
-//       size_t const p9 = p2 + 1;                 // Top right quadratic point
-//       size_t       p10 = p7 + 1;                // Top left quadratic point
-//       // If we're at the end of the ring, wrap around
-//       if (p10 == 1 + 2 * na)
-//       {
-//         p4 -= 2 * na;
-//         p10 -= 2 * na;
-//       }
-//       faces[2 * ia    ] = {p0, p1, p2, p3, p5, p6, p7, p8};
-//       faces[2 * ia + 1] = {p0, p3, p2, p4, p8, p7, p9, p10};
-//     }
-//     // All other faces
-//     for (size_t ir = 1; ir < nr + 1; ++ir)
-//     {
-//       size_t const np = 1 + 2 * na + 3 * na * (ir - 1);
-//       for (size_t ia = 0; ia < na; ++ia)
-//       {
-//         size_t const p0 = np + 2 * ia;
-//         size_t const p1 = p0 + 3 * na;
-//         size_t       p2 = p1 + 2;
-//         size_t       p3 = p0 + 2;
-//         size_t const p4 = np + 2 * na + ia;
-//         size_t const p5 = p1 + 1;
-//         size_t       p6 = p4 + 1;
-//         size_t const p7 = p0 + 1;
-//         // If we're at the end of the ring, wrap around
-//         if (ia + 1 == na)
-//         {
-//           p2 -= 2 * na;
-//           p3 -= 2 * na;
-//           p6 -= na;
-//         }
-//         faces[ir * na + ia] = {p0, p1, p2, p3, p4, p5, p6, p7};
-//       }
-//     }
-//     // Print the faces
-//     for (size_t i = 0; i < num_faces; ++i)
-//     {
-//       Log::debug("Face " + std::to_string(i) + ": " + std::to_string(faces[i][0]) + ",
-//       " + std::to_string(faces[i][1]) + ", " + std::to_string(faces[i][2]) + ", " +
-//       std::to_string(faces[i][3]) + ", " + std::to_string(faces[i][4]) + ", " +
-//       std::to_string(faces[i][5]) + ", " + std::to_string(faces[i][6]) + ", " +
-//       std::to_string(faces[i][7]));
-//     }
-//
-//     Vector<Point2<Float>> vertices_t(static_cast<Size>(num_points));
-//     double const half_pitch = pitch / 2;
-//     for (size_t i = 0; i < num_points; ++i)
-//     {
-//       vertices_t[i] = {static_cast<Float>(vertices[i][0] + half_pitch),
-//                        static_cast<Float>(vertices[i][1] + half_pitch)};
-//       // Fix close to zero values
-//       if (std::abs(vertices_t[i][0]) < 1e-6)
-//       {
-//         vertices_t[i][0] = 0;
-//       }
-//       if (std::abs(vertices_t[i][1]) < 1e-6)
-//       {
-//         vertices_t[i][1] = 0;
-//       }
-//     }
-//     Vector<Int> faces_t(static_cast<Size>(num_faces * 8));
-//     for (size_t i = 0; i < num_faces; ++i)
-//     {
-//       faces_t[8 * i    ] = static_cast<Int>(faces[i][0]);
-//       faces_t[8 * i + 1] = static_cast<Int>(faces[i][1]);
-//       faces_t[8 * i + 2] = static_cast<Int>(faces[i][2]);
-//       faces_t[8 * i + 3] = static_cast<Int>(faces[i][3]);
-//       faces_t[8 * i + 4] = static_cast<Int>(faces[i][4]);
-//       faces_t[8 * i + 5] = static_cast<Int>(faces[i][5]);
-//       faces_t[8 * i + 6] = static_cast<Int>(faces[i][6]);
-//       faces_t[8 * i + 7] = static_cast<Int>(faces[i][7]);
-//     }
-//     this->quadratic_quad.push_back(QuadraticQuadMesh<Float, Int>(vertices_t, {},
-//     faces_t)); return mesh_id;
-//   } else {
-//     Log::error("Only linear meshes are supported for cylindrical pin meshes.");
-//     return -1;
-//   }
-//   return 0;
-// }
-//
-// template <std::floating_point T, std::signed_integral I>
-// int SpatialPartition::make_rectangular_pin_mesh(Vec2<Float> const dxdy,
-//                                                       int const nx,
-//                                                       int const ny)
-//{
-//   if (dxdy[0] <= 0 || dxdy[1] <= 0)
-//   {
-//     Log::error("Pin dimensions must be positive");
-//   }
-//   if ( nx <= 0 || ny <= 0 )
-//   {
-//     Log::error("Number of divisions in x and y must be positive");
-//   }
+//=============================================================================
+// makeCylindricalPinMesh
+//=============================================================================
+// The pin is divided into radial regions by the radii, and each radial region
+// is divided into equal-area rings. Each ring is divided into num_azimuthal
+// faces. The boundaries of the rings are placed such that each ring in the mesh
+// has exactly the area of the ring it represents.
 //
-//   Size mesh_id = mesh_id = this->quad.size();
-//   Log::info("Making rectangular pin mesh " + std::to_string(mesh_id));
+// Linear mesh:
+//  The ring boundaries are regular polygons with num_azimuthal sides. The
+//  innermost ring is made of num_azimuthal / 2 kites, each with a vertex at
+//  the center and three vertices on the first ring, so that every face is a
+//  convex quadrilateral.
 //
-//   // Make the vertices
-//   Vector<Point2<Float>> vertices(static_cast<Size>((nx + 1) * (ny + 1)));
-//   Float const delta_x = dxdy[0] / nx;
-//   Float const delta_y = dxdy[1] / ny;
-//   for (Size j = 0; j < ny + 1; ++j)
-//   {
-//     for (Size i = 0; i < nx + 1; ++i)
-//     {
-//       vertices[j * (nx + 1) + i] = {i * delta_x, j * delta_y};
-//     }
-//   }
-//   // Make the faces
-//   Vector<Int> faces(4 * static_cast<Size>(nx * ny));
-//   // Left to right, bottom to top
-//   for (Size j = 0; j < ny; ++j)
-//   {
-//     for (Size i = 0; i < nx; ++i)
-//     {
-//       faces[4 * (j * nx + i)    ] = (j    ) * (nx + 1) + i    ;
-//       faces[4 * (j * nx + i) + 1] = (j    ) * (nx + 1) + i + 1;
-//       faces[4 * (j * nx + i) + 2] = (j + 1) * (nx + 1) + i + 1;
-//       faces[4 * (j * nx + i) + 3] = (j + 1) * (nx + 1) + i    ;
-//     }
-//   }
-//   this->quad.push_back(QuadMesh<Float, Int>(vertices, {}, faces));
-//   return mesh_id;
-// }
+// Quadratic mesh:
+//  The vertices lie on the actual ring radii and the edges along the rings are
+//  quadratic segments. The midpoint of each such edge is pushed outward until
+//  the ring area is matched. The area between a quadratic segment and its
+//  chord is 4/3 the area of the triangle formed by the segment's vertices.
+//  Hence, with γ = θ / 2, an edge with vertices at radius l and midpoint at
+//  radius L adds
+//      A_edge = (4 / 3) * l * sin(γ) * (L - l * cos(γ))
+//  to the area of the face inside it and removes it from the face outside it.
 //
+// Since num_azimuthal is a multiple of 8, the outermost vertices include the
+// corners of the pin, so the outermost faces exactly fill the remaining area.
+
+namespace
+{
+
+// Map the direction (cos, sin) to the boundary of the square [-h, h]^2, snapping
+// coordinates that are within round-off of 0 or h.
+auto
+squareBoundaryPoint(Float const c, Float const s, Float const h) -> Point2<Float>
+{
+  Float const eps = 1000 * std::numeric_limits<Float>::epsilon() * h;
+  Float const t = h / um2::max(std::abs(c), std::abs(s));
+  Point2<Float> p(t * c, t * s);
+  for (Size i = 0; i < 2; ++i) {
+    if (std::abs(p[i]) < eps) {
+      p[i] = 0;
+    } else if (std::abs(std::abs(p[i]) - h) < eps) {
+      p[i] = std::copysign(h, p[i]);
+    }
+  }
+  return p;
+}
+
+} // namespace
+
+auto
+SpatialPartition::makeCylindricalPinMesh(std::vector<Float> const & radii,
+                                         Float const pitch,
+                                         std::vector<Size> const & num_rings,
+                                         Size const num_azimuthal, Size const mesh_order)
+    -> Size
+{
+  if ((num_azimuthal & (num_azimuthal - 1)) != 0 || num_azimuthal < 8) {
+    Log::error("The number of azimuthal divisions must be a power of 2 and at least 8");
+    return -1;
+  }
+  if (radii.empty() || radii.size() != num_rings.size()) {
+    Log::error("The number of radii must match the size of the number of rings vector");
+    return -1;
+  }
+  for (size_t i = 0; i < radii.size(); ++i) {
+    if (radii[i] <= 0 || (i > 0 && radii[i] <= radii[i - 1])) {
+      Log::error("The radii must be positive and strictly increasing");
+      return -1;
+    }
+    if (num_rings[i] < 1) {
+      Log::error("Each radial region must have at least one ring");
+      return -1;
+    }
+  }
+  if (radii.back() >= pitch / 2) {
+    Log::error("The radii must be less than half the pitch");
+    return -1;
+  }
+  if (mesh_order != 1 && mesh_order != 2) {
+    Log::error("Invalid mesh order: " + std::to_string(mesh_order));
+    return -1;
+  }
+
+  // Get the radius and area of each ring
+  // -------------------------------------------------------------------------
+  Float const pi_f = pi<Float>;
+  std::vector<Float> ring_radii;
+  std::vector<Float> ring_areas;
+  Float r_prev = 0;
+  for (size_t ireg = 0; ireg < radii.size(); ++ireg) {
+    Float const region_area = pi_f * (radii[ireg] * radii[ireg] - r_prev * r_prev);
+    Float const ring_area = region_area / static_cast<Float>(num_rings[ireg]);
+    for (Size iring = 0; iring < num_rings[ireg]; ++iring) {
+      Float const r_in = ring_radii.empty() ? 0 : ring_radii.back();
+      ring_radii.push_back(std::sqrt(ring_area / pi_f + r_in * r_in));
+      ring_areas.push_back(ring_area);
+    }
+    // Avoid drift in the last ring of the region
+    ring_radii.back() = radii[ireg];
+    r_prev = radii[ireg];
+  }
+  auto const nr = static_cast<Size>(ring_radii.size());
+  Size const na = num_azimuthal;
+  Float const theta = 2 * pi_f / static_cast<Float>(na);
+  Float const gamma = theta / 2;
+  Float const half_pitch = pitch / 2;
+
+  // Get the radius of the vertices on each ring and, for quadratic meshes, of
+  // the midpoints of the edges along each ring.
+  // -------------------------------------------------------------------------
+  std::vector<Float> vert_radii(static_cast<size_t>(nr));
+  std::vector<Float> mid_radii(static_cast<size_t>(nr));
+  if (mesh_order == 1) {
+    // A_ring = na * (l² - l²_prev) * sin(θ) / 2
+    Float l_prev = 0;
+    for (size_t i = 0; i < ring_areas.size(); ++i) {
+      Float const l = std::sqrt(2 * ring_areas[i] /
+                                    (std::sin(theta) * static_cast<Float>(na)) +
+                                l_prev * l_prev);
+      vert_radii[i] = l;
+      l_prev = l;
+    }
+  } else {
+    Float const sin_gamma = std::sin(gamma);
+    Float const cos_gamma = std::cos(gamma);
+    Float l_prev = 0;
+    Float edge_area_prev = 0;
+    for (size_t i = 0; i < ring_areas.size(); ++i) {
+      Float const l = ring_radii[i];
+      Float const lin_area = (l * l - l_prev * l_prev) * sin_gamma * cos_gamma;
+      Float const edge_area =
+          ring_areas[i] / static_cast<Float>(na) - lin_area + edge_area_prev;
+      vert_radii[i] = l;
+      mid_radii[i] = 3 * edge_area / (4 * l * sin_gamma) + l * cos_gamma;
+      l_prev = l;
+      edge_area_prev = edge_area;
+    }
+  }
+  Float const r_max = mesh_order == 1 ? vert_radii.back() : mid_radii.back();
+  if (r_max >= half_pitch) {
+    Log::error("The outermost ring does not fit in the pin. Use fewer rings in the "
+               "outermost radial region or more azimuthal divisions");
+    return -1;
+  }
+
+  Size mesh_id = -1;
+  if (mesh_order == 1) {
+    mesh_id = quad.size();
+    Log::info("Making linear quadrilateral cylindrical pin mesh " +
+              std::to_string(mesh_id));
+  } else {
+    mesh_id = quadratic_quad.size();
+    Log::info("Making quadratic quadrilateral cylindrical pin mesh " +
+              std::to_string(mesh_id));
+  }
+
+  // Vertices
+  // -------------------------------------------------------------------------
+  // The mesh is built about the center of the pin, then shifted so that the
+  // bottom left corner is at the origin.
+  MeshFile<Float, Int> mesh_file;
+  auto const add_vertex = [&mesh_file](Point2<Float> const & p) -> Int {
+    mesh_file.vertices.emplace_back(p[0], p[1], static_cast<Float>(0));
+    return static_cast<Int>(mesh_file.vertices.size() - 1);
+  };
+  auto const polar = [](Float const r, Float const phi) -> Point2<Float> {
+    return {r * std::cos(phi), r * std::sin(phi)};
+  };
+  Int const center = add_vertex({0, 0});
+  // Vertices on the rings. Ring nr is the boundary of the pin.
+  std::vector<std::vector<Int>> ring_verts(static_cast<size_t>(nr + 1),
+                                           std::vector<Int>(static_cast<size_t>(na)));
+  for (Size ir = 0; ir <= nr; ++ir) {
+    for (Size ia = 0; ia < na; ++ia) {
+      Float const phi = static_cast<Float>(ia) * theta;
+      Point2<Float> const p =
+          ir == nr ? squareBoundaryPoint(std::cos(phi), std::sin(phi), half_pitch)
+                   : polar(vert_radii[static_cast<size_t>(ir)], phi);
+      ring_verts[static_cast<size_t>(ir)][static_cast<size_t>(ia)] = add_vertex(p);
+    }
+  }
+
+  // Faces
+  // -------------------------------------------------------------------------
+  // Faces are ordered ring by ring from the center outward, and by angle
+  // within each ring, starting at the positive x-axis.
+  Size const num_faces = na / 2 + na * nr;
+  Size const verts_per_face = mesh_order == 1 ? 4 : 8;
+  MeshType const mesh_type = mesh_order == 1 ? MeshType::Quad : MeshType::QuadraticQuad;
+  mesh_file.element_types.assign(static_cast<size_t>(num_faces), mesh_type);
+  mesh_file.element_offsets.resize(static_cast<size_t>(num_faces + 1));
+  for (Size i = 0; i <= num_faces; ++i) {
+    mesh_file.element_offsets[static_cast<size_t>(i)] = i * verts_per_face;
+  }
+  // The midpoints of straight edges are shared by the two faces on either side.
+  std::map<std::pair<Int, Int>, Int> straight_mids;
+  auto const straight_mid = [&](Int const a, Int const b) -> Int {
+    auto const key = std::make_pair(um2::min(a, b), um2::max(a, b));
+    auto const it = straight_mids.find(key);
+    if (it != straight_mids.end()) {
+      return it->second;
+    }
+    auto const & pa = mesh_file.vertices[static_cast<size_t>(a)];
+    auto const & pb = mesh_file.vertices[static_cast<size_t>(b)];
+    Int const m = add_vertex({(pa[0] + pb[0]) / 2, (pa[1] + pb[1]) / 2});
+    straight_mids.emplace(key, m);
+    return m;
+  };
+  // The midpoints of the curved edges along each ring
+  std::vector<std::vector<Int>> curved_mids;
+  if (mesh_order == 2) {
+    curved_mids.resize(static_cast<size_t>(nr), std::vector<Int>(static_cast<size_t>(na)));
+    for (Size ir = 0; ir < nr; ++ir) {
+      for (Size ia = 0; ia < na; ++ia) {
+        Float const phi = static_cast<Float>(2 * ia + 1) * gamma;
+        curved_mids[static_cast<size_t>(ir)][static_cast<size_t>(ia)] =
+            add_vertex(polar(mid_radii[static_cast<size_t>(ir)], phi));
+      }
+    }
+  }
+  // The midpoint of the edge along ring ir, starting at azimuthal index ia, or
+  // -1 if the edge is straight.
+  auto const curved_mid = [&](Size const ir, Size const ia) -> Int {
+    if (mesh_order == 1 || ir == nr) {
+      return -1;
+    }
+    return curved_mids[static_cast<size_t>(ir)][static_cast<size_t>(ia)];
+  };
+  // Add a face with vertices v, where edge i, from v[i] to v[i + 1], has the
+  // midpoint mids[i] if it is curved, or -1 if it is straight.
+  auto const add_face = [&](std::array<Int, 4> const & v, std::array<Int, 4> const & mids) {
+    for (auto const vi : v) {
+      mesh_file.element_conn.push_back(vi);
+    }
+    if (mesh_order == 1) {
+      return;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      Int const m = mids[i];
+      mesh_file.element_conn.push_back(m == -1 ? straight_mid(v[i], v[(i + 1) % 4]) : m);
+    }
+  };
+  // Innermost ring: kites {center, r0, r1, r2}
+  auto const & ring0 = ring_verts[0];
+  for (Size j = 0; j < na / 2; ++j) {
+    auto const k0 = static_cast<size_t>(2 * j);
+    auto const k1 = k0 + 1;
+    auto const k2 = (k0 + 2) % static_cast<size_t>(na);
+    add_face({center, ring0[k0], ring0[k1], ring0[k2]},
+             {-1, curved_mid(0, 2 * j), curved_mid(0, 2 * j + 1), -1});
+  }
+  // The remaining rings and the region outside the last ring
+  for (Size ir = 1; ir <= nr; ++ir) {
+    auto const & inner = ring_verts[static_cast<size_t>(ir - 1)];
+    auto const & outer = ring_verts[static_cast<size_t>(ir)];
+    for (Size ia = 0; ia < na; ++ia) {
+      auto const k0 = static_cast<size_t>(ia);
+      auto const k1 = (k0 + 1) % static_cast<size_t>(na);
+      add_face({inner[k0], outer[k0], outer[k1], inner[k1]},
+               {-1, curved_mid(ir, ia), -1, curved_mid(ir - 1, ia)});
+    }
+  }
+
+  // Shift the bottom left corner of the pin to the origin
+  for (auto & v : mesh_file.vertices) {
+    v[0] += half_pitch;
+    v[1] += half_pitch;
+  }
+  if (mesh_order == 1) {
+    QuadMesh<2, Float, Int> mesh(mesh_file);
+    moveToMeshArena(mesh);
+    quad.push_back(um2::move(mesh));
+  } else {
+    QuadraticQuadMesh<2, Float, Int> mesh(mesh_file);
+    moveToMeshArena(mesh);
+    quadratic_quad.push_back(um2::move(mesh));
+  }
+  return mesh_id;
+}
+
+//=============================================================================
+// makeRectangularPinMesh
+//=============================================================================
+
+auto
+SpatialPartition::makeRectangularPinMesh(Vec2<Float> const dxdy, Size const nx,
+                                         Size const ny) -> Size
+{
+  if (dxdy[0] <= 0 || dxdy[1] <= 0) {
+    Log::error("Pin dimensions must be positive");
+    return -1;
+  }
+  if (nx <= 0 || ny <= 0) {
+    Log::error("Number of divisions in x and y must be positive");
+    return -1;
+  }
+
+  Size const mesh_id = quad.size();
+  Log::info("Making rectangular pin mesh " + std::to_string(mesh_id));
+
+  MeshFile<Float, Int> mesh_file;
+  // Vertices, left to right, bottom to top
+  Float const delta_x = dxdy[0] / static_cast<Float>(nx);
+  Float const delta_y = dxdy[1] / static_cast<Float>(ny);
+  mesh_file.vertices.resize(static_cast<size_t>((nx + 1) * (ny + 1)));
+  for (Size j = 0; j <= ny; ++j) {
+    for (Size i = 0; i <= nx; ++i) {
+      mesh_file.vertices[static_cast<size_t>(j * (nx + 1) + i)] = {
+          static_cast<Float>(i) * delta_x, static_cast<Float>(j) * delta_y,
+          static_cast<Float>(0)};
+    }
+  }
+  // Faces, left to right, bottom to top
+  auto const num_faces = static_cast<size_t>(nx * ny);
+  mesh_file.element_types.assign(num_faces, MeshType::Quad);
+  mesh_file.element_offsets.resize(num_faces + 1);
+  mesh_file.element_conn.resize(4 * num_faces);
+  for (size_t i = 0; i <= num_faces; ++i) {
+    mesh_file.element_offsets[i] = static_cast<Int>(4 * i);
+  }
+  for (Size j = 0; j < ny; ++j) {
+    for (Size i = 0; i < nx; ++i) {
+      auto const f = static_cast<size_t>(j * nx + i);
+      mesh_file.element_conn[4 * f] = j * (nx + 1) + i;
+      mesh_file.element_conn[4 * f + 1] = j * (nx + 1) + i + 1;
+      mesh_file.element_conn[4 * f + 2] = (j + 1) * (nx + 1) + i + 1;
+      mesh_file.element_conn[4 * f + 3] = (j + 1) * (nx + 1) + i;
+    }
+  }
+  QuadMesh<2, Float, Int> mesh(mesh_file);
+  moveToMeshArena(mesh);
+  quad.push_back(um2::move(mesh));
+  return mesh_id;
+}
+
 // template <std::floating_point T, std::signed_integral I>
 // int SpatialPartition::makeCoarseCell(I const mesh_type,
 //                                              I const mesh_id,
@@ -1000,11 +715,41 @@ SpatialPartition::makeCore(std::vector<std::vector<Size>> const & asy_ids) -> Si
 //=============================================================================
 
 void
-SpatialPartition::importCoarseCells(std::string const & filename)
+SpatialPartition::importCoarseCells(std::string const & filename,
+                                    std::vector<Size> const & cc_representatives)
 {
   Log::info("Importing coarse cells from " + filename);
   MeshFile<Float, Int> mesh_file;
   importMesh(filename, mesh_file);
+  importCoarseCells(mesh_file, cc_representatives);
+}
+
+void
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+SpatialPartition::importCoarseCells(MeshFile<Float, Int> const & mesh_file,
+                                    std::vector<Size> const & cc_representatives)
+{
+  Size const num_coarse_cells = numCoarseCells();
+  if (!cc_representatives.empty()) {
+    if (cc_representatives.size() != static_cast<size_t>(num_coarse_cells)) {
+      Log::error("Number of coarse cell representatives does not match the number of "
+                 "coarse cells");
+      return;
+    }
+    for (Size i = 0; i < num_coarse_cells; ++i) {
+      Size const rep = cc_representatives[static_cast<size_t>(i)];
+      if (rep < 0 || rep >= num_coarse_cells ||
+          cc_representatives[static_cast<size_t>(rep)] != rep) {
+        Log::error("Coarse cell " + std::to_string(i) + " has an invalid representative");
+        return;
+      }
+      if (!isApprox(coarse_cells[i].dxdy, coarse_cells[rep].dxdy)) {
+        Log::error("Coarse cell " + std::to_string(i) +
+                   " has a different size than its representative");
+        return;
+      }
+    }
+  }
 
   // Get the materials
   std::vector<std::string> material_names;
@@ -1017,8 +762,10 @@ SpatialPartition::importCoarseCells(std::string const & filename)
 
   // For each coarse cell
   std::stringstream ss;
-  Size const num_coarse_cells = numCoarseCells();
   for (Size i = 0; i < num_coarse_cells; ++i) {
+    if (!cc_representatives.empty() && cc_representatives[static_cast<size_t>(i)] != i) {
+      continue;
+    }
     // Get the submesh for the coarse cell
     ss.str("");
     ss << "Coarse_Cell_" << std::setw(5) << std::setfill('0') << i;
@@ -1039,40 +786,20 @@ SpatialPartition::importCoarseCells(std::string const & filename)
     AxisAlignedBox2<Float> bb;
     Point2<Float> * vertices = nullptr;
     size_t const num_verts = cc_submesh.vertices.size();
-    // clang-tidy false positive
-    // NOLINTBEGIN(bugprone-branch-clone) justified above
-    switch (mesh_type) {
-    case MeshType::Tri: {
-      cc.mesh_id = tri.size();
-      tri.push_back(um2::move(TriMesh<2, Float, Int>(cc_submesh)));
-      bb = tri.back().boundingBox();
-      vertices = tri.back().vertices.data();
-      break;
-    }
-    case MeshType::Quad: {
-      cc.mesh_id = quad.size();
-      quad.push_back(um2::move(QuadMesh<2, Float, Int>(cc_submesh)));
-      bb = quad.back().boundingBox();
-      vertices = quad.back().vertices.data();
-      break;
-    }
-    case MeshType::QuadraticTri: {
-      cc.mesh_id = quadratic_tri.size();
-      quadratic_tri.push_back(um2::move(QuadraticTriMesh<2, Float, Int>(cc_submesh)));
-      bb = quadratic_tri.back().boundingBox();
-      vertices = quadratic_tri.back().vertices.data();
-      break;
-    }
-    case MeshType::QuadraticQuad: {
-      cc.mesh_id = quadratic_quad.size();
-      quadratic_quad.push_back(um2::move(QuadraticQuadMesh<2, Float, Int>(cc_submesh)));
-      bb = quadratic_quad.back().boundingBox();
-      vertices = quadratic_quad.back().vertices.data();
-      break;
-    }
-    // NOLINTEND(bugprone-branch-clone)
-    default:
-      Log::error("Mesh type not supported");
+    cc.mesh_id = visitMeshes(mesh_type, [&](auto & meshes) -> Size {
+      using Mesh = std::remove_cvref_t<decltype(meshes[0])>;
+      Mesh mesh(cc_submesh);
+      if (mesh_ordering != MeshOrdering::None) {
+        applyPermutation(cc.material_ids, mesh.reorder(mesh_ordering));
+      }
+      moveToMeshArena(mesh);
+      meshes.push_back(um2::move(mesh));
+      bb = meshes.back().boundingBox();
+      vertices = meshes.back().vertices.data();
+      return meshes.size() - 1;
+    });
+    if (vertices == nullptr) { // Unsupported mesh type
+      return;
     }
 
     // Shift the points so that the min point is at the origin.
@@ -1080,10 +807,27 @@ SpatialPartition::importCoarseCells(std::string const & filename)
     for (size_t ip = 0; ip < num_verts; ++ip) {
       vertices[ip] -= min_point;
     }
+    // boundingBox may have cached the geometry of the faces before the shift
+    visitMesh(mesh_type, cc.mesh_id, [](auto & mesh) { mesh.clearFaceGeometry(); });
 #ifndef NDEBUG
     Point2<Float> const dxdy = bb.maxima - bb.minima;
     assert(isApprox(dxdy, cc.dxdy));
 #endif
   }
+
+  // Share the mesh of each representative with its duplicates
+  if (!cc_representatives.empty()) {
+    for (Size i = 0; i < num_coarse_cells; ++i) {
+      Size const rep = cc_representatives[static_cast<size_t>(i)];
+      if (rep == i) {
+        continue;
+      }
+      CoarseCell & cc = coarse_cells[i];
+      CoarseCell const & rep_cc = coarse_cells[rep];
+      cc.mesh_type = rep_cc.mesh_type;
+      cc.mesh_id = rep_cc.mesh_id;
+      cc.material_ids = rep_cc.material_ids;
+    }
+  }
 }
 } // namespace um2::mpact
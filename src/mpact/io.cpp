@@ -1,101 +1,209 @@
 #include <um2/mpact/io.hpp>
 
+#include <cstring>     // std::memcpy
+#include <exception>   // std::exception_ptr
+#include <fstream>     // std::ifstream, std::ofstream
+#include <limits>      // std::numeric_limits
+#include <type_traits> // std::is_trivially_copyable_v
+
 namespace um2
 {
 
 //==============================================================================
-// writeCoarseCell
+// CoarseCellJob
 //==============================================================================
+// Writing a model is split into two parts:
+//  1. A serial traversal of the hierarchy, which creates the XML tree and the
+//     HDF5 groups down to the RTM level, and queues a CoarseCellJob for each
+//     coarse cell instance. This is cheap.
+//  2. A pipeline over the queued jobs. Converting a coarse cell mesh to a
+//     shifted MeshFile with material elsets is CPU-bound and independent per
+//     cell, but neither pugixml nor HDF5 are thread-safe. Hence, the cells are
+//     processed in batches: while the master thread writes one batch, the
+//     remaining threads prepare the next.
 
 namespace
 {
+
+struct CoarseCellJob {
+  Size cell_id;
+  Int cell_id_ctr;
+  Point2<Float> ll; // Global xy shift of the cell
+  Float cut_z;
+  pugi::xml_node xrtm_grid;
+  std::string h5rtm_grouppath;
+};
+
+// Number of coarse cells prepared per batch. Two batches are held in memory
+// at once.
+constexpr size_t coarse_cells_per_batch = 256;
+
+//==============================================================================
+// prepareCoarseCell
+//==============================================================================
+// Convert the coarse cell mesh to a mesh file in global coordinates, with the
+// material IDs as elsets. Thread-safe.
+
 void
-writeCoarseCell(Size rtm_id, mpact::SpatialPartition const & model, Size ix, Size iy,
-                Vector<Int> & cc_found, Point2<Float> const & prev_ll,
-                std::vector<std::string> const & mat_names, Float const cut_z,
-                std::stringstream & ss, pugi::xml_node & xrtm_grid, H5::H5File & h5file,
-                std::string const & h5filename, std::string const & h5rtm_grouppath,
-                std::vector<std::string> const & mat_names_short)
-{
-  // Get the ray tracing module that the coarse cell belongs to
-  auto const & rtm = model.rtms[rtm_id];
-  // Get the coarse cell id
-  auto const & cell_id = static_cast<Size>(rtm.getChild(ix, iy));
-  // Increment the number of copies of this coarse cell that we have found
-  cc_found[cell_id] += 1;
-  Int const cell_id_ctr = cc_found[cell_id];
-  // Get the bounding box of the coarse cell
-  auto const cell_bb = rtm.getBox(ix, iy);
-  // Add the lower left corner of the rtm to the lower left corner of the cell
-  // to get the global coordinate shift
-  Point2<Float> const ll = prev_ll + cell_bb.minima;
+prepareCoarseCell(mpact::SpatialPartition const & model, CoarseCellJob const & job,
+                  std::vector<std::string> const & mat_names,
+                  MeshFile<Float, Int> & mesh_file)
+{
   // Get the mesh type and id of the coarse cell. Convert the mesh to a
   // mesh file
-  MeshType const mesh_type = model.coarse_cells[cell_id].mesh_type;
-  Size const mesh_id = model.coarse_cells[cell_id].mesh_id;
-  MeshFile<Float, Int> mesh_file;
-  switch (mesh_type) {
-  case MeshType::Tri:
-    model.tri[mesh_id].toMeshFile(mesh_file);
-    break;
-  case MeshType::Quad:
-    model.quad[mesh_id].toMeshFile(mesh_file);
-    break;
-  case MeshType::QuadraticTri:
-    model.quadratic_tri[mesh_id].toMeshFile(mesh_file);
-    break;
-  case MeshType::QuadraticQuad:
-    model.quadratic_quad[mesh_id].toMeshFile(mesh_file);
-    break;
-  default:
-    Log::error("Unsupported mesh type");
-    return;
-  } // switch
-  // We need to add the material_ids as elsets to the mesh file
-  // Get the number of materials in the mesh
-  Vector<MaterialID> const & mat_ids = model.coarse_cells[cell_id].material_ids;
-  Vector<MaterialID> unique_mat_ids;
-  for (auto const & mat_id : mat_ids) {
-    if (!std::any_of(unique_mat_ids.begin(), unique_mat_ids.end(),
-                     [mat_id](MaterialID const & id) { return id == mat_id; })) {
-      // cppcheck-suppress useStlAlgorithm; justification: verbosity
-      unique_mat_ids.push_back(mat_id);
-    }
-  }
-  auto const num_mats = static_cast<size_t>(unique_mat_ids.size());
-  std::sort(unique_mat_ids.begin(), unique_mat_ids.end());
-  // Create the elsets
-  mesh_file.elset_names.resize(num_mats);
-  mesh_file.elset_offsets.resize(num_mats + 1U);
-  mesh_file.elset_offsets[0] = 0;
+  auto const & cell = model.coarse_cells[job.cell_id];
+  MeshType const mesh_type = cell.mesh_type;
+  Size const mesh_id = cell.mesh_id;
+  // writeXDMFFile checked that the mesh is loaded
+  model.visitMesh(mesh_type, mesh_id,
+                  [&mesh_file](auto const & mesh) { mesh.toMeshFile(mesh_file); });
+  // We need to add the material_ids as elsets to the mesh file.
+  // Bucket the elements by material with a counting sort, so that the elsets
+  // are built in O(elements + materials) and each elset remains sorted.
+  Vector<MaterialID> const & mat_ids = cell.material_ids;
   size_t const num_elements = mesh_file.numCells();
-  size_t elem_ctr = 0;
-  mesh_file.elset_ids.resize(num_elements);
-  // Indexing with different types makes the next few lines a bit messy
-  for (size_t imat = 0; imat < num_mats; ++imat) {
-    MaterialID const mat_id = unique_mat_ids[static_cast<Size>(imat)];
-    mesh_file.elset_names[imat] = mat_names[static_cast<size_t>(mat_id)];
-    for (size_t ielem = 0; ielem < num_elements; ++ielem) {
-      if (mat_ids[static_cast<Size>(ielem)] == mat_id) {
-        mesh_file.elset_ids[elem_ctr++] = static_cast<Size>(ielem);
-        mesh_file.elset_offsets[imat + 1U] = static_cast<Size>(elem_ctr);
-      }
+  assert(static_cast<size_t>(mat_ids.size()) == num_elements);
+  auto const num_all_mats = static_cast<size_t>(model.materials.size());
+  std::vector<Int> counts(num_all_mats + 1U, 0);
+  for (auto const & mat_id : mat_ids) {
+    assert(0 <= mat_id && static_cast<size_t>(mat_id) < num_all_mats);
+    counts[static_cast<size_t>(mat_id) + 1U] += 1;
+  }
+  mesh_file.elset_names.clear();
+  mesh_file.elset_offsets.clear();
+  mesh_file.elset_offsets.push_back(0);
+  for (size_t imat = 0; imat < num_all_mats; ++imat) {
+    if (counts[imat + 1U] > 0) {
+      mesh_file.elset_names.push_back(mat_names[imat]);
+      mesh_file.elset_offsets.push_back(mesh_file.elset_offsets.back() +
+                                        counts[imat + 1U]);
     }
+    // Exclusive prefix sum: counts[imat] is the start of material imat
+    counts[imat + 1U] += counts[imat];
+  }
+  mesh_file.elset_ids.resize(num_elements);
+  for (size_t ielem = 0; ielem < num_elements; ++ielem) {
+    auto const imat = static_cast<size_t>(mat_ids[static_cast<Size>(ielem)]);
+    mesh_file.elset_ids[static_cast<size_t>(counts[imat]++)] = static_cast<Int>(ielem);
   }
   // Shift the mesh to global coordinates
   for (auto & vertex : mesh_file.vertices) {
-    vertex[0] += ll[0];
-    vertex[1] += ll[1];
-    vertex[2] += cut_z;
+    vertex[0] += job.ll[0];
+    vertex[1] += job.ll[1];
+    vertex[2] += job.cut_z;
   }
-  // Write the mesh file to the XML and HDF5 files
-  ss.str("");
-  ss << "Coarse_Cell_" << std::setw(5) << std::setfill('0') << cell_id << "_"
-     << std::setw(5) << std::setfill('0') << cell_id_ctr;
+  std::stringstream ss;
+  ss << "Coarse_Cell_" << std::setw(5) << std::setfill('0') << job.cell_id << "_"
+     << std::setw(5) << std::setfill('0') << job.cell_id_ctr;
   mesh_file.name = ss.str();
-  // Now write the coarse cell as a uniform grid
-  writeXDMFUniformGrid(xrtm_grid, h5file, h5filename, h5rtm_grouppath, mesh_file,
-                       mat_names_short);
+}
+
+//==============================================================================
+// writeCoarseCellInfo
+//==============================================================================
+// Record the size and mesh type of a coarse cell on its grid, so that the
+// hierarchy of the model can be imported without reading any mesh data. See
+// readCoarseCellBoxes.
+
+void
+writeCoarseCellInfo(mpact::SpatialPartition::CoarseCell const & cell,
+                    pugi::xml_node & xgrid)
+{
+  std::stringstream ss;
+  ss << std::setprecision(std::numeric_limits<Float>::max_digits10) << cell.dxdy[0]
+     << ", " << cell.dxdy[1];
+  pugi::xml_node xsize = xgrid.append_child("Information");
+  xsize.append_attribute("Name") = "dx_dy";
+  xsize.append_child(pugi::node_pcdata).set_value(ss.str().c_str());
+  pugi::xml_node xtype = xgrid.append_child("Information");
+  xtype.append_attribute("Name") = "MeshType";
+  std::string const type_str = std::to_string(static_cast<int>(cell.mesh_type));
+  xtype.append_child(pugi::node_pcdata).set_value(type_str.c_str());
+}
+
+//==============================================================================
+// writeCoarseCells
+//==============================================================================
+
+void
+writeCoarseCells(mpact::SpatialPartition const & model,
+                 std::vector<CoarseCellJob> const & jobs,
+                 std::vector<std::string> const & mat_names, H5::H5File & h5file,
+                 std::string const & h5filename,
+                 std::vector<std::string> const & mat_names_short,
+                 H5WriteOptions const & h5options)
+{
+  size_t const num_jobs = jobs.size();
+  std::vector<MeshFile<Float, Int>> ready(coarse_cells_per_batch);
+  std::vector<MeshFile<Float, Int>> next(coarse_cells_per_batch);
+  // An exception, e.g. from HDF5, may not leave an OpenMP structured block. The
+  // first one thrown is kept and rethrown once the threads have joined.
+  std::exception_ptr error;
+  auto const keepError = [&error]() {
+#if UM2_USE_OPENMP
+#  pragma omp critical(um2_write_coarse_cells_error)
+#endif
+    {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  };
+  // Prepare the first batch
+  size_t ready_end = std::min(coarse_cells_per_batch, num_jobs);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (size_t i = 0; i < ready_end; ++i) {
+    try {
+      prepareCoarseCell(model, jobs[i], mat_names, ready[i]);
+    } catch (...) {
+      keepError();
+    }
+  }
+  for (size_t ready_begin = 0; ready_begin < num_jobs && !error;
+       ready_begin += coarse_cells_per_batch) {
+    size_t const next_end = std::min(ready_end + coarse_cells_per_batch, num_jobs);
+#if UM2_USE_OPENMP
+#  pragma omp parallel
+#endif
+    {
+      // Write the ready batch on the master thread, then help prepare the next
+      // batch once done.
+#if UM2_USE_OPENMP
+#  pragma omp master
+#endif
+      {
+        try {
+          for (size_t i = ready_begin; i < ready_end; ++i) {
+            // xml_node is a handle, so the copy refers to the same node
+            pugi::xml_node xrtm_grid = jobs[i].xrtm_grid;
+            writeXDMFUniformGrid(xrtm_grid, h5file, h5filename, jobs[i].h5rtm_grouppath,
+                                 ready[i - ready_begin], mat_names_short, h5options);
+            pugi::xml_node xcell_grid = xrtm_grid.last_child();
+            writeCoarseCellInfo(model.coarse_cells[jobs[i].cell_id], xcell_grid);
+          }
+        } catch (...) {
+          keepError();
+        }
+      }
+#if UM2_USE_OPENMP
+#  pragma omp for schedule(dynamic) nowait
+#endif
+      for (size_t i = ready_end; i < next_end; ++i) {
+        try {
+          prepareCoarseCell(model, jobs[i], mat_names, next[i - ready_end]);
+        } catch (...) {
+          keepError();
+        }
+      }
+    } // omp parallel
+    std::swap(ready, next);
+    ready_end = next_end;
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
 }
 
 //==============================================================================
@@ -105,10 +213,9 @@ writeCoarseCell(Size rtm_id, mpact::SpatialPartition const & model, Size ix, Siz
 void
 writeRTM(Size lat_id, mpact::SpatialPartition const & model, Size ix, Size iy,
          Vector<Int> & cc_found, Vector<Int> & rtm_found, Point2<Float> const & asy_ll,
-         std::vector<std::string> const & mat_names, Float const cut_z,
-         std::stringstream & ss, pugi::xml_node & xlat_grid, H5::H5File & h5file,
-         std::string const & h5filename, std::string const & h5lat_grouppath,
-         std::vector<std::string> const & mat_names_short)
+         Float const cut_z, std::stringstream & ss, pugi::xml_node & xlat_grid,
+         H5::H5File & h5file, std::string const & h5lat_grouppath,
+         std::vector<CoarseCellJob> & jobs)
 {
   // Get the lattice that the rtm is in
   auto const & lattice = model.lattices[lat_id];
@@ -148,12 +255,18 @@ writeRTM(Size lat_id, mpact::SpatialPartition const & model, Size ix, Size iy,
       std::to_string(nycells) + " x " + std::to_string(nxcells);
   xrtm_info.append_child(pugi::node_pcdata).set_value(rtm_mn_str.c_str());
 
-  // Write the coarse cells in the rtm
+  // Queue the coarse cells in the rtm
   for (Size iycell = 0; iycell < nycells; ++iycell) {
     for (Size ixcell = 0; ixcell < nxcells; ++ixcell) {
-      writeCoarseCell(rtm_id, model, ixcell, iycell, cc_found, prev_ll, mat_names, cut_z,
-                      ss, xrtm_grid, h5file, h5filename, h5rtm_grouppath,
-                      mat_names_short);
+      // Get the coarse cell id
+      auto const cell_id = static_cast<Size>(rtm.getChild(ixcell, iycell));
+      // Increment the number of copies of this coarse cell that we have found
+      cc_found[cell_id] += 1;
+      // Add the lower left corner of the rtm to the lower left corner of the cell
+      // to get the global coordinate shift
+      auto const cell_bb = rtm.getBox(ixcell, iycell);
+      jobs.push_back({cell_id, cc_found[cell_id], prev_ll + cell_bb.minima, cut_z,
+                      xrtm_grid, h5rtm_grouppath});
     } // cell
   }   // cell
 }
@@ -165,10 +278,9 @@ writeRTM(Size lat_id, mpact::SpatialPartition const & model, Size ix, Size iy,
 void
 writeLattice(Size asy_id, mpact::SpatialPartition const & model, Size iz,
              Vector<Int> & cc_found, Vector<Int> & rtm_found, Vector<Int> & lat_found,
-             Point2<Float> const & asy_ll, std::vector<std::string> const & mat_names,
-             std::stringstream & ss, pugi::xml_node & xasy_grid, H5::H5File & h5file,
-             std::string const & h5filename, std::string const & h5asy_grouppath,
-             std::vector<std::string> const & mat_names_short)
+             Point2<Float> const & asy_ll, std::stringstream & ss,
+             pugi::xml_node & xasy_grid, H5::H5File & h5file,
+             std::string const & h5asy_grouppath, std::vector<CoarseCellJob> & jobs)
 {
   // Get the assembly that the lattice is in
   auto const & assembly = model.assemblies[asy_id];
@@ -213,8 +325,8 @@ writeLattice(Size asy_id, mpact::SpatialPartition const & model, Size iz,
   // Write the RTMs in the lattice
   for (Size iyrtm = 0; iyrtm < nyrtm; ++iyrtm) {
     for (Size ixrtm = 0; ixrtm < nxrtm; ++ixrtm) {
-      writeRTM(lat_id, model, ixrtm, iyrtm, cc_found, rtm_found, asy_ll, mat_names, cut_z,
-               ss, xlat_grid, h5file, h5filename, h5lat_grouppath, mat_names_short);
+      writeRTM(lat_id, model, ixrtm, iyrtm, cc_found, rtm_found, asy_ll, cut_z, ss,
+               xlat_grid, h5file, h5lat_grouppath, jobs);
     } // rtm
   }   // rtm
 }
@@ -226,9 +338,18 @@ writeLattice(Size asy_id, mpact::SpatialPartition const & model, Size iz,
 //==============================================================================
 
 void
-writeXDMFFile(std::string const & path, mpact::SpatialPartition const & model)
+writeXDMFFile(std::string const & path, mpact::SpatialPartition const & model,
+              H5WriteOptions const & h5options)
 {
   Log::info("Writing MPACT model to XDMF file: " + path);
+  // Check before the HDF5 file is truncated
+  for (Size i = 0; i < model.numCoarseCells(); ++i) {
+    if (!model.hasCoarseCellMesh(i)) {
+      Log::error("Coarse cell " + std::to_string(i) +
+                 " has no loaded mesh. See loadCoarseCellMeshes");
+      return;
+    }
+  }
 
   size_t const h5filepath_end = path.find_last_of('/') + 1;
   std::string const name = path.substr(h5filepath_end, path.size() - 5 - h5filepath_end);
@@ -284,6 +405,7 @@ writeXDMFFile(std::string const & path, mpact::SpatialPartition const & model)
     return;
   }
   std::stringstream ss;
+  std::vector<CoarseCellJob> jobs;
   Size const nyasy = core.numYCells();
   Size const nxasy = core.numXCells();
   // Core M by N
@@ -320,12 +442,14 @@ writeXDMFFile(std::string const & path, mpact::SpatialPartition const & model)
       xasy_info.append_child(pugi::node_pcdata).set_value(asy_mn_str.c_str());
       // For each lattice
       for (Size izlat = 0; izlat < nzlat; ++izlat) {
-        writeLattice(asy_id, model, izlat, cc_found, rtm_found, lat_found, asy_ll,
-                     mat_names, ss, xasy_grid, h5file, h5filename, h5asy_grouppath,
-                     mat_names_short);
+        writeLattice(asy_id, model, izlat, cc_found, rtm_found, lat_found, asy_ll, ss,
+                     xasy_grid, h5file, h5asy_grouppath, jobs);
       } // lat
     }   // assembly
   }     // assembly
+  // Convert and write the coarse cells
+  writeCoarseCells(model, jobs, mat_names, h5file, h5filename, mat_names_short,
+                   h5options);
   // Write the XML file
   xdoc.save_file(path.c_str(), "  ");
 
@@ -333,15 +457,186 @@ writeXDMFFile(std::string const & path, mpact::SpatialPartition const & model)
   h5file.close();
 }
 
+//==============================================================================
+// writeSnapshotFile
+//==============================================================================
+// A snapshot is a flat binary image of the model in the native memory layout:
+//  - A fixed size header, which identifies the format, its version, and the
+//    sizes of the types used, so that a snapshot is never misread by a build
+//    with a different configuration.
+//  - The hierarchy, the coarse cells, the materials, and the meshes. Each array
+//    is stored as a uint64_t length, followed by its raw bytes, padded to a
+//    multiple of 8 bytes.
+// Reading a snapshot is a single read of the whole file, followed by copying
+// each array out of the buffer.
+
+namespace
+{
+
+constexpr char snapshot_magic[8] = {'U', 'M', '2', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint32_t snapshot_version = 2;
+constexpr uint32_t snapshot_endian_check = 0x01020304;
+constexpr size_t snapshot_alignment = 8;
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t endian_check;
+  uint8_t float_size;
+  uint8_t int_size;
+  uint8_t size_size;
+  uint8_t material_id_size;
+  uint32_t padding;
+};
+static_assert(sizeof(SnapshotHeader) % snapshot_alignment == 0);
+
+class SnapshotWriter
+{
+  std::ofstream _file;
+
+public:
+  explicit SnapshotWriter(std::string const & path)
+      : _file(path, std::ios::binary)
+  {
+  }
+
+  [[nodiscard]] auto
+  good() const -> bool
+  {
+    return _file.good();
+  }
+
+  void
+  writeBytes(void const * data, uint64_t const nbytes)
+  {
+    static constexpr char zeros[snapshot_alignment] = {};
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    _file.write(reinterpret_cast<char const *>(data), static_cast<std::streamsize>(nbytes));
+    uint64_t const npad = (snapshot_alignment - nbytes % snapshot_alignment) %
+                          snapshot_alignment;
+    _file.write(zeros, static_cast<std::streamsize>(npad));
+  }
+
+  template <class T>
+  void
+  write(T const & value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    writeBytes(&value, sizeof(T));
+  }
+
+  template <class T>
+  void
+  write(Vector<T> const & v)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    auto const n = static_cast<uint64_t>(v.size());
+    write(n);
+    writeBytes(v.data(), n * sizeof(T));
+  }
+
+  template <Size D, class T, class P>
+  void
+  write(RectilinearPartition<D, T, P> const & part)
+  {
+    for (Size i = 0; i < D; ++i) {
+      write(part.grid.divs[i]);
+    }
+    write(part.children);
+  }
+
+  template <Size D, class T, class P>
+  void
+  write(RegularPartition<D, T, P> const & part)
+  {
+    write(part.grid);
+    write(part.children);
+  }
+
+  template <Size P, Size N>
+  void
+  write(FaceVertexMesh<P, N, 2, Float, Int> const & mesh)
+  {
+    write(mesh.vertices);
+    write(mesh.fv);
+    write(mesh.vf_offsets);
+    write(mesh.vf);
+  }
+
+  template <Size P>
+  void
+  write(MixedFaceVertexMesh<P, 2, Float, Int> const & mesh)
+  {
+    write(mesh.vertices);
+    write(mesh.fv_offsets);
+    write(mesh.fv);
+    write(mesh.vf_offsets);
+    write(mesh.vf);
+  }
+
+  template <class T>
+  void
+  writeEach(Vector<T> const & v)
+  {
+    write(static_cast<uint64_t>(v.size()));
+    for (auto const & x : v) {
+      write(x);
+    }
+  }
+};
+
+} // namespace
+
+void
+writeSnapshotFile(std::string const & path, mpact::SpatialPartition const & model)
+{
+  Log::info("Writing snapshot file: " + path);
+  SnapshotWriter writer(path);
+  if (!writer.good()) {
+    Log::error("Could not open file: " + path);
+    return;
+  }
+  SnapshotHeader header = {};
+  std::copy(std::begin(snapshot_magic), std::end(snapshot_magic), header.magic);
+  header.version = snapshot_version;
+  header.endian_check = snapshot_endian_check;
+  header.float_size = sizeof(Float);
+  header.int_size = sizeof(Int);
+  header.size_size = sizeof(Size);
+  header.material_id_size = sizeof(MaterialID);
+  writer.write(header);
+
+  writer.write(model.core);
+  writer.writeEach(model.assemblies);
+  writer.writeEach(model.lattices);
+  writer.writeEach(model.rtms);
+  writer.write(static_cast<uint64_t>(model.coarse_cells.size()));
+  for (auto const & cell : model.coarse_cells) {
+    writer.write(cell.dxdy);
+    writer.write(cell.mesh_type);
+    writer.write(cell.mesh_id);
+    writer.write(cell.material_ids);
+  }
+  writer.write(model.materials);
+  model.forEachMeshes([&writer](auto const & meshes) { writer.writeEach(meshes); });
+  if (!writer.good()) {
+    Log::error("Error writing file: " + path);
+    return;
+  }
+}
+
 //==============================================================================
 // exportMesh
 //==============================================================================
 
 void
-exportMesh(std::string const & path, mpact::SpatialPartition const & model)
+exportMesh(std::string const & path, mpact::SpatialPartition const & model,
+           H5WriteOptions const & h5options)
 {
   if (path.ends_with(".xdmf")) {
-    writeXDMFFile(path, model);
+    writeXDMFFile(path, model, h5options);
+  } else if (path.ends_with(".um2")) {
+    writeSnapshotFile(path, model);
   } else {
     Log::error("Unsupported file format.");
   }
@@ -386,38 +681,23 @@ getMbyN(size_t & m, size_t & n, pugi::xml_node const & x)
     Log::error("Expected core Information Name=M_by_N");
   }
 }
-} // namespace
 
 //==============================================================================
-// readXDMFFile
+// getXDMFModelFiles
 //==============================================================================
+// Parse the XML document of a model, returning the core grid node. The name of
+// the HDF5 file and the material names are also returned.
 
-void
-// NOLINTNEXTLINE
-readXDMFFile(std::string const & path, mpact::SpatialPartition & model)
+auto
+getXDMFModelFiles(std::string const & path, pugi::xml_document & xdoc,
+                  std::string & h5filename, std::vector<std::string> & material_names)
+    -> pugi::xml_node
 {
-  Log::info("Importing MPACT model from file: " + path);
-  if (!path.ends_with(".xdmf")) {
-    Log::error("Unsupported file format.");
-    return;
-  }
-
-  // Open the XDMF file
-  std::ifstream const file(path);
-  if (!file.is_open()) {
-    Log::error("Could not open file: " + path);
-    return;
-  }
-  // Open the HDF5 file
   size_t const h5filepath_end = path.find_last_of('/') + 1;
-  std::string const h5filename =
-      path.substr(h5filepath_end, path.size() - 4 - h5filepath_end) + "h5";
-  std::string const h5filepath = path.substr(0, h5filepath_end);
+  h5filename = path.substr(h5filepath_end, path.size() - 4 - h5filepath_end) + "h5";
   LOG_DEBUG("H5 filename: " + h5filename);
-  H5::H5File const h5file(h5filepath + h5filename, H5F_ACC_RDONLY);
 
   // Setup XML document
-  pugi::xml_document xdoc;
   pugi::xml_parse_result const result = xdoc.load_file(path.c_str());
   if (!result) {
     Log::error("XDMF XML parse error: " + std::string(result.description()) +
@@ -426,14 +706,13 @@ readXDMFFile(std::string const & path, mpact::SpatialPartition & model)
   pugi::xml_node const xroot = xdoc.child("Xdmf");
   if (strcmp("Xdmf", xroot.name()) != 0) {
     Log::error("XDMF XML root node is not Xdmf");
-    return;
+    return {};
   }
   pugi::xml_node const xdomain = xroot.child("Domain");
   if (strcmp("Domain", xdomain.name()) != 0) {
     Log::error("XDMF XML domain node is not Domain");
-    return;
+    return {};
   }
-  std::vector<std::string> material_names;
   pugi::xml_node const xinfo = xdomain.child("Information");
   if (strcmp("Information", xinfo.name()) == 0) {
     // Get the "Name" attribute
@@ -452,15 +731,304 @@ readXDMFFile(std::string const & path, mpact::SpatialPartition & model)
       }
     }
   }
+  // Get the core node
+  pugi::xml_node const xcore = xdomain.child("Grid");
+  if (strcmp("Grid", xcore.name()) != 0) {
+    Log::error("XDMF XML grid node is not Grid");
+    return {};
+  }
+  if (strcmp("Tree", xcore.attribute("GridType").value()) != 0) {
+    Log::error("Expected core GridType=Tree");
+    return {};
+  }
+  return xcore;
+}
+
+//==============================================================================
+// shiftToOrigin
+//==============================================================================
+// Shift the mesh so that the minimum of its bounding box is at the origin,
+// returning the size of the box.
+
+template <class Mesh>
+auto
+shiftToOrigin(Mesh & mesh) -> Vec2<Float>
+{
+  AxisAlignedBox2<Float> const bb = mesh.boundingBox();
+  for (auto & vertex : mesh.vertices) {
+    vertex -= bb.minima;
+  }
+  // boundingBox cached the geometry of the faces before the shift
+  mesh.clearFaceGeometry();
+  return bb.maxima - bb.minima;
+}
+
+//==============================================================================
+// readCoarseCellMeshes
+//==============================================================================
+// Read the fine meshes of the coarse cells with XDMF grids xgrids, appending
+// them to the mesh arrays of the model. cells[i] is set to describe the coarse
+// cell of xgrids[i]. Returns false if a mesh could not be read, in which case
+// cells is empty and the mesh arrays are unchanged.
+//
+// HDF5 is not thread-safe, so the datasets are read serially. Constructing the
+// meshes dominates the cost and is done in parallel.
+
+auto
+readCoarseCellMeshes(std::vector<pugi::xml_node> const & xgrids,
+                     H5::H5File const & h5file, std::string const & h5filename,
+                     std::vector<std::string> const & long_material_names,
+                     mpact::SpatialPartition & model,
+                     std::vector<mpact::SpatialPartition::CoarseCell> & cells) -> bool
+{
+  size_t const num_cells = xgrids.size();
+  cells.resize(num_cells);
+  std::vector<MeshFile<Float, Int>> mesh_files(num_cells);
+  // Read the datasets, checking every mesh type before the model is modified
+  for (size_t i = 0; i < num_cells; ++i) {
+    mesh_files[i].format = MeshFileFormat::XDMF;
+    readXDMFUniformGrid(xgrids[i], h5file, h5filename, mesh_files[i]);
+    cells[i].mesh_type = mesh_files[i].getMeshType();
+    if (cells[i].mesh_type == MeshType::None) {
+      Log::error("Mesh type not supported");
+      cells.clear();
+      return false;
+    }
+  }
+  // Append an empty mesh for each cell, which is constructed below. The sizes
+  // of the mesh arrays are kept to remove these meshes again on failure.
+  std::vector<Size> num_meshes;
+  model.forEachMeshes(
+      [&num_meshes](auto const & meshes) { num_meshes.push_back(meshes.size()); });
+  for (auto & cell : cells) {
+    cell.mesh_id = model.visitMeshes(cell.mesh_type, [](auto & meshes) -> Size {
+      using Mesh = std::remove_cvref_t<decltype(meshes[0])>;
+      meshes.push_back(Mesh());
+      return meshes.size() - 1;
+    });
+  }
+  // Construct the meshes. Validation may log from several threads at once.
+  size_t const num_errors = Log::getNumErrors();
+#if UM2_USE_OPENMP
+#  pragma omp parallel for schedule(dynamic)
+#endif
+  for (size_t i = 0; i < num_cells; ++i) {
+    auto & cell = cells[i];
+    std::vector<MaterialID> material_ids;
+    mesh_files[i].getMaterialIDs(material_ids, long_material_names);
+    cell.material_ids.resize(static_cast<Size>(material_ids.size()));
+    std::copy(material_ids.begin(), material_ids.end(), cell.material_ids.begin());
+    model.visitMesh(cell.mesh_type, cell.mesh_id, [&](auto & mesh) {
+      using Mesh = std::remove_cvref_t<decltype(mesh)>;
+      mesh = Mesh(mesh_files[i]);
+      cell.dxdy = shiftToOrigin(mesh);
+    });
+    // Free the mesh file as soon as we are done with it
+    mesh_files[i] = MeshFile<Float, Int>();
+  }
+  if (Log::getNumErrors() != num_errors) {
+    size_t itype = 0;
+    model.forEachMeshes(
+        [&num_meshes, &itype](auto & meshes) { meshes.resize(num_meshes[itype++]); });
+    cells.clear();
+    return false;
+  }
+  // Move the meshes to the arena serially, so that they are in the order of
+  // the coarse cells
+  if (model.mesh_arena) {
+    for (auto const & cell : cells) {
+      model.visitMesh(cell.mesh_type, cell.mesh_id,
+                      [&model](auto & mesh) { model.moveToMeshArena(mesh); });
+    }
+  }
+  return true;
+}
+
+//==============================================================================
+// readCoarseCellInfo
+//==============================================================================
+// Read the size and mesh type written by writeCoarseCellInfo. Returns false if
+// the grid has no such information, e.g. if the file predates it.
+
+auto
+readCoarseCellInfo(pugi::xml_node const & xgrid,
+                   mpact::SpatialPartition::CoarseCell & cell) -> bool
+{
+  pugi::xml_node const xsize =
+      xgrid.find_child_by_attribute("Information", "Name", "dx_dy");
+  pugi::xml_node const xtype =
+      xgrid.find_child_by_attribute("Information", "Name", "MeshType");
+  if (xsize.empty() || xtype.empty()) {
+    return false;
+  }
+  std::stringstream ss(xsize.child_value());
+  std::string token;
+  std::getline(ss, token, ',');
+  cell.dxdy[0] = sto<Float>(token);
+  std::getline(ss, token, ',');
+  cell.dxdy[1] = sto<Float>(token);
+  cell.mesh_type = static_cast<MeshType>(sto<int32_t>(xtype.child_value()));
+  return true;
+}
+
+//==============================================================================
+// readCoarseCellBoxes
+//==============================================================================
+// Set the size and mesh type of the coarse cells with XDMF grids xgrids without
+// reading their meshes. Files written with the coarse cell information of
+// writeCoarseCellInfo need only the XML. For older files, the vertex
+// coordinates, and for mixed meshes the topology, are read. Returns false if a
+// cell could not be read, in which case cells is empty.
+
+auto
+readCoarseCellBoxes(std::vector<pugi::xml_node> const & xgrids, H5::H5File const & h5file,
+                    std::string const & h5filename,
+                    std::vector<mpact::SpatialPartition::CoarseCell> & cells) -> bool
+{
+  size_t const num_cells = xgrids.size();
+  cells.resize(num_cells);
+  for (size_t i = 0; i < num_cells; ++i) {
+    auto & cell = cells[i];
+    if (readCoarseCellInfo(xgrids[i], cell)) {
+      continue;
+    }
+    std::string const topology_type =
+        xgrids[i].child("Topology").attribute("TopologyType").value();
+    if (topology_type == "Triangle") {
+      cell.mesh_type = MeshType::Tri;
+    } else if (topology_type == "Quadrilateral") {
+      cell.mesh_type = MeshType::Quad;
+    } else if (topology_type == "Triangle_6") {
+      cell.mesh_type = MeshType::QuadraticTri;
+    } else if (topology_type == "Quadrilateral_8") {
+      cell.mesh_type = MeshType::QuadraticQuad;
+    } else if (topology_type != "Mixed") {
+      Log::error("Mesh type not supported: " + topology_type);
+      cells.clear();
+      return false;
+    }
+    MeshFile<Float, Int> mesh_file;
+    readXDMFGeometry(xgrids[i], h5file, h5filename, mesh_file);
+    if (topology_type == "Mixed") {
+      // The element types are only known from the topology
+      readXDMFTopology(xgrids[i], h5file, h5filename, mesh_file);
+      cell.mesh_type = mesh_file.getMeshType();
+      if (cell.mesh_type != MeshType::TriQuad &&
+          cell.mesh_type != MeshType::QuadraticTriQuad) {
+        Log::error("Mixed mesh type not supported");
+        cells.clear();
+        return false;
+      }
+    }
+    if (mesh_file.vertices.empty()) {
+      Log::error("Coarse cell mesh has no vertices");
+      cells.clear();
+      return false;
+    }
+    Point2<Float> minima(mesh_file.vertices[0][0], mesh_file.vertices[0][1]);
+    Point2<Float> maxima = minima;
+    for (auto const & v : mesh_file.vertices) {
+      minima[0] = um2::min(minima[0], v[0]);
+      minima[1] = um2::min(minima[1], v[1]);
+      maxima[0] = um2::max(maxima[0], v[0]);
+      maxima[1] = um2::max(maxima[1], v[1]);
+    }
+    cell.dxdy = maxima - minima;
+  }
+  return true;
+}
+
+//==============================================================================
+// getCoarseCellGrids
+//==============================================================================
+// Get the XDMF grid of the first instance of each coarse cell, indexed by
+// coarse cell ID.
+
+void
+getCoarseCellGrids(pugi::xml_node const & xcore, std::vector<pugi::xml_node> & xgrids)
+{
+  for (auto const & assembly_node : xcore.children("Grid")) {
+    for (auto const & lattice_node : assembly_node.children("Grid")) {
+      for (auto const & rtm_node : lattice_node.children("Grid")) {
+        for (auto const & coarse_cell_node : rtm_node.children("Grid")) {
+          // Of the form Coarse_Cell_XXXXX_YYYYY, where XXXXX is the coarse cell ID
+          std::string const coarse_cell_name =
+              coarse_cell_node.attribute("Name").value();
+          auto const coarse_cell_id =
+              static_cast<size_t>(sto<Size>(coarse_cell_name.substr(12, 5)));
+          if (coarse_cell_id >= xgrids.size()) {
+            xgrids.resize(coarse_cell_id + 1);
+          }
+          if (xgrids[coarse_cell_id].empty()) {
+            xgrids[coarse_cell_id] = coarse_cell_node;
+          }
+        }
+      }
+    }
+  }
+}
+
+//==============================================================================
+// XDMFModelFile
+//==============================================================================
+// The parsed XML document and the open HDF5 file of an MPACT model, so that the
+// hierarchy and the meshes of a model can be read with one parse of the XML.
+
+struct XDMFModelFile {
+  pugi::xml_document xdoc;
+  pugi::xml_node xcore;
+  std::string h5filename;
+  H5::H5File h5file;
+  std::vector<std::string> material_names;
+  std::vector<std::string> long_material_names;
+};
+
+// Returns false if the file could not be opened or parsed.
+auto
+openXDMFModelFile(std::string const & path, XDMFModelFile & file) -> bool
+{
+  if (!path.ends_with(".xdmf")) {
+    Log::error("Unsupported file format.");
+    return false;
+  }
+  std::ifstream const stream(path);
+  if (!stream.is_open()) {
+    Log::error("Could not open file: " + path);
+    return false;
+  }
+  file.xcore = getXDMFModelFiles(path, file.xdoc, file.h5filename, file.material_names);
+  if (file.xcore.empty()) {
+    return false;
+  }
+  std::string const h5filepath = path.substr(0, path.find_last_of('/') + 1);
+  file.h5file.openFile(h5filepath + file.h5filename, H5F_ACC_RDONLY);
+  file.long_material_names.resize(file.material_names.size());
+  for (size_t imat = 0; imat < file.material_names.size(); ++imat) {
+    file.long_material_names[imat] = "Material_" + file.material_names[imat];
+  }
+  return true;
+}
+
+//==============================================================================
+// readXDMFModel
+//==============================================================================
+
+void
+// NOLINTNEXTLINE
+readXDMFModel(XDMFModelFile const & file, mpact::SpatialPartition & model,
+              bool const load_meshes)
+{
+  pugi::xml_node const & xcore = file.xcore;
+  H5::H5File const & h5file = file.h5file;
+  std::string const & h5filename = file.h5filename;
+  std::vector<std::string> const & material_names = file.material_names;
+  std::vector<std::string> const & long_material_names = file.long_material_names;
+
   model.materials.resize(static_cast<Size>(material_names.size()));
   for (size_t imat = 0; imat < material_names.size(); ++imat) {
     model.materials[static_cast<Size>(imat)].name =
         ShortString(material_names[imat].c_str());
   }
-  std::vector<std::string> long_material_names(material_names.size());
-  for (size_t imat = 0; imat < material_names.size(); ++imat) {
-    long_material_names[imat] = "Material_" + material_names[imat];
-  }
 
   //============================================================================
   // Algorithm for populating the model
@@ -515,16 +1083,14 @@ readXDMFFile(std::string const & path, mpact::SpatialPartition & model)
   //               Write the coarse cell ID to rtm_coarse_cell_ids
   //               If the coarse cell ID is not in coarse_cell_ids
   //                 Insert the ID to coarse_cell_ids
-  //                 Read the mesh into a MeshFile object using readXDMFUniformGrid
-  //                 Set the coarse cell mesh type, mesh id, and material IDs
-  //                 Create the mesh
-  //                 Use the bounding box of the mesh to set the coarse cell dxdy
   //
   // Now that we have all the IDs we can create the model
+  // Read the meshes of the first instance of each coarse cell
+  //   Serially read the HDF5 data, then construct the meshes in parallel
+  //   Use the bounding box of each mesh to set the coarse cell dxdy
+  //   If the meshes are not loaded, read only the vertices to get the dxdy
   // For each coarse cell,
   //   Use makeCoarseCell to create the coarse cell
-  //   Add the mesh to the model
-  //   Adjust the mesh id of the coarse cell to be the index of the mesh in the model
   // For each RTM,
   //   Use makeRTM to create the RTM
   // For each lattice,
@@ -560,27 +1126,7 @@ readXDMFFile(std::string const & path, mpact::SpatialPartition & model)
   std::vector<Size> rtm_ids;         // IDs of all RTMs
   std::vector<Size> coarse_cell_ids; // IDs of all coarse cells
 
-  std::vector<Vec2<Float>> coarse_cell_dxdys; // dx and dy of each coarse cell
-  std::vector<MeshType> coarse_cell_mesh_types;
-  std::vector<Size> coarse_cell_mesh_ids; // Mesh ID in each coarse cell
-  std::vector<std::vector<MaterialID>>
-      coarse_cell_material_ids; // Material IDs in each coarse cell
-  // We also store a Vector of Mesh objects for each mesh type
-  Vector<TriMesh<2, Float, Int>> tri;
-  Vector<QuadMesh<2, Float, Int>> quad;
-  Vector<QuadraticTriMesh<2, Float, Int>> quadratic_tri;
-  Vector<QuadraticQuadMesh<2, Float, Int>> quadratic_quad;
 
-  // Get the core node
-  pugi::xml_node const xcore = xdomain.child("Grid");
-  if (strcmp("Grid", xcore.name()) != 0) {
-    Log::error("XDMF XML grid node is not Grid");
-    return;
-  }
-  if (strcmp("Tree", xcore.attribute("GridType").value()) != 0) {
-    Log::error("Expected core GridType=Tree");
-    return;
-  }
   // Get the M by N size of the core (of the form M x N)
   size_t core_m = 0;
   size_t core_n = 0;
@@ -778,91 +1324,6 @@ readXDMFFile(std::string const & path, mpact::SpatialPartition & model)
                   // Insert the ID to coarse_cell_ids
                   coarse_cell_ids.insert(coarse_cell_ids.begin() + coarse_cell_id_idx,
                                          coarse_cell_id);
-                  // Read the mesh into a MeshFile object using readXDMFUniformGrid
-                  MeshFile<Float, Int> coarse_cell_mesh;
-                  coarse_cell_mesh.format = MeshFileFormat::XDMF;
-                  readXDMFUniformGrid(coarse_cell_node, h5file, h5filename,
-                                      coarse_cell_mesh);
-                  // Set the coarse cell mesh type, mesh id, and material IDs
-                  coarse_cell_material_ids.insert(coarse_cell_material_ids.begin() +
-                                                      coarse_cell_id_idx,
-                                                  std::vector<MaterialID>());
-                  coarse_cell_mesh.getMaterialIDs(
-                      coarse_cell_material_ids[static_cast<size_t>(coarse_cell_id_idx)],
-                      long_material_names);
-                  coarse_cell_dxdys.insert(coarse_cell_dxdys.begin() + coarse_cell_id_idx,
-                                           Vec2<Float>(0, 0));
-                  AxisAlignedBox2<Float> bb;
-                  Size num_verts = 0;
-                  Point2<Float> * vertices = nullptr;
-                  switch (coarse_cell_mesh.getMeshType()) {
-                  case MeshType::Tri: {
-                    coarse_cell_mesh_types.insert(coarse_cell_mesh_types.begin() +
-                                                      coarse_cell_id_idx,
-                                                  MeshType::Tri);
-                    coarse_cell_mesh_ids.insert(
-                        coarse_cell_mesh_ids.begin() + coarse_cell_id_idx, tri.size());
-                    tri.push_back(um2::move(TriMesh<2, Float, Int>(coarse_cell_mesh)));
-                    // Shift the points so that the min point is at the origin.
-                    bb = tri.back().boundingBox();
-                    num_verts = tri.back().vertices.size();
-                    vertices = tri.back().vertices.data();
-                    break;
-                  }
-                  case MeshType::Quad: {
-                    coarse_cell_mesh_types.insert(coarse_cell_mesh_types.begin() +
-                                                      coarse_cell_id_idx,
-                                                  MeshType::Quad);
-                    coarse_cell_mesh_ids.insert(
-                        coarse_cell_mesh_ids.begin() + coarse_cell_id_idx, quad.size());
-                    quad.push_back(um2::move(QuadMesh<2, Float, Int>(coarse_cell_mesh)));
-                    // Shift the points so that the min point is at the origin.
-                    bb = quad.back().boundingBox();
-                    num_verts = quad.back().vertices.size();
-                    vertices = quad.back().vertices.data();
-                    break;
-                  }
-                  case MeshType::QuadraticTri: {
-                    coarse_cell_mesh_types.insert(coarse_cell_mesh_types.begin() +
-                                                      coarse_cell_id_idx,
-                                                  MeshType::QuadraticTri);
-                    coarse_cell_mesh_ids.insert(coarse_cell_mesh_ids.begin() +
-                                                    coarse_cell_id_idx,
-                                                quadratic_tri.size());
-                    quadratic_tri.push_back(
-                        um2::move(QuadraticTriMesh<2, Float, Int>(coarse_cell_mesh)));
-                    // Shift the points so that the min point is at the origin.
-                    bb = quadratic_tri.back().boundingBox();
-                    num_verts = quadratic_tri.back().vertices.size();
-                    vertices = quadratic_tri.back().vertices.data();
-                    break;
-                  }
-                  case MeshType::QuadraticQuad: {
-                    coarse_cell_mesh_types.insert(coarse_cell_mesh_types.begin() +
-                                                      coarse_cell_id_idx,
-                                                  MeshType::QuadraticQuad);
-                    coarse_cell_mesh_ids.insert(coarse_cell_mesh_ids.begin() +
-                                                    coarse_cell_id_idx,
-                                                quadratic_quad.size());
-                    quadratic_quad.push_back(
-                        um2::move(QuadraticQuadMesh<2, Float, Int>(coarse_cell_mesh)));
-                    // Shift the points so that the min point is at the origin.
-                    bb = quadratic_quad.back().boundingBox();
-                    num_verts = quadratic_quad.back().vertices.size();
-                    vertices = quadratic_quad.back().vertices.data();
-                    break;
-                  }
-                  default:
-                    Log::error("Mesh type not supported");
-                    return;
-                  }
-                  // Shift the points so that the min point is at the origin.
-                  Point2<Float> const min_point = bb.minima;
-                  for (Size ip = 0; ip < num_verts; ++ip) {
-                    vertices[ip] -= min_point;
-                  }
-                  Point2<Float> const dxdy = bb.maxima - bb.minima;
-                  coarse_cell_dxdys[static_cast<size_t>(coarse_cell_id_idx)] = dxdy;
                 } // if (coarse_cell_id_it == coarse_cell_ids.end())
                 coarse_cell_count++;
               } // for (auto const & coarse_cell_node : rtm_node.children("Grid"))
@@ -877,39 +1338,23 @@ readXDMFFile(std::string const & path, mpact::SpatialPartition & model)
   } // for (auto const & assembly_node : xcore.children("Grid"))
 
   // Now that we have all the IDs we can create the model
+  // Read the meshes, or just the size and mesh type of each coarse cell
+  std::vector<pugi::xml_node> coarse_cell_nodes;
+  getCoarseCellGrids(xcore, coarse_cell_nodes);
+  std::vector<mpact::SpatialPartition::CoarseCell> cells;
+  bool const read =
+      load_meshes ? readCoarseCellMeshes(coarse_cell_nodes, h5file, h5filename,
+                                         long_material_names, model, cells)
+                  : readCoarseCellBoxes(coarse_cell_nodes, h5file, h5filename, cells);
+  if (!read) {
+    return;
+  }
   // For each coarse cell,
   for (size_t i = 0; i < coarse_cell_ids.size(); ++i) {
     assert(static_cast<Size>(i) == coarse_cell_ids[i]);
     //   Use makeCoarseCell to create the coarse cell
-    model.makeCoarseCell(coarse_cell_dxdys[i]);
-    // Add the mesh to the model
-    // Adjust the mesh id of the coarse cell to be the index of the mesh in the model
-    model.coarse_cells[static_cast<Size>(i)].mesh_type = coarse_cell_mesh_types[i];
-    model.coarse_cells[static_cast<Size>(i)].material_ids.resize(
-        static_cast<Size>(coarse_cell_material_ids[i].size()));
-    std::copy(coarse_cell_material_ids[i].begin(), coarse_cell_material_ids[i].end(),
-              model.coarse_cells[static_cast<Size>(i)].material_ids.begin());
-    switch (coarse_cell_mesh_types[i]) {
-    case MeshType::Tri:
-      model.coarse_cells[static_cast<Size>(i)].mesh_id = model.tri.size();
-      model.tri.push_back(tri[coarse_cell_mesh_ids[i]]);
-      break;
-    case MeshType::Quad:
-      model.coarse_cells[static_cast<Size>(i)].mesh_id = model.quad.size();
-      model.quad.push_back(quad[coarse_cell_mesh_ids[i]]);
-      break;
-    case MeshType::QuadraticTri:
-      model.coarse_cells[static_cast<Size>(i)].mesh_id = model.quadratic_tri.size();
-      model.quadratic_tri.push_back(quadratic_tri[coarse_cell_mesh_ids[i]]);
-      break;
-    case MeshType::QuadraticQuad:
-      model.coarse_cells[static_cast<Size>(i)].mesh_id = model.quadratic_quad.size();
-      model.quadratic_quad.push_back(quadratic_quad[coarse_cell_mesh_ids[i]]);
-      break;
-    default:
-      Log::error("Mesh type not supported");
-      return;
-    }
+    model.makeCoarseCell(cells[i].dxdy, cells[i].mesh_type, cells[i].mesh_id,
+                         cells[i].material_ids);
   }
   // For each RTM,
   for (size_t i = 0; i < rtm_ids.size(); ++i) {
@@ -930,11 +1375,393 @@ readXDMFFile(std::string const & path, mpact::SpatialPartition & model)
   model.makeCore(core_assembly_ids);
 }
 
+//==============================================================================
+// getUnloadedCoarseCells
+//==============================================================================
+// Set to_load to the unique coarse cells in cc_ids whose meshes are not loaded.
+// Returns false if a coarse cell does not exist.
+
+auto
+getUnloadedCoarseCells(mpact::SpatialPartition const & model,
+                       std::vector<Size> const & cc_ids, std::vector<Size> & to_load)
+    -> bool
+{
+  std::vector<bool> queued(static_cast<size_t>(model.numCoarseCells()), false);
+  for (auto const cc_id : cc_ids) {
+    if (cc_id < 0 || cc_id >= model.numCoarseCells()) {
+      Log::error("Coarse cell " + std::to_string(cc_id) + " does not exist");
+      return false;
+    }
+    if (model.coarse_cells[cc_id].mesh_id == -1 && !queued[static_cast<size_t>(cc_id)]) {
+      queued[static_cast<size_t>(cc_id)] = true;
+      to_load.push_back(cc_id);
+    }
+  }
+  return true;
+}
+
+//==============================================================================
+// readUnloadedCoarseCellMeshes
+//==============================================================================
+// Read the meshes of the coarse cells to_load, which are not yet loaded.
+
+void
+readUnloadedCoarseCellMeshes(XDMFModelFile const & file, std::string const & path,
+                             mpact::SpatialPartition & model,
+                             std::vector<Size> const & to_load)
+{
+  Log::info("Loading " + std::to_string(to_load.size()) +
+            " coarse cell meshes from file: " + path);
+  std::vector<pugi::xml_node> all_xgrids;
+  getCoarseCellGrids(file.xcore, all_xgrids);
+  std::vector<pugi::xml_node> xgrids(to_load.size());
+  for (size_t i = 0; i < to_load.size(); ++i) {
+    auto const cc_id = static_cast<size_t>(to_load[i]);
+    if (cc_id >= all_xgrids.size() || all_xgrids[cc_id].empty()) {
+      Log::error("Coarse cell " + std::to_string(cc_id) + " not found in " + path);
+      return;
+    }
+    xgrids[i] = all_xgrids[cc_id];
+  }
+  std::vector<mpact::SpatialPartition::CoarseCell> cells;
+  if (!readCoarseCellMeshes(xgrids, file.h5file, file.h5filename,
+                            file.long_material_names, model, cells)) {
+    return;
+  }
+  for (size_t i = 0; i < to_load.size(); ++i) {
+    auto & cc = model.coarse_cells[to_load[i]];
+    if (cc.mesh_type != cells[i].mesh_type) {
+      Log::error("Mesh type of coarse cell " + std::to_string(to_load[i]) +
+                 " does not match the file");
+      return;
+    }
+    if (!isApprox(cc.dxdy, cells[i].dxdy)) {
+      Log::warn("Mesh of coarse cell " + std::to_string(to_load[i]) +
+                " does not match the coarse cell dimensions");
+    }
+    cc.mesh_id = cells[i].mesh_id;
+    cc.material_ids = um2::move(cells[i].material_ids);
+  }
+}
+
+} // namespace
+
+//==============================================================================
+// readXDMFFile
+//==============================================================================
+
+void
+readXDMFFile(std::string const & path, mpact::SpatialPartition & model,
+             bool const load_meshes)
+{
+  Log::info("Importing MPACT model from file: " + path);
+  XDMFModelFile file;
+  if (!openXDMFModelFile(path, file)) {
+    return;
+  }
+  readXDMFModel(file, model, load_meshes);
+}
+
+//==============================================================================
+// loadCoarseCellMeshes
+//==============================================================================
+
+void
+loadCoarseCellMeshes(std::string const & path, mpact::SpatialPartition & model,
+                     std::vector<Size> const & cc_ids)
+{
+  // Only load the meshes that are not already loaded
+  std::vector<Size> to_load;
+  if (!getUnloadedCoarseCells(model, cc_ids, to_load) || to_load.empty()) {
+    return;
+  }
+  XDMFModelFile file;
+  if (!openXDMFModelFile(path, file)) {
+    return;
+  }
+  readUnloadedCoarseCellMeshes(file, path, model, to_load);
+}
+
+//==============================================================================
+// readSnapshotFile
+//==============================================================================
+
+namespace
+{
+
+class SnapshotReader
+{
+  std::vector<char> _buffer;
+  size_t _pos = 0;
+  bool _good = true;
+
+public:
+  // Read the entire file with a single read.
+  explicit SnapshotReader(std::string const & path)
+  {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+      _good = false;
+      return;
+    }
+    auto const nbytes = static_cast<size_t>(file.tellg());
+    _buffer.resize(nbytes);
+    file.seekg(0);
+    file.read(_buffer.data(), static_cast<std::streamsize>(nbytes));
+    _good = file.good();
+  }
+
+  [[nodiscard]] auto
+  good() const -> bool
+  {
+    return _good;
+  }
+
+  [[nodiscard]] auto
+  atEnd() const -> bool
+  {
+    return _pos == _buffer.size();
+  }
+
+  void
+  readBytes(void * data, size_t const nbytes)
+  {
+    size_t const npad = (snapshot_alignment - nbytes % snapshot_alignment) %
+                        snapshot_alignment;
+    if (!_good || _buffer.size() - _pos < nbytes + npad) {
+      _good = false;
+      return;
+    }
+    if (nbytes > 0) {
+      std::memcpy(data, _buffer.data() + _pos, nbytes);
+    }
+    _pos += nbytes + npad;
+  }
+
+  template <class T>
+  void
+  read(T & value)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    readBytes(&value, sizeof(T));
+  }
+
+  // Read the length of an array, checking that the remaining bytes can hold at
+  // least that many elements of size elem_size.
+  auto
+  readSize(size_t const elem_size) -> Size
+  {
+    uint64_t n = 0;
+    read(n);
+    if (!_good || n > static_cast<uint64_t>(std::numeric_limits<Size>::max()) ||
+        n * elem_size > _buffer.size() - _pos) {
+      _good = false;
+      return 0;
+    }
+    return static_cast<Size>(n);
+  }
+
+  template <class T>
+  void
+  read(Vector<T> & v)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    Size const n = readSize(sizeof(T));
+    v.resize(n);
+    readBytes(v.data(), static_cast<size_t>(n) * sizeof(T));
+  }
+
+  template <Size D, class T, class P>
+  void
+  read(RectilinearPartition<D, T, P> & part)
+  {
+    for (Size i = 0; i < D; ++i) {
+      read(part.grid.divs[i]);
+    }
+    read(part.children);
+  }
+
+  template <Size D, class T, class P>
+  void
+  read(RegularPartition<D, T, P> & part)
+  {
+    read(part.grid);
+    read(part.children);
+  }
+
+  template <Size P, Size N>
+  void
+  read(FaceVertexMesh<P, N, 2, Float, Int> & mesh)
+  {
+    read(mesh.vertices);
+    read(mesh.fv);
+    read(mesh.vf_offsets);
+    read(mesh.vf);
+  }
+
+  template <Size P>
+  void
+  read(MixedFaceVertexMesh<P, 2, Float, Int> & mesh)
+  {
+    read(mesh.vertices);
+    read(mesh.fv_offsets);
+    read(mesh.fv);
+    read(mesh.vf_offsets);
+    read(mesh.vf);
+  }
+
+  template <class T>
+  void
+  readEach(Vector<T> & v)
+  {
+    // Every element takes at least one length (8 bytes) in the file.
+    v.resize(readSize(snapshot_alignment));
+    for (auto & x : v) {
+      read(x);
+    }
+  }
+};
+
+} // namespace
+
+void
+readSnapshotFile(std::string const & path, mpact::SpatialPartition & model)
+{
+  Log::info("Reading snapshot file: " + path);
+  SnapshotReader reader(path);
+  if (!reader.good()) {
+    Log::error("Could not read file: " + path);
+    return;
+  }
+  SnapshotHeader header = {};
+  reader.read(header);
+  if (!reader.good() ||
+      !std::equal(std::begin(snapshot_magic), std::end(snapshot_magic), header.magic)) {
+    Log::error("Not a snapshot file: " + path);
+    return;
+  }
+  if (header.version != snapshot_version) {
+    Log::error("Unsupported snapshot version " + std::to_string(header.version) +
+               ". Expected version " + std::to_string(snapshot_version));
+    return;
+  }
+  if (header.endian_check != snapshot_endian_check || header.float_size != sizeof(Float) ||
+      header.int_size != sizeof(Int) || header.size_size != sizeof(Size) ||
+      header.material_id_size != sizeof(MaterialID)) {
+    Log::error("Snapshot was written with a different endianness or type sizes");
+    return;
+  }
+
+  model.clear();
+  model.materials.clear();
+  reader.read(model.core);
+  reader.readEach(model.assemblies);
+  reader.readEach(model.lattices);
+  reader.readEach(model.rtms);
+  // Each coarse cell takes at least dxdy, mesh_type, mesh_id, and a length
+  model.coarse_cells.resize(reader.readSize(4 * snapshot_alignment));
+  for (auto & cell : model.coarse_cells) {
+    reader.read(cell.dxdy);
+    reader.read(cell.mesh_type);
+    reader.read(cell.mesh_id);
+    reader.read(cell.material_ids);
+  }
+  reader.read(model.materials);
+  {
+    // Each buffer is read with its exact size, so the meshes may be read
+    // directly into the arena
+    ArenaScope const scope(model.mesh_arena.get());
+    model.forEachMeshes([&reader](auto & meshes) { reader.readEach(meshes); });
+  }
+  if (!reader.good() || !reader.atEnd()) {
+    model.clear();
+    model.materials.clear();
+    Log::error("Snapshot file is truncated or corrupt: " + path);
+    return;
+  }
+  for (auto const & cell : model.coarse_cells) {
+    if (cell.mesh_id != -1) {
+      model.checkMeshExists(cell.mesh_type, cell.mesh_id);
+    }
+  }
+}
+
+//==============================================================================
+// importSubdomain
+//==============================================================================
+
+void
+importSubdomain(std::string const & path, mpact::SpatialPartition & model,
+                std::vector<Vec2<Size>> const & asy_positions)
+{
+  // Snapshots cannot be read in part. Parse the XDMF file once, for both the
+  // hierarchy and the meshes.
+  if (!path.ends_with(".xdmf")) {
+    Log::error("importSubdomain requires an XDMF file: " + path);
+    return;
+  }
+  Log::info("Importing MPACT model subdomain from file: " + path);
+  XDMFModelFile file;
+  if (!openXDMFModelFile(path, file)) {
+    return;
+  }
+  readXDMFModel(file, model, /*load_meshes=*/false);
+  // Get the unique coarse cells in the selected assemblies
+  auto const & core = model.core;
+  std::vector<Size> cc_ids;
+  for (auto const & pos : asy_positions) {
+    if (pos[0] < 0 || pos[0] >= core.numXCells() || pos[1] < 0 ||
+        pos[1] >= core.numYCells()) {
+      Log::error("Assembly position (" + std::to_string(pos[0]) + ", " +
+                 std::to_string(pos[1]) + ") is outside the core");
+      return;
+    }
+    auto const asy_id = static_cast<Size>(core.getChild(pos[0], pos[1]));
+    for (auto const lat_id : model.assemblies[asy_id].children) {
+      for (auto const rtm_id : model.lattices[static_cast<Size>(lat_id)].children) {
+        for (auto const cc_id : model.rtms[static_cast<Size>(rtm_id)].children) {
+          cc_ids.push_back(static_cast<Size>(cc_id));
+        }
+      }
+    }
+  }
+  std::sort(cc_ids.begin(), cc_ids.end());
+  cc_ids.erase(std::unique(cc_ids.begin(), cc_ids.end()), cc_ids.end());
+  Log::info("Subdomain of " + std::to_string(asy_positions.size()) + " assemblies uses " +
+            std::to_string(cc_ids.size()) + " of " +
+            std::to_string(model.numCoarseCells()) + " coarse cells");
+  std::vector<Size> to_load;
+  if (!getUnloadedCoarseCells(model, cc_ids, to_load) || to_load.empty()) {
+    return;
+  }
+  readUnloadedCoarseCellMeshes(file, path, model, to_load);
+}
+
+void
+importSubdomain(std::string const & path, mpact::SpatialPartition & model,
+                Vec2<Size> const & lo, Vec2<Size> const & hi)
+{
+  std::vector<Vec2<Size>> asy_positions;
+  for (Size iy = lo[1]; iy < hi[1]; ++iy) {
+    for (Size ix = lo[0]; ix < hi[0]; ++ix) {
+      asy_positions.emplace_back(ix, iy);
+    }
+  }
+  importSubdomain(path, model, asy_positions);
+}
+
+//==============================================================================
+// importMesh
+//==============================================================================
+
 void
-importMesh(std::string const & path, mpact::SpatialPartition & model)
+importMesh(std::string const & path, mpact::SpatialPartition & model,
+           bool const load_meshes)
 {
   if (path.ends_with(".xdmf")) {
-    readXDMFFile(path, model);
+    readXDMFFile(path, model, load_meshes);
+  } else if (path.ends_with(".um2")) {
+    readSnapshotFile(path, model);
   } else {
     Log::error("Unsupported file format.");
   }
@@ -246,37 +246,24 @@ um2MPACTCoarseCellFaceAreas(void * const model, Int const cc_id, Int * const n,
 {
   TRY_CATCH({
     auto const & sp = *reinterpret_cast<um2::mpact::SpatialPartition *>(model);
-    auto const & cc = sp.coarse_cells[cc_id];
-    auto const & mesh_id = cc.mesh_id;
-    um2::Vector<Float> areas_vec;
-    // NOLINTBEGIN(bugprone-branch-clone)
-    switch (cc.mesh_type) {
-    case um2::MeshType::Tri: {
-      areas_vec = sp.tri[mesh_id].getFaceAreas();
-      break;
-    }
-    case um2::MeshType::Quad: {
-      areas_vec = sp.quad[mesh_id].getFaceAreas();
-      break;
-    }
-    case um2::MeshType::QuadraticTri: {
-      areas_vec = sp.quadratic_tri[mesh_id].getFaceAreas();
-      break;
-    }
-    case um2::MeshType::QuadraticQuad: {
-      areas_vec = sp.quadratic_quad[mesh_id].getFaceAreas();
-      break;
+    *n = 0;
+    *areas = nullptr;
+    if (!sp.hasCoarseCellMesh(cc_id)) {
+      // NOLINTNEXTLINE justification: complains this is a null deference, but it's not
+      *ierr = 1;
+      return;
     }
-    default:
-      um2::Log::error("Mesh type not supported");
+    bool const found = sp.visitCoarseCellMesh(cc_id, [n, areas](auto const & mesh) {
+      auto const & areas_vec = mesh.faceGeometry().areas;
+      *n = areas_vec.size();
+      *areas = static_cast<Float *>(malloc(static_cast<size_t>(*n) * sizeof(Float)));
+      std::copy(areas_vec.begin(), areas_vec.end(), *areas);
+      return true;
+    });
+    if (!found) {
       // NOLINTNEXTLINE justification: complains this is a null deference, but it's not
       *ierr = 1;
-      break;
     }
-    // NOLINTEND(bugprone-branch-clone)
-    *n = areas_vec.size();
-    *areas = static_cast<Float *>(malloc(static_cast<size_t>(*n) * sizeof(Float)));
-    std::copy(areas_vec.begin(), areas_vec.end(), *areas);
   });
 }
 
@@ -286,33 +273,20 @@ um2MPACTCoarseCellFaceContaining(void * const model, Int const cc_id, Float cons
 {
   TRY_CATCH({
     auto const & sp = *reinterpret_cast<um2::mpact::SpatialPartition *>(model);
-    auto const & cc = sp.coarse_cells[cc_id];
-    auto const & mesh_id = cc.mesh_id;
-    // NOLINTBEGIN(bugprone-branch-clone)
-    switch (cc.mesh_type) {
-    case um2::MeshType::Tri: {
-      *face_id = sp.tri[mesh_id].faceContaining(um2::Point2<Float>(x, y));
-      break;
-    }
-    case um2::MeshType::Quad: {
-      *face_id = sp.quad[mesh_id].faceContaining(um2::Point2<Float>(x, y));
-      break;
-    }
-    case um2::MeshType::QuadraticTri: {
-      *face_id = sp.quadratic_tri[mesh_id].faceContaining(um2::Point2<Float>(x, y));
-      break;
-    }
-    case um2::MeshType::QuadraticQuad: {
-      *face_id = sp.quadratic_quad[mesh_id].faceContaining(um2::Point2<Float>(x, y));
-      break;
+    if (!sp.hasCoarseCellMesh(cc_id)) {
+      // NOLINTNEXTLINE justification: complains this is a null deference, but it's not
+      *ierr = 1;
+      return;
     }
-    default:
-      um2::Log::error("Mesh type not supported");
+    um2::Point2<Float> const p(x, y);
+    bool const found = sp.visitCoarseCellMesh(cc_id, [&p, face_id](auto const & mesh) {
+      *face_id = mesh.faceContaining(p);
+      return true;
+    });
+    if (!found) {
       // NOLINTNEXTLINE justification: complains this is a null deference, but it's not
       *ierr = 1;
-      break;
     }
-    // NOLINTEND(bugprone-branch-clone)
   });
 }
 
@@ -322,41 +296,21 @@ um2MPACTCoarseCellFaceCentroid(void * const model, Int const cc_id, Int const fa
 {
   TRY_CATCH({
     auto const & sp = *reinterpret_cast<um2::mpact::SpatialPartition *>(model);
-    auto const & cc = sp.coarse_cells[cc_id];
-    auto const & mesh_id = cc.mesh_id;
-    // NOLINTBEGIN(bugprone-branch-clone)
-    switch (cc.mesh_type) {
-    case um2::MeshType::Tri: {
-      auto const p = sp.tri[mesh_id].getFace(face_id).centroid();
-      *x = p[0];
-      *y = p[1];
-      break;
-    }
-    case um2::MeshType::Quad: {
-      auto const p = sp.quad[mesh_id].getFace(face_id).centroid();
-      *x = p[0];
-      *y = p[1];
-      break;
-    }
-    case um2::MeshType::QuadraticTri: {
-      auto const p = sp.quadratic_tri[mesh_id].getFace(face_id).centroid();
-      *x = p[0];
-      *y = p[1];
-      break;
+    if (!sp.hasCoarseCellMesh(cc_id)) {
+      // NOLINTNEXTLINE justification: complains this is a null deference, but it's not
+      *ierr = 1;
+      return;
     }
-    case um2::MeshType::QuadraticQuad: {
-      auto const p = sp.quadratic_quad[mesh_id].getFace(face_id).centroid();
+    bool const found = sp.visitCoarseCellMesh(cc_id, [=](auto const & mesh) {
+      auto const & p = mesh.faceGeometry().centroids[face_id];
       *x = p[0];
       *y = p[1];
-      break;
-    }
-    default:
-      um2::Log::error("Mesh type not supported");
+      return true;
+    });
+    if (!found) {
       // NOLINTNEXTLINE justification: complains this is a null deference, but it's not
       *ierr = 1;
-      break;
     }
-    // NOLINTEND(bugprone-branch-clone)
   });
 }
 
@@ -384,32 +338,13 @@ um2MPACTIntersectCoarseCell(void * const model, Int const cc_id, Float const ori
     return;
   }
   auto & sp = *reinterpret_cast<um2::mpact::SpatialPartition *>(model);
-  auto const & cc = sp.coarse_cells[cc_id];
-  auto const & mesh_id = cc.mesh_id;
+  if (!sp.hasCoarseCellMesh(cc_id)) {
+    return;
+  }
   um2::Ray<2, Float> const ray(um2::Point<2, Float>(origin_x, origin_y),
                                um2::Vec<2, Float>(direction_x, direction_y));
-
-  switch (cc.mesh_type) {
-  case um2::MeshType::Tri: {
-    um2::intersect(sp.tri[mesh_id], ray, intersections, n);
-    break;
-  }
-  case um2::MeshType::Quad: {
-    um2::intersect(sp.quad[mesh_id], ray, intersections, n);
-    break;
-  }
-  case um2::MeshType::QuadraticTri: {
-    um2::intersect(sp.quadratic_tri[mesh_id], ray, intersections, n);
-    break;
-  }
-  case um2::MeshType::QuadraticQuad: {
-    um2::intersect(sp.quadratic_quad[mesh_id], ray, intersections, n);
-    break;
-  }
-  default:
-    um2::Log::error("Mesh type not supported");
-    break;
-  }
+  sp.visitCoarseCellMesh(
+      cc_id, [&](auto const & mesh) { um2::intersect(mesh, ray, intersections, n); });
   *ierr = 0;
 }
 // NOLINTEND
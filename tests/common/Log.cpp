@@ -28,7 +28,34 @@ TEST_CASE(set_get)
   ASSERT(um2::Log::getFlushThreshold() == 21);
 }
 
-TEST_SUITE(Log) { TEST(set_get); }
+TEST_CASE(concurrent_messages)
+{
+  um2::Log::reset();
+  // Keep every message in the buffer, which reset() discards without printing
+  size_t const n = 1000;
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Warn);
+  um2::Log::setBuffered(/*val=*/true);
+  um2::Log::setFlushThreshold(2 * n);
+  um2::Log::setExitOnError(/*val=*/false);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (size_t i = 0; i < n; ++i) {
+    um2::Log::warn("warning " + std::to_string(i));
+    if (i % 10 == 0) {
+      um2::Log::error("error " + std::to_string(i));
+    }
+  }
+  ASSERT(um2::Log::getNumWarnings() == n);
+  ASSERT(um2::Log::getNumErrors() == n / 10);
+  um2::Log::reset();
+}
+
+TEST_SUITE(Log)
+{
+  TEST(set_get);
+  TEST(concurrent_messages);
+}
 
 auto
 main() -> int
@@ -18,15 +18,56 @@ TEST_CASE(sortPermutation)
   ASSERT(perm == expected_perm);
 }
 
-// template <typename T>
-// TEST_CASE(applyPermutation)
-//{
-//   um2::Vector<T> v{5, 3, 1, 4, 2};
-//   um2::Vector<Size> const perm{2, 4, 1, 3, 0};
-//   applyPermutation(v, perm);
-//   um2::Vector<T> const expected_v{1, 2, 3, 4, 5};
-//   ASSERT(v == expected_v);
-// }
+template <typename T>
+TEST_CASE(applyPermutation)
+{
+  um2::Vector<T> v{5, 3, 1, 4, 2};
+  um2::Vector<Size> const perm{2, 4, 1, 3, 0};
+  um2::applyPermutation(v, perm);
+  um2::Vector<T> const expected_v{1, 2, 3, 4, 5};
+  ASSERT(v == expected_v);
+}
+
+template <typename T>
+TEST_CASE(radixSortPermutation)
+{
+  // Repeated keys to check stability, and keys with a constant high byte
+  // to check that skipped passes still produce the permutation.
+  um2::Vector<T> v{5, 3, 1, 4, 2, 3, 0, 5, 1};
+  um2::Vector<T> const original = v;
+  um2::Vector<Size> perm(v.size());
+  um2::radixSortPermutation(v.begin(), v.end(), perm.begin());
+  um2::Vector<T> const expected_v{0, 1, 1, 2, 3, 3, 4, 5, 5};
+  ASSERT(v == expected_v);
+  um2::Vector<Size> const expected_perm{6, 2, 8, 4, 1, 5, 3, 0, 7};
+  ASSERT(perm == expected_perm);
+
+  // Keys which use every byte, compared against std::stable_sort.
+  Size const n = 1000;
+  um2::Vector<T> keys(n);
+  uint64_t x = 88172645463325252ULL;
+  for (Size i = 0; i < n; ++i) {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    keys[i] = static_cast<T>(x);
+  }
+  // Repeat some keys
+  for (Size i = 0; i < n; i += 10) {
+    keys[i] = keys[0];
+  }
+  um2::Vector<Size> expected(n);
+  std::iota(expected.begin(), expected.end(), 0);
+  std::stable_sort(expected.begin(), expected.end(),
+                   [&keys](Size const i, Size const j) { return keys[i] < keys[j]; });
+  um2::Vector<T> sorted = keys;
+  um2::Vector<Size> radix_perm(n);
+  um2::radixSortPermutation(sorted.begin(), sorted.end(), radix_perm.begin());
+  ASSERT(radix_perm == expected);
+  for (Size i = 0; i < n; ++i) {
+    ASSERT(sorted[i] == keys[radix_perm[i]]);
+  }
+}
 
 //==============================================================================
 // CUDA
@@ -38,7 +79,10 @@ template <class T>
 TEST_SUITE(sort)
 {
   TEST((sortPermutation<T>))
-  //  TEST((applyPermutation<T>))
+  TEST((applyPermutation<T>))
+  if constexpr (std::unsigned_integral<T>) {
+    TEST((radixSortPermutation<T>))
+  }
 }
 
 auto
@@ -0,0 +1,90 @@
+#include <um2/geometry/hilbert_sort_points.hpp>
+#include <um2/stdlib/Vector.hpp>
+
+#include <random>
+
+#include "../test_macros.hpp"
+
+// On a regular grid of points, consecutive points in Hilbert order are
+// neighbors on the grid.
+
+template <std::unsigned_integral U, std::floating_point T>
+TEST_CASE(hilbertSort2D)
+{
+  um2::Vector<um2::Point2<T>> points(64);
+  for (Size i = 0; i < 8; ++i) {
+    for (Size j = 0; j < 8; ++j) {
+      points[i * 8 + j] = um2::Point2<T>(static_cast<T>(i), static_cast<T>(j)) / 7;
+    }
+  }
+  std::mt19937 g(0);
+  std::shuffle(points.begin(), points.end(), g);
+  um2::hilbertSort<U>(points.begin(), points.end());
+  ASSERT(um2::isApprox(points[0], um2::Point2<T>(0, 0)));
+  T const h = static_cast<T>(1) / 7;
+  for (Size i = 1; i < points.size(); ++i) {
+    ASSERT_NEAR(points[i - 1].distanceTo(points[i]), h, static_cast<T>(1e-5));
+  }
+}
+
+template <std::unsigned_integral U, std::floating_point T>
+TEST_CASE(hilbertSort3D)
+{
+  um2::Vector<um2::Point3<T>> points(64);
+  for (Size i = 0; i < 4; ++i) {
+    for (Size j = 0; j < 4; ++j) {
+      for (Size k = 0; k < 4; ++k) {
+        points[i * 16 + j * 4 + k] =
+            um2::Point3<T>(static_cast<T>(i), static_cast<T>(j), static_cast<T>(k)) / 3;
+      }
+    }
+  }
+  std::mt19937 g(0);
+  std::shuffle(points.begin(), points.end(), g);
+  um2::hilbertSort<U>(points.begin(), points.end());
+  ASSERT(um2::isApprox(points[0], um2::Point3<T>(0, 0, 0)));
+  T const h = static_cast<T>(1) / 3;
+  for (Size i = 1; i < points.size(); ++i) {
+    ASSERT_NEAR(points[i - 1].distanceTo(points[i]), h, static_cast<T>(1e-5));
+  }
+}
+
+template <std::unsigned_integral U, std::floating_point T>
+TEST_CASE(hilbertSortPermutation)
+{
+  Size const n = 1 << 12;
+  std::mt19937 g(42);
+  std::uniform_real_distribution<T> dist(0, 1);
+  um2::Vector<um2::Point2<T>> points(n);
+  for (auto & p : points) {
+    p = um2::Point2<T>(dist(g), dist(g));
+  }
+  um2::Vector<Size> perm(n);
+  um2::hilbertSortPermutation<U>(points.cbegin(), points.cend(), perm.begin());
+  um2::Vector<int8_t> seen(n, 0);
+  for (Size const i : perm) {
+    ASSERT(0 <= i && i < n);
+    ASSERT(seen[i] == 0);
+    seen[i] = 1;
+  }
+  for (Size i = 1; i < n; ++i) {
+    ASSERT(!um2::hilbertLess<U>(points[perm[i]], points[perm[i - 1]]));
+  }
+}
+
+template <std::unsigned_integral U, std::floating_point T>
+TEST_SUITE(hilbertSort)
+{
+  TEST((hilbertSort2D<U, T>));
+  TEST((hilbertSort3D<U, T>));
+  TEST((hilbertSortPermutation<U, T>));
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE((hilbertSort<uint32_t, float>));
+  RUN_SUITE((hilbertSort<uint32_t, double>));
+  RUN_SUITE((hilbertSort<uint64_t, double>));
+  return 0;
+}
@@ -67,11 +67,47 @@ TEST_CASE(mortonSort3D)
   ASSERT(um2::isApprox(points[15], um2::Point3<T>(3, 1, 1) / 3));
 }
 
+template <std::unsigned_integral U, std::floating_point T>
+TEST_CASE(mortonSortPermutation)
+{
+  // Enough random points to take several radix passes (and, for the parallel
+  // sort, to be split between threads).
+  Size const n = 1 << 16;
+  std::mt19937 g(42);
+  std::uniform_real_distribution<T> dist(0, 1);
+  um2::Vector<um2::Point2<T>> points(n);
+  for (auto & p : points) {
+    p = um2::Point2<T>(dist(g), dist(g));
+  }
+  um2::Vector<Size> perm(n);
+  um2::mortonSortPermutation<U>(points.cbegin(), points.cend(), perm.begin());
+  // perm is a permutation
+  um2::Vector<int8_t> seen(n, 0);
+  for (Size const i : perm) {
+    ASSERT(0 <= i && i < n);
+    ASSERT(seen[i] == 0);
+    seen[i] = 1;
+  }
+  // The permuted points are in Morton order, and equal keys keep their order
+  for (Size i = 1; i < n; ++i) {
+    U const prev = um2::mortonEncode<U>(points[perm[i - 1]]);
+    U const curr = um2::mortonEncode<U>(points[perm[i]]);
+    ASSERT(prev < curr || (prev == curr && perm[i - 1] < perm[i]));
+  }
+  // mortonSort moves the points into the same order
+  um2::Vector<um2::Point2<T>> sorted = points;
+  um2::mortonSort<U>(sorted.begin(), sorted.end());
+  for (Size i = 0; i < n; ++i) {
+    ASSERT(um2::isApprox(sorted[i], points[perm[i]]));
+  }
+}
+
 template <std::unsigned_integral U, std::floating_point T>
 TEST_SUITE(mortonSort)
 {
   TEST((mortonSort2D<U, T>));
   TEST((mortonSort3D<U, T>));
+  TEST((mortonSortPermutation<U, T>));
 }
 
 auto
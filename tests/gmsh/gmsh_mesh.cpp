@@ -0,0 +1,221 @@
+#include <um2/common/Log.hpp>
+#include <um2/config.hpp>
+#if UM2_USE_GMSH
+#  include <um2/gmsh/io.hpp>
+#  include <um2/gmsh/mesh.hpp>
+#  include <um2/mesh/io.hpp>
+
+#  include <array>
+#  include <cstdlib> // setenv, unsetenv
+#  include <filesystem>
+#  include <vector>
+
+#  include <unistd.h> // getpid
+#endif
+
+#include "../test_macros.hpp"
+
+#if UM2_USE_GMSH
+
+TEST_CASE(getMeshFile)
+{
+  um2::gmsh::initialize();
+  um2::gmsh::model::occ::addRectangle(0.0, 0.0, 0.0, 1.0, 1.0);
+  um2::gmsh::model::occ::addRectangle(1.0, 0.0, 0.0, 1.0, 1.0);
+  um2::gmsh::model::occ::synchronize();
+  um2::gmsh::model::addPhysicalGroup(2, {1}, -1, "Material_B");
+  um2::gmsh::model::addPhysicalGroup(2, {2}, -1, "Material_A");
+  um2::gmsh::model::addPhysicalGroup(2, {1, 2}, -1, "Coarse_Cell_00000");
+  um2::gmsh::model::mesh::setGlobalMeshSize(0.25);
+  um2::gmsh::model::mesh::generateMesh(um2::MeshType::Tri);
+
+  // The in-memory mesh should match the mesh written to and read from a file
+  um2::MeshFile<Float, Int> mesh;
+  um2::gmsh::model::mesh::getMeshFile(mesh);
+  um2::gmsh::write("test_getMeshFile.inp");
+  um2::MeshFile<Float, Int> mesh_ref;
+  um2::importMesh("test_getMeshFile.inp", mesh_ref);
+  um2::gmsh::finalize();
+
+  ASSERT(mesh.numCells() > 0);
+  ASSERT(mesh.numCells() == mesh_ref.numCells());
+  ASSERT(mesh.getMeshType() == um2::MeshType::Tri);
+  ASSERT(mesh.elset_names == mesh_ref.elset_names);
+  ASSERT(mesh.elset_offsets == mesh_ref.elset_offsets);
+  for (size_t i = 0; i < mesh.numCells(); ++i) {
+    ASSERT(mesh.element_offsets[i + 1] - mesh.element_offsets[i] == 3);
+  }
+  // Every face is in the coarse cell and exactly one material
+  ASSERT(mesh.elset_names[0] == "Coarse_Cell_00000");
+  ASSERT(static_cast<size_t>(mesh.elset_offsets[1]) == mesh.numCells());
+  ASSERT(static_cast<size_t>(mesh.elset_offsets[3] - mesh.elset_offsets[1]) ==
+         mesh.numCells());
+  std::vector<std::string> material_names;
+  mesh.getMaterialNames(material_names);
+  std::vector<MaterialID> material_ids;
+  mesh.getMaterialIDs(material_ids, material_names);
+  std::vector<MaterialID> material_ids_ref;
+  mesh_ref.getMaterialIDs(material_ids_ref, material_names);
+  ASSERT(material_ids == material_ids_ref);
+
+  int const stat = std::remove("test_getMeshFile.inp");
+  ASSERT(stat == 0);
+}
+
+// Two coarse cells, each a square with a disk in it
+static void
+makeTwoPinModel(double const r1 = 0.3)
+{
+  um2::gmsh::model::occ::addRectangle(0.0, 0.0, 0.0, 1.0, 1.0);
+  um2::gmsh::model::occ::addDisk(0.5, 0.5, 0.0, 0.3, 0.3);
+  um2::gmsh::model::occ::addRectangle(1.0, 0.0, 0.0, 1.0, 1.0);
+  um2::gmsh::model::occ::addDisk(1.5, 0.5, 0.0, r1, r1);
+  um2::gmsh::vectorpair out_dimtags;
+  std::vector<um2::gmsh::vectorpair> out_dimtags_map;
+  um2::gmsh::model::occ::fragment({{2, 1}, {2, 3}}, {{2, 2}, {2, 4}}, out_dimtags,
+                                  out_dimtags_map);
+  um2::gmsh::model::occ::synchronize();
+  // out_dimtags_map[0], [1] are the pieces of the squares, [2], [3] of the disks
+  std::vector<int> fuel;
+  std::vector<int> water;
+  std::array<std::vector<int>, 2> cells;
+  for (size_t i = 0; i < 2; ++i) {
+    int const disk = out_dimtags_map[i + 2][0].second;
+    fuel.push_back(disk);
+    for (auto const & dimtag : out_dimtags_map[i]) {
+      cells[i].push_back(dimtag.second);
+      if (dimtag.second != disk) {
+        water.push_back(dimtag.second);
+      }
+    }
+  }
+  um2::gmsh::model::addPhysicalGroup(2, fuel, -1, "Material_Fuel");
+  um2::gmsh::model::addPhysicalGroup(2, water, -1, "Material_Water");
+  um2::gmsh::model::addPhysicalGroup(2, cells[0], -1, "Coarse_Cell_00000");
+  um2::gmsh::model::addPhysicalGroup(2, cells[1], -1, "Coarse_Cell_00001");
+  um2::gmsh::model::mesh::setGlobalMeshSize(0.1);
+}
+
+TEST_CASE(generateCoarseCellMeshes)
+{
+  std::string const cache_dir = "./test_mesh_cache";
+  std::filesystem::remove_all(cache_dir);
+
+  // Without a cache, this is generateMesh + getMeshFile
+  um2::gmsh::initialize();
+  makeTwoPinModel();
+  um2::MeshFile<Float, Int> mesh_ref;
+  ASSERT(um2::gmsh::model::mesh::generateCoarseCellMeshes(um2::MeshType::Tri, mesh_ref));
+  um2::gmsh::finalize();
+  ASSERT(mesh_ref.numCells() > 0);
+
+  // Both cells miss, then both hit
+  for (int run = 0; run < 2; ++run) {
+    um2::gmsh::initialize();
+    makeTwoPinModel();
+    um2::MeshFile<Float, Int> mesh;
+    ASSERT(um2::gmsh::model::mesh::generateCoarseCellMeshes(um2::MeshType::Tri, mesh,
+                                                            cache_dir));
+    um2::gmsh::finalize();
+    ASSERT(mesh.numCells() == mesh_ref.numCells());
+    ASSERT(mesh.elset_names == mesh_ref.elset_names);
+    ASSERT(mesh.elset_offsets == mesh_ref.elset_offsets);
+  }
+  // The cells are identical up to translation, so they share one cache entry
+  size_t num_keys = 0;
+  for (auto const & entry : std::filesystem::directory_iterator(cache_dir)) {
+    if (entry.path().extension() == ".key") {
+      ++num_keys;
+    }
+  }
+  ASSERT(num_keys == 1);
+
+  // A different mesh type is a miss
+  um2::gmsh::initialize();
+  makeTwoPinModel();
+  um2::MeshFile<Float, Int> quad_mesh;
+  ASSERT(um2::gmsh::model::mesh::generateCoarseCellMeshes(um2::MeshType::Quad,
+                                                          quad_mesh, cache_dir));
+  um2::gmsh::finalize();
+  ASSERT(quad_mesh.getMeshType() == um2::MeshType::Quad);
+  std::filesystem::remove_all(cache_dir);
+
+  // A model without coarse cells is an error, and leaves no temporary directory
+  um2::Log::setExitOnError(false);
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Off);
+  um2::gmsh::initialize();
+  um2::gmsh::model::occ::addRectangle(0.0, 0.0, 0.0, 1.0, 1.0);
+  um2::gmsh::model::occ::synchronize();
+  um2::MeshFile<Float, Int> no_cells_mesh;
+  ASSERT(!um2::gmsh::model::mesh::generateCoarseCellMeshes(
+      um2::MeshType::Tri, no_cells_mesh, "", /*smooth_iters=*/100, /*num_workers=*/2));
+  um2::gmsh::finalize();
+  ASSERT(no_cells_mesh.numCells() == 0);
+  ASSERT(um2::Log::getNumErrors() == 1);
+  ASSERT(!std::filesystem::exists(std::filesystem::temp_directory_path() /
+                                  ("um2_meshes_" + std::to_string(getpid()))));
+  um2::Log::reset();
+}
+
+TEST_CASE(generateCoarseCellMeshes_workers)
+{
+  // Different pins, so that each worker meshes one coarse cell
+  um2::gmsh::initialize();
+  makeTwoPinModel(0.4);
+  um2::MeshFile<Float, Int> mesh;
+  ASSERT(um2::gmsh::model::mesh::generateCoarseCellMeshes(um2::MeshType::Tri, mesh, "",
+                                                          /*smooth_iters=*/100,
+                                                          /*num_workers=*/2));
+  // The workers meshed the coarse cells, so this process did not mesh the model
+  std::vector<std::size_t> node_tags;
+  std::vector<double> coords;
+  std::vector<double> params;
+  um2::gmsh::model::mesh::getNodes(node_tags, coords, params);
+  ASSERT(node_tags.empty());
+  um2::gmsh::finalize();
+  ASSERT(mesh.numCells() > 0);
+  ASSERT(mesh.getMeshType() == um2::MeshType::Tri);
+  ASSERT(mesh.elset_names.size() == 4);
+  ASSERT(mesh.elset_names[0] == "Coarse_Cell_00000");
+  ASSERT(mesh.elset_names[1] == "Coarse_Cell_00001");
+  ASSERT(mesh.elset_names[2] == "Material_Fuel");
+  ASSERT(mesh.elset_names[3] == "Material_Water");
+  // Every face is in exactly one coarse cell
+  ASSERT(static_cast<size_t>(mesh.elset_offsets[2]) == mesh.numCells());
+  ASSERT(mesh.elset_offsets[1] > 0);
+  ASSERT(mesh.elset_offsets[2] > mesh.elset_offsets[1]);
+
+  // Without the worker executable, the coarse cells are meshed in this process
+  setenv("UM2_MESH_WORKER", "./no_such_mesh_worker", /*overwrite=*/1);
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Off);
+  um2::gmsh::initialize();
+  makeTwoPinModel(0.4);
+  um2::MeshFile<Float, Int> local_mesh;
+  ASSERT(um2::gmsh::model::mesh::generateCoarseCellMeshes(
+      um2::MeshType::Tri, local_mesh, "", /*smooth_iters=*/100, /*num_workers=*/2));
+  um2::gmsh::model::mesh::getNodes(node_tags, coords, params);
+  ASSERT(!node_tags.empty());
+  um2::gmsh::finalize();
+  unsetenv("UM2_MESH_WORKER");
+  ASSERT(um2::Log::getNumWarnings() > 0);
+  um2::Log::reset();
+  ASSERT(local_mesh.numCells() == mesh.numCells());
+}
+
+TEST_SUITE(gmsh_mesh)
+{
+  TEST(getMeshFile);
+  TEST(generateCoarseCellMeshes);
+  TEST(generateCoarseCellMeshes_workers);
+}
+#endif // UM2_USE_GMSH
+
+auto
+main() -> int
+{
+#if UM2_USE_GMSH
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Error);
+  RUN_SUITE(gmsh_mesh);
+#endif
+  return 0;
+}
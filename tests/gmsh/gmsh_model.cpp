@@ -372,6 +372,141 @@ TEST_CASE(groupPresIntersect_2d2d)
   }
 }
 
+TEST_CASE(getUniqueCoarseCells)
+{
+  um2::gmsh::initialize();
+  // A 2x2 lattice of 1x1 pin cells. The pin in the top right cell has a smaller
+  // radius.
+  um2::gmsh::model::occ::addDisk(0.5, 0.5, 0.0, 0.4, 0.4);
+  um2::gmsh::model::occ::addDisk(1.5, 0.5, 0.0, 0.4, 0.4);
+  um2::gmsh::model::occ::addDisk(0.5, 1.5, 0.0, 0.4, 0.4);
+  um2::gmsh::model::occ::addDisk(1.5, 1.5, 0.0, 0.3, 0.3);
+  um2::gmsh::model::occ::synchronize();
+  um2::gmsh::model::addPhysicalGroup(2, {1, 2, 3, 4}, -1, "Material_UO2");
+  um2::mpact::SpatialPartition model;
+  for (Size i = 0; i < 4; ++i) {
+    model.makeCoarseCell({1, 1});
+  }
+  model.makeRTM({
+      {2, 3},
+      {0, 1}
+  });
+  model.makeLattice({{0}});
+  model.makeAssembly({0});
+  model.makeCore({{0}});
+  std::vector<Size> const reps = um2::gmsh::model::occ::getUniqueCoarseCells(model);
+  ASSERT(reps.size() == 4);
+  ASSERT(reps[0] == 0);
+  ASSERT(reps[1] == 0);
+  ASSERT(reps[2] == 0);
+  ASSERT(reps[3] == 3);
+
+  // Only the representatives are cut from the model
+  um2::gmsh::model::occ::overlaySpatialPartition(model, "Moderator",
+                                                 um2::Color("royalblue"), reps);
+  um2::gmsh::vectorpair dimtags;
+  um2::gmsh::model::getPhysicalGroups(dimtags, 2);
+  std::vector<std::string> cc_names;
+  for (auto const & dimtag : dimtags) {
+    std::string name;
+    um2::gmsh::model::getPhysicalName(dimtag.first, dimtag.second, name);
+    if (name.starts_with("Coarse_Cell")) {
+      cc_names.push_back(name);
+    }
+  }
+  std::sort(cc_names.begin(), cc_names.end());
+  ASSERT(cc_names.size() == 2);
+  ASSERT(cc_names[0] == "Coarse_Cell_00000");
+  ASSERT(cc_names[1] == "Coarse_Cell_00003");
+  um2::gmsh::finalize();
+}
+
+TEST_CASE(getUniqueCoarseCells_mirrored)
+{
+  um2::gmsh::initialize();
+  // Two 1x1 cells, each with a right triangle. The second triangle is the first
+  // mirrored, so it has the same bounding box and area, but is not a translation.
+  std::vector<std::array<double, 2>> const corners = {
+      {0.1, 0.1}, {0.9, 0.1}, {0.1, 0.9},
+      {1.1, 0.1}, {1.9, 0.1}, {1.9, 0.9}
+  };
+  for (size_t t = 0; t < 2; ++t) {
+    std::vector<int> points(3);
+    for (size_t i = 0; i < 3; ++i) {
+      auto const & c = corners[3 * t + i];
+      points[i] = um2::gmsh::model::occ::addPoint(c[0], c[1], 0.0);
+    }
+    std::vector<int> lines(3);
+    for (size_t i = 0; i < 3; ++i) {
+      lines[i] = um2::gmsh::model::occ::addLine(points[i], points[(i + 1) % 3]);
+    }
+    int const loop = um2::gmsh::model::occ::addCurveLoop(lines);
+    um2::gmsh::model::occ::addPlaneSurface({loop});
+  }
+  um2::gmsh::model::occ::synchronize();
+  um2::gmsh::model::addPhysicalGroup(2, {1, 2}, -1, "Material_UO2");
+  um2::mpact::SpatialPartition model;
+  model.makeCoarseCell({1, 1});
+  model.makeCoarseCell({1, 1});
+  model.makeRTM({{0, 1}});
+  model.makeLattice({{0}});
+  model.makeAssembly({0});
+  model.makeCore({{0}});
+  std::vector<Size> const reps = um2::gmsh::model::occ::getUniqueCoarseCells(model);
+  ASSERT(reps.size() == 2);
+  ASSERT(reps[0] == 0);
+  ASSERT(reps[1] == 1);
+  um2::gmsh::finalize();
+}
+
+TEST_CASE(overlaySpatialPartition_tiles)
+{
+  um2::gmsh::initialize();
+  // A disk that spans all 4 cells of a 2x2 lattice of 1x1 cells, so each piece
+  // of it is cut in a different tile.
+  um2::gmsh::model::occ::addDisk(1.0, 1.0, 0.0, 0.9, 0.9);
+  um2::gmsh::model::occ::synchronize();
+  um2::gmsh::model::addPhysicalGroup(2, {1}, -1, "Material_UO2");
+  um2::mpact::SpatialPartition model;
+  model.makeCoarseCell({1, 1});
+  model.makeRTM({
+      {0, 0},
+      {0, 0}
+  });
+  model.makeLattice({{0}});
+  model.makeAssembly({0});
+  model.makeCore({{0}});
+  um2::gmsh::model::occ::overlaySpatialPartition(model, "Moderator",
+                                                 um2::Color("royalblue"), {}, 1);
+  um2::gmsh::vectorpair dimtags;
+  um2::gmsh::model::getPhysicalGroups(dimtags, 2);
+  Size num_cc = 0;
+  for (auto const & dimtag : dimtags) {
+    std::string name;
+    um2::gmsh::model::getPhysicalName(dimtag.first, dimtag.second, name);
+    std::vector<int> tags;
+    um2::gmsh::model::getEntitiesForPhysicalGroup(dimtag.first, dimtag.second, tags);
+    if (name.starts_with("Coarse_Cell")) {
+      ++num_cc;
+      // One piece of the disk and the moderator around it
+      ASSERT(tags.size() == 2);
+    } else {
+      ASSERT(tags.size() == 4);
+      if (name == "Material_UO2") {
+        double area = 0;
+        for (int const tag : tags) {
+          double mass = 0;
+          um2::gmsh::model::occ::getMass(2, tag, mass);
+          area += mass;
+        }
+        ASSERT_NEAR(area, 0.81 * um2::pi<double>, 1e-6);
+      }
+    }
+  }
+  ASSERT(num_cc == 4);
+  um2::gmsh::finalize();
+}
+
 TEST_SUITE(gmsh_model)
 {
   TEST(addToPhysicalGroup)
@@ -379,6 +514,9 @@ TEST_SUITE(gmsh_model)
   TEST(groupPresFragment_2d2d);
   TEST(groupPresFragment_3d3d);
   TEST(groupPresIntersect_2d2d);
+  TEST(getUniqueCoarseCells);
+  TEST(getUniqueCoarseCells_mirrored);
+  TEST(overlaySpatialPartition_tiles);
 }
 #endif // UM2_USE_GMSH
 
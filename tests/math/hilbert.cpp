@@ -0,0 +1,166 @@
+#include <um2/math/hilbert.hpp>
+
+#include "../test_macros.hpp"
+
+// The curve is tested through its defining properties, since the orientation
+// of the first cells depends on the number of bits per coordinate.
+
+template <std::unsigned_integral U>
+HOSTDEV
+TEST_CASE(hilbert2D)
+{
+  // NOLINTNEXTLINE justification: reduce clutter
+  using namespace um2;
+
+  ASSERT(hilbertEncode(static_cast<U>(0), static_cast<U>(0)) == 0);
+
+  // Round trip on a 16 by 16 block of cells
+  for (U x = 0; x < 16; ++x) {
+    for (U y = 0; y < 16; ++y) {
+      U const h = hilbertEncode(x, y);
+      U xd;
+      U yd;
+      hilbertDecode(h, xd, yd);
+      ASSERT(xd == x && yd == y);
+      // The 16 by 16 block is the first 256 cells of the curve
+      ASSERT(h < 256);
+    }
+  }
+
+  // Consecutive cells share a side
+  auto const is_step = [](U const h) {
+    U x0;
+    U y0;
+    U x1;
+    U y1;
+    hilbertDecode(h, x0, y0);
+    hilbertDecode(static_cast<U>(h + 1), x1, y1);
+    U const dx = x0 < x1 ? x1 - x0 : x0 - x1;
+    U const dy = y0 < y1 ? y1 - y0 : y0 - y1;
+    return dx + dy == 1;
+  };
+  for (U h = 0; h < 1024; ++h) {
+    ASSERT(is_step(h));
+  }
+  U const last = ~static_cast<U>(0);
+  for (U h = last - 1024; h < last; ++h) {
+    ASSERT(is_step(h));
+  }
+  U const mid = last / 2 - 512;
+  for (U h = mid; h < mid + 1024; ++h) {
+    ASSERT(is_step(h));
+  }
+}
+
+template <std::unsigned_integral U>
+HOSTDEV
+TEST_CASE(hilbert3D)
+{
+  // NOLINTNEXTLINE justification: reduce clutter
+  using namespace um2;
+
+  ASSERT(hilbertEncode(static_cast<U>(0), static_cast<U>(0), static_cast<U>(0)) == 0);
+
+  // Round trip on an 8 by 8 by 8 block of cells
+  for (U x = 0; x < 8; ++x) {
+    for (U y = 0; y < 8; ++y) {
+      for (U z = 0; z < 8; ++z) {
+        U const h = hilbertEncode(x, y, z);
+        U xd;
+        U yd;
+        U zd;
+        hilbertDecode(h, xd, yd, zd);
+        ASSERT(xd == x && yd == y && zd == z);
+        // The 8 by 8 by 8 block is the first 512 cells of the curve
+        ASSERT(h < 512);
+      }
+    }
+  }
+
+  // Consecutive cells share a face
+  auto const is_step = [](U const h) {
+    U p0[3];
+    U p1[3];
+    hilbertDecode(h, p0[0], p0[1], p0[2]);
+    hilbertDecode(static_cast<U>(h + 1), p1[0], p1[1], p1[2]);
+    U dist = 0;
+    for (Size i = 0; i < 3; ++i) {
+      dist += p0[i] < p1[i] ? p1[i] - p0[i] : p0[i] - p1[i];
+    }
+    return dist == 1;
+  };
+  for (U h = 0; h < 4096; ++h) {
+    ASSERT(is_step(h));
+  }
+  U const last = (static_cast<U>(1) << (3 * hilbert_bits<U, 3>)) - 1;
+  for (U h = last - 4096; h < last; ++h) {
+    ASSERT(is_step(h));
+  }
+}
+
+template <std::unsigned_integral U, std::floating_point T>
+HOSTDEV
+TEST_CASE(hilbertFloatRoundTrip)
+{
+  // NOLINTNEXTLINE justification: reduce clutter
+  using namespace um2;
+
+  T const zero = static_cast<T>(0);
+  T const one = static_cast<T>(1);
+  ASSERT((hilbertEncode<U, T>(zero, zero) == 0));
+  ASSERT((hilbertEncode<U, T>(zero, zero, zero) == 0));
+
+  T const coords[5] = {zero, static_cast<T>(0.25), static_cast<T>(0.5),
+                       static_cast<T>(0.875), one};
+  for (auto const x : coords) {
+    for (auto const y : coords) {
+      T xd;
+      T yd;
+      hilbertDecode<U, T>(hilbertEncode<U, T>(x, y), xd, yd);
+      ASSERT_NEAR(xd, x, static_cast<T>(1e-4));
+      ASSERT_NEAR(yd, y, static_cast<T>(1e-4));
+      for (auto const z : coords) {
+        T zd;
+        hilbertDecode<U, T>(hilbertEncode<U, T>(x, y, z), xd, yd, zd);
+        ASSERT_NEAR(xd, x, static_cast<T>(1e-3));
+        ASSERT_NEAR(yd, y, static_cast<T>(1e-3));
+        ASSERT_NEAR(zd, z, static_cast<T>(1e-3));
+      }
+    }
+  }
+}
+
+#if UM2_USE_CUDA
+template <std::unsigned_integral U>
+MAKE_CUDA_KERNEL(hilbert2D, U);
+
+template <std::unsigned_integral U>
+MAKE_CUDA_KERNEL(hilbert3D, U);
+
+template <std::unsigned_integral U, std::floating_point T>
+MAKE_CUDA_KERNEL(hilbertFloatRoundTrip, U, T);
+#endif
+
+template <std::unsigned_integral U>
+TEST_SUITE(hilbert)
+{
+  TEST_HOSTDEV(hilbert2D, 1, 1, U);
+  TEST_HOSTDEV(hilbert3D, 1, 1, U);
+}
+
+template <std::unsigned_integral U, std::floating_point T>
+TEST_SUITE(hilbertFloat)
+{
+  TEST_HOSTDEV(hilbertFloatRoundTrip, 1, 1, U, T);
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE(hilbert<uint32_t>);
+  RUN_SUITE(hilbert<uint64_t>);
+  RUN_SUITE((hilbertFloat<uint32_t, float>));
+  RUN_SUITE((hilbertFloat<uint32_t, double>));
+  RUN_SUITE((hilbertFloat<uint64_t, double>));
+  return 0;
+}
@@ -0,0 +1,159 @@
+#include <um2/mesh/CompactFaceVertexMesh.hpp>
+
+#include "./helpers/setup_mesh.hpp"
+
+#include "../test_macros.hpp"
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(constructor)
+{
+  static_assert(sizeof(typename um2::CompactTriMesh<T>::FaceConn) == 6);
+  static_assert(sizeof(um2::Vec2<uint16_t>) == 4);
+  um2::TriMesh<2, T, I> const mesh = makeTriReferenceMesh<2, T, I>();
+  um2::CompactTriMesh<T> const compact(mesh);
+  ASSERT(compact.numVertices() == 4);
+  ASSERT(compact.numFaces() == 2);
+  ASSERT(um2::isApprox(compact.box.minima, mesh.boundingBox().minima));
+  ASSERT(um2::isApprox(compact.box.maxima, mesh.boundingBox().maxima));
+  // The corners of the box are exact
+  ASSERT(compact.vertices[0][0] == 0);
+  ASSERT(compact.vertices[0][1] == 0);
+  ASSERT(compact.vertices[2][0] == 65535);
+  ASSERT(compact.vertices[2][1] == 65535);
+  for (Size i = 0; i < mesh.numVertices(); ++i) {
+    ASSERT(um2::isApprox(compact.getVertex(i), mesh.vertices[i]));
+  }
+  for (Size i = 0; i < mesh.numFaces(); ++i) {
+    for (Size j = 0; j < 3; ++j) {
+      ASSERT(compact.fv[i][j] == static_cast<uint16_t>(mesh.fv[i][j]));
+    }
+  }
+
+  // Too many vertices for 16-bit indices
+  if constexpr (sizeof(I) > 2) {
+    um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Off);
+    um2::Log::setExitOnError(false);
+    um2::TriMesh<2, T, I> big;
+    big.vertices.resize(65537);
+    size_t const num_errors = um2::Log::getNumErrors();
+    um2::CompactTriMesh<T> const compact_big(big);
+    ASSERT(um2::Log::getNumErrors() == num_errors + 1);
+    ASSERT(compact_big.numVertices() == 0);
+    um2::Log::reset();
+  }
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(quantization)
+{
+  um2::QuadraticQuadMesh<2, T, I> const mesh = makeQuad8ReferenceMesh<2, T, I>();
+  um2::CompactQuadraticQuadMesh<T> const compact(mesh);
+  // Each vertex moves by at most half the spacing in each direction
+  T const eps = um2::epsilonDistance<T>();
+  ASSERT_NEAR(compact.spacing[0], static_cast<T>(2) / 65535, eps);
+  ASSERT_NEAR(compact.spacing[1], static_cast<T>(1) / 65535, eps);
+  for (Size i = 0; i < mesh.numVertices(); ++i) {
+    auto const p = compact.getVertex(i);
+    for (Size d = 0; d < 2; ++d) {
+      ASSERT(um2::abs(p[d] - mesh.vertices[i][d]) <= compact.spacing[d] / 2 + eps);
+    }
+  }
+  auto const result = um2::validateCompactMesh(compact, mesh);
+  ASSERT(result.max_vertex_error <= compact.spacing.norm() / 2 + eps);
+  ASSERT(result.max_relative_area_error < static_cast<T>(1e-4));
+  ASSERT(result.flipped_faces.count == 0);
+
+  // With 32-bit coordinates, the vertices are as precise as float
+  um2::CompactQuadraticQuadMesh<T, uint32_t> const compact32(mesh);
+  for (Size i = 0; i < mesh.numVertices(); ++i) {
+    ASSERT(um2::isApprox(compact32.getVertex(i), mesh.vertices[i]));
+  }
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(faceContaining)
+{
+  um2::QuadraticQuadMesh<2, T, I> const mesh = makeQuad8ReferenceMesh<2, T, I>();
+  um2::CompactQuadraticQuadMesh<T> const compact(mesh);
+  // Points away from the edges are in the same face
+  for (Size i = 1; i < 20; ++i) {
+    for (Size j = 1; j < 10; ++j) {
+      um2::Point2<T> const p(static_cast<T>(i) / 10 + static_cast<T>(0.003),
+                             static_cast<T>(j) / 10 + static_cast<T>(0.003));
+      ASSERT(compact.faceContaining(p) == mesh.faceContaining(p));
+    }
+  }
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(intersect)
+{
+  um2::QuadraticQuadMesh<2, T, I> const mesh = makeQuad8ReferenceMesh<2, T, I>();
+  um2::CompactQuadraticQuadMesh<T> const compact(mesh);
+  um2::Vector<T> expected(16);
+  um2::Vector<T> intersections(16);
+  for (Size i = 1; i < 10; ++i) {
+    T const y = static_cast<T>(i) / 10 + static_cast<T>(0.003);
+    um2::Ray2<T> const ray({static_cast<T>(-1), y}, {1, 0});
+    Size n_expected = expected.size();
+    mesh.intersect(ray, expected.data(), &n_expected);
+    Size n = intersections.size();
+    compact.intersect(ray, intersections.data(), &n);
+    ASSERT(n == n_expected);
+    for (Size k = 0; k < n; ++k) {
+      ASSERT_NEAR(intersections[k], expected[k], static_cast<T>(1e-4));
+    }
+  }
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(validateCompactMesh)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Off);
+  // Triangle 0 is thinner than the spacing, so its third vertex is quantized
+  // onto its base
+  um2::TriMesh<2, T, I> mesh;
+  mesh.vertices = {
+      {                  0,                    0},
+      {                  1,                    0},
+      {static_cast<T>(0.5), static_cast<T>(1e-6)},
+      {                  1,                    1}
+  };
+  mesh.fv = {
+      {0, 1, 2},
+      {1, 3, 2}
+  };
+  um2::CompactTriMesh<T> const compact(mesh);
+  auto const result = um2::validateCompactMesh(compact, mesh);
+  ASSERT(result.flipped_faces.count == 1);
+  ASSERT(result.flipped_faces.ids.size() == 1);
+  ASSERT(result.flipped_faces.ids[0] == 0);
+  ASSERT(result.max_relative_area_error > static_cast<T>(0.5));
+
+  // 32-bit coordinates keep it
+  um2::CompactTriMesh<T, uint32_t> const compact32(mesh);
+  ASSERT(um2::validateCompactMesh(compact32, mesh).flipped_faces.count == 0);
+  um2::Log::reset();
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_SUITE(CompactFaceVertexMesh)
+{
+  TEST((constructor<T, I>));
+  TEST((quantization<T, I>));
+  TEST((faceContaining<T, I>));
+  TEST((intersect<T, I>));
+  TEST((validateCompactMesh<T, I>));
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE((CompactFaceVertexMesh<float, int16_t>));
+  RUN_SUITE((CompactFaceVertexMesh<float, int32_t>));
+  RUN_SUITE((CompactFaceVertexMesh<float, int64_t>));
+  RUN_SUITE((CompactFaceVertexMesh<double, int16_t>));
+  RUN_SUITE((CompactFaceVertexMesh<double, int32_t>));
+  RUN_SUITE((CompactFaceVertexMesh<double, int64_t>));
+  return 0;
+}
@@ -174,6 +174,36 @@ TEST_CASE(getMaterialIDs)
   ASSERT(mat_ids == mat_ids_ref2);
 }
 
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(weldVertices)
+{
+  um2::MeshFile<T, I> tri_ref;
+  makeReferenceTriMeshFile(tri_ref);
+  T const eps = um2::epsilonDistance<T>();
+  // Give the second triangle its own copies of vertices 2 and 0, as if the two
+  // triangles were stitched together
+  um2::MeshFile<T, I> tri;
+  makeReferenceTriMeshFile(tri);
+  tri.vertices.push_back(tri.vertices[2]);
+  tri.vertices.push_back(tri.vertices[0]);
+  tri.vertices[4][0] += eps / 2;
+  tri.element_conn = {0, 1, 2, 4, 3, 5};
+  ASSERT(tri.weldVertices() == 2);
+  ASSERT(um2::compareGeometry(tri, tri_ref) == 0);
+  ASSERT(um2::compareTopology(tri, tri_ref) == 0);
+  ASSERT(tri.weldVertices() == 0);
+
+  // Vertices farther apart than the tolerance are kept
+  makeReferenceTriMeshFile(tri);
+  tri.vertices.push_back(tri.vertices[2]);
+  tri.vertices[4][1] += eps * 2;
+  tri.element_conn = {0, 1, 2, 4, 3, 0};
+  ASSERT(tri.weldVertices() == 0);
+  ASSERT(tri.vertices.size() == 5);
+  ASSERT(tri.weldVertices(eps * 4) == 1);
+  ASSERT(um2::compareTopology(tri, tri_ref) == 0);
+}
+
 template <std::floating_point T, std::signed_integral I>
 TEST_SUITE(MeshFile)
 {
@@ -185,6 +215,7 @@ TEST_SUITE(MeshFile)
   TEST((getSubmesh<T, I>));
   TEST((getMaterialNames<T, I>));
   TEST((getMaterialIDs<T, I>));
+  TEST((weldVertices<T, I>));
 }
 
 auto
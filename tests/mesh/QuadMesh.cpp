@@ -5,6 +5,8 @@
 
 #include "../test_macros.hpp"
 
+#include <random>
+
 template <std::floating_point T, std::signed_integral I>
 TEST_CASE(mesh_file_constructor)
 {
@@ -83,6 +85,237 @@ TEST_CASE(toMeshFile)
   ASSERT(quad_mesh_file.getMeshType() == um2::MeshType::Quad);
 }
 
+// A grid of n by n unit squares, with the vertices and faces numbered randomly
+template <std::floating_point T, std::signed_integral I>
+auto
+makeShuffledQuadGrid(Size const n = 8) -> um2::QuadMesh<2, T, I>
+{
+  std::mt19937 g(0);
+  um2::Vector<Size> vertex_ids((n + 1) * (n + 1));
+  std::iota(vertex_ids.begin(), vertex_ids.end(), 0);
+  std::shuffle(vertex_ids.begin(), vertex_ids.end(), g);
+  um2::Vector<Size> face_ids(n * n);
+  std::iota(face_ids.begin(), face_ids.end(), 0);
+  std::shuffle(face_ids.begin(), face_ids.end(), g);
+  um2::QuadMesh<2, T, I> mesh;
+  mesh.vertices.resize((n + 1) * (n + 1));
+  for (Size i = 0; i <= n; ++i) {
+    for (Size j = 0; j <= n; ++j) {
+      mesh.vertices[vertex_ids[i * (n + 1) + j]] =
+          um2::Point2<T>(static_cast<T>(j), static_cast<T>(i));
+    }
+  }
+  auto const v = [&vertex_ids, n](Size const i, Size const j) {
+    return static_cast<I>(vertex_ids[i * (n + 1) + j]);
+  };
+  mesh.fv.resize(n * n);
+  for (Size i = 0; i < n; ++i) {
+    for (Size j = 0; j < n; ++j) {
+      auto & face = mesh.fv[face_ids[i * n + j]];
+      face[0] = v(i, j);
+      face[1] = v(i, j + 1);
+      face[2] = v(i + 1, j + 1);
+      face[3] = v(i + 1, j);
+    }
+  }
+  um2::buildVertexFaceConnectivity(mesh);
+  return mesh;
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(vertexFaceConnectivity)
+{
+  // Large enough for the parallel version, if I can index it
+  Size const n = sizeof(I) == 2 ? 8 : 100;
+  um2::QuadMesh<2, T, I> const mesh = makeShuffledQuadGrid<T, I>(n);
+  ASSERT(mesh.vf_offsets.size() == mesh.numVertices() + 1);
+  ASSERT(mesh.vf_offsets[0] == 0);
+  ASSERT(mesh.vf.size() == 4 * mesh.numFaces());
+  um2::Vector<I> counts(mesh.numVertices(), 0);
+  for (auto const & face : mesh.fv) {
+    for (Size j = 0; j < 4; ++j) {
+      ++counts[static_cast<Size>(face[j])];
+    }
+  }
+  for (Size v = 0; v < mesh.numVertices(); ++v) {
+    ASSERT(mesh.vf_offsets[v + 1] - mesh.vf_offsets[v] == counts[v]);
+    // The faces of each vertex are in increasing order and contain the vertex
+    for (I k = mesh.vf_offsets[v]; k < mesh.vf_offsets[v + 1]; ++k) {
+      auto const i = static_cast<Size>(mesh.vf[static_cast<Size>(k)]);
+      if (k > mesh.vf_offsets[v]) {
+        ASSERT(mesh.vf[static_cast<Size>(k - 1)] < mesh.vf[static_cast<Size>(k)]);
+      }
+      auto const & face = mesh.fv[i];
+      ASSERT(face[0] == v || face[1] == v || face[2] == v || face[3] == v);
+    }
+  }
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(validateMesh)
+{
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Off);
+  um2::QuadMesh<2, T, I> mesh = makeShuffledQuadGrid<T, I>();
+  // Flip every seventh face
+  for (Size i = 0; i < mesh.numFaces(); i += 7) {
+    mesh.flipFace(i);
+  }
+  size_t num_warnings = um2::Log::getNumWarnings();
+  um2::MeshValidation result = um2::validateMesh(mesh);
+  ASSERT(result.clockwise_faces.count == 10);
+  ASSERT(result.clockwise_faces.ids.size() == um2::MeshIssue::max_ids);
+  for (Size k = 0; k < um2::MeshIssue::max_ids; ++k) {
+    ASSERT(result.clockwise_faces.ids[k] == 7 * k);
+  }
+  for (Size i = 0; i < mesh.numFaces(); ++i) {
+    ASSERT(mesh.getFace(i).isCCW());
+  }
+  ASSERT(result.nonconvex_faces.count == 0);
+  ASSERT(result.duplicate_vertices.count == 0);
+  // One warning for all the flipped faces
+  ASSERT(um2::Log::getNumWarnings() == num_warnings + 1);
+
+  // A dart, and an unused copy of its first vertex
+  um2::QuadMesh<2, T, I> dart;
+  T const half = static_cast<T>(0.5);
+  dart.vertices = {
+      {   0,    0},
+      {   2,    0},
+      {half, half},
+      {   0,    2},
+      {   0,    0}
+  };
+  dart.fv.resize(1);
+  for (Size j = 0; j < 4; ++j) {
+    dart.fv[0][j] = static_cast<I>(j);
+  }
+  num_warnings = um2::Log::getNumWarnings();
+  result = um2::validateMesh(dart);
+  ASSERT(result.clockwise_faces.count == 0);
+  ASSERT(result.nonconvex_faces.count == 1);
+  ASSERT(result.nonconvex_faces.ids.size() == 1);
+  ASSERT(result.nonconvex_faces.ids[0] == 0);
+  // Duplicate vertices are only checked in debug builds
+  Size const num_duplicates = result.duplicate_vertices.count;
+  ASSERT(num_duplicates <= 1);
+  if (num_duplicates == 1) {
+    ASSERT(result.duplicate_vertices.ids[0] == 4);
+  }
+  ASSERT(um2::Log::getNumWarnings() ==
+         num_warnings + 1 + static_cast<size_t>(num_duplicates));
+  um2::Log::reset();
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(reorder)
+{
+  um2::QuadMesh<2, T, I> const mesh_ref = makeShuffledQuadGrid<T, I>();
+  // The largest spread of the vertex indices of a face
+  auto const bandwidth = [](um2::QuadMesh<2, T, I> const & mesh) {
+    I result = 0;
+    for (auto const & face : mesh.fv) {
+      I const lo = um2::min(um2::min(face[0], face[1]), um2::min(face[2], face[3]));
+      I const hi = um2::max(um2::max(face[0], face[1]), um2::max(face[2], face[3]));
+      result = um2::max(result, static_cast<I>(hi - lo));
+    }
+    return result;
+  };
+  // The length of the path through the face centroids, in face order
+  auto const pathLength = [](um2::QuadMesh<2, T, I> const & mesh) {
+    T result = 0;
+    for (Size i = 1; i < mesh.numFaces(); ++i) {
+      result += mesh.getFace(i - 1).centroid().distanceTo(mesh.getFace(i).centroid());
+    }
+    return result;
+  };
+
+  um2::MeshOrdering const orderings[3] = {
+      um2::MeshOrdering::Morton, um2::MeshOrdering::Hilbert, um2::MeshOrdering::RCM};
+  for (auto const ordering : orderings) {
+    um2::QuadMesh<2, T, I> mesh = mesh_ref;
+    um2::Vector<Size> const perm = mesh.reorder(ordering);
+    ASSERT(mesh.numVertices() == mesh_ref.numVertices());
+    ASSERT(mesh.numFaces() == mesh_ref.numFaces());
+    // Each face is the same quadrilateral as before
+    for (Size i = 0; i < mesh.numFaces(); ++i) {
+      auto const face = mesh.getFace(i);
+      auto const face_ref = mesh_ref.getFace(perm[i]);
+      for (Size j = 0; j < 4; ++j) {
+        ASSERT(um2::isApprox(face[j], face_ref[j]));
+      }
+    }
+    // The faces of each vertex contain the vertex
+    ASSERT(mesh.vf_offsets.size() == mesh.numVertices() + 1);
+    ASSERT(mesh.vf.size() == 4 * mesh.numFaces());
+    for (Size v = 0; v < mesh.numVertices(); ++v) {
+      for (I k = mesh.vf_offsets[v]; k < mesh.vf_offsets[v + 1]; ++k) {
+        auto const & face = mesh.fv[static_cast<Size>(mesh.vf[static_cast<Size>(k)])];
+        ASSERT(face[0] == v || face[1] == v || face[2] == v || face[3] == v);
+      }
+    }
+    // Neighboring faces and vertices are closer in memory
+    ASSERT(bandwidth(mesh) < bandwidth(mesh_ref));
+    ASSERT(pathLength(mesh) < pathLength(mesh_ref));
+  }
+
+  // No ordering leaves the mesh as is
+  um2::QuadMesh<2, T, I> mesh = mesh_ref;
+  um2::Vector<Size> const perm = mesh.reorder(um2::MeshOrdering::None);
+  for (Size i = 0; i < mesh.numFaces(); ++i) {
+    ASSERT(perm[i] == i);
+    for (Size j = 0; j < 4; ++j) {
+      ASSERT(mesh.fv[i][j] == mesh_ref.fv[i][j]);
+    }
+  }
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(weldVertices)
+{
+  um2::QuadMesh<2, T, I> const mesh_ref = makeShuffledQuadGrid<T, I>();
+  Size const num_vertices = mesh_ref.numVertices();
+  T const eps = um2::epsilonDistance<T>();
+  // Every other face uses a copy of each of its vertices, slightly moved
+  um2::QuadMesh<2, T, I> mesh = mesh_ref;
+  for (Size i = 0; i < num_vertices; ++i) {
+    um2::Point2<T> p = mesh.vertices[i];
+    p[i % 2] += eps / 4;
+    mesh.vertices.push_back(p);
+  }
+  for (Size i = 1; i < mesh.numFaces(); i += 2) {
+    for (auto & v : mesh.fv[i]) {
+      v = static_cast<I>(v + num_vertices);
+    }
+  }
+  um2::buildVertexFaceConnectivity(mesh);
+  // The copies are merged into the original vertices, which have the smaller
+  // indices, so the mesh is the same as before
+  ASSERT(mesh.weldVertices() == num_vertices);
+  ASSERT(mesh.numVertices() == num_vertices);
+  for (Size i = 0; i < num_vertices; ++i) {
+    ASSERT(um2::isApprox(mesh.vertices[i], mesh_ref.vertices[i]));
+  }
+  for (Size i = 0; i < mesh.numFaces(); ++i) {
+    for (Size j = 0; j < 4; ++j) {
+      ASSERT(mesh.fv[i][j] == mesh_ref.fv[i][j]);
+    }
+  }
+  ASSERT(mesh.vf_offsets == mesh_ref.vf_offsets);
+  ASSERT(mesh.vf == mesh_ref.vf);
+  ASSERT(mesh.weldVertices() == 0);
+
+  // With a tolerance larger than the grid spacing, all vertices are merged
+  // into vertex 0
+  mesh = mesh_ref;
+  ASSERT(mesh.weldVertices(static_cast<T>(1.5)) == num_vertices - 1);
+  ASSERT(mesh.numVertices() == 1);
+  for (auto const & face : mesh.fv) {
+    for (Size j = 0; j < 4; ++j) {
+      ASSERT(face[j] == 0);
+    }
+  }
+}
+
 #if UM2_USE_CUDA
 template <std::floating_point T, std::signed_integral I>
 MAKE_CUDA_KERNEL(accessors, T, I)
@@ -96,6 +329,10 @@ TEST_SUITE(QuadMesh)
   TEST((boundingBox<T, I>));
   TEST((faceContaining<T, I>));
   TEST((toMeshFile<T, I>));
+  TEST((vertexFaceConnectivity<T, I>));
+  TEST((validateMesh<T, I>));
+  TEST((reorder<T, I>));
+  TEST((weldVertices<T, I>));
 }
 
 auto
@@ -1,5 +1,6 @@
 #include <um2/mesh/FaceVertexMesh.hpp>
 
+#include "./helpers/check_face_geometry.hpp"
 #include "./helpers/setup_mesh.hpp"
 #include "./helpers/setup_mesh_file.hpp"
 
@@ -70,6 +71,30 @@ TEST_CASE(boundingBox)
   ASSERT_NEAR(box.yMax(), static_cast<T>(1), static_cast<T>(1e-6));
 }
 
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(faceGeometry)
+{
+  um2::QuadraticQuadMesh<2, T, I> mesh = makeQuad8ReferenceMesh<2, T, I>();
+  T const eps = static_cast<T>(1e-6);
+  ASSERT(faceGeometryIsCurrent(mesh));
+  // The cache is kept until it is cleared. Move vertex 6, the midpoint of the
+  // bottom edge of face 0, down.
+  T const area0 = mesh.faceGeometry().areas[0];
+  mesh.vertices[6][1] = static_cast<T>(-0.1);
+  ASSERT_NEAR(mesh.faceGeometry().areas[0], area0, eps);
+  ASSERT(!faceGeometryIsCurrent(mesh));
+  mesh.clearFaceGeometry();
+  ASSERT(!mesh.face_geometry.computed);
+  ASSERT(mesh.faceGeometry().areas[0] > area0 + eps);
+  ASSERT_NEAR(mesh.boundingBox().yMin(), static_cast<T>(-0.1), eps);
+  ASSERT(faceGeometryIsCurrent(mesh));
+  // Flipping a face clears it
+  mesh.flipFace(0);
+  ASSERT(!mesh.face_geometry.computed);
+  mesh.flipFace(0);
+  ASSERT(faceGeometryIsCurrent(mesh));
+}
+
 template <std::floating_point T, std::signed_integral I>
 TEST_CASE(faceContaining)
 {
@@ -104,6 +129,7 @@ TEST_SUITE(QuadraticQuadMesh)
   TEST((mesh_file_constructor<T, I>));
   TEST_HOSTDEV(accessors, 1, 1, T, I);
   TEST((boundingBox<T, I>));
+  TEST((faceGeometry<T, I>));
   TEST((faceContaining<T, I>));
 }
 
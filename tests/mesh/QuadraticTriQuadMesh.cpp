@@ -0,0 +1,124 @@
+#include <um2/mesh/MixedFaceVertexMesh.hpp>
+
+#include "./helpers/check_face_geometry.hpp"
+#include "./helpers/setup_mesh.hpp"
+#include "./helpers/setup_mesh_file.hpp"
+
+#include "../test_macros.hpp"
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(mesh_file_constructor)
+{
+  um2::MeshFile<T, I> mesh_file;
+  makeReferenceTri6Quad8MeshFile(mesh_file);
+  um2::QuadraticTriQuadMesh<2, T, I> mesh_ref = makeTri6Quad8ReferenceMesh<2, T, I>();
+  um2::QuadraticTriQuadMesh<2, T, I> mesh(mesh_file);
+  ASSERT(mesh.numVertices() == mesh_ref.numVertices());
+  for (Size i = 0; i < mesh.numVertices(); ++i) {
+    ASSERT(um2::isApprox(mesh.vertices[i], mesh_ref.vertices[i]));
+  }
+  ASSERT(mesh.fv_offsets == mesh_ref.fv_offsets);
+  ASSERT(mesh.fv == mesh_ref.fv);
+  ASSERT(mesh.vf_offsets == mesh_ref.vf_offsets);
+  ASSERT(mesh.vf == mesh_ref.vf);
+}
+
+template <std::floating_point T, std::signed_integral I>
+HOSTDEV
+TEST_CASE(accessors)
+{
+  um2::QuadraticTriQuadMesh<2, T, I> mesh = makeTri6Quad8ReferenceMesh<2, T, I>();
+  ASSERT(mesh.numVertices() == 11);
+  ASSERT(mesh.numFaces() == 2);
+  ASSERT(mesh.numFaceVertices(0) == 8);
+  ASSERT(mesh.numFaceVertices(1) == 6);
+  auto const num_edges = [](auto const & face) { return face.numEdges(); };
+  ASSERT(mesh.visitFace(0, num_edges) == 4);
+  ASSERT(mesh.visitFace(1, num_edges) == 3);
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(boundingBox)
+{
+  um2::QuadraticTriQuadMesh<2, T, I> const mesh = makeTri6Quad8ReferenceMesh<2, T, I>();
+  auto const box = mesh.boundingBox();
+  ASSERT_NEAR(box.xMin(), static_cast<T>(0), static_cast<T>(1e-6));
+  ASSERT_NEAR(box.xMax(), static_cast<T>(2), static_cast<T>(1e-6));
+  ASSERT_NEAR(box.yMin(), static_cast<T>(0), static_cast<T>(1e-6));
+  ASSERT_NEAR(box.yMax(), static_cast<T>(1), static_cast<T>(1e-6));
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(faceGeometry)
+{
+  um2::QuadraticTriQuadMesh<2, T, I> mesh = makeTri6Quad8ReferenceMesh<2, T, I>();
+  T const eps = static_cast<T>(1e-6);
+  ASSERT(faceGeometryIsCurrent(mesh));
+  // The cache is kept until it is cleared. Move vertex 5, the midpoint of the
+  // bottom edge of face 0, down.
+  T const area0 = mesh.faceGeometry().areas[0];
+  mesh.vertices[5][1] = static_cast<T>(-0.1);
+  ASSERT_NEAR(mesh.faceGeometry().areas[0], area0, eps);
+  ASSERT(!faceGeometryIsCurrent(mesh));
+  mesh.clearFaceGeometry();
+  ASSERT(!mesh.face_geometry.computed);
+  ASSERT(mesh.faceGeometry().areas[0] > area0 + eps);
+  ASSERT_NEAR(mesh.boundingBox().yMin(), static_cast<T>(-0.1), eps);
+  ASSERT(faceGeometryIsCurrent(mesh));
+  // Flipping a face clears it
+  mesh.flipFace(0);
+  ASSERT(!mesh.face_geometry.computed);
+  mesh.flipFace(0);
+  ASSERT(faceGeometryIsCurrent(mesh));
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(faceContaining)
+{
+  um2::QuadraticTriQuadMesh<2, T, I> const mesh = makeTri6Quad8ReferenceMesh<2, T, I>();
+  um2::Point2<T> p(static_cast<T>(0.6), static_cast<T>(0.5));
+  ASSERT(mesh.faceContaining(p) == 0);
+  p = um2::Point2<T>(static_cast<T>(0.8), static_cast<T>(0.5));
+  ASSERT(mesh.faceContaining(p) == 1);
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(toMeshFile)
+{
+  um2::QuadraticTriQuadMesh<2, T, I> const mesh = makeTri6Quad8ReferenceMesh<2, T, I>();
+  um2::MeshFile<T, I> mesh_file_ref;
+  makeReferenceTri6Quad8MeshFile(mesh_file_ref);
+  um2::MeshFile<T, I> mesh_file;
+  mesh.toMeshFile(mesh_file);
+  ASSERT(um2::compareGeometry(mesh_file, mesh_file_ref) == 0);
+  ASSERT(um2::compareTopology(mesh_file, mesh_file_ref) == 0);
+  ASSERT(mesh_file.getMeshType() == um2::MeshType::QuadraticTriQuad);
+}
+
+#if UM2_USE_CUDA
+template <std::floating_point T, std::signed_integral I>
+MAKE_CUDA_KERNEL(accessors, T, I)
+#endif
+
+template <std::floating_point T, std::signed_integral I>
+TEST_SUITE(QuadraticTriQuadMesh)
+{
+  TEST((mesh_file_constructor<T, I>));
+  TEST_HOSTDEV(accessors, 1, 1, T, I);
+  TEST((boundingBox<T, I>));
+  TEST((faceGeometry<T, I>));
+  TEST((faceContaining<T, I>));
+  TEST((toMeshFile<T, I>));
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE((QuadraticTriQuadMesh<float, int16_t>));
+  RUN_SUITE((QuadraticTriQuadMesh<float, int32_t>));
+  RUN_SUITE((QuadraticTriQuadMesh<float, int64_t>));
+  RUN_SUITE((QuadraticTriQuadMesh<double, int16_t>));
+  RUN_SUITE((QuadraticTriQuadMesh<double, int32_t>));
+  RUN_SUITE((QuadraticTriQuadMesh<double, int64_t>));
+  return 0;
+}
@@ -0,0 +1,191 @@
+#include <um2/mesh/MixedFaceVertexMesh.hpp>
+
+#include "./helpers/setup_mesh.hpp"
+#include "./helpers/setup_mesh_file.hpp"
+
+#include "../test_macros.hpp"
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(mesh_file_constructor)
+{
+  um2::MeshFile<T, I> mesh_file;
+  makeReferenceTriQuadMeshFile(mesh_file);
+  um2::TriQuadMesh<2, T, I> mesh_ref = makeTriQuadReferenceMesh<2, T, I>();
+  um2::TriQuadMesh<2, T, I> mesh(mesh_file);
+  ASSERT(mesh.numVertices() == mesh_ref.numVertices());
+  for (Size i = 0; i < mesh.numVertices(); ++i) {
+    ASSERT(um2::isApprox(mesh.vertices[i], mesh_ref.vertices[i]));
+  }
+  ASSERT(mesh.fv_offsets == mesh_ref.fv_offsets);
+  ASSERT(mesh.fv == mesh_ref.fv);
+  ASSERT(mesh.vf_offsets == mesh_ref.vf_offsets);
+  ASSERT(mesh.vf == mesh_ref.vf);
+}
+
+template <std::floating_point T, std::signed_integral I>
+HOSTDEV
+TEST_CASE(accessors)
+{
+  um2::TriQuadMesh<2, T, I> mesh = makeTriQuadReferenceMesh<2, T, I>();
+  ASSERT(mesh.numVertices() == 5);
+  ASSERT(mesh.numFaces() == 2);
+  ASSERT(mesh.numFaceVertices(0) == 4);
+  ASSERT(mesh.numFaceVertices(1) == 3);
+  // face
+  auto const num_edges = [](auto const & face) { return face.numEdges(); };
+  ASSERT(mesh.visitFace(0, num_edges) == 4);
+  ASSERT(mesh.visitFace(1, num_edges) == 3);
+  auto const area = [](auto const & face) { return face.area(); };
+  ASSERT_NEAR(mesh.visitFace(0, area), static_cast<T>(1), static_cast<T>(1e-6));
+  ASSERT_NEAR(mesh.visitFace(1, area), static_cast<T>(0.5), static_cast<T>(1e-6));
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(boundingBox)
+{
+  um2::TriQuadMesh<2, T, I> const mesh = makeTriQuadReferenceMesh<2, T, I>();
+  auto const box = mesh.boundingBox();
+  ASSERT_NEAR(box.xMin(), static_cast<T>(0), static_cast<T>(1e-6));
+  ASSERT_NEAR(box.xMax(), static_cast<T>(2), static_cast<T>(1e-6));
+  ASSERT_NEAR(box.yMin(), static_cast<T>(0), static_cast<T>(1e-6));
+  ASSERT_NEAR(box.yMax(), static_cast<T>(1), static_cast<T>(1e-6));
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(faceContaining)
+{
+  um2::TriQuadMesh<2, T, I> const mesh = makeTriQuadReferenceMesh<2, T, I>();
+  um2::Point2<T> p(static_cast<T>(0.5), static_cast<T>(0.25));
+  ASSERT(mesh.faceContaining(p) == 0);
+  p = um2::Point2<T>(static_cast<T>(1.25), static_cast<T>(0.25));
+  ASSERT(mesh.faceContaining(p) == 1);
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(flipFace)
+{
+  um2::TriQuadMesh<2, T, I> mesh = makeTriQuadReferenceMesh<2, T, I>();
+  mesh.flipFace(0);
+  mesh.flipFace(1);
+  um2::Vector<I> const fv_ref = {0, 3, 2, 1, 1, 2, 4};
+  ASSERT(mesh.fv == fv_ref);
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(toMeshFile)
+{
+  um2::TriQuadMesh<2, T, I> const mesh = makeTriQuadReferenceMesh<2, T, I>();
+  um2::MeshFile<T, I> mesh_file_ref;
+  makeReferenceTriQuadMeshFile(mesh_file_ref);
+  um2::MeshFile<T, I> mesh_file;
+  mesh.toMeshFile(mesh_file);
+  ASSERT(um2::compareGeometry(mesh_file, mesh_file_ref) == 0);
+  ASSERT(um2::compareTopology(mesh_file, mesh_file_ref) == 0);
+  ASSERT(mesh_file.getMeshType() == um2::MeshType::TriQuad);
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(intersect)
+{
+  um2::TriQuadMesh<2, T, I> const mesh = makeTriQuadReferenceMesh<2, T, I>();
+  um2::Ray2<T> const ray(um2::Point2<T>(static_cast<T>(-1), static_cast<T>(0.5)),
+                         um2::Vec2<T>(static_cast<T>(1), static_cast<T>(0)));
+  T intersections[8];
+  Size n = 8;
+  mesh.intersect(ray, intersections, &n);
+  // The shared edge is intersected once by each face
+  ASSERT(n == 4);
+  ASSERT_NEAR(intersections[0], static_cast<T>(1), static_cast<T>(1e-6));
+  ASSERT_NEAR(intersections[1], static_cast<T>(2), static_cast<T>(1e-6));
+  ASSERT_NEAR(intersections[2], static_cast<T>(2), static_cast<T>(1e-6));
+  ASSERT_NEAR(intersections[3], static_cast<T>(2.5), static_cast<T>(1e-6));
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(reorder)
+{
+  um2::TriQuadMesh<2, T, I> const mesh_ref = makeTriQuadReferenceMesh<2, T, I>();
+  um2::MeshOrdering const orderings[4] = {
+      um2::MeshOrdering::None, um2::MeshOrdering::Morton, um2::MeshOrdering::Hilbert,
+      um2::MeshOrdering::RCM};
+  for (auto const ordering : orderings) {
+    um2::TriQuadMesh<2, T, I> mesh = mesh_ref;
+    um2::Vector<Size> const perm = mesh.reorder(ordering);
+    ASSERT(perm.size() == 2);
+    ASSERT(mesh.fv_offsets.size() == 3);
+    ASSERT(mesh.fv.size() == mesh_ref.fv.size());
+    // Each face has the same vertices as before, in the same order
+    for (Size i = 0; i < 2; ++i) {
+      auto const first = static_cast<Size>(mesh.fv_offsets[i]);
+      auto const first_ref = static_cast<Size>(mesh_ref.fv_offsets[perm[i]]);
+      Size const n = static_cast<Size>(mesh.fv_offsets[i + 1]) - first;
+      ASSERT(n == static_cast<Size>(mesh_ref.fv_offsets[perm[i] + 1]) - first_ref);
+      for (Size j = 0; j < n; ++j) {
+        auto const v = static_cast<Size>(mesh.fv[first + j]);
+        auto const v_ref = static_cast<Size>(mesh_ref.fv[first_ref + j]);
+        ASSERT(um2::isApprox(mesh.vertices[v], mesh_ref.vertices[v_ref]));
+      }
+    }
+    // The faces of each vertex contain the vertex
+    ASSERT(mesh.vf_offsets.size() == 6);
+    ASSERT(mesh.vf.size() == 7);
+    for (Size v = 0; v < 5; ++v) {
+      for (I k = mesh.vf_offsets[v]; k < mesh.vf_offsets[v + 1]; ++k) {
+        auto const face = static_cast<Size>(mesh.vf[static_cast<Size>(k)]);
+        bool found = false;
+        for (I j = mesh.fv_offsets[face]; j < mesh.fv_offsets[face + 1]; ++j) {
+          found = found || mesh.fv[static_cast<Size>(j)] == v;
+        }
+        ASSERT(found);
+      }
+    }
+  }
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(weldVertices)
+{
+  um2::TriQuadMesh<2, T, I> const mesh_ref = makeTriQuadReferenceMesh<2, T, I>();
+  // Give the triangle its own copies of vertices 1 and 2
+  um2::TriQuadMesh<2, T, I> mesh = mesh_ref;
+  mesh.vertices.push_back(mesh_ref.vertices[1]);
+  mesh.vertices.push_back(mesh_ref.vertices[2]);
+  mesh.fv = {0, 1, 2, 3, 5, 4, 6};
+  um2::buildVertexFaceConnectivity(mesh);
+  ASSERT(mesh.weldVertices() == 2);
+  ASSERT(mesh.numVertices() == 5);
+  ASSERT(mesh.fv == mesh_ref.fv);
+  ASSERT(mesh.vf_offsets == mesh_ref.vf_offsets);
+  ASSERT(mesh.vf == mesh_ref.vf);
+}
+
+#if UM2_USE_CUDA
+template <std::floating_point T, std::signed_integral I>
+MAKE_CUDA_KERNEL(accessors, T, I)
+#endif
+
+template <std::floating_point T, std::signed_integral I>
+TEST_SUITE(TriQuadMesh)
+{
+  TEST((mesh_file_constructor<T, I>));
+  TEST_HOSTDEV(accessors, 1, 1, T, I);
+  TEST((boundingBox<T, I>));
+  TEST((faceContaining<T, I>));
+  TEST((flipFace<T, I>));
+  TEST((toMeshFile<T, I>));
+  TEST((intersect<T, I>));
+  TEST((reorder<T, I>));
+  TEST((weldVertices<T, I>));
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE((TriQuadMesh<float, int16_t>));
+  RUN_SUITE((TriQuadMesh<float, int32_t>));
+  RUN_SUITE((TriQuadMesh<float, int64_t>));
+  RUN_SUITE((TriQuadMesh<double, int16_t>));
+  RUN_SUITE((TriQuadMesh<double, int32_t>));
+  RUN_SUITE((TriQuadMesh<double, int64_t>));
+  return 0;
+}
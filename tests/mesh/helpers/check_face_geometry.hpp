@@ -0,0 +1,38 @@
+#include <um2/mesh/MixedFaceVertexMesh.hpp>
+
+// Whether the cached face geometry of mesh, a FaceVertexMesh or a
+// MixedFaceVertexMesh, matches the geometry of its faces.
+template <class Mesh>
+auto
+faceGeometryIsCurrent(Mesh const & mesh) -> bool
+{
+  using T = std::remove_cvref_t<decltype(mesh.vertices[0][0])>;
+  auto const eps = static_cast<T>(1e-6);
+  auto const & geometry = mesh.faceGeometry();
+  if (!geometry.computed || geometry.areas.size() != mesh.numFaces() ||
+      geometry.centroids.size() != mesh.numFaces() ||
+      geometry.boxes.size() != mesh.numFaces()) {
+    return false;
+  }
+  for (Size i = 0; i < mesh.numFaces(); ++i) {
+    bool const current = mesh.visitFace(i, [&geometry, i, eps](auto const & face) {
+      auto const box = face.boundingBox();
+      return um2::abs(geometry.areas[i] - face.area()) <= eps &&
+             um2::isApprox(geometry.centroids[i], face.centroid()) &&
+             um2::isApprox(geometry.boxes[i].minima, box.minima) &&
+             um2::isApprox(geometry.boxes[i].maxima, box.maxima);
+    });
+    if (!current) {
+      return false;
+    }
+  }
+  if (mesh.numFaces() == 0) {
+    return true;
+  }
+  auto box = geometry.boxes[0];
+  for (Size i = 1; i < mesh.numFaces(); ++i) {
+    box += geometry.boxes[i];
+  }
+  return um2::isApprox(geometry.box.minima, box.minima) &&
+         um2::isApprox(geometry.box.maxima, box.maxima);
+}
@@ -1,3 +1,5 @@
+#include <um2/mesh/MixedFaceVertexMesh.hpp>
+
 template <Size D, std::floating_point T, std::signed_integral I>
 HOSTDEV auto
 makeTriReferenceMesh() -> um2::TriMesh<D, T, I>
@@ -49,23 +51,25 @@ makeQuadReferenceMesh() -> um2::QuadMesh<D, T, I>
   return mesh;
 }
 
-//
-// template <std::floating_point T, std::signed_integral I>
-// HOSTDEV void makeTriQuadReferenceMesh(um2::TriQuadMesh<T, I> & mesh)
-//{
-//   mesh.vertices = {
-//       {0, 0},
-//       {1, 0},
-//       {1, 1},
-//       {0, 1},
-//       {2, 0}
-//   };
-//   mesh.fv_offsets = {0, 4, 7};
-//   mesh.fv = {0, 1, 2, 3, 1, 4, 2};
-//   mesh.vf_offsets = {0, 1, 3, 5, 6, 7};
-//   mesh.vf = {0, 0, 1, 0, 1, 0, 1};
-// }
-//
+template <Size D, std::floating_point T, std::signed_integral I>
+HOSTDEV auto
+makeTriQuadReferenceMesh() -> um2::TriQuadMesh<D, T, I>
+{
+  um2::TriQuadMesh<D, T, I> mesh;
+  mesh.vertices = {
+      {0, 0},
+      {1, 0},
+      {1, 1},
+      {0, 1},
+      {2, 0}
+  };
+  mesh.fv_offsets = {0, 4, 7};
+  mesh.fv = {0, 1, 2, 3, 1, 4, 2};
+  mesh.vf_offsets = {0, 1, 3, 5, 6, 7};
+  mesh.vf = {0, 0, 1, 0, 1, 0, 1};
+  return mesh;
+}
+
 template <Size D, std::floating_point T, std::signed_integral I>
 HOSTDEV auto
 makeTri6ReferenceMesh() -> um2::QuadraticTriMesh<D, T, I>
@@ -120,25 +124,27 @@ makeQuad8ReferenceMesh() -> um2::QuadraticQuadMesh<D, T, I>
   return mesh;
 }
 
-// template <std::floating_point T, std::signed_integral I>
-// HOSTDEV void makeTri6Quad8ReferenceMesh(um2::QuadraticTriQuadMesh<T, I> &
-// mesh)
-//{
-//   mesh.vertices = {
-//       {static_cast<T>(0.0), static_cast<T>(0.0)},
-//       {static_cast<T>(1.0), static_cast<T>(0.0)},
-//       {static_cast<T>(1.0), static_cast<T>(1.0)},
-//       {static_cast<T>(0.0), static_cast<T>(1.0)},
-//       {static_cast<T>(2.0), static_cast<T>(0.0)},
-//       {static_cast<T>(0.5), static_cast<T>(0.0)},
-//       {static_cast<T>(0.7), static_cast<T>(0.6)},
-//       {static_cast<T>(0.5), static_cast<T>(1.0)},
-//       {static_cast<T>(0.0), static_cast<T>(0.5)},
-//       {static_cast<T>(1.5), static_cast<T>(0.0)},
-//       {static_cast<T>(1.5), static_cast<T>(0.5)}
-//   };
-//   mesh.fv_offsets = {0, 8, 14};
-//   mesh.fv = {0, 1, 2, 3, 5, 6, 7, 8, 1, 4, 2, 9, 10, 6};
-//   mesh.vf_offsets = {0, 1, 3, 5, 6, 7, 8, 10, 11, 12, 13, 14};
-//   mesh.vf = {0, 0, 1, 0, 1, 0, 1, 0, 0, 1, 0, 0, 1, 1};
-// }
+template <Size D, std::floating_point T, std::signed_integral I>
+HOSTDEV auto
+makeTri6Quad8ReferenceMesh() -> um2::QuadraticTriQuadMesh<D, T, I>
+{
+  um2::QuadraticTriQuadMesh<D, T, I> mesh;
+  mesh.vertices = {
+      {static_cast<T>(0.0), static_cast<T>(0.0)},
+      {static_cast<T>(1.0), static_cast<T>(0.0)},
+      {static_cast<T>(1.0), static_cast<T>(1.0)},
+      {static_cast<T>(0.0), static_cast<T>(1.0)},
+      {static_cast<T>(2.0), static_cast<T>(0.0)},
+      {static_cast<T>(0.5), static_cast<T>(0.0)},
+      {static_cast<T>(0.7), static_cast<T>(0.6)},
+      {static_cast<T>(0.5), static_cast<T>(1.0)},
+      {static_cast<T>(0.0), static_cast<T>(0.5)},
+      {static_cast<T>(1.5), static_cast<T>(0.0)},
+      {static_cast<T>(1.5), static_cast<T>(0.5)}
+  };
+  mesh.fv_offsets = {0, 8, 14};
+  mesh.fv = {0, 1, 2, 3, 5, 6, 7, 8, 1, 4, 2, 9, 10, 6};
+  mesh.vf_offsets = {0, 1, 3, 5, 6, 7, 8, 10, 11, 12, 13, 14};
+  mesh.vf = {0, 0, 1, 0, 1, 0, 1, 0, 0, 1, 0, 0, 1, 1};
+  return mesh;
+}
@@ -153,3 +153,115 @@ makeReferenceTri6Quad8MeshFile(um2::MeshFile<T, I> & mesh)
   mesh.elset_offsets = {0, 2, 3, 4, 5};
   mesh.elset_ids = {0, 1, 1, 1, 0};
 }
+
+inline auto
+syntheticCellType(size_t const i, bool const mixed) -> um2::MeshType
+{
+  return (mixed && i % 3 == 0) ? um2::MeshType::QuadraticTri
+                               : um2::MeshType::QuadraticQuad;
+}
+
+size_t constexpr synthetic_num_vertices = 1000;
+
+// A mesh of num_cells quadratic quadrilaterals, or of quadratic triangles and
+// quadrilaterals if mixed, on 1000 vertices. The type and vertex ids of cell i
+// follow from i, so that compareSyntheticMeshFile can check a mesh too large to
+// keep two copies of. Every 64th cell is in elset Material_A, and the cell after
+// it in Material_B.
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
+void
+makeSyntheticMeshFile(um2::MeshFile<T, I, O> & mesh, size_t const num_cells,
+                      bool const mixed)
+{
+  mesh.filepath = "./synthetic.xdmf";
+  mesh.name = "synthetic";
+  mesh.format = um2::MeshFileFormat::XDMF;
+  mesh.vertices.resize(synthetic_num_vertices);
+  for (size_t i = 0; i < synthetic_num_vertices; ++i) {
+    mesh.vertices[i] = um2::Point3<T>(static_cast<T>(i % 40), static_cast<T>(i / 40),
+                                      static_cast<T>(0));
+  }
+  mesh.element_types.resize(num_cells);
+  mesh.element_offsets.resize(num_cells + 1);
+  size_t num_conn = 0;
+  for (size_t i = 0; i < num_cells; ++i) {
+    mesh.element_types[i] = syntheticCellType(i, mixed);
+    mesh.element_offsets[i] = static_cast<O>(num_conn);
+    num_conn += static_cast<size_t>(um2::verticesPerCell(mesh.element_types[i]));
+  }
+  mesh.element_offsets[num_cells] = static_cast<O>(num_conn);
+  mesh.element_conn.resize(num_conn);
+  for (size_t i = 0; i < num_cells; ++i) {
+    auto const start = static_cast<size_t>(mesh.element_offsets[i]);
+    auto const end = static_cast<size_t>(mesh.element_offsets[i + 1]);
+    for (size_t j = start; j < end; ++j) {
+      mesh.element_conn[j] = static_cast<I>((i + j - start) % synthetic_num_vertices);
+    }
+  }
+  mesh.elset_names = {"Material_A", "Material_B"};
+  size_t const num_a = (num_cells + 63) / 64;
+  size_t const num_b = (num_cells + 62) / 64;
+  mesh.elset_offsets = {0, static_cast<O>(num_a), static_cast<O>(num_a + num_b)};
+  mesh.elset_ids.resize(num_a + num_b);
+  for (size_t i = 0; i < num_a; ++i) {
+    mesh.elset_ids[i] = static_cast<I>(64 * i);
+  }
+  for (size_t i = 0; i < num_b; ++i) {
+    mesh.elset_ids[num_a + i] = static_cast<I>(64 * i + 1);
+  }
+}
+
+// 0 if mesh is the mesh makeSyntheticMeshFile makes, as compareTopology.
+template <std::floating_point T, std::signed_integral I, std::signed_integral O>
+auto
+compareSyntheticMeshFile(um2::MeshFile<T, I, O> const & mesh, size_t const num_cells,
+                         bool const mixed) -> int
+{
+  um2::MeshFile<T, I, O> small;
+  makeSyntheticMeshFile(small, num_cells < 128 ? num_cells : 128, mixed);
+  if (um2::compareGeometry(mesh, small) != 0) {
+    return 1;
+  }
+  if (mesh.element_types.size() != num_cells ||
+      mesh.element_offsets.size() != num_cells + 1) {
+    return 2;
+  }
+  size_t offset = 0;
+  for (size_t i = 0; i < num_cells; ++i) {
+    if (mesh.element_types[i] != syntheticCellType(i, mixed)) {
+      return 3;
+    }
+    if (static_cast<size_t>(mesh.element_offsets[i]) != offset) {
+      return 4;
+    }
+    auto const n = static_cast<size_t>(um2::verticesPerCell(mesh.element_types[i]));
+    for (size_t j = 0; j < n; ++j) {
+      if (static_cast<size_t>(mesh.element_conn[offset + j]) !=
+          (i + j) % synthetic_num_vertices) {
+        return 5;
+      }
+    }
+    offset += n;
+  }
+  if (static_cast<size_t>(mesh.element_offsets[num_cells]) != offset ||
+      mesh.element_conn.size() != offset) {
+    return 4;
+  }
+  if (mesh.elset_names != small.elset_names) {
+    return 6;
+  }
+  size_t const num_a = (num_cells + 63) / 64;
+  size_t const num_b = (num_cells + 62) / 64;
+  if (mesh.elset_offsets.size() != 3 ||
+      static_cast<size_t>(mesh.elset_offsets[1]) != num_a ||
+      static_cast<size_t>(mesh.elset_offsets[2]) != num_a + num_b) {
+    return 7;
+  }
+  for (size_t i = 0; i < num_a + num_b; ++i) {
+    size_t const expected = i < num_a ? 64 * i : 64 * (i - num_a) + 1;
+    if (static_cast<size_t>(mesh.elset_ids[i]) != expected) {
+      return 8;
+    }
+  }
+  return 0;
+}
@@ -156,6 +156,77 @@ TEST_CASE(tri6_quad8_mesh)
   ASSERT(stat == 0);
 }
 
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(compressed_mesh)
+{
+  // Chunked, shuffled, and deflated datasets should round-trip exactly.
+  // Use a tiny chunk size so that each dataset spans several chunks.
+  um2::H5WriteOptions options;
+  options.compression = um2::H5Compression::ShuffleDeflate;
+  options.chunk_rows = 2;
+  for (int imesh = 0; imesh < 2; ++imesh) {
+    um2::MeshFile<T, I> mesh_ref;
+    if (imesh == 0) {
+      makeReferenceTri6MeshFile(mesh_ref);
+    } else {
+      makeReferenceTri6Quad8MeshFile(mesh_ref);
+    }
+    mesh_ref.filepath = "./compressed.xdmf";
+    um2::writeXDMFFile<T, I>(mesh_ref, options);
+
+    um2::MeshFile<T, I> mesh;
+    um2::readXDMFFile("./compressed.xdmf", mesh);
+    ASSERT(mesh.name == mesh_ref.name);
+    ASSERT(um2::compareGeometry(mesh, mesh_ref) == 0);
+    ASSERT(um2::compareTopology(mesh, mesh_ref) == 0);
+    ASSERT(mesh.elset_names == mesh_ref.elset_names);
+    ASSERT(mesh.elset_offsets == mesh_ref.elset_offsets);
+    ASSERT(mesh.elset_ids == mesh_ref.elset_ids);
+
+    int stat = std::remove("./compressed.xdmf");
+    ASSERT(stat == 0);
+    stat = std::remove("./compressed.h5");
+    ASSERT(stat == 0);
+  }
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(wide_offsets)
+{
+  // 64-bit offsets with narrower ids. With 16-bit ids, element_conn has more
+  // entries than the ids can count. With wider ids, the mixed topology spans
+  // several of the blocks it is written and read in.
+  size_t constexpr num_cells = 32000;
+  for (bool const mixed : {false, true}) {
+    um2::MeshFile<T, I, int64_t> mesh_ref;
+    makeSyntheticMeshFile(mesh_ref, num_cells, mixed);
+    um2::writeXDMFFile(mesh_ref);
+
+    um2::MeshFile<T, I, int64_t> mesh;
+    um2::readXDMFFile("./synthetic.xdmf", mesh);
+    ASSERT(compareSyntheticMeshFile(mesh, num_cells, mixed) == 0);
+    ASSERT(um2::compareTopology(mesh, mesh_ref) == 0);
+    ASSERT(mesh.elset_offsets == mesh_ref.elset_offsets);
+    ASSERT(mesh.elset_ids == mesh_ref.elset_ids);
+
+    // The offsets of the mesh do not fit in 16 bits
+    if constexpr (std::same_as<I, int16_t>) {
+      um2::Log::setExitOnError(false);
+      size_t const num_errors = um2::Log::getNumErrors();
+      um2::MeshFile<T, I> narrow;
+      um2::readXDMFFile("./synthetic.xdmf", narrow);
+      ASSERT(um2::Log::getNumErrors() == num_errors + 1);
+      ASSERT(narrow.element_conn.empty());
+      um2::Log::reset();
+    }
+
+    int stat = std::remove("./synthetic.xdmf");
+    ASSERT(stat == 0);
+    stat = std::remove("./synthetic.h5");
+    ASSERT(stat == 0);
+  }
+}
+
 template <std::floating_point T, std::integral I>
 TEST_SUITE(io_xdmf)
 {
@@ -165,6 +236,8 @@ TEST_SUITE(io_xdmf)
   TEST((tri6_mesh<T, I>));
   TEST((quad8_mesh<T, I>));
   TEST((tri6_quad8_mesh<T, I>));
+  TEST((compressed_mesh<T, I>));
+  TEST((wide_offsets<T, I>));
 }
 
 auto
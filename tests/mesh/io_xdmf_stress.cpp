@@ -0,0 +1,41 @@
+#include <um2/mesh/io_xdmf.hpp>
+
+#include "./helpers/setup_mesh_file.hpp"
+
+#include "../test_macros.hpp"
+
+// Export and import a mesh with more than 2^31 entries in element_conn, with
+// 32-bit ids and 64-bit offsets. The mesh takes about 11 GB of memory and 9 GB
+// of disk, and is never held twice, so this is only built with
+// UM2_BUILD_STRESS_TESTS.
+
+TEST_CASE(large_mesh)
+{
+  // 2^28 + 1 quadratic quadrilaterals have 2^31 + 8 entries in element_conn
+  size_t constexpr num_cells = (size_t{1} << 28) + 1;
+  for (bool const mixed : {false, true}) {
+    {
+      um2::MeshFile<float, int32_t, int64_t> mesh;
+      makeSyntheticMeshFile(mesh, num_cells, mixed);
+      ASSERT(!um2::offsetFits<int32_t>(mesh.element_conn.size()));
+      um2::writeXDMFFile(mesh);
+    }
+    um2::MeshFile<float, int32_t, int64_t> mesh;
+    um2::readXDMFFile("./synthetic.xdmf", mesh);
+    ASSERT(compareSyntheticMeshFile(mesh, num_cells, mixed) == 0);
+
+    int stat = std::remove("./synthetic.xdmf");
+    ASSERT(stat == 0);
+    stat = std::remove("./synthetic.h5");
+    ASSERT(stat == 0);
+  }
+}
+
+TEST_SUITE(io_xdmf_stress) { TEST(large_mesh); }
+
+auto
+main() -> int
+{
+  RUN_SUITE(io_xdmf_stress);
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <um2/mesh/tracing.hpp>
+
+#include "./helpers/setup_mesh.hpp"
+
+#include "../test_macros.hpp"
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(convertPrecision)
+{
+  um2::QuadraticTriQuadMesh<2, T, I> const mesh = makeTri6Quad8ReferenceMesh<2, T, I>();
+  auto const mesh_f = um2::convertPrecision<float>(mesh);
+  ASSERT(mesh_f.numVertices() == mesh.numVertices());
+  ASSERT(mesh_f.numFaces() == mesh.numFaces());
+  for (Size i = 0; i < mesh.numVertices(); ++i) {
+    ASSERT_NEAR(mesh_f.vertices[i][0], static_cast<float>(mesh.vertices[i][0]), 0.0F);
+    ASSERT_NEAR(mesh_f.vertices[i][1], static_cast<float>(mesh.vertices[i][1]), 0.0F);
+  }
+  ASSERT(mesh_f.fv == mesh.fv);
+  ASSERT(mesh_f.fv_offsets == mesh.fv_offsets);
+  ASSERT(mesh_f.vf == mesh.vf);
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_CASE(addTrackLengths)
+{
+  T const eps = static_cast<T>(1e-5);
+  um2::QuadMesh<2, T, I> const quad = makeQuadReferenceMesh<2, T, I>();
+  um2::Vector<T> lengths(2, 0);
+  um2::Point2<T> const o(static_cast<T>(-1), static_cast<T>(0.5));
+  um2::Vec2<T> const d(static_cast<T>(1), static_cast<T>(0));
+  um2::Ray2<T> const ray(o, d);
+  um2::addTrackLengths(quad, ray, lengths.data());
+  ASSERT_NEAR(lengths[0], 1, eps);
+  ASSERT_NEAR(lengths[1], 1, eps);
+
+  // The track lengths of a set of modular rays times their spacing add up to the
+  // area of each face
+  um2::QuadraticQuadMesh<2, T, I> const mesh = makeQuad8ReferenceMesh<2, T, I>();
+  um2::Vector<double> total(mesh.numFaces(), 0);
+  auto const params = um2::getModularRayParams(static_cast<T>(0.7), static_cast<T>(1e-3),
+                                               mesh.boundingBox());
+  Size const num_rays = params.num_rays[0] + params.num_rays[1];
+  for (Size i = 0; i < num_rays; ++i) {
+    um2::addTrackLengths(mesh, params.getRay(i), total.data());
+  }
+  double const spacing = params.spacing[0] * params.direction[1];
+  auto const areas = mesh.getFaceAreas();
+  for (Size i = 0; i < mesh.numFaces(); ++i) {
+    double const area = areas[i];
+    ASSERT_NEAR(total[i] * spacing, area, 1e-3);
+  }
+}
+
+template <std::signed_integral I>
+TEST_CASE(addTrackLengths_mixed)
+{
+  // A float mesh far from the origin of the core, traced with a ray in double,
+  // gives the same lengths as a double mesh
+  um2::QuadraticQuadMesh<2, double, I> const mesh =
+      makeQuad8ReferenceMesh<2, double, I>();
+  auto const mesh_f = um2::convertPrecision<float>(mesh);
+  um2::Point2<double> const origin(300.0, 200.0);
+  double const angle = 0.3;
+  um2::Vec2<double> const d(um2::cos(angle), um2::sin(angle));
+  for (Size i = 1; i < 10; ++i) {
+    // A ray through (origin + (1, i / 10)), from the left edge of the core
+    um2::Point2<double> const p(origin[0] + 1, origin[1] + static_cast<double>(i) / 10);
+    um2::Ray2<double> const ray(p - (p[0] / d[0]) * d, d);
+    um2::Vector<double> expected(2, 0);
+    um2::Vector<double> lengths(2, 0);
+    um2::addTrackLengths(mesh, origin, ray, expected.data());
+    um2::addTrackLengths(mesh_f, origin, ray, lengths.data());
+    ASSERT(expected[0] + expected[1] > 1);
+    ASSERT_NEAR(lengths[0], expected[0], 1e-5);
+    ASSERT_NEAR(lengths[1], expected[1], 1e-5);
+  }
+}
+
+template <std::floating_point T, std::signed_integral I>
+TEST_SUITE(tracing)
+{
+  TEST((convertPrecision<T, I>));
+  TEST((addTrackLengths<T, I>));
+  if constexpr (std::same_as<T, double>) {
+    TEST((addTrackLengths_mixed<I>));
+  }
+}
+
+auto
+main() -> int
+{
+  RUN_SUITE((tracing<float, int16_t>));
+  RUN_SUITE((tracing<float, int32_t>));
+  RUN_SUITE((tracing<float, int64_t>));
+  RUN_SUITE((tracing<double, int16_t>));
+  RUN_SUITE((tracing<double, int32_t>));
+  RUN_SUITE((tracing<double, int64_t>));
+  return 0;
+}
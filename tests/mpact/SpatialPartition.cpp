@@ -1,9 +1,12 @@
 #include <um2/mpact/SpatialPartition.hpp>
 #include <um2/mpact/io.hpp>
 
+#include "../mesh/helpers/check_face_geometry.hpp"
+
 #include "../test_macros.hpp"
 
 #include <fstream>
+#include <sstream>
 
 #if UM2_ENABLE_FLOAT64 == 1
 constexpr Float test_eps = 1e-6;
@@ -11,88 +14,204 @@ constexpr Float test_eps = 1e-6;
 constexpr auto test_eps = static_cast<Float>(1e-6);
 #endif
 
-// template <typename T, typename I>
-// TEST_CASE(test_make_cylindrical_pin_mesh)
-// um2::mpact::SpatialPartition model;
-// std::vector<double> const radii = {0.4096, 0.475, 0.575};
-// double const pitch = 1.26;
-// std::vector<int> const num_rings = {3, 1, 1};
-// int const na = 8;
-//
-// int id = -1;
-// id = model.make_cylindrical_pin_mesh(radii, pitch, num_rings, na, 1);
-// ASSERT(id == 0, "id should be 0");
-// ASSERT(model.quad.size() == 1, "size");
-// int total_rings = std::reduce(num_rings.begin(), num_rings.end());
-// int nfaces = (total_rings + 1) * na;
-// ASSERT(num_faces(model.quad[0]) == nfaces, "num_faces");
-// auto aabb = um2::bounding_box(model.quad[0]);
-// ASSERT_NEAR(um2::width(aabb), 1.26, 1e-6, "width");
-// ASSERT_NEAR(um2::height(aabb), 1.26, 1e-6, "height");
-// ASSERT_NEAR(aabb.minima[0], 0, 1e-6, "minima[0]");
-// ASSERT_NEAR(aabb.minima[1], 0, 1e-6, "minima[1]");
-//
-// id = model.make_cylindrical_pin_mesh(radii, pitch, num_rings, na, 2);
-// ASSERT(id == 0, "id should be 0");
-// ASSERT(model.quadratic_quad.size() == 1, "size");
-// ASSERT(num_faces(model.quadratic_quad[0]) == nfaces, "num_faces");
-// aabb = um2::bounding_box(model.quadratic_quad[0]);
-// ASSERT_NEAR(um2::width(aabb), 1.26, 1e-6, "width");
-// ASSERT_NEAR(um2::height(aabb), 1.26, 1e-6, "height");
-// ASSERT_NEAR(aabb.minima[0], 0, 1e-6, "minima[0]");
-// ASSERT_NEAR(aabb.minima[1], 0, 1e-6, "minima[1]");
-//
-// std::vector<um2::Material> materials;
-// um2::Vector<int8_t> material_ids;
-// um2::Material uo2("UO2", "forestgreen");
-// um2::Material clad("Clad", "lightgray");
-// um2::Material water("Water", "lightblue");
-// materials.insert(materials.end(), 3 * 8, uo2);
-// materials.insert(materials.end(), 1 * 8, clad);
-// materials.insert(materials.end(), 2 * 8, water);
-// material_ids.insert(material_ids.end(), 3 * 8, 0);
-// material_ids.insert(material_ids.end(), 1 * 8, 1);
-// material_ids.insert(material_ids.end(), 2 * 8, 2);
-// id = model.makeCoarseCell(2, 0, materials);
-// ASSERT(id == 0, "id should be 0");
-// ASSERT_NEAR(model.coarse_cells[0].dxdy[0], pitch, 1e-6, "dxdy");
-// ASSERT_NEAR(model.coarse_cells[0].dxdy[1], pitch, 1e-6, "dxdy");
-// ASSERT(model.coarse_cells[0].mesh_type == 2, "mesh_type");
-// ASSERT(model.coarse_cells[0].mesh_id == 0, "mesh_id");
-// ASSERT(model.coarse_cells[0].material_ids == material_ids, "material_ids");
-// END_TEST_CASE
-
-// template <typename T, typename I>
-// TEST_CASE(test_make_rectangular_pin_mesh)
-//{
-// um2::mpact::SpatialPartition model;
-// um2::Vec2<Float> dxdy(2, 1);
-//
-// int id = -1;
-// int nx = 1;
-// int ny = 1;
-// id = model.make_rectangular_pin_mesh(dxdy, nx, ny);
-// ASSERT(id == 0, "id should be 0");
-// ASSERT(model.quad.size() == 1, "size");
-// ASSERT(num_faces(model.quad[0]) == nx * ny, "num_faces");
-// auto aabb = um2::bounding_box(model.quad[0]);
-// ASSERT_NEAR(um2::width(aabb), dxdy[0], 1e-6, "width");
-// ASSERT_NEAR(um2::height(aabb), dxdy[1], 1e-6, "height");
-// ASSERT_NEAR(aabb.minima[0], 0, 1e-6, "minima[0]");
-// ASSERT_NEAR(aabb.minima[1], 0, 1e-6, "minima[1]");
-//
-// std::vector<um2::Material>
-// materials(nx * ny, um2::Material("A", "red"));
-// um2::Vector<int8_t>
-// material_ids(nx * ny, 0);
-// id = model.makeCoarseCell(2, 0, materials);
-// ASSERT(id == 0, "id should be 0");
-// ASSERT_NEAR(model.coarse_cells[0].dxdy[0], dxdy[0], 1e-6, "dxdy");
-// ASSERT_NEAR(model.coarse_cells[0].dxdy[1], dxdy[1], 1e-6, "dxdy");
-// ASSERT(model.coarse_cells[0].mesh_type == 2, "mesh_type");
-// ASSERT(model.coarse_cells[0].mesh_id == 0, "mesh_id");
-// ASSERT(model.coarse_cells[0].material_ids == material_ids, "material_ids");
-// }
+TEST_CASE(makeCylindricalPinMesh)
+{
+  um2::mpact::SpatialPartition model;
+  std::vector<Float> const radii = {0.4096, 0.475, 0.575};
+  Float const pitch = 1.26;
+  std::vector<Size> const num_rings = {3, 1, 1};
+  Size const na = 8;
+  Size const nfaces = na / 2 + (2 + 1 + 1 + 1) * na;
+  // The area of each ring, and outside the last ring
+  Float const pi = um2::pi<Float>;
+  std::vector<Float> ring_areas(3, pi * radii[0] * radii[0] / 3);
+  ring_areas.push_back(pi * (radii[1] * radii[1] - radii[0] * radii[0]));
+  ring_areas.push_back(pi * (radii[2] * radii[2] - radii[1] * radii[1]));
+  ring_areas.push_back(pitch * pitch - pi * radii[2] * radii[2]);
+
+  for (Size order = 1; order <= 2; ++order) {
+    Size const id = model.makeCylindricalPinMesh(radii, pitch, num_rings, na, order);
+    ASSERT(id == 0);
+    um2::Vector<Float> areas;
+    um2::AxisAlignedBox2<Float> box;
+    if (order == 1) {
+      ASSERT(model.quad.size() == 1);
+      ASSERT(model.quad[0].numFaces() == nfaces);
+      areas = model.quad[0].getFaceAreas();
+      box = model.quad[0].boundingBox();
+    } else {
+      ASSERT(model.quadratic_quad.size() == 1);
+      ASSERT(model.quadratic_quad[0].numFaces() == nfaces);
+      areas = model.quadratic_quad[0].getFaceAreas();
+      box = model.quadratic_quad[0].boundingBox();
+    }
+    ASSERT_NEAR(box.minima[0], 0, test_eps);
+    ASSERT_NEAR(box.minima[1], 0, test_eps);
+    ASSERT_NEAR(box.maxima[0], pitch, test_eps);
+    ASSERT_NEAR(box.maxima[1], pitch, test_eps);
+    Size iface = 0;
+    for (size_t ir = 0; ir < ring_areas.size(); ++ir) {
+      Size const nfaces_in_ring = ir == 0 ? na / 2 : na;
+      Float ring_area = 0;
+      for (Size ia = 0; ia < nfaces_in_ring; ++ia, ++iface) {
+        ASSERT(areas[iface] > 0);
+        ring_area += areas[iface];
+      }
+      ASSERT_NEAR(ring_area, ring_areas[ir], test_eps);
+    }
+    ASSERT(iface == nfaces);
+  }
+
+  // Fuel in the first region, clad in the second, and water outside
+  um2::Vector<MaterialID> material_ids(nfaces, 2);
+  for (Size i = 0; i < na / 2 + 3 * na; ++i) {
+    material_ids[i] = i < na / 2 + 2 * na ? 0 : 1;
+  }
+  Size const id = model.makeCoarseCell({pitch, pitch}, um2::MeshType::Quad, 0, material_ids);
+  ASSERT(id == 0);
+  ASSERT(model.coarse_cells[0].numFaces() == nfaces);
+
+  // Invalid arguments
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Off);
+  um2::Log::setExitOnError(false);
+  ASSERT(model.makeCylindricalPinMesh(radii, pitch, num_rings, 12) == -1);
+  ASSERT(model.makeCylindricalPinMesh(radii, 1.0, num_rings, na) == -1);
+  ASSERT(model.makeCylindricalPinMesh(radii, pitch, {3, 1}, na) == -1);
+  um2::Log::reset();
+}
+
+TEST_CASE(makeRectangularPinMesh)
+{
+  um2::mpact::SpatialPartition model;
+  um2::Vec2<Float> const dxdy(2, 1);
+  Size const id = model.makeRectangularPinMesh(dxdy, 2, 3);
+  ASSERT(id == 0);
+  ASSERT(model.quad.size() == 1);
+  auto const & mesh = model.quad[0];
+  ASSERT(mesh.numFaces() == 6);
+  ASSERT(mesh.numVertices() == 12);
+  auto const box = mesh.boundingBox();
+  ASSERT(um2::isApprox(box.minima, {0, 0}));
+  ASSERT(um2::isApprox(box.maxima, dxdy));
+  for (auto const area : mesh.getFaceAreas()) {
+    ASSERT_NEAR(area, static_cast<Float>(1) / 3, test_eps);
+  }
+  um2::Vector<MaterialID> const material_ids(6, 0);
+  Size const cc_id = model.makeCoarseCell(dxdy, um2::MeshType::Quad, id, material_ids);
+  ASSERT(cc_id == 0);
+  ASSERT(model.coarse_cells[0].mesh_id == 0);
+}
+
+TEST_CASE(visitMesh)
+{
+  um2::mpact::SpatialPartition model;
+  um2::Vec2<Float> const dxdy(2, 1);
+  Size const quad_id = model.makeRectangularPinMesh(dxdy, 2, 3);
+  Size const cyl_id = model.makeCylindricalPinMesh({0.4}, 1, {1}, 8, 2);
+  model.makeCoarseCell(dxdy, um2::MeshType::Quad, quad_id, um2::Vector<MaterialID>(6, 0));
+  model.makeCoarseCell({1, 1}, um2::MeshType::QuadraticQuad, cyl_id,
+                       um2::Vector<MaterialID>(12, 0));
+  auto const num_faces = [](auto const & mesh) -> Size { return mesh.numFaces(); };
+  ASSERT(model.visitMesh(um2::MeshType::Quad, quad_id, num_faces) == 6);
+  ASSERT(model.visitCoarseCellMesh(0, num_faces) == 6);
+  ASSERT(model.visitCoarseCellMesh(1, num_faces) == 12);
+  ASSERT(model.visitMeshes(um2::MeshType::QuadraticQuad,
+                           [](auto const & meshes) -> Size { return meshes.size(); }) == 1);
+  // FaceVertexMesh::visitFace matches MixedFaceVertexMesh::visitFace
+  auto const c = model.quad[quad_id].visitFace(
+      0, [](auto const & face) { return face.centroid(); });
+  ASSERT(um2::isApprox(c, {0.5, static_cast<Float>(1) / 6}));
+  Size num_meshes = 0;
+  model.forEachMeshes([&num_meshes](auto const & meshes) { num_meshes += meshes.size(); });
+  ASSERT(num_meshes == 2);
+  model.clear();
+  num_meshes = 0;
+  model.forEachMeshes([&num_meshes](auto const & meshes) { num_meshes += meshes.size(); });
+  ASSERT(num_meshes == 0);
+  // An invalid mesh type is an error
+  um2::Log::setExitOnError(false);
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Off);
+  ASSERT(model.visitMesh(um2::MeshType::None, 0, num_faces) == 0);
+  um2::Log::reset();
+}
+
+TEST_CASE(meshArena)
+{
+  um2::mpact::SpatialPartition model;
+  model.useMeshArena();
+  um2::Vec2<Float> const dxdy(2, 1);
+  for (Size i = 0; i < 100; ++i) {
+    ASSERT(model.makeRectangularPinMesh(dxdy, 2, 3) == i);
+  }
+  ASSERT(model.mesh_arena->numSlabs() == 1);
+  for (auto const & mesh : model.quad) {
+    ASSERT(model.mesh_arena->contains(mesh.vertices.data()));
+    ASSERT(model.mesh_arena->contains(mesh.fv.data()));
+    ASSERT(mesh.numFaces() == 6);
+    for (auto const area : mesh.getFaceAreas()) {
+      ASSERT_NEAR(area, static_cast<Float>(1) / 3, test_eps);
+    }
+  }
+  // Copies are on the heap
+  um2::QuadMesh<2, Float, Int> const copy = model.quad[99];
+  ASSERT(!model.mesh_arena->contains(copy.vertices.data()));
+  // Clearing the model starts a new arena
+  model.clear();
+  ASSERT(model.quad.empty());
+  ASSERT(model.mesh_arena->numSlabs() == 0);
+  model.makeRectangularPinMesh(dxdy, 1, 1);
+  ASSERT(model.mesh_arena->contains(model.quad[0].vertices.data()));
+  // A mesh may outlive the model and its arena
+  um2::QuadMesh<2, Float, Int> mesh;
+  {
+    um2::mpact::SpatialPartition other;
+    other.useMeshArena();
+    other.makeRectangularPinMesh(dxdy, 2, 3);
+    mesh = um2::move(other.quad[0]);
+  }
+  ASSERT(mesh.numFaces() == 6);
+  for (auto const area : mesh.getFaceAreas()) {
+    ASSERT_NEAR(area, static_cast<Float>(1) / 3, test_eps);
+  }
+}
+
+// The mesh arrays of a snapshot read into an arena are themselves in the arena.
+// Assigning over the model replaces the arena before the meshes, so the slabs
+// must outlive the arena.
+TEST_CASE(meshArena_assign)
+{
+  um2::mpact::SpatialPartition model_out;
+  um2::Vec2<Float> const dxdy(2, 1);
+  Size const cell = model_out.makeCoarseCell(dxdy, um2::MeshType::Quad,
+                                             model_out.makeRectangularPinMesh(dxdy, 2, 3),
+                                             um2::Vector<MaterialID>(6, 0));
+  model_out.makeRTM({{cell}});
+  model_out.makeLattice({{0}});
+  model_out.makeAssembly({0});
+  model_out.makeCore({{0}});
+  std::string const filepath = "./mpact_arena_assign_test_model.um2";
+  um2::exportMesh(filepath, model_out);
+
+  um2::mpact::SpatialPartition model;
+  model.useMeshArena();
+  um2::importMesh(filepath, model);
+  ASSERT(model.mesh_arena->contains(model.quad.data()));
+  ASSERT(model.mesh_arena->contains(model.quad[0].vertices.data()));
+  // Copy assignment
+  model = model_out;
+  ASSERT(model.quad.size() == 1);
+  ASSERT(model.quad[0].numFaces() == 6);
+  // Move assignment
+  um2::mpact::SpatialPartition model2;
+  model2.useMeshArena();
+  um2::importMesh(filepath, model2);
+  model2 = um2::mpact::SpatialPartition();
+  ASSERT(model2.quad.empty());
+  ASSERT(!model2.mesh_arena);
+
+  int const stat = std::remove(filepath.c_str());
+  ASSERT(stat == 0);
+}
 
 TEST_CASE(makeCoarseCell)
 {
@@ -405,6 +524,92 @@ TEST_CASE(importCoarseCells)
   ASSERT(quad_mesh.fv[0][3] == 3);
 }
 
+TEST_CASE(importCoarseCells_shared)
+{
+  um2::mpact::SpatialPartition model;
+  model.makeCoarseCell({1, 1});
+  model.makeCoarseCell({1, 1});
+  model.makeCoarseCell({1, 1});
+  model.makeRTM({
+      {2, 2},
+      {0, 1}
+  });
+  model.makeLattice({{0}});
+  model.makeAssembly({0});
+  model.makeCore({{0}});
+  // Coarse cell 1 reuses the mesh of coarse cell 0
+  model.importCoarseCells("./mpact_mesh_files/coarse_cells.inp", {0, 0, 2});
+
+  ASSERT(model.tri.size() == 1);
+  ASSERT(model.quad.size() == 1);
+  auto const & cell0 = model.coarse_cells[0];
+  auto const & cell1 = model.coarse_cells[1];
+  ASSERT(cell1.mesh_type == um2::MeshType::Tri);
+  ASSERT(cell1.mesh_id == cell0.mesh_id);
+  ASSERT(cell1.material_ids.size() == 2);
+  ASSERT(cell1.material_ids[0] == cell0.material_ids[0]);
+  ASSERT(cell1.material_ids[1] == cell0.material_ids[1]);
+  ASSERT(model.coarse_cells[2].mesh_type == um2::MeshType::Quad);
+  ASSERT(model.coarse_cells[2].mesh_id == 0);
+
+  // A representative must be its own representative
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Off);
+  um2::Log::setExitOnError(false);
+  um2::mpact::SpatialPartition bad_model;
+  bad_model.makeCoarseCell({1, 1});
+  bad_model.makeCoarseCell({1, 1});
+  bad_model.makeRTM({{0, 1}});
+  bad_model.makeLattice({{0}});
+  bad_model.makeAssembly({0});
+  bad_model.makeCore({{0}});
+  bad_model.importCoarseCells("./mpact_mesh_files/coarse_cells.inp", {1, 0});
+  ASSERT(bad_model.tri.empty());
+  um2::Log::reset();
+}
+
+TEST_CASE(importCoarseCells_reorder)
+{
+  auto const makeModel = [](um2::MeshOrdering const ordering) {
+    um2::mpact::SpatialPartition model;
+    model.mesh_ordering = ordering;
+    model.makeCoarseCell({1, 1});
+    model.makeCoarseCell({1, 1});
+    model.makeCoarseCell({1, 1});
+    model.makeRTM({
+        {2, 2},
+        {0, 1}
+    });
+    model.makeLattice({{0}});
+    model.makeAssembly({0});
+    model.makeCore({{0}});
+    model.importCoarseCells("./mpact_mesh_files/coarse_cells.inp");
+    return model;
+  };
+  um2::mpact::SpatialPartition const model_ref = makeModel(um2::MeshOrdering::None);
+  um2::MeshOrdering const orderings[3] = {
+      um2::MeshOrdering::Morton, um2::MeshOrdering::Hilbert, um2::MeshOrdering::RCM};
+  for (auto const ordering : orderings) {
+    um2::mpact::SpatialPartition const model = makeModel(ordering);
+    ASSERT(model.tri.size() == 2);
+    // The material of each face follows the face
+    for (Size icc = 0; icc < 2; ++icc) {
+      auto const & cell = model.coarse_cells[icc];
+      auto const & cell_ref = model_ref.coarse_cells[icc];
+      auto const & mesh = model.tri[cell.mesh_id];
+      auto const & mesh_ref = model_ref.tri[cell_ref.mesh_id];
+      ASSERT(cell.material_ids.size() == cell_ref.material_ids.size());
+      for (Size i = 0; i < mesh.numFaces(); ++i) {
+        auto const c = mesh.getFace(i).centroid();
+        for (Size j = 0; j < mesh_ref.numFaces(); ++j) {
+          if (um2::isApprox(c, mesh_ref.getFace(j).centroid())) {
+            ASSERT(cell.material_ids[i] == cell_ref.material_ids[j]);
+          }
+        }
+      }
+    }
+  }
+}
+
 TEST_CASE(io)
 {
   using CoarseCell = um2::mpact::SpatialPartition::CoarseCell;
@@ -423,6 +628,7 @@ TEST_CASE(io)
   std::string const filepath = "./mpact_export_test_model.xdmf";
   um2::exportMesh(filepath, model_out);
   um2::mpact::SpatialPartition model;
+  model.useMeshArena();
   um2::importMesh(filepath, model);
 
   ASSERT(model.numAssemblies() == 1);
@@ -491,6 +697,437 @@ TEST_CASE(io)
   stat = std::remove("./mpact_export_test_model.h5");
   ASSERT(stat == 0);
 }
+
+TEST_CASE(io_face_geometry)
+{
+  // Two instances of a quadratic pin mesh. The second is exported with an offset,
+  // which the import shifts back to the origin.
+  um2::mpact::SpatialPartition model_out;
+  model_out.materials.push_back(um2::Material("Fuel", "red"));
+  Size const mesh_id = model_out.makeCylindricalPinMesh({0.4}, 1, {1}, 8, 2);
+  model_out.makeCoarseCell({1, 1}, um2::MeshType::QuadraticQuad, mesh_id,
+                           um2::Vector<MaterialID>(12, 0));
+  model_out.makeCoarseCell({1, 1}, um2::MeshType::QuadraticQuad, mesh_id,
+                           um2::Vector<MaterialID>(12, 0));
+  model_out.makeRTM({{0, 1}});
+  model_out.makeLattice({{0}});
+  model_out.makeAssembly({0});
+  model_out.makeCore({{0}});
+  std::string const filepath = "./mpact_export_test_model_face_geometry.xdmf";
+  um2::exportMesh(filepath, model_out);
+  um2::mpact::SpatialPartition model;
+  um2::importMesh(filepath, model);
+
+  ASSERT(model.quadratic_quad.size() == 2);
+  for (auto const & mesh : model.quadratic_quad) {
+    // Not filled on import
+    ASSERT(!mesh.face_geometry.computed);
+  }
+  // The first query may come from several threads at once
+  auto const & mesh0 = model.quadratic_quad[0];
+  Size constexpr num_queries = 16;
+  um2::Vector<Size> num_areas(num_queries, 0);
+#if UM2_USE_OPENMP
+#  pragma omp parallel for
+#endif
+  for (Size i = 0; i < num_queries; ++i) {
+    num_areas[i] = mesh0.faceGeometry().areas.size();
+  }
+  for (Size i = 0; i < num_queries; ++i) {
+    ASSERT(num_areas[i] == mesh0.numFaces());
+  }
+  for (auto const & mesh : model.quadratic_quad) {
+    // Filled after the shift
+    ASSERT(faceGeometryIsCurrent(mesh));
+    ASSERT(um2::isApprox(mesh.boundingBox().minima, {0, 0}));
+    ASSERT(um2::isApprox(mesh.boundingBox().maxima, {1, 1}));
+  }
+
+  int stat = std::remove(filepath.c_str());
+  ASSERT(stat == 0);
+  stat = std::remove("./mpact_export_test_model_face_geometry.h5");
+  ASSERT(stat == 0);
+}
+
+TEST_CASE(io_batches)
+{
+  // More coarse cells than the writer prepares per batch, each with its own
+  // materials, so that every batch of the pipeline is written and checked
+  um2::mpact::SpatialPartition model_out;
+  model_out.materials.push_back(um2::Material("Fuel", "red"));
+  model_out.materials.push_back(um2::Material("Moderator", "blue"));
+  um2::Vec2<Float> const dxdy(2, 1);
+  Size const mesh_id = model_out.makeRectangularPinMesh(dxdy, 2, 3);
+  Size constexpr nx = 20;
+  Size constexpr ny = 15;
+  std::vector<std::vector<Size>> cc_ids(ny, std::vector<Size>(nx));
+  for (Size i = 0; i < nx * ny; ++i) {
+    um2::Vector<MaterialID> material_ids(6);
+    for (Size k = 0; k < 6; ++k) {
+      material_ids[k] = static_cast<MaterialID>((i >> k) & 1);
+    }
+    model_out.makeCoarseCell(dxdy, um2::MeshType::Quad, mesh_id, material_ids);
+    cc_ids[static_cast<size_t>(i / nx)][static_cast<size_t>(i % nx)] = i;
+  }
+  model_out.makeRTM(cc_ids);
+  model_out.makeLattice({{0}});
+  model_out.makeAssembly({0});
+  model_out.makeCore({{0}});
+  std::string const filepath = "./mpact_export_test_model_batches.xdmf";
+  um2::exportMesh(filepath, model_out);
+  um2::mpact::SpatialPartition model;
+  um2::importMesh(filepath, model);
+
+  ASSERT(model.numCoarseCells() == nx * ny);
+  ASSERT(model.quad.size() == nx * ny);
+  auto const & mesh_out = model_out.quad[mesh_id];
+  for (Size i = 0; i < model.numCoarseCells(); ++i) {
+    auto const & cell = model.coarse_cells[i];
+    ASSERT(cell.mesh_type == um2::MeshType::Quad);
+    ASSERT(cell.material_ids == model_out.coarse_cells[i].material_ids);
+    ASSERT(um2::isApprox(cell.dxdy, dxdy));
+    auto const & mesh = model.quad[cell.mesh_id];
+    ASSERT(mesh.numVertices() == mesh_out.numVertices());
+    for (Size j = 0; j < mesh.numVertices(); ++j) {
+      ASSERT(um2::isApprox(mesh.vertices[j], mesh_out.vertices[j]));
+    }
+    ASSERT(mesh.numFaces() == mesh_out.numFaces());
+    for (Size j = 0; j < mesh.numFaces(); ++j) {
+      for (Size k = 0; k < 4; ++k) {
+        ASSERT(mesh.fv[j][k] == mesh_out.fv[j][k]);
+      }
+    }
+  }
+
+  int stat = std::remove(filepath.c_str());
+  ASSERT(stat == 0);
+  stat = std::remove("./mpact_export_test_model_batches.h5");
+  ASSERT(stat == 0);
+}
+
+TEST_CASE(io_lazy)
+{
+  um2::mpact::SpatialPartition model_out;
+  model_out.makeCoarseCell({1, 1});
+  model_out.makeCoarseCell({1, 1});
+  model_out.makeCoarseCell({1, 1});
+  model_out.makeRTM({
+      {2, 2},
+      {0, 1}
+  });
+  model_out.makeLattice({{0}});
+  model_out.makeAssembly({0});
+  model_out.makeCore({{0}});
+  model_out.importCoarseCells("./mpact_mesh_files/coarse_cells.inp");
+  std::string const filepath = "./mpact_export_test_model_lazy.xdmf";
+  um2::exportMesh(filepath, model_out);
+
+  // Only the hierarchy should be read
+  um2::mpact::SpatialPartition model;
+  um2::importMesh(filepath, model, /*load_meshes=*/false);
+  ASSERT(model.numAssemblies() == 1);
+  ASSERT(model.numLattices() == 1);
+  ASSERT(model.numRTMs() == 1);
+  ASSERT(model.numCoarseCells() == 3);
+  ASSERT(model.tri.empty());
+  ASSERT(model.quad.empty());
+  ASSERT(model.coarse_cells[0].mesh_type == um2::MeshType::Tri);
+  ASSERT(model.coarse_cells[1].mesh_type == um2::MeshType::Tri);
+  ASSERT(model.coarse_cells[2].mesh_type == um2::MeshType::Quad);
+  for (auto const & cell : model.coarse_cells) {
+    ASSERT(cell.mesh_id == -1);
+    ASSERT(cell.material_ids.empty());
+    ASSERT_NEAR(cell.dxdy[0], 1, test_eps);
+    ASSERT_NEAR(cell.dxdy[1], 1, test_eps);
+  }
+
+  // Files without the coarse cell information fall back to reading the
+  // vertices and topology of each cell
+  {
+    std::vector<std::string> lines;
+    std::ifstream in(filepath);
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.find("\"dx_dy\"") == std::string::npos &&
+          line.find("\"MeshType\"") == std::string::npos) {
+        lines.push_back(line);
+      }
+    }
+    in.close();
+    std::ofstream out(filepath);
+    for (auto const & l : lines) {
+      out << l << '\n';
+    }
+    out.close();
+    um2::mpact::SpatialPartition old_model;
+    um2::importMesh(filepath, old_model, /*load_meshes=*/false);
+    ASSERT(old_model.numCoarseCells() == 3);
+    for (Size i = 0; i < 3; ++i) {
+      ASSERT(old_model.coarse_cells[i].mesh_type == model.coarse_cells[i].mesh_type);
+      ASSERT(old_model.coarse_cells[i].mesh_id == -1);
+      ASSERT(um2::isApprox(old_model.coarse_cells[i].dxdy, model.coarse_cells[i].dxdy));
+    }
+  }
+
+  // Load a subset of the meshes, then the rest
+  um2::loadCoarseCellMeshes(filepath, model, {2, 1});
+  ASSERT(model.coarse_cells[0].mesh_id == -1);
+  ASSERT(model.coarse_cells[1].mesh_id == 0);
+  ASSERT(model.coarse_cells[2].mesh_id == 0);
+  ASSERT(model.tri.size() == 1);
+  ASSERT(model.quad.size() == 1);
+  ASSERT(model.coarse_cells[1].material_ids.size() == 2);
+  ASSERT(model.coarse_cells[1].material_ids[0] == 1);
+  ASSERT(model.coarse_cells[1].material_ids[1] == 0);
+  ASSERT(model.coarse_cells[2].material_ids.size() == 1);
+  ASSERT(model.coarse_cells[2].material_ids[0] == 0);
+  ASSERT(model.quad[0].fv.size() == 1);
+
+  // Coarse cells without a loaded mesh cannot be visited or exported
+  um2::Log::setExitOnError(false);
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Off);
+  ASSERT(!model.hasCoarseCellMesh(0));
+  ASSERT(model.hasCoarseCellMesh(1));
+  auto const num_faces = [](auto const & mesh) -> Size { return mesh.numFaces(); };
+  ASSERT(model.visitCoarseCellMesh(0, num_faces) == 0);
+  ASSERT(um2::Log::getNumErrors() == 1);
+  um2::exportMesh("./mpact_export_test_model_unloaded.xdmf", model);
+  ASSERT(um2::Log::getNumErrors() == 2);
+  ASSERT(!std::ifstream("./mpact_export_test_model_unloaded.h5").good());
+
+  // A mesh that fails to load leaves the model unchanged. Rename a material set
+  // of coarse cell 0, the first cell in the file, so that a face has no material.
+  {
+    std::ifstream in(filepath);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    in.close();
+    std::string const original = ss.str();
+    std::string text = original;
+    std::string const set = "Set Name=\"Material_UO2\"";
+    size_t const pos = text.find(set);
+    ASSERT(pos != std::string::npos);
+    text.replace(pos, set.size(), "Set Name=\"Material_Zr\"");
+    std::ofstream out(filepath);
+    out << text;
+    out.close();
+    um2::loadCoarseCellMeshes(filepath, model, {0});
+    ASSERT(um2::Log::getNumErrors() > 2);
+    ASSERT(model.coarse_cells[0].mesh_id == -1);
+    ASSERT(model.tri.size() == 1);
+    ASSERT(model.quad.size() == 1);
+    out.open(filepath);
+    out << original;
+    out.close();
+  }
+  um2::Log::reset();
+
+  um2::loadCoarseCellMeshes(filepath, model, {0, 1, 2});
+  ASSERT(model.tri.size() == 2);
+  ASSERT(model.quad.size() == 1);
+  ASSERT(model.coarse_cells[0].mesh_id == 1);
+  ASSERT(model.coarse_cells[0].material_ids.size() == 2);
+  ASSERT(model.coarse_cells[0].material_ids[0] == 1);
+  ASSERT(model.coarse_cells[0].material_ids[1] == 2);
+  um2::TriMesh<2, Float, Int> const & tri_mesh = model.tri[1];
+  ASSERT(tri_mesh.numVertices() == 4);
+  ASSERT(um2::isApprox(tri_mesh.vertices[0], {0, 0}));
+  ASSERT(um2::isApprox(tri_mesh.vertices[1], {1, 0}));
+  ASSERT(um2::isApprox(tri_mesh.vertices[2], {1, 1}));
+  ASSERT(um2::isApprox(tri_mesh.vertices[3], {0, 1}));
+
+  int stat = std::remove("./mpact_export_test_model_lazy.xdmf");
+  ASSERT(stat == 0);
+  stat = std::remove("./mpact_export_test_model_lazy.h5");
+  ASSERT(stat == 0);
+}
+
+TEST_CASE(io_subdomain)
+{
+  um2::mpact::SpatialPartition model_out;
+  model_out.makeCoarseCell({1, 1});
+  model_out.makeCoarseCell({1, 1});
+  model_out.makeCoarseCell({1, 1});
+  model_out.makeRTM({{0, 1}});
+  model_out.makeRTM({{2, 2}});
+  model_out.makeLattice({{0}});
+  model_out.makeLattice({{1}});
+  model_out.makeAssembly({0});
+  model_out.makeAssembly({1});
+  model_out.makeCore({{0, 1}});
+  model_out.importCoarseCells("./mpact_mesh_files/coarse_cells.inp");
+  std::string const filepath = "./mpact_export_test_model_subdomain.xdmf";
+  um2::exportMesh(filepath, model_out);
+
+  // Only the right assembly
+  um2::mpact::SpatialPartition model;
+  um2::importSubdomain(filepath, model, {{1, 0}});
+  ASSERT(model.numAssemblies() == 2);
+  ASSERT(model.numCoarseCells() == 3);
+  ASSERT(model.coarse_cells[0].mesh_id == -1);
+  ASSERT(model.coarse_cells[1].mesh_id == -1);
+  ASSERT(model.coarse_cells[2].mesh_id == 0);
+  ASSERT(model.tri.empty());
+  ASSERT(model.quad.size() == 1);
+
+  // The whole core
+  um2::mpact::SpatialPartition model_all;
+  um2::importSubdomain(filepath, model_all, {0, 0}, {2, 1});
+  ASSERT(model_all.tri.size() == 2);
+  ASSERT(model_all.quad.size() == 1);
+  for (auto const & cell : model_all.coarse_cells) {
+    ASSERT(cell.mesh_id != -1);
+  }
+
+  // Snapshots cannot be read in part
+  um2::Log::setExitOnError(false);
+  um2::Log::setMaxVerbosityLevel(um2::LogVerbosity::Off);
+  um2::mpact::SpatialPartition model_snapshot;
+  um2::importSubdomain("./mpact_export_test_model_subdomain.um2", model_snapshot,
+                       {{0, 0}});
+  ASSERT(um2::Log::getNumErrors() == 1);
+  ASSERT(model_snapshot.numCoarseCells() == 0);
+  um2::Log::reset();
+
+  int stat = std::remove("./mpact_export_test_model_subdomain.xdmf");
+  ASSERT(stat == 0);
+  stat = std::remove("./mpact_export_test_model_subdomain.h5");
+  ASSERT(stat == 0);
+}
+
+TEST_CASE(io_snapshot)
+{
+  // Use mesh arenas for both models
+  um2::mpact::SpatialPartition model_out;
+  model_out.useMeshArena();
+  model_out.makeCoarseCell({1, 1});
+  model_out.makeCoarseCell({1, 1});
+  model_out.makeCoarseCell({1, 1});
+  model_out.makeRTM({
+      {2, 2},
+      {0, 1}
+  });
+  model_out.makeLattice({{0}});
+  model_out.makeAssembly({0}, {0, 2});
+  model_out.makeCore({{0}});
+  model_out.importCoarseCells("./mpact_mesh_files/coarse_cells.inp");
+  std::string const filepath = "./mpact_export_test_model.um2";
+  um2::exportMesh(filepath, model_out);
+  um2::mpact::SpatialPartition model;
+  model.useMeshArena();
+  um2::importMesh(filepath, model);
+
+  ASSERT(model.core.children.size() == 1);
+  ASSERT(model.core.grid.divs[0].size() == 2);
+  ASSERT_NEAR(model.core.grid.divs[1][1], 2, test_eps);
+  ASSERT(model.numAssemblies() == 1);
+  ASSERT_NEAR(model.assemblies[0].grid.divs[0][1], 2, test_eps);
+  ASSERT(model.numLattices() == 1);
+  ASSERT(model.lattices[0].grid.num_cells[0] == 1);
+  ASSERT_NEAR(model.lattices[0].grid.spacing[1], 2, test_eps);
+  ASSERT(model.numRTMs() == 1);
+  ASSERT(model.rtms[0].children.size() == 4);
+  ASSERT(model.rtms[0].children[0] == 0);
+  ASSERT(model.rtms[0].children[3] == 2);
+  ASSERT(model.numCoarseCells() == 3);
+  for (Size i = 0; i < model.numCoarseCells(); ++i) {
+    auto const & cell = model.coarse_cells[i];
+    auto const & cell_out = model_out.coarse_cells[i];
+    ASSERT(cell.mesh_type == cell_out.mesh_type);
+    ASSERT(cell.mesh_id == cell_out.mesh_id);
+    ASSERT(cell.material_ids == cell_out.material_ids);
+    ASSERT(um2::isApprox(cell.dxdy, cell_out.dxdy));
+  }
+  ASSERT(model.materials == model_out.materials);
+  ASSERT(model.tri.size() == 2);
+  ASSERT(model.quad.size() == 1);
+  ASSERT(model.quadratic_tri.empty());
+  ASSERT(model.quadratic_quad.empty());
+  for (Size i = 0; i < model.tri.size(); ++i) {
+    auto const & mesh = model.tri[i];
+    auto const & mesh_out = model_out.tri[i];
+    ASSERT(mesh.numVertices() == mesh_out.numVertices());
+    for (Size j = 0; j < mesh.numVertices(); ++j) {
+      ASSERT(um2::isApprox(mesh.vertices[j], mesh_out.vertices[j]));
+    }
+    ASSERT(mesh.numFaces() == mesh_out.numFaces());
+    for (Size j = 0; j < mesh.numFaces(); ++j) {
+      for (Size k = 0; k < 3; ++k) {
+        ASSERT(mesh.fv[j][k] == mesh_out.fv[j][k]);
+      }
+    }
+    ASSERT(mesh.vf_offsets == mesh_out.vf_offsets);
+    ASSERT(mesh.vf == mesh_out.vf);
+  }
+  ASSERT(model.quad[0].numFaces() == 1);
+  for (Size k = 0; k < 4; ++k) {
+    ASSERT(model.quad[0].fv[0][k] == model_out.quad[0].fv[0][k]);
+  }
+
+  int const stat = std::remove(filepath.c_str());
+  ASSERT(stat == 0);
+}
+TEST_CASE(io_tri_quad)
+{
+  // A 2 by 1 coarse cell, with a quad on the left and two triangles on the right
+  um2::MeshFile<Float, Int> mesh_file;
+  mesh_file.vertices = {
+      {0, 0, 0},
+      {1, 0, 0},
+      {1, 1, 0},
+      {0, 1, 0},
+      {2, 0, 0},
+      {2, 1, 0}
+  };
+  mesh_file.element_types = {um2::MeshType::Quad, um2::MeshType::Tri, um2::MeshType::Tri};
+  mesh_file.element_offsets = {0, 4, 7, 10};
+  mesh_file.element_conn = {0, 1, 2, 3, 1, 4, 5, 1, 5, 2};
+  mesh_file.elset_names = {"Coarse_Cell_00000", "Material_H2O", "Material_UO2"};
+  mesh_file.elset_offsets = {0, 3, 5, 6};
+  mesh_file.elset_ids = {0, 1, 2, 1, 2, 0};
+  um2::mpact::SpatialPartition model_out;
+  model_out.makeCoarseCell({2, 1});
+  model_out.makeRTM({{0}});
+  model_out.makeLattice({{0}});
+  model_out.makeAssembly({0});
+  model_out.makeCore({{0}});
+  model_out.importCoarseCells(mesh_file);
+  ASSERT(model_out.tri_quad.size() == 1);
+  ASSERT(model_out.coarse_cells[0].mesh_type == um2::MeshType::TriQuad);
+  ASSERT(model_out.coarse_cells[0].numFaces() == 3);
+  auto const & mesh_out = model_out.tri_quad[0];
+  ASSERT(mesh_out.numFaces() == 3);
+  um2::Point2<Float> const p0 = {0.5, 0.5};
+  um2::Point2<Float> const p1 = {1.9, 0.5};
+  ASSERT(mesh_out.faceContaining(p0) == 0);
+  ASSERT(mesh_out.faceContaining(p1) == 1);
+
+  // Both file formats round trip the mixed mesh
+  for (std::string const ext : {".xdmf", ".um2"}) {
+    std::string const filepath = "./mpact_export_test_model" + ext;
+    um2::exportMesh(filepath, model_out);
+    um2::mpact::SpatialPartition model;
+    um2::importMesh(filepath, model);
+    ASSERT(model.tri_quad.size() == 1);
+    auto const & cell = model.coarse_cells[0];
+    ASSERT(cell.mesh_type == um2::MeshType::TriQuad);
+    ASSERT(cell.material_ids == model_out.coarse_cells[0].material_ids);
+    ASSERT(um2::isApprox(cell.dxdy, model_out.coarse_cells[0].dxdy));
+    auto const & mesh = model.tri_quad[cell.mesh_id];
+    ASSERT(mesh.numVertices() == mesh_out.numVertices());
+    ASSERT(mesh.fv_offsets == mesh_out.fv_offsets);
+    ASSERT(mesh.fv == mesh_out.fv);
+    ASSERT(mesh.vf_offsets == mesh_out.vf_offsets);
+    ASSERT(mesh.vf == mesh_out.vf);
+    int stat = std::remove(filepath.c_str());
+    ASSERT(stat == 0);
+    if (ext == ".xdmf") {
+      stat = std::remove("./mpact_export_test_model.h5");
+      ASSERT(stat == 0);
+    }
+  }
+}
+
 //// template <typename T, typename I>
 //// TEST_CASE(test_coarse_cell_face_areas)
 //// um2::mpact::SpatialPartition model;
@@ -597,7 +1234,11 @@ TEST_CASE(io)
 
 TEST_SUITE(SpatialPartition)
 {
-  // TEST_CASE("make_cylindrical_pin_mesh", (test_make_cylindrical_pin_mesh<Float, Int>));
+  TEST(makeCylindricalPinMesh);
+  TEST(makeRectangularPinMesh);
+  TEST(visitMesh);
+  TEST(meshArena);
+  TEST(meshArena_assign);
   TEST(makeCoarseCell);
   TEST(makeRTM);
   TEST(makeLattice);
@@ -605,7 +1246,15 @@ TEST_SUITE(SpatialPartition)
   TEST(makeAssembly_2d);
   TEST(makeCore);
   TEST(importCoarseCells);
+  TEST(importCoarseCells_shared);
+  TEST(importCoarseCells_reorder);
   TEST(io);
+  TEST(io_face_geometry);
+  TEST(io_batches);
+  TEST(io_lazy);
+  TEST(io_subdomain);
+  TEST(io_snapshot);
+  TEST(io_tri_quad);
   //    TEST_CASE("coarse_cell_face_areas", (test_coarse_cell_face_areas<Float, Int>));
   //    TEST_CASE("coarse_cell_find_face", (test_coarse_cell_find_face<Float, Int>));
   //    TEST_CASE("coarse_cell_ray_intersect", (test_coarse_cell_ray_intersect<Float,
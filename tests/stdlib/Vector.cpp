@@ -293,6 +293,76 @@ TEST_CASE(push_back_n)
   ASSERT(non_empty_vector.capacity() == 6);
 }
 
+//==============================================================================
+// Arena
+//==============================================================================
+
+template <class T>
+TEST_CASE(arena)
+{
+  um2::Vector<T> heap_vector{1, 2, 3};
+  um2::Vector<T> outlives_arena;
+  {
+    um2::Arena arena;
+    ASSERT(!arena.contains(heap_vector.data()));
+    {
+      um2::ArenaScope const scope(&arena);
+      um2::Vector<T> v(10, 2);
+      ASSERT(arena.contains(v.data()));
+      ASSERT(arena.numSlabs() == 1);
+      // Consecutive vectors are adjacent in the arena
+      um2::Vector<T> v2(4);
+      ASSERT(arena.contains(v2.data()));
+      ASSERT(reinterpret_cast<std::byte const *>(v2.data()) -
+                 reinterpret_cast<std::byte const *>(v.data()) ==
+             static_cast<ptrdiff_t>(10 * sizeof(T)));
+      // Growing past the slab size adds a slab
+      auto const n = static_cast<Size>(arena.slabSize() / sizeof(T));
+      for (Size i = 0; i < n; ++i) {
+        v.push_back(static_cast<T>(i % 100));
+      }
+      ASSERT(v.size() == n + 10);
+      ASSERT(arena.numSlabs() > 1);
+      ASSERT(arena.contains(v.data()));
+      for (Size i = 0; i < n + 10; ++i) {
+        T const expected = i < 10 ? static_cast<T>(2) : static_cast<T>((i - 10) % 100);
+        if constexpr (std::floating_point<T>) {
+          ASSERT_NEAR(v[i], expected, static_cast<T>(1e-6));
+        } else {
+          ASSERT(v[i] == expected);
+        }
+      }
+      // Heap and arena vectors may be mixed
+      um2::Vector<T> copy = heap_vector;
+      ASSERT(arena.contains(copy.data()));
+      heap_vector = um2::move(copy);
+      ASSERT(arena.contains(heap_vector.data()));
+      ASSERT(copy.data() == nullptr);
+      outlives_arena = um2::Vector<T>(5, 3);
+      // A nested null scope keeps the current arena
+      um2::ArenaScope const null_scope(nullptr);
+      ASSERT(um2::Arena::current() == &arena);
+    }
+    ASSERT(um2::Arena::current() == nullptr);
+    // Outside the scope, vectors are allocated on the heap again
+    um2::Vector<T> v3(10);
+    ASSERT(!arena.contains(v3.data()));
+    ASSERT(arena.bytesAllocated() > 0);
+  }
+  // The slabs of the arena are kept while its buffers are in use
+  outlives_arena.push_back(static_cast<T>(4));
+  ASSERT(outlives_arena.size() == 6);
+  for (Size i = 0; i < 6; ++i) {
+    T const expected = i < 5 ? static_cast<T>(3) : static_cast<T>(4);
+    if constexpr (std::floating_point<T>) {
+      ASSERT_NEAR(outlives_arena[i], expected, static_cast<T>(1e-6));
+    } else {
+      ASSERT(outlives_arena[i] == expected);
+    }
+  }
+  heap_vector = um2::Vector<T>(3);
+}
+
 //==============================================================================
 // CUDA
 //==============================================================================
@@ -354,6 +424,9 @@ MAKE_CUDA_KERNEL(clear)
   TEST_HOSTDEV(push_back, 1, 1, T)
   TEST_HOSTDEV(push_back_rval_ref, 1, 1, T)
   TEST_HOSTDEV(push_back_n, 1, 1, T)
+
+  // Arena
+  TEST(arena<T>)
 }
 
 auto
@@ -145,8 +145,13 @@ main() -> int
   model.makeAssembly({0});
   model.makeCore({{0}});
 
+  // Most coarse cells are identical up to translation. Only mesh one
+  // representative of each and share its mesh with the others.
+  auto const cc_representatives = um2::gmsh::model::occ::getUniqueCoarseCells(model);
+
   // Overlay the spatial partition
-  um2::gmsh::model::occ::overlaySpatialPartition(model);
+  um2::gmsh::model::occ::overlaySpatialPartition(model, "Moderator", um2::Color("royalblue"),
+                                                 cc_representatives);
 
   //   um2::gmsh::fltk::run();
 
@@ -156,8 +161,10 @@ main() -> int
 
   //   um2::gmsh::fltk::run();
 
-  um2::gmsh::write("crocus.inp");
-  model.importCoarseCells("crocus.inp");
+  // Skip writing and reparsing an .inp file by taking the mesh straight from gmsh
+  um2::MeshFile<Float, Int> mesh_file;
+  um2::gmsh::model::mesh::getMeshFile(mesh_file);
+  model.importCoarseCells(mesh_file, cc_representatives);
   um2::exportMesh("crocus.xdmf", model);
 
   um2::finalize();